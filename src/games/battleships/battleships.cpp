@@ -46,6 +46,12 @@ battleships_engine::Player &battleships_engine::Battleships::get_player_by_ind(s
     }
 }
 
+const battleships_engine::Player &battleships_engine::Battleships::get_player_by_ind(short ind) const {
+    return const_cast<Battleships *>(this)->get_player_by_ind(ind);
+}
+
+void battleships_engine::Battleships::set_player_now(short ind) { this->_player_now = &get_player_by_ind(ind); }
+
 void battleships_engine::Battleships::start_game() {
     if (!this->is_game_can_be_started()){
         throw std::runtime_error("Not all players are ready. Have you forgot to call make_ready() on each of them?");
@@ -553,8 +559,12 @@ bool battleships_engine::Ship::attack(const battleships_engine::Cell &position,F
 
 battleships_engine::Field &battleships_engine::Player::get_field() {return _my_field;}
 
+const battleships_engine::Field &battleships_engine::Player::get_field() const {return _my_field;}
+
 battleships_engine::Ships_container &battleships_engine::Player::get_ships() {return _ships;}
 
+const battleships_engine::Ships_container &battleships_engine::Player::get_ships() const {return _ships;}
+
 std::set<int> battleships_engine::Player::get_free_columns(battleships_engine::Ship *ship) {
     std::set<int> cols;
     Cell temp_cell(-1,-1);
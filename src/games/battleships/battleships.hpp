@@ -119,6 +119,12 @@ namespace battleships_engine {
          */
         Ships_container &get_ships();
 
+        /**
+         * @brief Provides read only access to the player's ships.
+         * @return A constant reference to the Ships_container that holds the player's ships.
+         */
+        const Ships_container &get_ships() const;
+
         /**
          * @brief Determines which columns are free for placing a ship.
          * @param ship Pointer to the ship to be placed.
@@ -157,6 +163,12 @@ namespace battleships_engine {
          */
         Field &get_field();
 
+        /**
+         * @brief Retrieves the player's game field for reading.
+         * @return A constant reference to the player's Field (10x10 grid).
+         */
+        const Field &get_field() const;
+
         /**
          * @brief Randomly places all the player's ships on the field.
          */
@@ -485,6 +497,19 @@ public:
      */
     Player &get_player_by_ind(short ind);
 
+    /**
+     * @brief Retrieves a player by their index for reading.
+     * @param ind The index of the player (0 or 1).
+     * @return A constant reference to the player corresponding to the index.
+     */
+    const Player &get_player_by_ind(short ind) const;
+
+    /**
+     * @brief Sets the player whose turn it is, used when a saved game is restored.
+     * @param ind The index of the player (0 or 1).
+     */
+    void set_player_now(short ind);
+
     /**
      * @brief Starts the game if all players are ready and sets the game as active.
      */
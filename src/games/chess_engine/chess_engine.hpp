@@ -0,0 +1,427 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <vector>
+
+#include "src/games/chess/chess/chess.h"
+
+namespace chess_engine {
+
+    /**
+     * @brief Result of a search.
+     */
+    struct Search_result {
+        std::optional<chess::Move> move; ///< Best move, empty if the side to move has no legal move.
+        int score = 0; ///< Score in centipawns for the side to move.
+        int depth = 0; ///< Last fully searched depth.
+        uint64_t nodes = 0; ///< Searched nodes.
+        bool is_cancelled = false; ///< Search was cancelled, move comes from the last finished depth.
+    };
+
+    /**
+     * @class Chess_engine
+     * @brief Iterative deepening alpha-beta search on top of the chess library move generator.
+     *
+     * Positions are scored by material and piece-square tables, captures are resolved by quiescence search.
+     * Moves are ordered by the transposition table move, then captures by most valuable victim and least
+     * valuable attacker, then killer moves. Search stops at a deadline or when cancel flag is set, checked every
+     * 1024 nodes, and returns the best move of the last finished depth. One engine must not be used from two
+     * threads at once, keep one per search thread to share its table between games.
+     */
+    class Chess_engine {
+    public:
+        /// Score of being mated now, mates found later score less.
+        static constexpr int mate_score = 100000;
+
+        /// Maximal search depth in plies.
+        static constexpr int max_ply = 64;
+
+    private:
+        /**
+         * @brief Transposition table entry.
+         */
+        struct Entry {
+            uint64_t key = 0; ///< Position key, 0 if empty.
+            int32_t score = 0; ///< Searched score, mates are stored relative to the position.
+            int8_t depth = -1; ///< Depth the score was searched to.
+            int8_t bound = 0; ///< 0 exact, 1 lower bound, 2 upper bound.
+            int8_t from = -1; ///< Origin square of the best move.
+            int8_t to = -1; ///< Target square of the best move.
+        };
+
+        /**
+         * @brief Move with its ordering score.
+         */
+        struct Scored_move {
+            chess::Move move;
+            int score;
+        };
+
+        /// Piece values indexed by piece type, pawn is 1.
+        static constexpr std::array<int, 7> piece_values = {0, 100, 320, 330, 500, 900, 20000};
+
+        /// Piece-square tables indexed by piece type and square from a8, seen from white side.
+        static constexpr std::array<std::array<int8_t, 64>, 7> piece_squares = {{
+            {},
+            { // pawn
+                  0,   0,   0,   0,   0,   0,   0,   0,
+                 50,  50,  50,  50,  50,  50,  50,  50,
+                 10,  10,  20,  30,  30,  20,  10,  10,
+                  5,   5,  10,  25,  25,  10,   5,   5,
+                  0,   0,   0,  20,  20,   0,   0,   0,
+                  5,  -5, -10,   0,   0, -10,  -5,   5,
+                  5,  10,  10, -20, -20,  10,  10,   5,
+                  0,   0,   0,   0,   0,   0,   0,   0
+            },
+            { // knight
+                -50, -40, -30, -30, -30, -30, -40, -50,
+                -40, -20,   0,   0,   0,   0, -20, -40,
+                -30,   0,  10,  15,  15,  10,   0, -30,
+                -30,   5,  15,  20,  20,  15,   5, -30,
+                -30,   0,  15,  20,  20,  15,   0, -30,
+                -30,   5,  10,  15,  15,  10,   5, -30,
+                -40, -20,   0,   5,   5,   0, -20, -40,
+                -50, -40, -30, -30, -30, -30, -40, -50
+            },
+            { // bishop
+                -20, -10, -10, -10, -10, -10, -10, -20,
+                -10,   0,   0,   0,   0,   0,   0, -10,
+                -10,   0,   5,  10,  10,   5,   0, -10,
+                -10,   5,   5,  10,  10,   5,   5, -10,
+                -10,   0,  10,  10,  10,  10,   0, -10,
+                -10,  10,  10,  10,  10,  10,  10, -10,
+                -10,   5,   0,   0,   0,   0,   5, -10,
+                -20, -10, -10, -10, -10, -10, -10, -20
+            },
+            { // rook
+                  0,   0,   0,   0,   0,   0,   0,   0,
+                  5,  10,  10,  10,  10,  10,  10,   5,
+                 -5,   0,   0,   0,   0,   0,   0,  -5,
+                 -5,   0,   0,   0,   0,   0,   0,  -5,
+                 -5,   0,   0,   0,   0,   0,   0,  -5,
+                 -5,   0,   0,   0,   0,   0,   0,  -5,
+                 -5,   0,   0,   0,   0,   0,   0,  -5,
+                  0,   0,   0,   5,   5,   0,   0,   0
+            },
+            { // queen
+                -20, -10, -10,  -5,  -5, -10, -10, -20,
+                -10,   0,   0,   0,   0,   0,   0, -10,
+                -10,   0,   5,   5,   5,   5,   0, -10,
+                 -5,   0,   5,   5,   5,   5,   0,  -5,
+                  0,   0,   5,   5,   5,   5,   0,  -5,
+                -10,   5,   5,   5,   5,   5,   0, -10,
+                -10,   0,   5,   0,   0,   0,   0, -10,
+                -20, -10, -10,  -5,  -5, -10, -10, -20
+            },
+            { // king
+                -30, -40, -40, -50, -50, -40, -40, -30,
+                -30, -40, -40, -50, -50, -40, -40, -30,
+                -30, -40, -40, -50, -50, -40, -40, -30,
+                -30, -40, -40, -50, -50, -40, -40, -30,
+                -20, -30, -30, -40, -40, -30, -30, -20,
+                -10, -20, -20, -20, -20, -20, -20, -10,
+                 20,  20,   0,   0,   0,   0,  20,  20,
+                 20,  30,  10,   0,   0,  10,  30,  20
+            }
+        }};
+
+        std::vector<Entry> _table; ///< Transposition table, size is a power of two.
+        std::array<std::array<std::pair<int8_t, int8_t>, 2>, max_ply> _killers{}; ///< Quiet moves which cut off.
+        std::chrono::steady_clock::time_point _deadline; ///< Time the search must stop at.
+        const std::atomic_bool *_cancel = nullptr; ///< Flag which stops the running search.
+        uint64_t _nodes = 0; ///< Searched nodes.
+        bool _is_stopped = false; ///< Search was stopped, results of the running depth are void.
+
+        /**
+         * @brief Mixes bits of a value.
+         */
+        static constexpr uint64_t mix(uint64_t x) {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        /**
+         * @brief Scores position for the side to move.
+         */
+        static int evaluate(const chess::Board &board) {
+            int score = 0;
+            for (int type = chess::PAWN; type <= chess::KING; type++) {
+                uint64_t white = board.pieces_mask(type, chess::WHITE);
+                uint64_t black = board.pieces_mask(type, chess::BLACK);
+                score += piece_values[type] * (std::popcount(white) - std::popcount(black));
+                // library squares start at a1, tables at a8
+                for (; white; white &= white - 1) {
+                    score += piece_squares[type][std::countr_zero(white) ^ 56];
+                }
+                for (; black; black &= black - 1) {
+                    score -= piece_squares[type][std::countr_zero(black)];
+                }
+            }
+            return board.turn == chess::WHITE ? score : -score;
+        }
+
+        /**
+         * @brief Checks deadline and cancel flag every 1024 nodes.
+         *
+         * @return True if search must stop.
+         */
+        bool is_stopped() {
+            if ((++_nodes & 1023) == 0 &&
+                (std::chrono::steady_clock::now() >= _deadline || (_cancel && _cancel->load(std::memory_order_relaxed)))) {
+                _is_stopped = true;
+            }
+            return _is_stopped;
+        }
+
+        /**
+         * @brief Gets legal moves ordered by how promising they are.
+         *
+         * @param captures_only Skip quiet moves, for quiescence search.
+         */
+        std::vector<Scored_move> order_moves(const chess::Board &board, const Entry *entry, int ply,
+                                             bool captures_only) const {
+            std::vector<Scored_move> moves;
+            for (chess::Move move: board.legal_moves()) {
+                int score = 0;
+                bool is_capture = board.is_capture(move);
+                if (entry && move.from_square == entry->from && move.to_square == entry->to) {
+                    score = 1000000;
+                } else if (is_capture) {
+                    auto victim = board.piece_type_at(move.to_square);
+                    auto attacker = board.piece_type_at(move.from_square);
+                    // en passant victim is not on the target square
+                    score = 100000 + (victim ? piece_values[*victim] : piece_values[chess::PAWN]) * 10 -
+                            (attacker ? piece_values[*attacker] / 100 : 0);
+                } else if (move.promotion) {
+                    score = 90000 + piece_values[*move.promotion];
+                } else if (captures_only) {
+                    continue;
+                } else if (ply < max_ply && (_killers[ply][0] == std::pair<int8_t, int8_t>(move.from_square, move.to_square) ||
+                                             _killers[ply][1] == std::pair<int8_t, int8_t>(move.from_square, move.to_square))) {
+                    score = 80000;
+                }
+                moves.push_back({move, score});
+            }
+            std::stable_sort(moves.begin(), moves.end(),
+                             [](const Scored_move &a, const Scored_move &b) { return a.score > b.score; });
+            return moves;
+        }
+
+        /**
+         * @brief Searches captures until the position is quiet.
+         *
+         * Side in check may not stand pat, all its evasions are searched and having none is mate.
+         */
+        int quiescence(chess::Board &board, int alpha, int beta, int ply) {
+            if (is_stopped()) {
+                return 0;
+            }
+            if (ply >= max_ply) {
+                return evaluate(board);
+            }
+            bool is_check = board.is_check();
+            if (!is_check) {
+                int stand_pat = evaluate(board);
+                if (stand_pat >= beta) {
+                    return stand_pat;
+                }
+                alpha = std::max(alpha, stand_pat);
+            }
+            auto moves = order_moves(board, nullptr, ply, !is_check);
+            if (is_check && moves.empty()) {
+                return -mate_score + ply;
+            }
+            for (auto &[move, order]: moves) {
+                board.push(move);
+                int score = -quiescence(board, -beta, -alpha, ply + 1);
+                board.pop();
+                if (_is_stopped) {
+                    return 0;
+                }
+                if (score >= beta) {
+                    return score;
+                }
+                alpha = std::max(alpha, score);
+            }
+            return alpha;
+        }
+
+        /**
+         * @brief Searches position to given depth.
+         *
+         * @return Score for the side to move, -mate_score + ply when mated.
+         */
+        int negamax(chess::Board &board, int depth, int alpha, int beta, int ply) {
+            if (depth <= 0 || ply >= max_ply) {
+                return quiescence(board, alpha, beta, ply);
+            }
+            if (is_stopped()) {
+                return 0;
+            }
+
+            int alpha_orig = alpha;
+            uint64_t key = get_key(board);
+            Entry &entry = _table[mix(key) & (_table.size() - 1)];
+            bool is_hit = entry.key == key;
+            if (is_hit && entry.depth >= depth) {
+                int score = entry.score;
+                // mates are stored relative to the position, convert them back to distance from the root
+                if (score > mate_score - max_ply * 2) {
+                    score -= ply;
+                } else if (score < -mate_score + max_ply * 2) {
+                    score += ply;
+                }
+                if (entry.bound == 0 || (entry.bound == 1 && score >= beta) || (entry.bound == 2 && score <= alpha)) {
+                    return score;
+                }
+            }
+
+            auto moves = order_moves(board, is_hit ? &entry : nullptr, ply, false);
+            if (moves.empty()) {
+                return board.is_check() ? -mate_score + ply : 0;
+            }
+
+            int best = -mate_score;
+            const chess::Move *best_move = &moves[0].move;
+            for (auto &[move, order]: moves) {
+                board.push(move);
+                int score = -negamax(board, depth - 1, -beta, -alpha, ply + 1);
+                board.pop();
+                if (_is_stopped) {
+                    return 0;
+                }
+                if (score > best) {
+                    best = score;
+                    best_move = &move;
+                }
+                if (score > alpha) {
+                    alpha = score;
+                }
+                if (alpha >= beta) {
+                    if (!board.is_capture(move) && !move.promotion) {
+                        _killers[ply][1] = _killers[ply][0];
+                        _killers[ply][0] = {static_cast<int8_t>(move.from_square), static_cast<int8_t>(move.to_square)};
+                    }
+                    break;
+                }
+            }
+
+            int stored = best;
+            if (stored > mate_score - max_ply * 2) {
+                stored += ply;
+            } else if (stored < -mate_score + max_ply * 2) {
+                stored -= ply;
+            }
+            entry.key = key;
+            entry.score = stored;
+            entry.depth = static_cast<int8_t>(depth);
+            entry.bound = static_cast<int8_t>(best <= alpha_orig ? 2 : best >= beta ? 1 : 0);
+            entry.from = static_cast<int8_t>(best_move->from_square);
+            entry.to = static_cast<int8_t>(best_move->to_square);
+            return best;
+        }
+
+    public:
+        /**
+         * @brief Gets key of the position from piece bitboards, side to move, castling rights and en passant square.
+         *
+         * En passant square is set after every double pawn push, even if no capture is possible, which only splits
+         * equal positions between two entries.
+         */
+        static uint64_t get_key(const chess::Board &board) {
+            uint64_t key = board.turn == chess::WHITE ? 0x5851F42D4C957F2Dull : 0;
+            for (int type = chess::PAWN; type <= chess::KING; type++) {
+                key ^= mix(board.pieces_mask(type, chess::WHITE) ^ (uint64_t(type) << 56));
+                key = std::rotl(key, 7) ^ mix(board.pieces_mask(type, chess::BLACK) ^ (uint64_t(type) << 60));
+            }
+            key ^= mix(std::rotl(mix(board.castling_rights), 13));
+            if (board.ep_square) {
+                key ^= mix(0xD6E8FEB86659FD93ull + uint64_t(*board.ep_square));
+            }
+            return key | 1;
+        }
+
+        /**
+         * @brief Constructs engine.
+         *
+         * @param table_bits Log2 of transposition table entries.
+         */
+        explicit Chess_engine(int table_bits = 18) : _table(size_t(1) << table_bits) {}
+
+        /**
+         * @brief Finds the best move until deadline or cancellation.
+         *
+         * Depth 1 is always finished unless the search is cancelled, so a move is returned even if the deadline
+         * has already passed.
+         *
+         * @param board Position, searched on a copy.
+         * @param deadline Time the search must stop at.
+         * @param cancel Flag which stops the search when set.
+         * @return Search result.
+         */
+        Search_result search(chess::Board board, std::chrono::steady_clock::time_point deadline,
+                             const std::atomic_bool &cancel) {
+            Search_result result;
+            _nodes = 0;
+            _is_stopped = false;
+            _cancel = &cancel;
+            _killers = {};
+
+            auto moves = order_moves(board, nullptr, 0, false);
+            if (moves.empty()) {
+                return result;
+            }
+            result.move = moves[0].move;
+
+            for (int depth = 1; depth < max_ply; depth++) {
+                _deadline = depth == 1 ? std::chrono::steady_clock::time_point::max() : deadline;
+                int alpha = -mate_score;
+                int best = -mate_score;
+                size_t best_index = 0;
+                for (size_t i = 0; i < moves.size(); i++) {
+                    board.push(moves[i].move);
+                    int score = -negamax(board, depth - 1, -mate_score, -alpha, 1);
+                    board.pop();
+                    if (_is_stopped) {
+                        break;
+                    }
+                    if (score > best) {
+                        best = score;
+                        best_index = i;
+                    }
+                    alpha = std::max(alpha, score);
+                }
+                if (_is_stopped) {
+                    result.is_cancelled = cancel.load(std::memory_order_relaxed);
+                    break;
+                }
+                result.move = moves[best_index].move;
+                result.score = best;
+                result.depth = depth;
+                // search the best move first in the next depth
+                std::rotate(moves.begin(), moves.begin() + best_index, moves.begin() + best_index + 1);
+                if (std::abs(best) > mate_score - max_ply * 2 || moves.size() == 1 ||
+                    std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+            }
+            result.nodes = _nodes;
+            _cancel = nullptr;
+            return result;
+        }
+    };
+
+} // namespace chess_engine
@@ -0,0 +1,257 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include "./connect_four.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <string>
+
+using namespace connect_four;
+
+/**
+ * @brief Mask of the lowest cell of every column.
+ */
+static constexpr uint64_t bottom_row = []() {
+    uint64_t r = 0;
+    for (int col = 0; col < width; col++) {
+        r |= Connect_four::bottom_mask(col);
+    }
+    return r;
+}();
+
+/**
+ * @brief Mask of all cells of the board.
+ */
+static constexpr uint64_t board_mask = bottom_row * ((uint64_t(1) << height) - 1);
+
+/**
+ * @brief Columns from the center out, center columns take part in the most fours.
+ */
+static constexpr std::array<int, width> center_order = {3, 2, 4, 1, 5, 0, 6};
+
+bool Connect_four::is_aligned(uint64_t stones) {
+    // vertical, horizontal and both diagonals
+    for (int shift: {1, height + 1, height, height + 2}) {
+        uint64_t m = stones & (stones >> shift);
+        if (m & (m >> (2 * shift))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t Connect_four::winning_cells(uint64_t stones, uint64_t mask) {
+    // vertical
+    uint64_t r = (stones << 1) & (stones << 2) & (stones << 3);
+    // three of the four stones on both sides of the cell
+    for (int shift: {height + 1, height, height + 2}) {
+        uint64_t p = (stones << shift) & (stones << (2 * shift));
+        r |= p & (stones << (3 * shift));
+        r |= p & (stones >> shift);
+        p = (stones >> shift) & (stones >> (2 * shift));
+        r |= p & (stones << shift);
+        r |= p & (stones >> (3 * shift));
+    }
+    return r & (board_mask ^ mask);
+}
+
+void Connect_four::play(int col) {
+    if (!can_play(col)) {
+        throw std::invalid_argument("Column " + std::to_string(col) + " can not be played");
+    }
+    _current ^= _mask;
+    _mask |= _mask + bottom_mask(col);
+    _moves++;
+}
+
+uint64_t Connect_four::get_playable() const {
+    return (_mask + bottom_row) & board_mask;
+}
+
+int Connect_four::get_cell(int row, int col) const {
+    uint64_t bit = uint64_t(1) << (col * (height + 1) + height - 1 - row);
+    if (!(_mask & bit)) {
+        return 0;
+    }
+    // first player is to move after even amount of moves
+    bool is_current = _current & bit;
+    bool is_first_to_move = _moves % 2 == 0;
+    return is_current == is_first_to_move ? 1 : 2;
+}
+
+Connect_four_solver::Connect_four_solver(int table_bits) : _table(size_t(1) << table_bits) {}
+
+int Connect_four_solver::order_moves(const Connect_four &board, uint64_t allowed, int tt_move,
+                                     std::array<int, width> &moves) const {
+    std::array<int, width> scores{};
+    int amount = 0;
+    for (int col: center_order) {
+        uint64_t move = allowed & Connect_four::column_mask(col);
+        if (!move) {
+            continue;
+        }
+        // moves creating more own threats first, stable insertion keeps center order among equal ones
+        int score = col == tt_move ? width * height :
+                    std::popcount(Connect_four::winning_cells(board.get_current() | move, board.get_mask() | move));
+        int i = amount++;
+        for (; i > 0 && scores[i - 1] < score; i--) {
+            scores[i] = scores[i - 1];
+            moves[i] = moves[i - 1];
+        }
+        scores[i] = score;
+        moves[i] = col;
+    }
+    return amount;
+}
+
+int Connect_four_solver::evaluate(const Connect_four &board) {
+    uint64_t mask = board.get_mask();
+    return std::popcount(Connect_four::winning_cells(board.get_current(), mask)) -
+           std::popcount(Connect_four::winning_cells(board.get_current() ^ mask, mask));
+}
+
+int Connect_four_solver::negamax(const Connect_four &board, int alpha, int beta, int depth) {
+    if ((++_nodes & 1023) == 0 && std::chrono::steady_clock::now() >= _deadline) {
+        _is_stopped = true;
+    }
+    if (_is_stopped) {
+        return 0;
+    }
+    if (board.is_full()) {
+        return 0;
+    }
+
+    uint64_t mask = board.get_mask();
+    uint64_t playable = board.get_playable();
+    if (Connect_four::winning_cells(board.get_current(), mask) & playable) {
+        return win_score - board.get_moves() - 1;
+    }
+    uint64_t opponent_wins = Connect_four::winning_cells(board.get_current() ^ mask, mask);
+    uint64_t forced = opponent_wins & playable;
+    uint64_t allowed = playable;
+    if (forced) {
+        if (forced & (forced - 1)) {
+            return -(win_score - board.get_moves() - 2);
+        }
+        allowed = forced;
+    }
+    // playing below an opponent's winning cell lets them drop into it
+    allowed &= ~(opponent_wins >> 1);
+    if (!allowed) {
+        return -(win_score - board.get_moves() - 2);
+    }
+    if (depth == 0) {
+        return evaluate(board);
+    }
+
+    int alpha_orig = alpha;
+    uint64_t key = board.get_key();
+    Entry &entry = _table[(key * 0x9E3779B97F4A7C15ull) >> (64 - std::countr_zero(_table.size()))];
+    int tt_move = -1;
+    if (entry.key == key) {
+        tt_move = entry.move;
+        if (entry.depth >= depth) {
+            if (entry.bound == 0) {
+                return entry.score;
+            }
+            if (entry.bound == 1) {
+                alpha = std::max<int>(alpha, entry.score);
+            } else {
+                beta = std::min<int>(beta, entry.score);
+            }
+            if (alpha >= beta) {
+                return entry.score;
+            }
+        }
+    }
+
+    std::array<int, width> moves{};
+    int amount = order_moves(board, allowed, tt_move, moves);
+    int best = -win_score;
+    int best_move = moves[0];
+    for (int i = 0; i < amount; i++) {
+        Connect_four next = board;
+        next.play(moves[i]);
+        int score = -negamax(next, -beta, -alpha, depth - 1);
+        if (_is_stopped) {
+            return 0;
+        }
+        if (score > best) {
+            best = score;
+            best_move = moves[i];
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    entry.key = key;
+    entry.score = static_cast<int16_t>(best);
+    entry.depth = static_cast<int8_t>(depth);
+    entry.bound = static_cast<int8_t>(best <= alpha_orig ? 2 : best >= beta ? 1 : 0);
+    entry.move = static_cast<int8_t>(best_move);
+    return best;
+}
+
+int Connect_four_solver::best_move(const Connect_four &board, std::chrono::microseconds budget) {
+    uint64_t mask = board.get_mask();
+    uint64_t playable = board.get_playable();
+    if (!playable || board.is_won()) {
+        throw std::invalid_argument("Game is finished");
+    }
+    _nodes = 0;
+    _is_stopped = false;
+
+    uint64_t wins = Connect_four::winning_cells(board.get_current(), mask) & playable;
+    uint64_t opponent_wins = Connect_four::winning_cells(board.get_current() ^ mask, mask);
+    uint64_t allowed = opponent_wins & playable ? opponent_wins & playable : playable;
+    if (!wins) {
+        allowed &= ~(opponent_wins >> 1);
+    }
+    std::array<int, width> moves{};
+    int amount = order_moves(board, wins ? wins : allowed ? allowed : playable, -1, moves);
+    if (wins || !allowed || amount == 1) {
+        // won, lost or forced, nothing to search
+        return moves[0];
+    }
+
+    // first iteration always completes, so there is a searched move to return
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    _deadline = std::chrono::steady_clock::time_point::max();
+    int result = moves[0];
+    int max_depth = width * height - board.get_moves();
+    for (int depth = 1; depth <= max_depth; depth++) {
+        int alpha = -win_score;
+        int best = -win_score;
+        int best_move = moves[0];
+        for (int i = 0; i < amount; i++) {
+            Connect_four next = board;
+            next.play(moves[i]);
+            int score = -negamax(next, -win_score, -alpha, depth - 1);
+            if (_is_stopped) {
+                return result;
+            }
+            if (score > best) {
+                best = score;
+                best_move = moves[i];
+            }
+            alpha = std::max(alpha, score);
+        }
+        result = best_move;
+        // search the best move first in the next iteration
+        auto it = std::find(moves.begin(), moves.begin() + amount, best_move);
+        std::rotate(moves.begin(), it, it + 1);
+        if (std::abs(best) >= win_score - width * height) {
+            break;
+        }
+        _deadline = deadline;
+        if (std::chrono::steady_clock::now() >= _deadline) {
+            break;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,221 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace connect_four {
+
+    /**
+     * @brief Board width in columns.
+     */
+    constexpr int width = 7;
+
+    /**
+     * @brief Board height in rows.
+     */
+    constexpr int height = 6;
+
+    /**
+     * @class Connect_four
+     * @brief Connect four position stored as two 64 bit bitboards.
+     *
+     * Every column takes height + 1 bits, bit col * 7 + row with row 0 at the bottom; the spare bit on top
+     * of every column keeps shifted lines from wrapping into the next column. The position is the mask of
+     * all stones plus the stones of the player to move, so a move is one addition and a four in a row is
+     * found with four shift-and-mask tests.
+     */
+    class Connect_four {
+        uint64_t _current = 0; ///< Stones of the player to move.
+        uint64_t _mask = 0; ///< All stones.
+        int _moves = 0; ///< Amount of played moves.
+
+    public:
+        /**
+         * @brief Gets mask of the lowest cell of a column.
+         */
+        static constexpr uint64_t bottom_mask(int col) { return uint64_t(1) << (col * (height + 1)); }
+
+        /**
+         * @brief Gets mask of the highest cell of a column.
+         */
+        static constexpr uint64_t top_mask(int col) { return uint64_t(1) << (height - 1 + col * (height + 1)); }
+
+        /**
+         * @brief Gets mask of all cells of a column.
+         */
+        static constexpr uint64_t column_mask(int col) {
+            return ((uint64_t(1) << height) - 1) << (col * (height + 1));
+        }
+
+        /**
+         * @brief Checks if stones contain four in a row.
+         *
+         * @param stones Stones of one player.
+         * @return True if the player has a four in any direction.
+         */
+        static bool is_aligned(uint64_t stones);
+
+        /**
+         * @brief Gets empty cells which would complete a four for the stones.
+         *
+         * @param stones Stones of one player.
+         * @param mask All stones.
+         * @return Winning cells, including ones not playable yet.
+         */
+        static uint64_t winning_cells(uint64_t stones, uint64_t mask);
+
+        /**
+         * @brief Checks if a stone can be dropped into the column.
+         *
+         * @param col Column 0-6.
+         * @return True if the column is not full.
+         */
+        bool can_play(int col) const { return col >= 0 && col < width && !(_mask & top_mask(col)); }
+
+        /**
+         * @brief Drops stone of the player to move into the column.
+         *
+         * @param col Column 0-6.
+         * @throws std::invalid_argument If the column is full or out of range.
+         */
+        void play(int col);
+
+        /**
+         * @brief Checks if dropping into the column wins for the player to move.
+         *
+         * @param col Playable column.
+         * @return True if the move completes a four.
+         */
+        bool is_winning_move(int col) const {
+            return is_aligned(_current | ((_mask + bottom_mask(col)) & column_mask(col)));
+        }
+
+        /**
+         * @brief Checks if the player who moved last has a four.
+         *
+         * @return True if the game was won by the last move.
+         */
+        bool is_won() const { return is_aligned(_current ^ _mask); }
+
+        /**
+         * @brief Checks if the board is full.
+         *
+         * @return True if no move is left.
+         */
+        bool is_full() const { return _moves == width * height; }
+
+        /**
+         * @brief Gets amount of played moves.
+         */
+        int get_moves() const { return _moves; }
+
+        /**
+         * @brief Gets stones of the player to move.
+         */
+        uint64_t get_current() const { return _current; }
+
+        /**
+         * @brief Gets all stones.
+         */
+        uint64_t get_mask() const { return _mask; }
+
+        /**
+         * @brief Gets cells where a stone can be dropped now.
+         */
+        uint64_t get_playable() const;
+
+        /**
+         * @brief Gets unique key of the position.
+         */
+        uint64_t get_key() const { return _current + _mask; }
+
+        /**
+         * @brief Gets owner of a cell.
+         *
+         * @param row Row 0-5 counted from the top, as the board is shown.
+         * @param col Column 0-6.
+         * @return 0 for empty cell, 1 for the first player, 2 for the second player.
+         */
+        int get_cell(int row, int col) const;
+    };
+
+    /**
+     * @class Connect_four_solver
+     * @brief Negamax alpha-beta search with a transposition table and move ordering.
+     *
+     * Search is iteratively deepened until the time budget runs out or the position is solved, so it can
+     * answer within a fixed time on any position and plays perfectly near the end. Leaves are scored by
+     * the difference of open winning cells. One solver must not be used from two threads at once, keep one
+     * per thread to share its table between games.
+     */
+    class Connect_four_solver {
+    public:
+        /// Score of a win on the next move, wins found later score less.
+        static constexpr int win_score = 1000;
+
+    private:
+        /**
+         * @brief Transposition table entry.
+         */
+        struct Entry {
+            uint64_t key = 0; ///< Position key, 0 if empty.
+            int16_t score = 0; ///< Searched score.
+            int8_t depth = -1; ///< Depth the score was searched to.
+            int8_t bound = 0; ///< 0 exact, 1 lower bound, 2 upper bound.
+            int8_t move = -1; ///< Best move found.
+        };
+
+        std::vector<Entry> _table; ///< Transposition table, size is a power of two.
+        std::chrono::steady_clock::time_point _deadline; ///< Time the search must stop at.
+        uint64_t _nodes = 0; ///< Searched nodes.
+        bool _is_stopped = false; ///< Deadline was hit, results of the running iteration are void.
+
+        /**
+         * @brief Gets columns ordered by how promising they are.
+         */
+        int order_moves(const Connect_four &board, uint64_t allowed, int tt_move, std::array<int, width> &moves) const;
+
+        /**
+         * @brief Scores quiet position for the player to move.
+         */
+        static int evaluate(const Connect_four &board);
+
+        /**
+         * @brief Searches position to given depth.
+         *
+         * @return Score for the player to move, win_score - moves for wins.
+         */
+        int negamax(const Connect_four &board, int alpha, int beta, int depth);
+
+    public:
+        /**
+         * @brief Constructs solver.
+         *
+         * @param table_bits Log2 of transposition table entries.
+         */
+        explicit Connect_four_solver(int table_bits = 16);
+
+        /**
+         * @brief Finds the best move within time budget.
+         *
+         * @param board Position, must not be finished.
+         * @param budget Time the search may take, at least depth 1 is always searched.
+         * @return Column to play.
+         * @throws std::invalid_argument If no move is possible.
+         */
+        int best_move(const Connect_four &board, std::chrono::microseconds budget);
+
+        /**
+         * @brief Gets amount of nodes searched by the last best_move call.
+         */
+        uint64_t get_nodes() const { return _nodes; }
+    };
+
+} // namespace connect_four
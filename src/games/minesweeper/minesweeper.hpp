@@ -39,7 +39,7 @@ namespace minesweeper_engine {
     private:
         bool _is_stated = false; ///< Flag indicating if the game has started.
         std::array<std::array<int, 2>, 8> _offsets{{{1, 0}, {1, 1}, {0, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}, {-1, 1}}}; ///< Offset directions for neighboring cells.
-        std::random_device _rd; ///< Random device used for generating random positions.
+        std::mt19937 _rd{std::random_device{}()}; ///< Random engine used for generating random positions, seeded once.
 
         // 0-8 values represent counts of neighboring mines, 9 - mine, 10 - flag.
         std::vector<std::vector<char>> _board; ///< Internal representation of the Minesweeper board.
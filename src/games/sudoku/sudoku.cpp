@@ -3,6 +3,7 @@
 //
 
 #include "./sudoku.hpp"
+#include "./sudoku_solver.hpp"
 
 #include <chrono>
 #include <random>
@@ -27,54 +28,6 @@ int gen_rand_num(int max_limit) { return rand() % max_limit; }
 // END: Generate random number
 
 
-// START: Helper functions for solving grid
-bool find_unassigned_location(int grid[9][9], int &row, int &col) {
-    for (row = 0; row < 9; row++) {
-        for (col = 0; col < 9; col++) {
-            if (grid[row][col] == 0)
-                return true;
-        }
-    }
-
-    return false;
-}
-
-bool used_in_row(int grid[9][9], int row, int num) {
-    for (int col = 0; col < 9; col++) {
-        if (grid[row][col] == num)
-            return true;
-    }
-
-    return false;
-}
-
-bool used_in_col(int grid[9][9], int col, int num) {
-    for (int row = 0; row < 9; row++) {
-        if (grid[row][col] == num)
-            return true;
-    }
-
-    return false;
-}
-
-bool used_in_box(int grid[9][9], int box_start_row, int box_start_col, int num) {
-    for (int row = 0; row < 3; row++) {
-        for (int col = 0; col < 3; col++) {
-            if (grid[row + box_start_row][col + box_start_col] == num)
-                return true;
-        }
-    }
-
-    return false;
-}
-
-bool is_safe(int grid[9][9], int row, int col, int num) {
-    return !used_in_row(grid, row, num) && !used_in_col(grid, col, num) &&
-           !used_in_box(grid, row - row % 3, col - col % 3, num);
-}
-// END: Helper functions for solving grid
-
-
 // START: Create seed grid
 void Sudoku::fill_empty_diagonal_box(int idx) {
     int start = idx * 3;
@@ -246,52 +199,26 @@ void Sudoku::print_grid() {
 // END: Printing the grid
 
 
-// START: Modified Sudoku solver
+// START: Sudoku solver
 bool Sudoku::solve_grid() {
-    int row, col;
-
-    // If there is no unassigned location, we are done
-    if (!find_unassigned_location(this->_grid, row, col))
-        return true; // success!
-
-    // Consider digits 1 to 9
-    for (int num = 0; num < 9; num++) {
-        // if looks promising
-        if (is_safe(this->_grid, row, col, this->_guess_num[num])) {
-            // make tentative assignment
-            this->_grid[row][col] = this->_guess_num[num];
-
-            // return, if success, yay!
-            if (solve_grid())
-                return true;
-
-            // failure, unmake & try again
-            this->_grid[row][col] = 0;
-        }
+    Sudoku_solver solver(this->_grid);
+    std::array<int, 9> order;
+    std::copy(this->_guess_num, this->_guess_num + 9, order.begin());
+    if (!solver.solve(order)) {
+        return false;
     }
-
-    return false; // this triggers backtracking
+    for (int i = 0; i < 81; i++) {
+        this->_grid[i / 9][i % 9] = solver.get(i);
+    }
+    return true;
 }
-// END: Modified Sudoku Solver
+// END: Sudoku Solver
 
 
 // START: Check if the grid is uniquely solvable
 void Sudoku::count_soln(int &number) {
-    int row, col;
-
-    if (!find_unassigned_location(this->_grid, row, col)) {
-        number++;
-        return;
-    }
-
-
-    for (int i = 0; i < 9 && number < 2; i++) {
-        if (is_safe(this->_grid, row, col, this->_guess_num[i])) {
-            this->_grid[row][col] = this->_guess_num[i];
-            count_soln(number);
-        }
-
-        this->_grid[row][col] = 0;
+    if (number < 2) {
+        number += Sudoku_solver(this->_grid).count_solutions(2 - number);
     }
 }
 // END: Check if the grid is uniquely solvable
@@ -299,105 +226,75 @@ void Sudoku::count_soln(int &number) {
 
 // START: Gneerate puzzle
 void Sudoku::gen_puzzle() {
+    // the grid stays uniquely solvable, so a removal keeps it unique unless the cell can hold other digit
+    Sudoku_solver solver(this->_grid);
     for (int i = 0; i < 81; i++) {
         int x = (this->_grid_pos[i]) / 9;
         int y = (this->_grid_pos[i]) % 9;
         int temp = this->_grid[x][y];
-        this->_grid[x][y] = 0;
+        solver.clear(this->_grid_pos[i]);
 
-        // If now more than 1 solution , replace the removed cell back.
-        int check = 0;
-        count_soln(check);
-        if (check != 1) {
-            this->_grid[x][y] = temp;
+        if (solver.has_other_solution(this->_grid_pos[i], temp)) {
+            solver.set(this->_grid_pos[i], temp);
+        } else {
+            this->_grid[x][y] = 0;
         }
     }
 }
 // END: Generate puzzle
 
 
-// START: Calculate branch difficulty score
-int Sudoku::branch_difficulty_score() {
-    int empty_positions = -1;
-    int temp_grid[9][9];
-    int sum = 0;
+// START: Calculate difficulty level of current grid
+void Sudoku::calculate_difficulty() {
+    std::array<uint8_t, 81> solution;
+    int empty_cells = 0;
 
-    for (int i = 0; i < 9; i++) {
-        for (int j = 0; j < 9; j++) {
-            temp_grid[i][j] = this->_grid[i][j];
-        }
+    for (int i = 0; i < 81; i++) {
+        solution[i] = static_cast<uint8_t>(this->_soln_grid[i / 9][i % 9]);
+        if (this->_grid[i / 9][i % 9] == 0)
+            empty_cells++;
     }
 
-    while (empty_positions != 0) {
-        std::vector<std::vector<int>> empty;
-
-        for (int i = 0; i < 81; i++) {
-            if (temp_grid[(int) (i / 9)][(int) (i % 9)] == 0) {
-                std::vector<int> temp;
-                temp.push_back(i);
-
-                for (int num = 1; num <= 9; num++) {
-                    if (is_safe(temp_grid, i / 9, i % 9, num)) {
-                        temp.push_back(num);
-                    }
-                }
-
-                empty.push_back(temp);
-            }
-        }
-
-        if (empty.size() == 0) {
-            // std::cout<<"Hello: "<<sum<<std::endl;
-            return sum;
-        }
+    this->_difficulty_level = Sudoku_solver(this->_grid).grade(solution) * 100 + empty_cells;
+}
+// END: calculating difficulty level
 
-        int min_index = 0;
 
-        int check = empty.size();
-        for (int i = 0; i < check; i++) {
-            if (empty[i].size() < empty[min_index].size())
-                min_index = i;
-        }
+int Sudoku::get_difficulty_level() const { return this->_difficulty_level; }
 
-        int branchFactor = empty[min_index].size();
-        int rowIndex = empty[min_index][0] / 9;
-        int colIndex = empty[min_index][0] % 9;
 
-        temp_grid[rowIndex][colIndex] = this->_soln_grid[rowIndex][colIndex];
-        sum = sum + ((branchFactor - 2) * (branchFactor - 2));
+std::array<std::array<int, 9>, 9> Sudoku::get_field() const {
+    std::array<std::array<int, 9>, 9> arr2; // std::array of std::array of int
 
-        empty_positions = empty.size() - 1;
+    for (int i = 0; i < 9; i++) {
+        std::copy(this->_grid[i], this->_grid[i] + 9, arr2[i].begin());
     }
-
-    return sum;
+    return arr2;
 }
-// END: Finish branch difficulty score
 
+std::array<std::array<int, 9>, 9> Sudoku::get_solution_field() const {
+    std::array<std::array<int, 9>, 9> arr2;
 
-// START: Calculate difficulty level of current grid
-void Sudoku::calculate_difficulty() {
-    int B = branch_difficulty_score();
-    int empty_cells = 0;
+    for (int i = 0; i < 9; i++) {
+        std::copy(this->_soln_grid[i], this->_soln_grid[i] + 9, arr2[i].begin());
+    }
+    return arr2;
+}
 
+bool Sudoku::restore(const std::array<std::array<int, 9>, 9> &field,
+                     const std::array<std::array<int, 9>, 9> &solution) {
     for (int i = 0; i < 9; i++) {
         for (int j = 0; j < 9; j++) {
-            if (this->_grid[i][j] == 0)
-                empty_cells++;
+            if (solution[i][j] < 1 || solution[i][j] > 9 || (field[i][j] != 0 && field[i][j] != solution[i][j])) {
+                return false;
+            }
         }
     }
-
-    this->_difficulty_level = B * 100 + empty_cells;
-}
-// END: calculating difficulty level
-
-
-std::array<std::array<int, 9>, 9> Sudoku::get_field() {
-    std::array<std::array<int, 9>, 9> arr2; // std::array of std::array of int
-
     for (int i = 0; i < 9; i++) {
-        std::copy(this->_grid[i], this->_grid[i] + 9, arr2[i].begin());
+        std::copy(field[i].begin(), field[i].end(), this->_grid[i]);
+        std::copy(solution[i].begin(), solution[i].end(), this->_soln_grid[i]);
     }
-    return arr2;
+    return true;
 }
 
 bool Sudoku::place(const std::array<int, 2> &pos, int value) {
@@ -88,17 +88,37 @@ namespace sudoku {
          *
          * @return A 2D array representing the current state of the grid.
          */
-        std::array<std::array<int, 9>, 9> get_field();
+        std::array<std::array<int, 9>, 9> get_field() const;
 
         /**
-         * @brief Counts the number of solutions for the current grid configuration.
+         * @brief Returns the solution of the puzzle as a 2D array.
          *
-         * @param number A reference to store the number of solutions found.
+         * @return A 2D array representing the solved grid.
+         */
+        std::array<std::array<int, 9>, 9> get_solution_field() const;
+
+        /**
+         * @brief Restores a game in progress, e.g. from a saved game.
+         *
+         * @param field The current state of the grid, 0 for empty cells.
+         * @param solution The solved grid.
+         * @return True if restored, false if the solution has cells out of 1-9 or the field does not match it,
+         * the puzzle is left unchanged then.
+         */
+        bool restore(const std::array<std::array<int, 9>, 9> &field,
+                     const std::array<std::array<int, 9>, 9> &solution);
+
+        /**
+         * @brief Counts the number of solutions for the current grid configuration, stopping at 2.
+         *
+         * @param number A reference to add the number of solutions found to.
          */
         void count_soln(int &number);
 
         /**
          * @brief Generates a Sudoku puzzle by removing cells from the solved grid.
+         *
+         * A cell stays filled if emptying it would allow a second solution.
          */
         void gen_puzzle();
 
@@ -111,15 +131,17 @@ namespace sudoku {
 
         /**
          * @brief Calculates the difficulty level of the current puzzle.
+         *
+         * Guessing needed by the solver weighted by 100 plus amount of empty cells.
          */
         void calculate_difficulty();
 
         /**
-         * @brief Calculates the branch difficulty score of the current grid.
+         * @brief Gets difficulty level computed by calculate_difficulty.
          *
-         * @return An integer representing the branch difficulty score.
+         * @return Difficulty level, 0 being easiest.
          */
-        int branch_difficulty_score();
+        int get_difficulty_level() const;
 
         /**
          * @brief Ends the game and fills the grid with the solution.
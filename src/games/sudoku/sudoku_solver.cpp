@@ -0,0 +1,213 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include "./sudoku_solver.hpp"
+
+#include <bit>
+
+using namespace sudoku;
+
+Sudoku_solver::Sudoku_solver(const int (&grid)[9][9]) {
+    for (int row = 0; row < 9; row++) {
+        for (int col = 0; col < 9; col++) {
+            if (grid[row][col]) {
+                set(row * 9 + col, grid[row][col]);
+            }
+        }
+    }
+}
+
+void Sudoku_solver::set(int cell, int digit) {
+    uint16_t bit = uint16_t(1) << (digit - 1);
+    _cells[cell] = static_cast<uint8_t>(digit);
+    _rows[cell / 9] |= bit;
+    _cols[cell % 9] |= bit;
+    _boxes[box_of(cell)] |= bit;
+    _empty[cell >> 6] &= ~(uint64_t(1) << (cell & 63));
+}
+
+void Sudoku_solver::clear(int cell) {
+    if (!_cells[cell]) {
+        return;
+    }
+    // digits are unique in every unit, so the bit belongs only to this cell
+    uint16_t bit = uint16_t(1) << (_cells[cell] - 1);
+    _cells[cell] = 0;
+    _rows[cell / 9] &= ~bit;
+    _cols[cell % 9] &= ~bit;
+    _boxes[box_of(cell)] &= ~bit;
+    _empty[cell >> 6] |= uint64_t(1) << (cell & 63);
+}
+
+uint16_t Sudoku_solver::candidates(int cell) const {
+    return ~(_rows[cell / 9] | _cols[cell % 9] | _boxes[box_of(cell)]) & all_digits;
+}
+
+/**
+ * @brief Cells of all 27 rows, columns and boxes.
+ */
+static constexpr std::array<std::array<uint8_t, 9>, 27> units = []() {
+    std::array<std::array<uint8_t, 9>, 27> r{};
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            r[i][j] = static_cast<uint8_t>(i * 9 + j);
+            r[9 + i][j] = static_cast<uint8_t>(j * 9 + i);
+            r[18 + i][j] = static_cast<uint8_t>((i / 3) * 27 + (i % 3) * 3 + (j / 3) * 9 + j % 3);
+        }
+    }
+    return r;
+}();
+
+bool Sudoku_solver::propagate() {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        // naked singles: cell with one candidate
+        for (int part = 0; part < 2; part++) {
+            uint64_t empty = _empty[part];
+            while (empty) {
+                int cell = part * 64 + std::countr_zero(empty);
+                empty &= empty - 1;
+                uint16_t c = candidates(cell);
+                if (!c) {
+                    return false;
+                }
+                if (!(c & (c - 1))) {
+                    set(cell, std::countr_zero(c) + 1);
+                    changed = true;
+                }
+            }
+        }
+        if (changed) {
+            continue;
+        }
+        // hidden singles: digit with one place in a unit, they cut most of the branching on hard grids
+        for (auto &unit: units) {
+            uint16_t once = 0, twice = 0, used = 0;
+            for (uint8_t cell: unit) {
+                if (_cells[cell]) {
+                    used |= uint16_t(1) << (_cells[cell] - 1);
+                    continue;
+                }
+                uint16_t c = candidates(cell);
+                twice |= once & c;
+                once |= c;
+            }
+            if ((once | used) != all_digits) {
+                return false;
+            }
+            uint16_t singles = once & ~twice;
+            while (singles) {
+                uint16_t bit = singles & -singles;
+                singles &= singles - 1;
+                for (uint8_t cell: unit) {
+                    if (!_cells[cell] && (candidates(cell) & bit)) {
+                        set(cell, std::countr_zero(bit) + 1);
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int Sudoku_solver::find_mrv_cell() const {
+    int best = -1;
+    int best_count = 10;
+    for (int part = 0; part < 2; part++) {
+        uint64_t empty = _empty[part];
+        while (empty) {
+            int cell = part * 64 + std::countr_zero(empty);
+            empty &= empty - 1;
+            int count = std::popcount(candidates(cell));
+            if (count < best_count) {
+                best = cell;
+                best_count = count;
+                if (count <= 2) {
+                    return best;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+void Sudoku_solver::search(int limit, int &count) {
+    if (!propagate()) {
+        return;
+    }
+    int cell = find_mrv_cell();
+    if (cell < 0) {
+        count++;
+        return;
+    }
+    uint16_t c = candidates(cell);
+    while (c && count < limit) {
+        Sudoku_solver next = *this;
+        next.set(cell, std::countr_zero(c) + 1);
+        c &= c - 1;
+        next.search(limit, count);
+    }
+}
+
+int Sudoku_solver::count_solutions(int limit) const {
+    Sudoku_solver s = *this;
+    int count = 0;
+    s.search(limit, count);
+    return count;
+}
+
+bool Sudoku_solver::has_other_solution(int cell, int digit) const {
+    uint16_t c = candidates(cell) & ~(uint16_t(1) << (digit - 1));
+    while (c) {
+        Sudoku_solver next = *this;
+        next.set(cell, std::countr_zero(c) + 1);
+        c &= c - 1;
+        if (next.count_solutions(1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Sudoku_solver::solve(const std::array<int, 9> &order) {
+    Sudoku_solver s = *this;
+    if (!s.propagate()) {
+        return false;
+    }
+    int cell = s.find_mrv_cell();
+    if (cell < 0) {
+        *this = s;
+        return true;
+    }
+    uint16_t c = s.candidates(cell);
+    for (int digit: order) {
+        if (c & (uint16_t(1) << (digit - 1))) {
+            Sudoku_solver next = s;
+            next.set(cell, digit);
+            if (next.solve(order)) {
+                *this = next;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int Sudoku_solver::grade(const std::array<uint8_t, 81> &solution) const {
+    Sudoku_solver s = *this;
+    int score = 0;
+    while (s.propagate()) {
+        int cell = s.find_mrv_cell();
+        if (cell < 0) {
+            break;
+        }
+        int branch = std::popcount(s.candidates(cell));
+        score += (branch - 1) * (branch - 1);
+        s.set(cell, solution[cell]);
+    }
+    return score;
+}
@@ -0,0 +1,139 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace sudoku {
+
+    /**
+     * @class Sudoku_solver
+     * @brief Bitboard sudoku solver used for generation, uniqueness checks and grading.
+     *
+     * Digits used in every row, column and box are kept as 9 bit masks, so candidates of a cell are three
+     * ORs, and empty cells are a 81 bit set walked with bit scans. Search propagates naked and hidden singles and
+     * then branches on the cell with the fewest candidates. The whole state is ~170 bytes, so branches copy it
+     * instead of undoing moves.
+     */
+    class Sudoku_solver {
+        std::array<uint8_t, 81> _cells{}; ///< Digit of every cell in row-major order, 0 if empty.
+        std::array<uint16_t, 9> _rows{}; ///< Digits used in every row, bit d-1 for digit d.
+        std::array<uint16_t, 9> _cols{}; ///< Digits used in every column.
+        std::array<uint16_t, 9> _boxes{}; ///< Digits used in every box.
+        std::array<uint64_t, 2> _empty{~uint64_t(0), (uint64_t(1) << (81 - 64)) - 1}; ///< Set of empty cells.
+
+        /**
+         * @brief Gets box of the cell.
+         */
+        static int box_of(int cell) { return (cell / 27) * 3 + (cell % 9) / 3; }
+
+        /**
+         * @brief Assigns digits by naked singles (cell with one candidate) and hidden singles (digit with one
+         * place in a row, column or box) until none is left.
+         *
+         * @return False if some empty cell has no candidates or some unit has no place for a digit.
+         */
+        bool propagate();
+
+        /**
+         * @brief Gets empty cell with the fewest candidates.
+         *
+         * @return Cell index, -1 if the grid is full.
+         */
+        int find_mrv_cell() const;
+
+        /**
+         * @brief Counts solutions reachable from this state, stops at limit. Modifies the state.
+         */
+        void search(int limit, int &count);
+
+    public:
+        /// Mask of all 9 digits.
+        static constexpr uint16_t all_digits = 0x1FF;
+
+        /**
+         * @brief Constructs solver of an empty grid.
+         */
+        Sudoku_solver() = default;
+
+        /**
+         * @brief Constructs solver of a grid, the grid must not contain conflicting digits.
+         *
+         * @param grid Grid in [row][column] order, 0 for empty cells.
+         */
+        explicit Sudoku_solver(const int (&grid)[9][9]);
+
+        /**
+         * @brief Places digit into an empty cell without checking candidates.
+         *
+         * @param cell Cell index in row-major order.
+         * @param digit Digit 1-9.
+         */
+        void set(int cell, int digit);
+
+        /**
+         * @brief Empties a cell.
+         *
+         * @param cell Cell index in row-major order.
+         */
+        void clear(int cell);
+
+        /**
+         * @brief Gets digit of a cell.
+         *
+         * @param cell Cell index in row-major order.
+         * @return Digit, 0 if the cell is empty.
+         */
+        int get(int cell) const { return _cells[cell]; }
+
+        /**
+         * @brief Gets digits which can be placed into a cell.
+         *
+         * @param cell Cell index in row-major order.
+         * @return Mask with bit d-1 set for every allowed digit d.
+         */
+        uint16_t candidates(int cell) const;
+
+        /**
+         * @brief Counts solutions of the grid, stopping early.
+         *
+         * @param limit Count at which search stops, 2 is enough to check uniqueness.
+         * @return Amount of solutions, at most limit.
+         */
+        int count_solutions(int limit) const;
+
+        /**
+         * @brief Checks if the grid has a solution where the cell holds other digit.
+         *
+         * If the grid with the cell filled has exactly one solution, this tells whether the grid with the
+         * cell emptied has more than one, with a single search instead of counting.
+         *
+         * @param cell Empty cell index in row-major order.
+         * @param digit Digit the cell has in the known solution.
+         * @return True if other solution exists.
+         */
+        bool has_other_solution(int cell, int digit) const;
+
+        /**
+         * @brief Solves the grid in place, trying digits in given order.
+         *
+         * @param order Permutation of digits 1-9, random orders give random solutions of an empty grid.
+         * @return False if the grid has no solution, the state is unchanged then.
+         */
+        bool solve(const std::array<int, 9> &order);
+
+        /**
+         * @brief Grades the grid by how much guessing it needs.
+         *
+         * Naked and hidden singles are free, every time they run out the cell with the fewest candidates is filled
+         * from the solution, adding (candidates - 1)^2.
+         *
+         * @param solution Solution of the grid in row-major order.
+         * @return Branch difficulty score, 0 if singles alone solve the grid.
+         */
+        int grade(const std::array<uint8_t, 81> &solution) const;
+    };
+
+} // namespace sudoku
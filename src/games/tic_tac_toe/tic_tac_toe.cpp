@@ -0,0 +1,18 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include "./tic_tac_toe.hpp"
+
+namespace tic_tac_toe {
+
+    /**
+     * @brief Table evaluated at compile time, in this translation unit only.
+     */
+    static constexpr Table solved_table = make_table();
+
+    static_assert(solved_table.scores[0] == 0, "Perfect tic tac toe play is a draw");
+
+    constinit const Table table = solved_table;
+
+} // namespace tic_tac_toe
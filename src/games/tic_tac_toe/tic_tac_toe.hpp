@@ -0,0 +1,118 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace tic_tac_toe {
+
+    /**
+     * @brief Amount of positions, every cell is empty, X or O.
+     */
+    constexpr int positions = 19683;
+
+    /**
+     * @brief Weight of every cell in position index, position is sum of cell * 3^i.
+     */
+    constexpr std::array<int, 9> cell_weights = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+
+    /**
+     * @brief Cell values used in position index.
+     */
+    enum CELL { EMPTY = 0, X = 1, O = 2 };
+
+    /**
+     * @brief Gets cell of position.
+     *
+     * @param position Position index.
+     * @param cell Cell 0-8 in row-major order.
+     * @return Cell value.
+     */
+    constexpr CELL get_cell(int position, int cell) { return static_cast<CELL>(position / cell_weights[cell] % 3); }
+
+    /**
+     * @brief Gets player with three in a row.
+     *
+     * @param position Position index.
+     * @return X or O, EMPTY if nobody has three in a row.
+     */
+    constexpr CELL get_winner(int position) {
+        constexpr int lines[8][3] = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}, {0, 3, 6},
+                                     {1, 4, 7}, {2, 5, 8}, {0, 4, 8}, {2, 4, 6}};
+        for (auto &line: lines) {
+            CELL c = get_cell(position, line[0]);
+            if (c != EMPTY && c == get_cell(position, line[1]) && c == get_cell(position, line[2])) {
+                return c;
+            }
+        }
+        return EMPTY;
+    }
+
+    /**
+     * @brief Perfect play table of all positions.
+     */
+    struct Table {
+        std::array<int8_t, positions> moves{}; ///< Best cell for the player to move, -1 in finished positions.
+        std::array<int8_t, positions> scores{}; ///< Score for the player to move, +-(1 + empty cells) for wins and losses.
+    };
+
+    /**
+     * @brief Solves all positions, X always moves first.
+     *
+     * Placing a stone only increases the index, so walking indexes down visits every child before its parent
+     * and one pass is enough. Positions which can not happen in a game are solved too, they are never looked up.
+     */
+    constexpr Table make_table() {
+        Table t;
+        for (int position = positions - 1; position >= 0; position--) {
+            int x = 0, o = 0;
+            for (int i = 0; i < 9; i++) {
+                x += get_cell(position, i) == X;
+                o += get_cell(position, i) == O;
+            }
+            int empty = 9 - x - o;
+            t.moves[position] = -1;
+            if (get_winner(position) != EMPTY) {
+                // previous player won, quicker losses score lower
+                t.scores[position] = static_cast<int8_t>(-(1 + empty));
+                continue;
+            }
+            if (empty == 0) {
+                t.scores[position] = 0;
+                continue;
+            }
+            int stone = x == o ? X : O;
+            int best = -100;
+            // center and corners first, so equal moves are the natural ones
+            for (int i: {4, 0, 2, 6, 8, 1, 3, 5, 7}) {
+                if (get_cell(position, i) != EMPTY) {
+                    continue;
+                }
+                int score = -t.scores[position + stone * cell_weights[i]];
+                if (score > best) {
+                    best = score;
+                    t.moves[position] = static_cast<int8_t>(i);
+                }
+            }
+            t.scores[position] = static_cast<int8_t>(best);
+        }
+        return t;
+    }
+
+    /**
+     * @brief Perfect play table, built by the compiler once in tic_tac_toe.cpp.
+     */
+    extern const Table table;
+
+    /**
+     * @brief Gets best move for the player to move.
+     *
+     * @param position Position index.
+     * @return Cell 0-8 in row-major order, -1 if the game is finished.
+     */
+    inline int get_best_move(int position) { return table.moves[position]; }
+
+} // namespace tic_tac_toe
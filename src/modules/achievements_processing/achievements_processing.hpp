@@ -4,7 +4,9 @@
 
 #pragma once
 #include <ctime>
+#include <optional>
 #include <src/module/module.hpp>
+#include <src/utils/coro/coro.hpp>
 
 namespace gb {
 
@@ -80,18 +82,33 @@ namespace gb {
          *
          * @param name The name of the achievement to activate.
          * @param user_id The ID of the user for whom the achievement is activated.
-         * @return The activated Achievement object.
+         * @return Task resolving to the activated Achievement object.
          */
-        virtual Achievement activate_achievement(const std::string &name, const std::string &user_id) = 0;
+        virtual Task<Achievement> activate_achievement(const std::string &name, const std::string &user_id) = 0;
+
+        /**
+         * @brief Activates an achievement unless user already has it.
+         *
+         * Unlike activate_achievement, nothing is written to the database for already unlocked achievements, so
+         * it is cheap to call every time the achievement condition holds. Ownership of users not cached yet is
+         * loaded with co_await, so callers on event threads are not blocked.
+         *
+         * @param name The name of the achievement to activate.
+         * @param user_id The ID of the user for whom the achievement is activated.
+         * @return Task resolving to the activated Achievement object, empty if user already had it or the
+         * achievement could not be recorded.
+         */
+        virtual Task<std::optional<Achievement>> unlock_achievement(const std::string &name,
+                                                                    const std::string &user_id) = 0;
 
         /**
          * @brief Checks if a user has a specific achievement.
          *
          * @param name The name of the achievement to check.
          * @param user_id The ID of the user to check.
-         * @return True if the user has the achievement, false otherwise.
+         * @return Task resolving to true if the user has the achievement, false otherwise.
          */
-        virtual bool is_have_achievement(const std::string &name, const std::string &user_id) = 0;
+        virtual Task<bool> is_have_achievement(const std::string &name, const std::string &user_id) = 0;
 
         /**
          * @brief Retrieves an achievements report for a specific user.
@@ -102,7 +119,7 @@ namespace gb {
          * along with the time they were unlocked and the locked achievements that the user has yet to achieve.
          *
          * @param user_id The ID of the user for whom the achievements report is being generated.
-         * @return Achievements_report A report detailing the user's unlocked and locked achievements.
+         * @return Task resolving to a report detailing the user's unlocked and locked achievements.
          *
          * @throws std::runtime_error if the `time_opened` string cannot be parsed.
          *
@@ -114,7 +131,7 @@ namespace gb {
          * - `locked_usual`: Usual achievements that the user has not yet unlocked.
          * - `locked_secret`: Secret achievements that the user has not yet unlocked.
          */
-        virtual Achievements_report get_achievements_report(const std::string &user_id) = 0;
+        virtual Task<Achievements_report> get_achievements_report(const std::string &user_id) = 0;
     };
 
     /**
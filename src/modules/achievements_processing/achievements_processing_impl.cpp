@@ -3,30 +3,39 @@
 //
 
 #include "achievements_processing_impl.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <format>
 #include <fstream>
 
 namespace gb {
     Achievements_processing_impl::Achievements_processing_impl() :
-        Achievements_processing("achievements_processing", {"admin_terminal", "database"}) {}
+        Achievements_processing("achievements_processing", {"admin_terminal", "database", "config"}) {}
 
     void Achievements_processing_impl::stop() {
         _admin_terminal->remove_command("achievements_reload");
         _admin_terminal->remove_command("achievements_list");
+        _admin_terminal->remove_command("achievements_cache_stats");
         _db->remove_prepared_statement(_activate_achievement_stmt);
-        _db->remove_prepared_statement(_check_achievement_stmt);
+        _db->remove_prepared_statement(_get_user_achievement_names);
         _db->remove_prepared_statement(_get_user_achievements);
     }
 
-    void Achievements_processing_impl::run() {}
+    void Achievements_processing_impl::run() {
+        std::unique_lock lk(_cache_mutex);
+        _cache_max_users = std::stoull(_config->get_value_or("achievements_cache_users", "50000"));
+    }
 
     void Achievements_processing_impl::init(const Modules &modules) {
         _admin_terminal = std::static_pointer_cast<Admin_terminal>(modules.at("admin_terminal"));
         _db = std::static_pointer_cast<Database>(modules.at("database"));
+        _config = std::static_pointer_cast<Config>(modules.at("config"));
 
         _activate_achievement_stmt = _db->create_prepared_statement(
             "INSERT IGNORE INTO `achievements` (`name`,`user_id`,`time_opened`) VALUES (?,?,UTC_TIMESTAMP())");
-        _check_achievement_stmt = _db->create_prepared_statement(
-            "SELECT EXISTS(SELECT `name` from `achievements` where `name`=? and `user_id`=?) as does_have");
+        _get_user_achievement_names =
+            _db->create_prepared_statement("SELECT `name` FROM `achievements` WHERE `user_id`=?");
         _get_user_achievements = _db->create_prepared_statement("CALL get_achievements(?)");
 
         _admin_terminal->add_command(
@@ -63,22 +72,160 @@ namespace gb {
 
                                          std::cout << output.str() << std::endl;
                                      });
+        _admin_terminal->add_command(
+            "achievements_cache_stats", "Prints statistics of achievements ownership cache.", "Arguments: no arguments",
+            [this](const std::vector<std::string> &args) {
+                size_t users;
+                {
+                    std::unique_lock lk(_cache_mutex);
+                    users = _cache.size();
+                }
+                std::cout << std::format("Achievements cache: users {}/{}, hits {}, loads {}, skipped writes {}, "
+                                         "cached reports {}",
+                                         users, _cache_max_users, _cache_hits.load(), _cache_loads.load(),
+                                         _skipped_writes.load(), _report_hits.load())
+                          << std::endl;
+            });
         load_from_file();
     }
-    Achievement Achievements_processing_impl::activate_achievement(const std::string &name,
-                                                                   const std::string &user_id) {
+
+    std::vector<uint64_t> Achievements_processing_impl::make_bits(const std::vector<std::string> &names) const {
+        std::vector<uint64_t> bits((_achievement_bits.size() + 63) / 64, 0);
+        for (auto &name: names) {
+            auto it = _achievement_bits.find(name);
+            if (it != _achievement_bits.end()) {
+                bits[it->second / 64] |= uint64_t(1) << (it->second % 64);
+            }
+        }
+        return bits;
+    }
+
+    Achievements_processing_impl::User_achievements &
+    Achievements_processing_impl::cache_put(const std::string &user_id, std::vector<uint64_t> bits) {
+        auto it = _cache.find(user_id);
+        if (it != _cache.end()) {
+            // loaded concurrently, keep bits set by activations in between
+            for (size_t i = 0; i < bits.size(); i++) {
+                it->second->bits[i] |= bits[i];
+            }
+            _cache_lru.splice(_cache_lru.begin(), _cache_lru, it->second);
+            return *it->second;
+        }
+        _cache_lru.push_front({user_id, std::move(bits)});
+        _cache.insert({user_id, _cache_lru.begin()});
+        while (_cache.size() > std::max<size_t>(_cache_max_users, 1)) {
+            _cache.erase(_cache_lru.back().user_id);
+            _cache_lru.pop_back();
+        }
+        return _cache_lru.front();
+    }
+
+    Task<void> Achievements_processing_impl::load_user_achievements(const std::string &user_id) {
+        {
+            std::shared_lock lk(_mutex);
+            std::unique_lock cache_lock(_cache_mutex);
+            auto it = _cache.find(user_id);
+            if (it != _cache.end()) {
+                _cache_hits++;
+                _cache_lru.splice(_cache_lru.begin(), _cache_lru, it->second);
+                co_return;
+            }
+        }
+
+        // query runs without any lock, so neither other users nor achievements reload wait for it
+        Database_return_t r = co_await _db->execute_prepared_statement(_get_user_achievement_names, user_id);
+        std::vector<std::string> names;
+        names.reserve(r.size());
+        for (auto &i: r) {
+            names.push_back(i.at("name"));
+        }
+        _cache_loads++;
+
+        // bits are made with indexes of achievements loaded now, cache_put merges an entry loaded meanwhile
         std::shared_lock lk(_mutex);
-        if (!_achievements.contains(name)) {
-            throw std::runtime_error("Achievement " + name + " does not exist in Achievements manager");
+        std::unique_lock cache_lock(_cache_mutex);
+        cache_put(user_id, make_bits(names));
+    }
+
+    Task<Achievement> Achievements_processing_impl::activate_achievement(const std::string &name,
+                                                                         const std::string &user_id) {
+        std::optional<Achievement> a = co_await unlock_achievement(name, user_id);
+        if (a) {
+            co_return *a;
         }
-        _db->background_execute_prepared_statement(_activate_achievement_stmt, name, user_id);
-        return _achievements.at(name);
+        std::shared_lock lk(_mutex);
+        co_return _achievements.at(name);
     }
 
-    bool Achievements_processing_impl::is_have_achievement(const std::string &name, const std::string &user_id) {
-        std::string r =
-            sync_wait(_db->execute_prepared_statement(_check_achievement_stmt, name, user_id)).at(0)["does_have"];
-        return r == "1";
+    Task<std::optional<Achievement>> Achievements_processing_impl::unlock_achievement(const std::string &name,
+                                                                                      const std::string &user_id) {
+        {
+            std::shared_lock lk(_mutex);
+            if (!_achievements.contains(name)) {
+                throw std::runtime_error("Achievement " + name + " does not exist in Achievements manager");
+            }
+        }
+        std::optional<Achievement> achievement;
+        while (!achievement) {
+            co_await load_user_achievements(user_id);
+            // achievements may have been reloaded and the user evicted while loading, both are checked again
+            std::shared_lock lk(_mutex);
+            auto it = _achievements.find(name);
+            if (it == _achievements.end()) {
+                throw std::runtime_error("Achievement " + name + " does not exist in Achievements manager");
+            }
+            std::unique_lock cache_lock(_cache_mutex);
+            auto cached = _cache.find(user_id);
+            if (cached == _cache.end()) {
+                continue;
+            }
+            size_t bit = _achievement_bits.at(name);
+            uint64_t &word = cached->second->bits[bit / 64];
+            uint64_t mask = uint64_t(1) << (bit % 64);
+            if (word & mask) {
+                _skipped_writes++;
+                co_return std::nullopt;
+            }
+            // set before the write is queued, so concurrent activations of the same achievement do nothing
+            word |= mask;
+            _unlocks_amount++;
+            cached->second->unlock_times.clear();
+            achievement = it->second;
+        }
+        if (!_db->background_execute_prepared_statement(_activate_achievement_stmt, name, user_id)) {
+            // the write was dropped, so the user does not have the achievement and may unlock it again
+            std::shared_lock lk(_mutex);
+            std::unique_lock cache_lock(_cache_mutex);
+            auto cached = _cache.find(user_id);
+            auto bit = _achievement_bits.find(name);
+            if (cached != _cache.end() && bit != _achievement_bits.end()) {
+                cached->second->bits[bit->second / 64] &= ~(uint64_t(1) << (bit->second % 64));
+            }
+            co_return std::nullopt;
+        }
+        co_return achievement;
+    }
+
+    Task<bool> Achievements_processing_impl::is_have_achievement(const std::string &name, const std::string &user_id) {
+        {
+            std::shared_lock lk(_mutex);
+            if (!_achievement_bits.contains(name)) {
+                co_return false;
+            }
+        }
+        while (true) {
+            co_await load_user_achievements(user_id);
+            std::shared_lock lk(_mutex);
+            auto bit = _achievement_bits.find(name);
+            if (bit == _achievement_bits.end()) {
+                co_return false;
+            }
+            std::unique_lock cache_lock(_cache_mutex);
+            auto cached = _cache.find(user_id);
+            if (cached != _cache.end()) {
+                co_return cached->second->bits[bit->second / 64] >> (bit->second % 64) & 1;
+            }
+        }
     }
 
     void Achievements_processing_impl::load_from_file() {
@@ -92,6 +239,15 @@ namespace gb {
         nlohmann::json j;
         file >> j;
         _achievements.clear();
+        _achievement_bits.clear();
+        _achievements_by_bit.clear();
+        _usual_bits.clear();
+        _secret_bits.clear();
+        {
+            std::unique_lock cache_lock(_cache_mutex);
+            _cache.clear();
+            _cache_lru.clear();
+        }
 
         for (const auto &item: j["achievements"]) {
             std::string name = item["name"];
@@ -105,55 +261,103 @@ namespace gb {
                                          " already exist, check your achievements config file");
             }
             _achievements.insert({name, Achievement(name, description, image_url, is_secret, discord_emoji)});
+            _achievement_bits.insert({name, _achievement_bits.size()});
+        }
+        // partitions are made once here, reports only walk them
+        for (auto &[name, achievement]: _achievements) {
+            size_t bit = _achievement_bits.at(name);
+            if (_achievements_by_bit.size() <= bit) {
+                _achievements_by_bit.resize(bit + 1);
+            }
+            _achievements_by_bit[bit] = &achievement;
+            (achievement.is_secret ? _secret_bits : _usual_bits).push_back(bit);
         }
     }
 
-    Achievements_report Achievements_processing_impl::get_achievements_report(const std::string &user_id) {
-        Database_return_t r = sync_wait(_db->execute_prepared_statement(_get_user_achievements, user_id));
-        Achievements_report report{};
-
-        // read thread safety required
-        std::shared_lock lk(_mutex);
-
-        for (auto &i: r) {
-            const auto &achievement = _achievements.at(i.at("name"));
-            std::tm tm = {};
-            std::istringstream ss(i.at("time_opened"));
-            ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-
-            if (ss.fail()) {
+    /**
+     * @brief Parses UTC time in "YYYY-MM-DD HH:MM:SS" format.
+     *
+     * @throws std::runtime_error If string has other format.
+     */
+    static std::time_t parse_utc_time(std::string_view s) {
+        int year = 0;
+        unsigned month = 0, day = 0, hour = 0, minute = 0, second = 0;
+        auto read = [&s](size_t pos, size_t len, auto &value) {
+            if (s.size() < pos + len ||
+                std::from_chars(s.data() + pos, s.data() + pos + len, value).ptr != s.data() + pos + len) {
                 throw std::runtime_error("Failed to parse time_opened string");
             }
+        };
+        read(0, 4, year);
+        read(5, 2, month);
+        read(8, 2, day);
+        read(11, 2, hour);
+        read(14, 2, minute);
+        read(17, 2, second);
+        std::chrono::sys_days days{std::chrono::year(year) / month / day};
+        return std::chrono::system_clock::to_time_t(days + std::chrono::hours(hour) + std::chrono::minutes(minute) +
+                                                    std::chrono::seconds(second));
+    }
 
-// Convert to time_t assuming the time is in UTC (without timezone adjustment)
-#ifdef _WIN32
-            std::time_t unix_timestamp = _mkgmtime(&tm); // Windows
-#else
-            std::time_t unix_timestamp = timegm(&tm); // POSIX systems
-#endif
+    Achievements_report Achievements_processing_impl::make_report(const std::vector<uint64_t> &bits,
+                                                                 const std::vector<std::time_t> &unlock_times) const {
+        Achievements_report report{};
+        auto fill = [&](const std::vector<size_t> &partition, std::vector<std::pair<Achievement, std::time_t>> &unlocked,
+                        std::vector<Achievement> &locked) {
+            for (size_t bit: partition) {
+                if (bits[bit / 64] >> (bit % 64) & 1) {
+                    unlocked.emplace_back(*_achievements_by_bit[bit], unlock_times[bit]);
+                } else {
+                    locked.emplace_back(*_achievements_by_bit[bit]);
+                }
+            }
+            std::ranges::stable_sort(unlocked, {}, [](const auto &i) { return i.second; });
+        };
+        fill(_usual_bits, report.unlocked_usual, report.locked_usual);
+        fill(_secret_bits, report.unlocked_secret, report.locked_secret);
+        return report;
+    }
 
-            if (!achievement.is_secret) {
-                report.unlocked_usual.emplace_back(achievement, unix_timestamp);
-            } else {
-                report.unlocked_secret.emplace_back(achievement, unix_timestamp);
+    Task<Achievements_report> Achievements_processing_impl::get_achievements_report(const std::string &user_id) {
+        {
+            std::shared_lock lk(_mutex);
+            std::unique_lock cache_lock(_cache_mutex);
+            auto it = _cache.find(user_id);
+            if (it != _cache.end() && !it->second->unlock_times.empty()) {
+                _report_hits++;
+                _cache_lru.splice(_cache_lru.begin(), _cache_lru, it->second);
+                co_return make_report(it->second->bits, it->second->unlock_times);
             }
         }
 
-        for (const auto &achievement_pair: _achievements) {
-            const auto &achievement = achievement_pair.second;
-
-            bool opened =
-                std::ranges::any_of(r, [&achievement](const auto &i) { return i.at("name") == achievement.name; });
+        uint64_t unlocks_amount = _unlocks_amount;
+        Database_return_t r = co_await _db->execute_prepared_statement(_get_user_achievements, user_id);
 
-            if (!opened) {
-                if (!achievement.is_secret) {
-                    report.locked_usual.emplace_back(achievement);
-                } else {
-                    report.locked_secret.emplace_back(achievement);
-                }
+        // read thread safety required
+        std::shared_lock lk(_mutex);
+        std::vector<std::string> names;
+        std::vector<std::time_t> unlock_times(_achievement_bits.size(), 0);
+        names.reserve(r.size());
+        for (auto &i: r) {
+            auto bit = _achievement_bits.find(i.at("name"));
+            // achievements removed from the file are not reported
+            if (bit == _achievement_bits.end()) {
+                continue;
             }
+            unlock_times[bit->second] = parse_utc_time(i.at("time_opened"));
+            names.push_back(i.at("name"));
         }
-        return report;
+        std::vector<uint64_t> bits = make_bits(names);
+        Achievements_report report = make_report(bits, unlock_times);
+
+        // report has every owned achievement, so it doubles as a cache load
+        std::unique_lock cache_lock(_cache_mutex);
+        User_achievements &cached = cache_put(user_id, bits);
+        // cached bits may include unlocks whose INSERT is still queued, their unlock time is unknown yet
+        if (unlocks_amount == _unlocks_amount && cached.bits == bits) {
+            cached.unlock_times = std::move(unlock_times);
+        }
+        co_return report;
     }
 
     Module_ptr create() { return std::dynamic_pointer_cast<Module>(std::make_shared<Achievements_processing_impl>()); }
@@ -3,8 +3,13 @@
 //
 
 #pragma once
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 #include <src/modules/admin_terminal/admin_terminal.hpp>
+#include <src/modules/config/config.hpp>
 #include <src/modules/database/database.hpp>
 #include "./achievements_processing.hpp"
 
@@ -19,20 +24,82 @@ namespace gb {
      */
     class Achievements_processing_impl : public Achievements_processing {
 
+        /**
+         * @brief Achievements owned by one user, bit i is set if user has achievement with bit index i.
+         */
+        struct User_achievements {
+            std::string user_id; ///< ID of the user.
+            std::vector<uint64_t> bits; ///< Ownership bitmap.
+            std::vector<std::time_t> unlock_times; ///< Unlock time by bit index, empty until a report is made.
+        };
+
         Admin_terminal_ptr _admin_terminal; ///< Pointer to the admin terminal module.
+        Config_ptr _config; ///< Pointer to the config module.
         Database_ptr _db; ///< Pointer to the database module.
         Prepared_statement _activate_achievement_stmt; ///< Prepared statement for activating an achievement.
-        Prepared_statement _check_achievement_stmt; ///< Prepared statement for checking if a user has an achievement.
+        Prepared_statement
+            _get_user_achievement_names; ///< Prepared statement to get names of achievements owned by a user.
         Prepared_statement
             _get_user_achievements; ///< Prepared statement to get achievements unlocked by specific user.
         std::shared_mutex _mutex; ///< Mutex for thread-safe access to the achievements map.
         std::map<std::string, Achievement> _achievements; ///< Map of achievement names to Achievement objects.
+        std::unordered_map<std::string, size_t> _achievement_bits; ///< Bit index of each achievement.
+        std::vector<const Achievement *> _achievements_by_bit; ///< Achievements by bit index.
+        std::vector<size_t> _usual_bits; ///< Bit indexes of usual achievements, ordered by name.
+        std::vector<size_t> _secret_bits; ///< Bit indexes of secret achievements, ordered by name.
+
+        std::mutex _cache_mutex; ///< Protects ownership cache, locked after _mutex when both are needed.
+        std::list<User_achievements> _cache_lru; ///< Cached users, most recently used first.
+        std::unordered_map<std::string, std::list<User_achievements>::iterator> _cache; ///< Cached users by id.
+        size_t _cache_max_users = 50000; ///< Maximal amount of cached users.
+        std::atomic_uint64_t _cache_hits = 0; ///< Lookups answered from the cache.
+        std::atomic_uint64_t _cache_loads = 0; ///< Users loaded from the database.
+        std::atomic_uint64_t _skipped_writes = 0; ///< Activations of already owned achievements.
+        std::atomic_uint64_t _report_hits = 0; ///< Reports made from cached unlock times.
+        std::atomic_uint64_t _unlocks_amount = 0; ///< Unlocks so far, reports loaded across an unlock are not cached.
+
+        /**
+         * @brief Puts ownership bitmap of the user into the cache, loading it from the database on a miss.
+         *
+         * No lock is held while the query runs, so achievements may be reloaded or the user evicted before the
+         * caller locks the cache again: callers look the user up again and retry if it is missing.
+         *
+         * @param user_id ID of the user.
+         * @return Task completing once the user is cached.
+         */
+        Task<void> load_user_achievements(const std::string &user_id);
+
+        /**
+         * @brief Builds ownership bitmap from achievement names. Requires _mutex.
+         *
+         * @param names Names of owned achievements, unknown names are skipped.
+         * @return Ownership bitmap.
+         */
+        std::vector<uint64_t> make_bits(const std::vector<std::string> &names) const;
+
+        /**
+         * @brief Puts bitmap into the cache, merging it with an entry added meanwhile. Requires _cache_mutex.
+         *
+         * @return Cached entry of the user.
+         */
+        User_achievements &cache_put(const std::string &user_id, std::vector<uint64_t> bits);
+
+        /**
+         * @brief Builds report from cached ownership and unlock times. Requires _mutex.
+         *
+         * @param bits Ownership bitmap.
+         * @param unlock_times Unlock time by bit index.
+         * @return Report, unlocked achievements ordered by unlock time.
+         */
+        Achievements_report make_report(const std::vector<uint64_t> &bits,
+                                        const std::vector<std::time_t> &unlock_times) const;
 
         /**
          * @brief Loads achievements from a JSON file into the achievements map.
          *
          * This method reads a JSON file containing achievements data and populates the internal map of achievements.
          * Throws an exception if the file cannot be opened or if there are duplicate achievements in the file.
+         * Bit indexes are reassigned, so the ownership cache is cleared.
          */
         void load_from_file();
 
@@ -75,20 +142,33 @@ namespace gb {
          *
          * @param name The name of the achievement.
          * @param user_id The ID of the user.
-         * @return The activated Achievement object.
+         * @return Task resolving to the activated Achievement object.
          *
          * @throws std::runtime_error if the achievement does not exist in the map.
          */
-        Achievement activate_achievement(const std::string &name, const std::string &user_id) override;
+        Task<Achievement> activate_achievement(const std::string &name, const std::string &user_id) override;
+
+        /**
+         * @brief Activates an achievement unless user already has it, checked against the ownership cache.
+         *
+         * The bit is set in the cache before the write is queued and cleared again if the database drops the write.
+         *
+         * @param name The name of the achievement to activate.
+         * @param user_id The ID of the user for whom the achievement is activated.
+         * @return Task resolving to the activated Achievement object, empty if user already had it or the write
+         * was dropped.
+         */
+        Task<std::optional<Achievement>> unlock_achievement(const std::string &name,
+                                                            const std::string &user_id) override;
 
         /**
          * @brief Checks if a user has a specific achievement.
          *
          * @param name The name of the achievement.
          * @param user_id The ID of the user.
-         * @return True if the user has the achievement, false otherwise.
+         * @return Task resolving to true if the user has the achievement, false otherwise.
          */
-        bool is_have_achievement(const std::string &name, const std::string &user_id) override;
+        Task<bool> is_have_achievement(const std::string &name, const std::string &user_id) override;
 
         /**
          * @brief Retrieves an achievements report for a specific user.
@@ -99,10 +179,14 @@ namespace gb {
          * along with the time they were unlocked and the locked achievements that the user has yet to achieve.
          *
          * @param user_id The ID of the user for whom the achievements report is being generated.
-         * @return Achievements_report A report detailing the user's unlocked and locked achievements.
+         * @return Task resolving to a report detailing the user's unlocked and locked achievements.
          *
          * @throws std::runtime_error if the `time_opened` string cannot be parsed.
          *
+         * Parsed unlock times are cached with the ownership bitmap until the user unlocks something new, so
+         * repeated reports do not touch the database. They are not cached while an unlock of the user is still
+         * waiting to be written, its time would be missing.
+         *
          * The report contains:
          * - `unlocked_usual`: Usual achievements that the user has unlocked, along with the UTC timestamp of when they
          * were unlocked.
@@ -111,7 +195,7 @@ namespace gb {
          * - `locked_usual`: Usual achievements that the user has not yet unlocked.
          * - `locked_secret`: Secret achievements that the user has not yet unlocked.
          */
-        Achievements_report get_achievements_report(const std::string &user_id) override;
+        Task<Achievements_report> get_achievements_report(const std::string &user_id) override;
     };
 
     /**
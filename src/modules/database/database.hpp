@@ -4,11 +4,21 @@
 
 #pragma once
 
+#include <charconv>
+#include <chrono>
 #include <coroutine>
+#include <cstddef>
+#include <ctime>
 #include <vector>
 #include <map>
 #include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
 
 #include "../../module/module.hpp"
 #include "src/utils/coro/coro.hpp"
@@ -32,6 +42,323 @@ namespace gb {
      */
     typedef std::vector<Database_return_record_t> Database_return_t;
 
+    /**
+     * @class Database_result
+     * @brief Typed, column oriented result of a database query.
+     *
+     * Unlike Database_return_t, values are stored per column in native form: integers, doubles and
+     * timestamps (as unix seconds, UTC) in one vector per column, strings in a single arena shared by
+     * the whole result. Reading a value does not allocate; get_string_view returns views into the arena
+     * which stay valid as long as the result object lives.
+     *
+     * Typed getters convert when the column was delivered as text (for example DECIMAL produced by SUM()).
+     */
+    class Database_result {
+    public:
+        /**
+         * @brief Storage type of a column.
+         */
+        enum class Column_type { INTEGER, UNSIGNED, DOUBLE, TIMESTAMP, STRING };
+
+        /**
+         * @brief Column data, values are indexed by row.
+         */
+        struct Column {
+            std::string name; ///< Column name or alias.
+            Column_type type = Column_type::STRING; ///< Storage type.
+            std::vector<int64_t> integers; ///< Values of INTEGER, UNSIGNED (bit cast) and TIMESTAMP columns.
+            std::vector<double> doubles; ///< Values of DOUBLE columns.
+            std::vector<std::pair<size_t, size_t>> strings; ///< Offset and length in arena for STRING columns.
+            std::vector<bool> nulls; ///< Null flags.
+        };
+
+    private:
+        std::vector<Column> _columns; ///< Result columns.
+        std::string _arena; ///< Storage for all string values.
+        size_t _rows_amount = 0; ///< Amount of rows.
+
+        const Column &column(size_t col) const { return _columns.at(col); }
+
+        void check_row(size_t row) const {
+            if (row >= _rows_amount) {
+                throw std::out_of_range("Database_result: row " + std::to_string(row) + " is out of range");
+            }
+        }
+
+        /**
+         * @brief Parses whole string value as a number, so "12abc" or "1.5" read as an integer throw instead of
+         * being truncated. DECIMAL columns are strings, get them with get_double if they may have a fraction.
+         */
+        template<typename T>
+        T parse_number(size_t row, size_t col) const {
+            std::string_view s = get_string_view(row, col);
+            T value{};
+            auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+            if (ec != std::errc() || ptr != s.data() + s.size()) {
+                throw std::runtime_error("Database_result: value of column " + column(col).name +
+                                         " is not a number: " + std::string(s));
+            }
+            return value;
+        }
+
+    public:
+        /**
+         * @brief Adds a column. Must be called before any row is added.
+         *
+         * @param name Column name.
+         * @param type Storage type.
+         */
+        void add_column(const std::string &name, Column_type type) { _columns.push_back({name, type}); }
+
+        /**
+         * @brief Reserves space for the given amount of rows in every column.
+         *
+         * @param rows Expected rows amount.
+         */
+        void reserve(size_t rows) {
+            for (auto &c: _columns) {
+                c.nulls.reserve(rows);
+                switch (c.type) {
+                    case Column_type::DOUBLE:
+                        c.doubles.reserve(rows);
+                        break;
+                    case Column_type::STRING:
+                        c.strings.reserve(rows);
+                        break;
+                    default:
+                        c.integers.reserve(rows);
+                }
+            }
+        }
+
+        /**
+         * @brief Appends null value to a column of the row being filled.
+         */
+        void push_null(size_t col) {
+            Column &c = _columns.at(col);
+            c.nulls.push_back(true);
+            switch (c.type) {
+                case Column_type::DOUBLE:
+                    c.doubles.push_back(0);
+                    break;
+                case Column_type::STRING:
+                    c.strings.emplace_back(_arena.size(), 0);
+                    break;
+                default:
+                    c.integers.push_back(0);
+            }
+        }
+
+        /**
+         * @brief Appends integer value (INTEGER, UNSIGNED or TIMESTAMP column).
+         */
+        void push_integer(size_t col, int64_t value) {
+            Column &c = _columns.at(col);
+            c.nulls.push_back(false);
+            c.integers.push_back(value);
+        }
+
+        /**
+         * @brief Appends double value (DOUBLE column).
+         */
+        void push_double(size_t col, double value) {
+            Column &c = _columns.at(col);
+            c.nulls.push_back(false);
+            c.doubles.push_back(value);
+        }
+
+        /**
+         * @brief Appends string value (STRING column), copying it into the arena.
+         */
+        void push_string(size_t col, std::string_view value) {
+            Column &c = _columns.at(col);
+            c.nulls.push_back(false);
+            c.strings.emplace_back(_arena.size(), value.size());
+            _arena.append(value);
+        }
+
+        /**
+         * @brief Finishes current row, every column must have received exactly one value.
+         */
+        void finish_row() { _rows_amount++; }
+
+        /**
+         * @brief Gets amount of rows.
+         */
+        size_t size() const { return _rows_amount; }
+
+        /**
+         * @brief Checks if the result has no rows.
+         */
+        bool empty() const { return _rows_amount == 0; }
+
+        /**
+         * @brief Gets amount of columns.
+         */
+        size_t columns_amount() const { return _columns.size(); }
+
+        /**
+         * @brief Gets column name by index.
+         */
+        const std::string &get_column_name(size_t col) const { return column(col).name; }
+
+        /**
+         * @brief Gets column storage type by index.
+         */
+        Column_type get_column_type(size_t col) const { return column(col).type; }
+
+        /**
+         * @brief Looks up column index by name.
+         *
+         * Resolve the index once before iterating rows instead of passing names to getters in loops.
+         *
+         * @param name Column name.
+         * @return Column index.
+         * @throws std::out_of_range if there is no such column.
+         */
+        size_t get_column_index(std::string_view name) const {
+            for (size_t i = 0; i < _columns.size(); i++) {
+                if (_columns[i].name == name) {
+                    return i;
+                }
+            }
+            throw std::out_of_range("Database_result: no column named " + std::string(name));
+        }
+
+        /**
+         * @brief Checks if value is SQL NULL.
+         */
+        bool is_null(size_t row, size_t col) const {
+            check_row(row);
+            return column(col).nulls[row];
+        }
+
+        /**
+         * @brief Gets value as signed 64 bit integer.
+         */
+        int64_t get_int64(size_t row, size_t col) const {
+            check_row(row);
+            const Column &c = column(col);
+            switch (c.type) {
+                case Column_type::DOUBLE:
+                    return static_cast<int64_t>(c.doubles[row]);
+                case Column_type::STRING:
+                    return parse_number<int64_t>(row, col);
+                default:
+                    return c.integers[row];
+            }
+        }
+
+        /**
+         * @brief Gets value as unsigned 64 bit integer (snowflakes, counters).
+         */
+        uint64_t get_uint64(size_t row, size_t col) const {
+            check_row(row);
+            const Column &c = column(col);
+            switch (c.type) {
+                case Column_type::DOUBLE:
+                    return static_cast<uint64_t>(c.doubles[row]);
+                case Column_type::STRING:
+                    return parse_number<uint64_t>(row, col);
+                default:
+                    return static_cast<uint64_t>(c.integers[row]);
+            }
+        }
+
+        /**
+         * @brief Gets value as double.
+         */
+        double get_double(size_t row, size_t col) const {
+            check_row(row);
+            const Column &c = column(col);
+            switch (c.type) {
+                case Column_type::DOUBLE:
+                    return c.doubles[row];
+                case Column_type::STRING:
+                    return parse_number<double>(row, col);
+                case Column_type::UNSIGNED:
+                    return static_cast<double>(static_cast<uint64_t>(c.integers[row]));
+                default:
+                    return static_cast<double>(c.integers[row]);
+            }
+        }
+
+        /**
+         * @brief Gets DATETIME/TIMESTAMP value as unix time (UTC).
+         */
+        time_t get_timestamp(size_t row, size_t col) const { return static_cast<time_t>(get_int64(row, col)); }
+
+        /**
+         * @brief Gets text value without copying.
+         *
+         * Only STRING columns can be viewed, the view is valid while this result is alive.
+         */
+        std::string_view get_string_view(size_t row, size_t col) const {
+            check_row(row);
+            const Column &c = column(col);
+            if (c.type != Column_type::STRING) {
+                throw std::runtime_error("Database_result: column " + c.name + " is not a string column");
+            }
+            auto [offset, length] = c.strings[row];
+            return std::string_view(_arena).substr(offset, length);
+        }
+
+        /**
+         * @brief Gets value as string, formatting numeric columns.
+         */
+        std::string get_string(size_t row, size_t col) const {
+            check_row(row);
+            const Column &c = column(col);
+            switch (c.type) {
+                case Column_type::STRING:
+                    return std::string(get_string_view(row, col));
+                case Column_type::DOUBLE:
+                    return std::to_string(c.doubles[row]);
+                case Column_type::UNSIGNED:
+                    return std::to_string(static_cast<uint64_t>(c.integers[row]));
+                default:
+                    return std::to_string(c.integers[row]);
+            }
+        }
+
+        /**
+         * @brief Gets signed integer or nullopt for NULL.
+         */
+        std::optional<int64_t> get_optional_int64(size_t row, size_t col) const {
+            if (is_null(row, col)) {
+                return std::nullopt;
+            }
+            return get_int64(row, col);
+        }
+
+        /**
+         * @brief Gets string or nullopt for NULL.
+         */
+        std::optional<std::string> get_optional_string(size_t row, size_t col) const {
+            if (is_null(row, col)) {
+                return std::nullopt;
+            }
+            return get_string(row, col);
+        }
+
+        // Name based overloads, convenient for single row results.
+        int64_t get_int64(size_t row, std::string_view name) const { return get_int64(row, get_column_index(name)); }
+        uint64_t get_uint64(size_t row, std::string_view name) const {
+            return get_uint64(row, get_column_index(name));
+        }
+        double get_double(size_t row, std::string_view name) const { return get_double(row, get_column_index(name)); }
+        time_t get_timestamp(size_t row, std::string_view name) const {
+            return get_timestamp(row, get_column_index(name));
+        }
+        std::string_view get_string_view(size_t row, std::string_view name) const {
+            return get_string_view(row, get_column_index(name));
+        }
+        std::string get_string(size_t row, std::string_view name) const {
+            return get_string(row, get_column_index(name));
+        }
+        bool is_null(size_t row, std::string_view name) const { return is_null(row, get_column_index(name)); }
+    };
+
     /**
      * @brief Type representing a prepared statement identifier.
      *
@@ -44,17 +371,58 @@ namespace gb {
      * @brief Abstract base class for prepared statement parameters.
      *
      * This class defines the interface for adding parameters to a prepared
-     * statement. Derived classes must implement the add_param method to
-     * handle specific parameter types and conversions.
+     * statement. Parameters are bound in their native types, so the database
+     * server does not have to parse numbers and dates sent as text. Derived
+     * classes must implement every add_*_param method.
      */
     class Prepared_statement_params {
     public:
         /**
-         * @brief Adds a parameter to the prepared statement.
+         * @brief Adds a text parameter to the prepared statement.
+         *
+         * @param param The parameter to add, copied into the parameters object.
+         */
+        virtual void add_param(std::string_view param) = 0;
+
+        /**
+         * @brief Adds SQL NULL parameter.
+         */
+        virtual void add_null_param() = 0;
+
+        /**
+         * @brief Adds signed integer parameter.
+         *
+         * @param param The parameter to add.
+         */
+        virtual void add_int_param(int64_t param) = 0;
+
+        /**
+         * @brief Adds unsigned integer parameter (snowflakes, counters).
+         *
+         * @param param The parameter to add.
+         */
+        virtual void add_unsigned_param(uint64_t param) = 0;
+
+        /**
+         * @brief Adds floating point parameter.
+         *
+         * @param param The parameter to add.
+         */
+        virtual void add_double_param(double param) = 0;
+
+        /**
+         * @brief Adds DATETIME parameter, the time point is treated as UTC.
+         *
+         * @param param The parameter to add.
+         */
+        virtual void add_datetime_param(std::chrono::sys_seconds param) = 0;
+
+        /**
+         * @brief Adds binary parameter.
          *
-         * @param param The parameter to add, represented as a string.
+         * @param param Bytes to add, copied into the parameters object.
          */
-        virtual void add_param(const std::string &param) = 0;
+        virtual void add_blob_param(std::span<const std::byte> param) = 0;
 
         /**
          * @brief Virtual destructor for Prepared_statement_params.
@@ -62,6 +430,28 @@ namespace gb {
         virtual ~Prepared_statement_params() = default;
     };
 
+    namespace database_detail {
+        template<typename T>
+        struct is_optional : std::false_type {};
+
+        template<typename T>
+        struct is_optional<std::optional<T>> : std::true_type {};
+
+        template<typename T>
+        struct is_sys_time : std::false_type {};
+
+        template<typename Duration>
+        struct is_sys_time<std::chrono::time_point<std::chrono::system_clock, Duration>> : std::true_type {};
+
+        /**
+         * @brief Contiguous range of raw bytes, bound as BLOB.
+         */
+        template<typename T>
+        concept Blob = std::ranges::contiguous_range<T> && sizeof(std::ranges::range_value_t<T>) == 1 &&
+                       (std::is_same_v<std::ranges::range_value_t<T>, std::byte> ||
+                        std::is_same_v<std::ranges::range_value_t<T>, uint8_t>);
+    } // namespace database_detail
+
     /**
      * @brief Abstract base class for database modules.
      *
@@ -101,11 +491,30 @@ namespace gb {
          *
          * Derived classes must implement this function to handle the
          * execution of prepared statements without waiting for the result.
+         * It must never block the caller, callers are usually D++ event threads.
          *
          * @param p The identifier of the prepared statement.
          * @param params The parameters to bind to the prepared statement.
+         * @param is_droppable The statement may be dropped when the background queue is full, otherwise it is
+         * queued past the limit.
+         * @return False if the statement was rejected because the background queue is full.
          */
-        virtual void _background_execute_prepared_statement(Prepared_statement p, std::unique_ptr<Prepared_statement_params> params) = 0;
+        virtual bool _background_execute_prepared_statement(Prepared_statement p,
+                                                            std::unique_ptr<Prepared_statement_params> params,
+                                                            bool is_droppable) = 0;
+
+        /**
+         * @brief Executes a prepared statement asynchronously and returns typed result.
+         *
+         * Derived classes must implement this function to bind result columns directly
+         * into native typed buffers.
+         *
+         * @param p The identifier of the prepared statement.
+         * @param params The parameters to bind to the prepared statement.
+         * @return A Task that, when awaited, returns the result as a Database_result.
+         */
+        virtual Task<Database_result> _query_prepared_statement(Prepared_statement p,
+                                                                std::unique_ptr<Prepared_statement_params> params) = 0;
 
     public:
         /**
@@ -199,12 +608,59 @@ namespace gb {
             return std::string(value);
         }
 
+        /**
+         * @brief Binds a value to prepared statement parameters in its native type.
+         *
+         * The type is selected at compile time: integers (and enums, bools, snowflakes) are bound as
+         * BIGINT, floating point as DOUBLE, system_clock time points as DATETIME, byte ranges as BLOB,
+         * strings as text and std::nullopt/nullptr as NULL. Anything else falls back to to_string.
+         *
+         * @param params Parameters object to add to.
+         * @param value The value to bind.
+         */
+        template<typename T>
+        void add_typed_param(Prepared_statement_params &params, const T &value) {
+            using V = std::remove_cvref_t<T>;
+            if constexpr (std::is_same_v<V, std::nullptr_t> || std::is_same_v<V, std::nullopt_t>) {
+                params.add_null_param();
+            } else if constexpr (database_detail::is_optional<V>::value) {
+                if (value) {
+                    add_typed_param(params, *value);
+                } else {
+                    params.add_null_param();
+                }
+            } else if constexpr (std::is_same_v<V, bool>) {
+                params.add_int_param(value ? 1 : 0);
+            } else if constexpr (std::is_same_v<V, char>) {
+                params.add_param(std::string_view(&value, 1));
+            } else if constexpr (std::is_enum_v<V>) {
+                add_typed_param(params, static_cast<std::underlying_type_t<V>>(value));
+            } else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>) {
+                params.add_int_param(static_cast<int64_t>(value));
+            } else if constexpr (std::is_integral_v<V>) {
+                params.add_unsigned_param(static_cast<uint64_t>(value));
+            } else if constexpr (std::is_floating_point_v<V>) {
+                params.add_double_param(static_cast<double>(value));
+            } else if constexpr (std::is_convertible_v<const V &, std::string_view>) {
+                params.add_param(std::string_view(value));
+            } else if constexpr (database_detail::is_sys_time<V>::value) {
+                params.add_datetime_param(std::chrono::floor<std::chrono::seconds>(value));
+            } else if constexpr (database_detail::Blob<const V>) {
+                params.add_blob_param(std::as_bytes(std::span(std::ranges::data(value), std::ranges::size(value))));
+            } else if constexpr (std::is_convertible_v<const V &, uint64_t>) {
+                // snowflakes and other id wrappers
+                params.add_unsigned_param(static_cast<uint64_t>(value));
+            } else {
+                params.add_param(to_string(value));
+            }
+        }
+
         /**
          * @brief Executes a prepared statement asynchronously with parameters.
          *
          * This function uses variadic templates to accept any number of
-         * parameters of any type, converts them to strings, and binds them
-         * to the prepared statement.
+         * parameters of any type and binds them to the prepared statement,
+         * see add_typed_param for the type mapping.
          *
          * @param pt The identifier of the prepared statement.
          * @param args The parameters to bind to the prepared statement.
@@ -214,34 +670,65 @@ namespace gb {
         template<typename... Args>
         Task<Database_return_t> execute_prepared_statement(Prepared_statement pt, Args &&... args) {
             auto params = this->get_params_object();
-            auto add_param = [&params, this](const auto &arg) {
-                params->add_param(to_string(arg));
-            };
-            // Expand the variadic template and apply add_param to each argument
-            (add_param(std::forward<Args>(args)), ...);
+            // Expand the variadic template and bind each argument in its native type
+            (add_typed_param(*params, args), ...);
             Database_return_t result = co_await _execute_prepared_statement(pt, std::move(params));
             co_return {result};
         }
 
+        /**
+         * @brief Executes a prepared statement asynchronously and returns typed, column oriented result.
+         *
+         * Prefer this over execute_prepared_statement for queries returning many rows or numeric
+         * columns: values are not converted to strings and rows do not allocate maps.
+         *
+         * @param pt The identifier of the prepared statement.
+         * @param args The parameters to bind to the prepared statement.
+         * @return A Task that, when awaited, returns the result of the query as a Database_result.
+         */
+        template<typename... Args>
+        Task<Database_result> query_prepared_statement(Prepared_statement pt, Args &&... args) {
+            auto params = this->get_params_object();
+            // Expand the variadic template and bind each argument in its native type
+            (add_typed_param(*params, args), ...);
+            Database_result result = co_await _query_prepared_statement(pt, std::move(params));
+            co_return result;
+        }
+
         /**
          * @brief Executes a prepared statement in the background with parameters.
          *
          * This function uses variadic templates to accept any number of
-         * parameters of any type, converts them to strings, and binds them
-         * to the prepared statement.
+         * parameters of any type and binds them to the prepared statement,
+         * see add_typed_param for the type mapping. The statement is dropped if the
+         * background queue is full, use it only for writes which may be lost.
+         *
+         * @param pt The identifier of the prepared statement.
+         * @param args The parameters to bind to the prepared statement.
+         * @return False if the statement was dropped because the background queue is full.
+         */
+        template<typename... Args>
+        bool background_execute_prepared_statement(Prepared_statement pt, Args &&... args){
+            auto params = this->get_params_object();
+            // Expand the variadic template and bind each argument in its native type
+            (add_typed_param(*params, args), ...);
+            return _background_execute_prepared_statement(pt, std::move(params), true);
+        }
+
+        /**
+         * @brief Executes a prepared statement in the background, never dropping it.
+         *
+         * Same as background_execute_prepared_statement, but the statement is queued even if the
+         * background queue is full, for records other rows depend on.
          *
          * @param pt The identifier of the prepared statement.
          * @param args The parameters to bind to the prepared statement.
          */
         template<typename... Args>
-        void background_execute_prepared_statement(Prepared_statement pt, Args &&... args){
+        void background_execute_critical_prepared_statement(Prepared_statement pt, Args &&... args){
             auto params = this->get_params_object();
-            auto add_param = [&params, this](const auto &arg) {
-                params->add_param(to_string(arg));
-            };
-            // Expand the variadic template and apply add_param to each argument
-            (add_param(std::forward<Args>(args)), ...);
-            _background_execute_prepared_statement(pt, std::move(params));
+            (add_typed_param(*params, args), ...);
+            _background_execute_prepared_statement(pt, std::move(params), false);
         }
     };
 
@@ -6,10 +6,86 @@
 #include <mysql/mysql.h>
 #include <mysql/errmsg.h>
 
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <chrono>
+
 
 namespace gb {
+    /**
+     * @brief Splits "INSERT ... VALUES (row)" into head and row so rows can be repeated.
+     *
+     * Only plain single row inserts are accepted: nothing but whitespace and ';' may follow the
+     * row tuple (no ON DUPLICATE KEY UPDATE) and all placeholders must be inside the tuple.
+     */
+    static std::optional<Database_impl::Multi_row_insert> split_single_row_insert(const std::string &sql) {
+        std::string upper(sql.size(), ' ');
+        std::transform(sql.begin(), sql.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+        size_t begin = upper.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos || upper.compare(begin, 6, "INSERT") != 0) {
+            return std::nullopt;
+        }
+        auto is_word = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '`'; };
+        size_t values = upper.find("VALUES");
+        while (values != std::string::npos &&
+               ((values > 0 && is_word(upper[values - 1])) ||
+                (values + 6 < upper.size() && is_word(upper[values + 6])))) {
+            values = upper.find("VALUES", values + 6);
+        }
+        if (values == std::string::npos) {
+            return std::nullopt;
+        }
+        size_t row_begin = upper.find_first_not_of(" \t\r\n", values + 6);
+        if (row_begin == std::string::npos || sql[row_begin] != '(') {
+            return std::nullopt;
+        }
+        int depth = 0;
+        char quote = 0;
+        size_t row_end = std::string::npos;
+        size_t row_params = 0;
+        for (size_t i = row_begin; i < sql.size() && row_end == std::string::npos; i++) {
+            char c = sql[i];
+            if (quote) {
+                if (c == '\\') {
+                    i++;
+                } else if (c == quote) {
+                    quote = 0;
+                }
+                continue;
+            }
+            switch (c) {
+                case '\'':
+                case '"':
+                case '`':
+                    quote = c;
+                    break;
+                case '?':
+                    row_params++;
+                    break;
+                case '(':
+                    depth++;
+                    break;
+                case ')':
+                    if (--depth == 0) {
+                        row_end = i;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (row_end == std::string::npos ||
+            sql.find_first_not_of(" \t\r\n;", row_end + 1) != std::string::npos ||
+            std::count(sql.begin(), sql.end(), '?') != static_cast<std::ptrdiff_t>(row_params)) {
+            return std::nullopt;
+        }
+        return Database_impl::Multi_row_insert{sql.substr(0, row_begin), sql.substr(row_begin, row_end - row_begin + 1),
+                                               row_params};
+    }
+
     Database_impl::Database_impl() : Database("database", {"config", "logging", "admin_terminal"}) {
-        _bg_thread = std::thread([this]() -> Task<void> {
+        _bg_thread = std::thread([this]() {
             while (1) {
                 std::unique_lock lk(_bg_thread_mutex);
                 _cv_bg.wait(lk, [this]() { return !_bg_queue.empty() || !_is_bg_running; });
@@ -22,13 +98,17 @@ namespace gb {
                 auto e = _bg_queue.front();
                 _bg_queue.pop();
                 lk.unlock();
-                co_await execute(e);
+                try {
+                    sync_wait(execute(e));
+                } catch (const std::exception &ex) {
+                    _log->error(std::string("Database: background query failed: ") + ex.what());
+                }
                 queries_amount--;
                 _cv_stop.notify_all();
             }
-            co_return;
         });
-        _bg_stmt_thread = std::thread([this]() -> Task<void> {
+        _bg_stmt_thread = std::thread([this]() {
+            std::vector<Background_statement> batch;
             while (1) {
                 std::unique_lock lk(_bg_thread_stmt_mutex);
                 _cv_bg_stmt.wait(lk, [this]() { return !_bg_stmt_queue.empty() || !_is_bg_running; });
@@ -38,14 +118,22 @@ namespace gb {
                 if (_bg_stmt_queue.empty()) {
                     continue;
                 }
-                auto e = std::move(_bg_stmt_queue.front());
-                _bg_stmt_queue.pop();
+                // group commit window, skipped when stopping so the queue is flushed right away
+                size_t batch_size = std::max<size_t>(_bg_batch_size, 1);
+                _cv_bg_stmt.wait_for(lk, std::chrono::milliseconds(_bg_batch_window_ms), [this, batch_size]() {
+                    return _bg_stmt_queue.size() >= batch_size || !_is_bg_running;
+                });
+                while (!_bg_stmt_queue.empty() && batch.size() < batch_size) {
+                    batch.push_back(std::move(_bg_stmt_queue.front()));
+                    _bg_stmt_queue.pop();
+                }
                 lk.unlock();
-                co_await _execute_prepared_statement(e.first, std::move(e.second));
-                queries_amount--;
+                size_t amount = batch.size();
+                flush_background_batch(batch);
+                batch.clear();
+                queries_amount -= amount;
                 _cv_stop.notify_all();
             }
-            co_return;
         });
     }
 
@@ -82,6 +170,46 @@ namespace gb {
                 }
             });
 
+        _admin_terminal->add_command(
+            "database_get_pool_stats", "Shows connection pool wait time metrics", "Arguments: no arguments.",
+            [this](const std::vector<std::string> &arguments) {
+                auto stats = _pool.get_stats();
+                std::string r = std::format("Connection pool:\nconnections: {}, idle: {}, waiting queries: {}",
+                                            stats.connections_amount, stats.idle_amount, stats.waiters_amount);
+                r += std::format("\nacquired: {}, had to wait: {}, timed out: {}", stats.acquired_amount,
+                                 stats.waited_amount, stats.timeouts_amount);
+                r += std::format("\naverage wait: {} us, max wait: {} us",
+                                 stats.acquired_amount ? stats.total_wait_us / stats.acquired_amount : 0,
+                                 stats.max_wait_us);
+                r += "\nwait time distribution:";
+                uint64_t lower_bound = 0;
+                for (size_t i = 0; i < stats.wait_histogram.size(); i++) {
+                    if (i < Mysql_connection_pool::histogram_bounds_us.size()) {
+                        r += std::format("\n  [{} us, {} us): {}", lower_bound,
+                                         Mysql_connection_pool::histogram_bounds_us[i], stats.wait_histogram[i]);
+                        lower_bound = Mysql_connection_pool::histogram_bounds_us[i];
+                    } else {
+                        r += std::format("\n  [{} us, inf): {}", lower_bound, stats.wait_histogram[i]);
+                    }
+                }
+                std::cout << r << std::endl;
+            });
+
+        _admin_terminal->add_command(
+            "database_get_batch_stats", "Shows background statements batching metrics", "Arguments: no arguments.",
+            [this](const std::vector<std::string> &arguments) {
+                auto stats = get_batch_stats();
+                std::string r = std::format("Background statements:\nqueued: {}, batches: {}, statements: {}",
+                                            stats.queue_size, stats.batches_amount, stats.statements_amount);
+                r += std::format("\naverage batch size: {}, merged into multi-row inserts: {}",
+                                 stats.batches_amount ? stats.statements_amount / stats.batches_amount : 0,
+                                 stats.merged_rows_amount);
+                r += std::format("\nfailed batches: {}, failed statements: {}, rejected on full queue: {}",
+                                 stats.failed_batches_amount, stats.failed_statements_amount,
+                                 stats.rejected_amount);
+                std::cout << r << std::endl;
+            });
+
         _admin_terminal->add_command(
             "database_request_queue_size", "Shows length of request queue (including currently running)",
             "Arguments: no arguments.", [this](const std::vector<std::string> &arguments) {
@@ -169,6 +297,11 @@ namespace gb {
     }
 
     void Database_impl::run() {
+        _scheduler = std::make_unique<Thread_pool>(std::stoi(_config->get_value_or("mysql_scheduler_threads", "2")));
+        _pool.set_max_wait(std::chrono::milliseconds(std::stoll(_config->get_value_or("mysql_max_wait_ms", "0"))));
+        _bg_batch_size = std::stoull(_config->get_value_or("mysql_batch_size", "64"));
+        _bg_batch_window_ms = std::stoull(_config->get_value_or("mysql_batch_window_ms", "10"));
+        _bg_queue_limit = std::stoull(_config->get_value_or("mysql_background_queue_limit", "10000"));
         auto mysql_connections_amount = std::stoi(_config->get_value_or("mysql_connections_amount", "2"));
         for (size_t i = 0; i < mysql_connections_amount; i++) {
             new_connection();
@@ -179,14 +312,20 @@ namespace gb {
         _admin_terminal->remove_command("database_get_connections");
         _admin_terminal->remove_command("database_add_connection");
         _admin_terminal->remove_command("database_request_queue_size");
+        _admin_terminal->remove_command("database_get_pool_stats");
+        _admin_terminal->remove_command("database_get_batch_stats");
         _is_bg_running = false;
         _cv_bg.notify_all();
         _cv_bg_stmt.notify_all();
         std::mutex m;
         std::unique_lock lk(m);
         _cv_stop.wait(lk, [this] { return queries_amount == 0; });
-        _mysql_list.clear();
         _bg_thread.join();
+        _bg_stmt_thread.join();
+        // let coroutines resumed after the last queries finish before connections go away
+        _scheduler.reset();
+        _pool.clear();
+        _mysql_list.clear();
     }
 
     void Database_impl::backup(const std::string &file_path) {
@@ -219,42 +358,19 @@ namespace gb {
     void Database_impl::new_connection() {
         std::unique_lock lock(_mutex);
         auto c = std::make_unique<Mysql_connection>(_log, _config, this);
+        _pool.add(c.get());
         _mysql_list.push_back(std::move(c));
     }
 
     Task<Database_return_t> Database_impl::execute(const std::string &sql) {
         queries_amount++;
-        auto storage = std::make_shared<Database_return_t>();
-        auto storage_mutex = std::make_shared<std::mutex>();
-        auto evaluated = std::make_shared<bool>(false);
-        std::function<Task<Database_return_t>()> tt = [sql, evaluated, this, storage,
-                                                       storage_mutex]() -> Task<Database_return_t> {
-            std::unique_lock l(*storage_mutex);
-            if (!(*evaluated)) {
-                *evaluated = true;
-                MYSQL_RES *confres;
-                Mysql_connection *conn;
-                bool stop = false;
-                std::unique_lock<std::mutex> r;
-                while (true) {
-                    std::unique_lock lock(_mutex);
-                    for (auto &i: _mysql_list) {
-                        if (!i->_busy) {
-                            r = std::unique_lock(i->_mutex);
-                            conn = i.get();
-                            conn->_busy = true;
-                            lock.unlock();
-                            confres = i->execute_query(sql);
-                            stop = true;
-                            break;
-                        }
-                    }
-                    if (stop) {
-                        break;
-                    }
-                    lock.unlock();
-                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                }
+        Database_return_t r;
+        std::exception_ptr exception;
+        try {
+            r = co_await Database_job<Database_return_t>(this, [this, sql]() {
+                Database_return_t storage;
+                auto conn = _pool.acquire();
+                MYSQL_RES *confres = conn->execute_query(sql);
 
                 // Get the number of columns
                 if (confres) {
@@ -278,22 +394,20 @@ namespace gb {
                                 row_map[column_names[i]] = "NULL";
                             }
                         }
-                        storage->push_back(row_map);
+                        storage.push_back(row_map);
                     }
                     mysql_free_result(confres);
                 }
-                conn->_busy = false;
-            }
-            co_return *storage;
-        };
-        {
-            std::unique_lock l(_mutex);
-            _sql_queue.push_back(tt);
+                return storage;
+            });
+        } catch (...) {
+            exception = std::current_exception();
         }
-        _cv.notify_all();
-        Database_return_t r = co_await tt();
         queries_amount--;
         _cv_stop.notify_all();
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
         co_return r;
     }
 
@@ -316,18 +430,128 @@ namespace gb {
         return _prepared_statements.at(st);
     }
 
+    std::optional<size_t> Database_impl::get_multi_row_params_amount(const Prepared_statement &st) {
+        std::shared_lock lk(_prepared_statements_mutex);
+        auto it = _multi_row_inserts.find(st);
+        if (it == _multi_row_inserts.end()) {
+            return std::nullopt;
+        }
+        return it->second.row_params_amount;
+    }
+
+    std::string Database_impl::get_multi_row_statement(const Prepared_statement &st, size_t rows) {
+        std::shared_lock lk(_prepared_statements_mutex);
+        const Multi_row_insert &insert = _multi_row_inserts.at(st);
+        std::string sql;
+        sql.reserve(insert.head.size() + (insert.row.size() + 1) * rows);
+        sql += insert.head;
+        for (size_t i = 0; i < rows; i++) {
+            if (i) {
+                sql += ',';
+            }
+            sql += insert.row;
+        }
+        return sql;
+    }
+
+    Database_batch_stats Database_impl::get_batch_stats() {
+        Database_batch_stats stats;
+        {
+            std::unique_lock lk(_bg_thread_stmt_mutex);
+            stats.queue_size = _bg_stmt_queue.size();
+        }
+        stats.batches_amount = _batches_amount;
+        stats.statements_amount = _batched_statements_amount;
+        stats.merged_rows_amount = _merged_rows_amount;
+        stats.failed_batches_amount = _failed_batches_amount;
+        stats.failed_statements_amount = _failed_statements_amount;
+        stats.rejected_amount = _rejected_amount;
+        return stats;
+    }
+
+    void Database_impl::flush_background_batch(std::vector<Background_statement> &batch) {
+        _batches_amount++;
+        _batched_statements_amount += batch.size();
+        try {
+            auto conn = _pool.acquire();
+            bool transaction = batch.size() > 1;
+            try {
+                if (transaction) {
+                    conn->begin_transaction();
+                }
+                size_t merged = 0;
+                for (size_t i = 0; i < batch.size();) {
+                    Prepared_statement st = batch[i].first;
+                    size_t run_end = i + 1;
+                    while (run_end < batch.size() && batch[run_end].first == st) {
+                        run_end++;
+                    }
+                    auto row_params = run_end - i > 1 ? get_multi_row_params_amount(st) : std::nullopt;
+                    if (!row_params) {
+                        for (; i < run_end; i++) {
+                            conn->execute_batched(st, 1, *batch[i].second);
+                        }
+                        continue;
+                    }
+                    // rows go in power of two chunks, so each connection prepares only a few variants
+                    size_t max_rows = std::bit_floor(std::min<size_t>(
+                        std::max<size_t>(_bg_batch_size, 1), *row_params ? 65535 / *row_params : 65535));
+                    while (i < run_end) {
+                        size_t rows = std::min(std::bit_floor(run_end - i), max_rows);
+                        if (rows == 1) {
+                            conn->execute_batched(st, 1, *batch[i].second);
+                            i++;
+                            continue;
+                        }
+                        Mysql_prepared_statement_params merged_params;
+                        for (size_t j = i; j < i + rows; j++) {
+                            merged_params.append(dynamic_cast<Mysql_prepared_statement_params &>(*batch[j].second));
+                        }
+                        conn->execute_batched(st, rows, merged_params);
+                        merged += rows;
+                        i += rows;
+                    }
+                }
+                if (transaction) {
+                    conn->commit();
+                }
+                _merged_rows_amount += merged;
+                return;
+            } catch (const std::exception &e) {
+                if (!transaction) {
+                    throw;
+                }
+                conn->rollback();
+                _failed_batches_amount++;
+                _log->warn(std::string("Database: background batch failed, retrying statements one by one: ") +
+                           e.what());
+            }
+            for (auto &[st, params]: batch) {
+                try {
+                    conn->execute_prepared_statement(st, *params);
+                } catch (const std::exception &e) {
+                    _failed_statements_amount++;
+                    _log->error(std::string("Database: background prepared statement failed: ") + e.what());
+                }
+            }
+        } catch (const std::exception &e) {
+            _failed_statements_amount += batch.size();
+            _log->error(std::string("Database: background prepared statement failed: ") + e.what());
+        }
+    }
+
     void Database_impl::remove_prepared_statement(Prepared_statement st) {
         {
             std::unique_lock lk2(_mutex);
             std::unique_lock lk(_prepared_statements_mutex);
-            auto tt = [this, st]() -> Task<Database_return_t> {
+            _sql_queue.emplace_back([this, st]() {
                 for (auto &i: _mysql_list) {
                     i->remove_statement(st);
                 }
+                std::unique_lock lk(_prepared_statements_mutex);
                 _prepared_statements.erase(st);
-                co_return {};
-            };
-            _sql_queue.emplace_back(tt);
+                _multi_row_inserts.erase(st);
+            });
         }
         _cv.notify_all();
     }
@@ -344,6 +568,9 @@ namespace gb {
             }
         }
         _prepared_statements[_prepared_statements_index] = sql;
+        if (auto multi_row = split_single_row_insert(sql)) {
+            _multi_row_inserts[_prepared_statements_index] = std::move(*multi_row);
+        }
         auto ind = _prepared_statements_index;
         lk.unlock();
         for (auto &i: _mysql_list) {
@@ -360,66 +587,90 @@ namespace gb {
     Database_impl::_execute_prepared_statement(Prepared_statement st,
                                                std::unique_ptr<Prepared_statement_params> params) {
         queries_amount++;
-        auto storage = std::make_shared<Database_return_t>();
-        auto storage_mutex = std::make_shared<std::mutex>();
-        auto evaluated = std::make_shared<bool>(false);
-
-        auto tt = [st, evaluated, &params, this, storage, storage_mutex]() -> Task<Database_return_t> {
-            std::unique_lock l(*storage_mutex);
-            if (!(*evaluated)) {
-                *evaluated = true;
-                Mysql_connection *conn = nullptr;
-                bool stop = false;
-                std::unique_lock<std::mutex> r;
-                while (!stop) {
-                    std::unique_lock lock(_mutex);
-                    for (auto &i: _mysql_list) {
-                        if (!i->_busy) {
-                            r = std::unique_lock(i->_mutex);
-                            conn = i.get();
-                            conn->_busy = true;
-                            lock.unlock();
-                            try {
-                                auto temp = i->execute_prepared_statement(st, std::move(params));
-                                storage->insert(storage->end(), temp.begin(), temp.end());
-                                stop = true;
-                            } catch (const std::runtime_error &e) {
-                                conn->_busy = false;
-                                throw;
-                            }
-                            break;
-                        }
-                    }
-                    if (!stop) {
-                        lock.unlock();
-                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                    }
-                }
-                conn->_busy = false;
-            }
-            co_return *storage;
-        };
-        {
-            std::unique_lock l(_mutex);
-            _sql_queue.emplace_back(tt);
+        // std::function requires copyable callables, so the params are shared with the job
+        std::shared_ptr<Prepared_statement_params> shared_params = std::move(params);
+        Database_return_t r;
+        std::exception_ptr exception;
+        try {
+            r = co_await Database_job<Database_return_t>(this, [this, st, shared_params]() {
+                auto conn = _pool.acquire();
+                return conn->execute_prepared_statement(st, *shared_params);
+            });
+        } catch (...) {
+            exception = std::current_exception();
         }
-        _cv.notify_all();
+        queries_amount--;
+        _cv_stop.notify_all();
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        co_return r;
+    }
 
-        Database_return_t r = co_await tt();
+    Task<Database_result>
+    Database_impl::_query_prepared_statement(Prepared_statement st, std::unique_ptr<Prepared_statement_params> params) {
+        queries_amount++;
+        std::shared_ptr<Prepared_statement_params> shared_params = std::move(params);
+        Database_result r;
+        std::exception_ptr exception;
+        try {
+            r = co_await Database_job<Database_result>(this, [this, st, shared_params]() {
+                auto conn = _pool.acquire();
+                return conn->query_prepared_statement(st, *shared_params);
+            });
+        } catch (...) {
+            exception = std::current_exception();
+        }
         queries_amount--;
         _cv_stop.notify_all();
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
         co_return r;
     }
 
-    void Database_impl::_background_execute_prepared_statement(Prepared_statement p,
-                                                               std::unique_ptr<Prepared_statement_params> params) {
+    void Database_impl::enqueue_job(std::function<void()> job) {
+        {
+            std::unique_lock l(_mutex);
+            _sql_queue.push_back(std::move(job));
+        }
+        _cv.notify_one();
+    }
+
+    void Database_impl::schedule_resume(std::coroutine_handle<> h, Executor *executor) {
+        if (_scheduler) {
+            (executor ? executor : _scheduler.get())->post([h]() { h.resume(); });
+        } else {
+            h.resume();
+        }
+    }
+
+    bool Database_impl::_background_execute_prepared_statement(Prepared_statement p,
+                                                               std::unique_ptr<Prepared_statement_params> params,
+                                                               bool is_droppable) {
         {
             std::unique_lock lk(_bg_thread_stmt_mutex);
+            if (is_droppable && _is_bg_running && _bg_stmt_queue.size() >= _bg_queue_limit) {
+                // never block the caller, it is usually a D++ event thread
+                _rejected_amount++;
+                bool is_first = !_is_rejecting;
+                _is_rejecting = true;
+                lk.unlock();
+                if (is_first) {
+                    _log->error("Database: background statements queue is full (" + std::to_string(_bg_queue_limit) +
+                                "), statements are rejected until it drains");
+                }
+                return false;
+            }
+            if (_bg_stmt_queue.size() < _bg_queue_limit) {
+                _is_rejecting = false;
+            }
             _bg_stmt_queue.emplace(p, std::move(params));
             queries_amount++;
         }
 
         _cv_bg_stmt.notify_all();
+        return true;
     }
 
 
@@ -427,6 +678,7 @@ namespace gb {
 
     void Mysql_connection::connect() {
         _prepared_statements.clear();
+        _multi_row_statements.clear();
         if (_conn == nullptr) {
             _conn = mysql_init(nullptr);
             if (_conn == nullptr) {
@@ -454,7 +706,7 @@ namespace gb {
         _log = log;
         _db = db;
         _config = config;
-        _execution_thread = std::thread([this]() -> Task<void> {
+        _execution_thread = std::thread([this]() {
             while (1) {
                 std::unique_lock lk(_db->_mutex);
                 _db->_cv.wait(lk, [this] { return !_is_running || !_db->_sql_queue.empty(); });
@@ -464,12 +716,11 @@ namespace gb {
                 if (_db->_sql_queue.empty()) {
                     continue;
                 }
-                auto task = _db->_sql_queue.front();
+                auto job = std::move(_db->_sql_queue.front());
                 _db->_sql_queue.pop_front();
                 lk.unlock();
-                Database_return_t r = co_await task();
+                job();
             }
-            co_return;
         });
         connect();
     }
@@ -542,38 +793,296 @@ namespace gb {
         MYSQL_STMT *stm = _prepared_statements.at(st);
         mysql_stmt_close(stm);
         _prepared_statements.erase(st);
+        auto it = _multi_row_statements.lower_bound({st, 0});
+        while (it != _multi_row_statements.end() && it->first.first == st) {
+            mysql_stmt_close(it->second);
+            it = _multi_row_statements.erase(it);
+        }
     }
 
-    Database_return_t Mysql_connection::execute_prepared_statement(const Prepared_statement &st,
-                                                                   std::unique_ptr<Prepared_statement_params> params) {
+    MYSQL_STMT *Mysql_connection::get_multi_row_statement(const Prepared_statement &st, size_t rows) {
+        auto it = _multi_row_statements.find({st, rows});
+        if (it != _multi_row_statements.end()) {
+            return it->second;
+        }
+        std::string statement = _db->get_multi_row_statement(st, rows);
+        MYSQL_STMT *stm = mysql_stmt_init(_conn);
+        if (stm == nullptr) {
+            throw std::runtime_error("Database ERROR: mysql_stmt_init() failed.");
+        }
+        if (mysql_stmt_prepare(stm, statement.c_str(), statement.size()) != 0) {
+            std::string error_message = mysql_stmt_error(stm);
+            mysql_stmt_close(stm);
+            throw std::runtime_error("Database ERROR: Failed to create multi-row statement: " + statement +
+                                     ". MySQL error: " + error_message);
+        }
+        _multi_row_statements[{st, rows}] = stm;
+        return stm;
+    }
+
+    void Mysql_connection::execute_batched(const Prepared_statement &st, size_t rows,
+                                           Prepared_statement_params &params) {
+        if (_conn == nullptr) {
+            connect();
+        }
+        MYSQL_STMT *stmt;
+        if (rows > 1) {
+            stmt = bind_and_execute(get_multi_row_statement(st, rows), params);
+        } else {
+            stmt = bind_and_execute(st, params);
+        }
+        // drain result sets, statements run in batches (e.g. procedure calls) may still produce them
+        do {
+            mysql_stmt_free_result(stmt);
+        } while (mysql_stmt_next_result(stmt) == 0);
+    }
+
+    void Mysql_connection::begin_transaction() {
+        if (_conn == nullptr) {
+            connect();
+        }
+        if (mysql_autocommit(_conn, 0)) {
+            throw std::runtime_error("Database ERROR: Failed to start transaction: " + std::string(mysql_error(_conn)));
+        }
+    }
+
+    void Mysql_connection::commit() {
+        bool failed = mysql_commit(_conn);
+        std::string error = failed ? mysql_error(_conn) : "";
+        mysql_autocommit(_conn, 1);
+        if (failed) {
+            throw std::runtime_error("Database ERROR: Failed to commit transaction: " + error);
+        }
+    }
+
+    void Mysql_connection::rollback() noexcept {
+        if (_conn == nullptr) {
+            return;
+        }
+        mysql_rollback(_conn);
+        mysql_autocommit(_conn, 1);
+    }
+
+    MYSQL_STMT *Mysql_connection::bind_and_execute(const Prepared_statement &st, Prepared_statement_params &params) {
+        if (_conn == nullptr) {
+            connect();
+        }
+        auto it = _prepared_statements.find(st);
+        if (it == _prepared_statements.end()) {
+            _log->critical("Database Error: Unknown prepared statement");
+            throw std::runtime_error("Database Error: Unknown prepared statement");
+        }
+        return bind_and_execute(it->second, params);
+    }
+
+    MYSQL_STMT *Mysql_connection::bind_and_execute(MYSQL_STMT *stmt, Prepared_statement_params &params) {
+        MYSQL_BIND *args = dynamic_cast<Mysql_prepared_statement_params &>(params).get_binds();
+        if (args) {
+            if (mysql_stmt_bind_param(stmt, args)) {
+                _log->critical("Database Error: mysql_stmt_bind_param failed");
+                throw std::runtime_error("Database Error: mysql_stmt_bind_param failed");
+            }
+        }
+
+        if (mysql_stmt_execute(stmt)) {
+            _log->critical("Database Error: mysql_stmt_execute(), failed. Error: " +
+                           std::string(mysql_stmt_error(stmt)));
+            throw std::runtime_error("Database Error: mysql_stmt_execute(), failed. Error: " +
+                                     std::string(mysql_stmt_error(stmt)));
+        }
+        return stmt;
+    }
+
+    /**
+     * @brief Converts MYSQL_TIME to unix seconds, treating it as UTC.
+     */
+    static int64_t mysql_time_to_unix(const MYSQL_TIME &t) {
+        if (t.year == 0 || t.month == 0 || t.day == 0) {
+            return 0;
+        }
+        auto days = std::chrono::sys_days(std::chrono::year_month_day(
+            std::chrono::year(static_cast<int>(t.year)), std::chrono::month(t.month), std::chrono::day(t.day)));
+        return static_cast<int64_t>(days.time_since_epoch().count()) * 86400 + t.hour * 3600 + t.minute * 60 +
+               t.second;
+    }
+
+    Database_result Mysql_connection::query_prepared_statement(const Prepared_statement &st,
+                                                               Prepared_statement_params &params) {
+        /**
+         * @brief Output buffer of a single result column.
+         */
+        struct Column_buffer {
+            int64_t integer = 0;
+            double real = 0;
+            MYSQL_TIME time{};
+            std::vector<char> text;
+            unsigned long length = 0;
+            my_bool is_null = 0;
+            my_bool error = 0;
+        };
+
         int max_retries = 2;
         int attempts = 0;
 
         while (attempts < max_retries) {
             try {
-                if (_conn == nullptr) {
-                    connect();
-                }
-                auto args = dynamic_cast<Mysql_prepared_statement_params *>(params.get())->get_binds();
+                MYSQL_STMT *stmt = bind_and_execute(st, params);
+                Database_result result;
+                bool has_columns = false;
 
-                if (!_prepared_statements.contains(st)) {
-                    _log->critical("Database Error: Unknown prepared statement");
-                    throw std::runtime_error("Database Error: Unknown prepared statement");
-                }
-                auto *stmt = _prepared_statements[st];
-                if (!args.empty()) {
-                    if (mysql_stmt_bind_param(stmt, &args[0])) {
-                        _log->critical("Database Error: mysql_stmt_bind_param failed");
-                        throw std::runtime_error("Database Error: mysql_stmt_bind_param failed");
+                do {
+                    MYSQL_RES *meta = mysql_stmt_result_metadata(stmt);
+                    if (!meta) {
+                        continue;
+                    }
+                    unsigned int num_fields = mysql_stmt_field_count(stmt);
+                    MYSQL_FIELD *fields = mysql_fetch_fields(meta);
+
+                    // result sets of other shape (e.g. from stored procedures) are skipped
+                    if (has_columns && num_fields != result.columns_amount()) {
+                        mysql_free_result(meta);
+                        mysql_stmt_free_result(stmt);
+                        continue;
+                    }
+
+                    auto buffers = std::make_unique<Column_buffer[]>(num_fields);
+                    auto bindings = std::make_unique<MYSQL_BIND[]>(num_fields);
+                    std::memset(bindings.get(), 0, sizeof(MYSQL_BIND) * num_fields);
+
+                    for (unsigned int i = 0; i < num_fields; i++) {
+                        Database_result::Column_type type;
+                        MYSQL_BIND &b = bindings[i];
+                        Column_buffer &buf = buffers[i];
+                        switch (fields[i].type) {
+                            case MYSQL_TYPE_TINY:
+                            case MYSQL_TYPE_SHORT:
+                            case MYSQL_TYPE_INT24:
+                            case MYSQL_TYPE_LONG:
+                            case MYSQL_TYPE_LONGLONG:
+                            case MYSQL_TYPE_YEAR:
+                                b.buffer_type = MYSQL_TYPE_LONGLONG;
+                                b.buffer = &buf.integer;
+                                b.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+                                type = b.is_unsigned ? Database_result::Column_type::UNSIGNED
+                                                     : Database_result::Column_type::INTEGER;
+                                break;
+                            case MYSQL_TYPE_FLOAT:
+                            case MYSQL_TYPE_DOUBLE:
+                                b.buffer_type = MYSQL_TYPE_DOUBLE;
+                                b.buffer = &buf.real;
+                                type = Database_result::Column_type::DOUBLE;
+                                break;
+                            case MYSQL_TYPE_TIMESTAMP:
+                            case MYSQL_TYPE_DATETIME:
+                            case MYSQL_TYPE_DATE:
+                                b.buffer_type = fields[i].type;
+                                b.buffer = &buf.time;
+                                type = Database_result::Column_type::TIMESTAMP;
+                                break;
+                            default:
+                                // start small, longer values are fetched separately after truncation
+                                buf.text.resize(std::clamp<unsigned long>(fields[i].length, 1, 256));
+                                b.buffer_type = MYSQL_TYPE_STRING;
+                                b.buffer = buf.text.data();
+                                b.buffer_length = buf.text.size();
+                                type = Database_result::Column_type::STRING;
+                        }
+                        b.is_null = &buf.is_null;
+                        b.length = &buf.length;
+                        b.error = &buf.error;
+                        if (!has_columns) {
+                            result.add_column(fields[i].name ? fields[i].name : "", type);
+                        }
+                    }
+                    has_columns = true;
+
+                    if (mysql_stmt_bind_result(stmt, bindings.get())) {
+                        mysql_free_result(meta);
+                        _log->critical("Database ERROR: mysql_stmt_bind_result failed: " +
+                                       std::string(mysql_stmt_error(stmt)));
+                        throw std::runtime_error("Database ERROR: mysql_stmt_bind_result failed: " +
+                                                 std::string(mysql_stmt_error(stmt)));
+                    }
+
+                    while (true) {
+                        int fetch_result = mysql_stmt_fetch(stmt);
+                        if (fetch_result == MYSQL_NO_DATA) {
+                            break;
+                        }
+                        if (fetch_result != 0 && fetch_result != MYSQL_DATA_TRUNCATED) {
+                            mysql_free_result(meta);
+                            _log->critical("Database ERROR: " + std::string(mysql_stmt_error(stmt)));
+                            throw std::runtime_error("Database ERROR: " + std::string(mysql_stmt_error(stmt)));
+                        }
+
+                        for (unsigned int i = 0; i < num_fields; i++) {
+                            Column_buffer &buf = buffers[i];
+                            if (buf.is_null) {
+                                result.push_null(i);
+                                continue;
+                            }
+                            switch (result.get_column_type(i)) {
+                                case Database_result::Column_type::INTEGER:
+                                case Database_result::Column_type::UNSIGNED:
+                                    result.push_integer(i, buf.integer);
+                                    break;
+                                case Database_result::Column_type::DOUBLE:
+                                    result.push_double(i, buf.real);
+                                    break;
+                                case Database_result::Column_type::TIMESTAMP:
+                                    result.push_integer(i, mysql_time_to_unix(buf.time));
+                                    break;
+                                case Database_result::Column_type::STRING:
+                                    if (buf.length > buf.text.size()) {
+                                        std::vector<char> full(buf.length);
+                                        MYSQL_BIND column_bind{};
+                                        column_bind.buffer_type = MYSQL_TYPE_STRING;
+                                        column_bind.buffer = full.data();
+                                        column_bind.buffer_length = full.size();
+                                        if (mysql_stmt_fetch_column(stmt, &column_bind, i, 0)) {
+                                            mysql_free_result(meta);
+                                            throw std::runtime_error("Database ERROR: mysql_stmt_fetch_column failed: " +
+                                                                     std::string(mysql_stmt_error(stmt)));
+                                        }
+                                        result.push_string(i, std::string_view(full.data(), full.size()));
+                                    } else {
+                                        result.push_string(i, std::string_view(buf.text.data(), buf.length));
+                                    }
+                                    break;
+                            }
+                        }
+                        result.finish_row();
                     }
-                }
 
-                if (mysql_stmt_execute(stmt)) {
-                    _log->critical("Database Error: mysql_stmt_execute(), failed. Error: " +
-                                   std::string(mysql_stmt_error(stmt)));
-                    throw std::runtime_error("Database Error: mysql_stmt_execute(), failed. Error: " +
-                                             std::string(mysql_stmt_error(stmt)));
+                    mysql_free_result(meta);
+
+                    // Proceed to the next result set if available
+                } while (mysql_stmt_next_result(stmt) == 0);
+
+                return result;
+
+            } catch (const std::runtime_error &e) {
+                // Check if the error is due to connection lost
+                if (std::string(e.what()).find("Lost connection") != std::string::npos) {
+                    _log->warn("Connection lost, attempting to reconnect...");
+                    connect(); // Attempt to reconnect
+                    attempts++;
+                } else {
+                    throw; // Rethrow the exception if it's not related to connection lost
                 }
+            }
+        }
+        throw std::runtime_error("Database Error: Max retries reached. Unable to execute statement.");
+    }
+
+    Database_return_t Mysql_connection::execute_prepared_statement(const Prepared_statement &st,
+                                                                   Prepared_statement_params &params) {
+        int max_retries = 2;
+        int attempts = 0;
+
+        while (attempts < max_retries) {
+            try {
+                MYSQL_STMT *stmt = bind_and_execute(st, params);
 
                 Database_return_t storage{};
 
@@ -660,18 +1169,232 @@ namespace gb {
     }
 
 
-    void Mysql_prepared_statement_params::add_param(const std::string &param) {
-        MYSQL_BIND bind{};
-        _string_data.push_back(param); // Store the string in the container
-        auto &stored_string = _string_data.back();
-        bind.buffer_type = MYSQL_TYPE_VAR_STRING;
-        bind.buffer = const_cast<char *>(stored_string.c_str());
-        bind.is_null = 0;
-        bind.is_null_value = false;
-        bind.buffer_length = stored_string.length();
-        _binds.push_back(bind);
-        // std::cout<<std::string((char*)_binds.back().buffer,(_binds.back().buffer_length)) << std::endl;
+    std::pair<MYSQL_BIND &, Mysql_prepared_statement_params::Param_slot &>
+    Mysql_prepared_statement_params::next_param() {
+        size_t index = _size++;
+        if (index < inline_capacity) {
+            _inline_binds[index] = MYSQL_BIND{};
+            return {_inline_binds[index], _inline_slots[index]};
+        }
+        if (_overflow_binds.empty()) {
+            _overflow_binds.assign(_inline_binds.begin(), _inline_binds.end());
+        }
+        // inline binds keep pointing at inline slots, only the array holding them grows
+        _overflow_binds.push_back(MYSQL_BIND{});
+        return {_overflow_binds.back(), _overflow_slots.emplace_back()};
+    }
+
+    void Mysql_prepared_statement_params::add_param(std::string_view param) {
+        auto [bind, slot] = next_param();
+        slot.data.assign(param);
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = slot.data.data();
+        bind.buffer_length = slot.data.size();
     }
 
-    std::vector<MYSQL_BIND> Mysql_prepared_statement_params::get_binds() { return _binds; }
+    void Mysql_prepared_statement_params::add_null_param() {
+        auto [bind, slot] = next_param();
+        bind.buffer_type = MYSQL_TYPE_NULL;
+    }
+
+    void Mysql_prepared_statement_params::add_int_param(int64_t param) {
+        auto [bind, slot] = next_param();
+        slot.integer = param;
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &slot.integer;
+    }
+
+    void Mysql_prepared_statement_params::add_unsigned_param(uint64_t param) {
+        auto [bind, slot] = next_param();
+        slot.integer = static_cast<int64_t>(param);
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &slot.integer;
+        bind.is_unsigned = 1;
+    }
+
+    void Mysql_prepared_statement_params::add_double_param(double param) {
+        auto [bind, slot] = next_param();
+        slot.real = param;
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = &slot.real;
+    }
+
+    void Mysql_prepared_statement_params::add_datetime_param(std::chrono::sys_seconds param) {
+        auto [bind, slot] = next_param();
+        auto days = std::chrono::floor<std::chrono::days>(param);
+        std::chrono::year_month_day ymd(days);
+        std::chrono::hh_mm_ss hms(param - days);
+        slot.time = MYSQL_TIME{};
+        slot.time.year = static_cast<int>(ymd.year());
+        slot.time.month = static_cast<unsigned>(ymd.month());
+        slot.time.day = static_cast<unsigned>(ymd.day());
+        slot.time.hour = hms.hours().count();
+        slot.time.minute = hms.minutes().count();
+        slot.time.second = hms.seconds().count();
+        slot.time.time_type = MYSQL_TIMESTAMP_DATETIME;
+        bind.buffer_type = MYSQL_TYPE_DATETIME;
+        bind.buffer = &slot.time;
+    }
+
+    void Mysql_prepared_statement_params::add_blob_param(std::span<const std::byte> param) {
+        auto [bind, slot] = next_param();
+        slot.data.assign(reinterpret_cast<const char *>(param.data()), param.size());
+        bind.buffer_type = MYSQL_TYPE_BLOB;
+        bind.buffer = slot.data.data();
+        bind.buffer_length = slot.data.size();
+    }
+
+    void Mysql_prepared_statement_params::append(Mysql_prepared_statement_params &other) {
+        MYSQL_BIND *binds = other.get_binds();
+        for (size_t i = 0; i < other._size; i++) {
+            const MYSQL_BIND &b = binds[i];
+            switch (b.buffer_type) {
+                case MYSQL_TYPE_NULL:
+                    add_null_param();
+                    break;
+                case MYSQL_TYPE_LONGLONG:
+                    if (b.is_unsigned) {
+                        add_unsigned_param(static_cast<uint64_t>(*static_cast<int64_t *>(b.buffer)));
+                    } else {
+                        add_int_param(*static_cast<int64_t *>(b.buffer));
+                    }
+                    break;
+                case MYSQL_TYPE_DOUBLE:
+                    add_double_param(*static_cast<double *>(b.buffer));
+                    break;
+                case MYSQL_TYPE_DATETIME: {
+                    auto [bind, slot] = next_param();
+                    slot.time = *static_cast<MYSQL_TIME *>(b.buffer);
+                    bind.buffer_type = MYSQL_TYPE_DATETIME;
+                    bind.buffer = &slot.time;
+                    break;
+                }
+                case MYSQL_TYPE_BLOB:
+                    add_blob_param(std::as_bytes(std::span(static_cast<const char *>(b.buffer), b.buffer_length)));
+                    break;
+                default:
+                    add_param(std::string_view(static_cast<const char *>(b.buffer), b.buffer_length));
+            }
+        }
+    }
+
+    MYSQL_BIND *Mysql_prepared_statement_params::get_binds() {
+        if (_size == 0) {
+            return nullptr;
+        }
+        return _size <= inline_capacity ? _inline_binds.data() : _overflow_binds.data();
+    }
+
+    Mysql_connection_lease::Mysql_connection_lease(Mysql_connection_pool *pool, Mysql_connection *conn) :
+        _pool(pool), _conn(conn), _conn_lock(conn->_mutex) {
+        _conn->_busy = true;
+    }
+
+    Mysql_connection_lease::Mysql_connection_lease(Mysql_connection_lease &&other) noexcept :
+        _pool(other._pool), _conn(other._conn), _conn_lock(std::move(other._conn_lock)) {
+        other._pool = nullptr;
+        other._conn = nullptr;
+    }
+
+    Mysql_connection_lease::~Mysql_connection_lease() {
+        if (!_conn) {
+            return;
+        }
+        _conn->_busy = false;
+        _conn_lock.unlock();
+        _pool->release(_conn);
+    }
+
+    void Mysql_connection_pool::record_wait(uint64_t wait_us) {
+        _acquired_amount++;
+        _total_wait_us += wait_us;
+        uint64_t prev_max = _max_wait_us.load();
+        while (prev_max < wait_us && !_max_wait_us.compare_exchange_weak(prev_max, wait_us)) {
+        }
+        size_t bucket = 0;
+        while (bucket < histogram_bounds_us.size() && wait_us >= histogram_bounds_us[bucket]) {
+            bucket++;
+        }
+        _wait_histogram[bucket]++;
+    }
+
+    void Mysql_connection_pool::set_max_wait(std::chrono::milliseconds max_wait) { _max_wait_ms = max_wait.count(); }
+
+    void Mysql_connection_pool::add(Mysql_connection *conn) {
+        {
+            std::unique_lock lk(_mutex);
+            _connections_amount++;
+        }
+        release(conn);
+    }
+
+    void Mysql_connection_pool::clear() {
+        std::unique_lock lk(_mutex);
+        _idle.clear();
+        _connections_amount = 0;
+    }
+
+    Mysql_connection_lease Mysql_connection_pool::acquire() {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_lock lk(_mutex);
+        if (_waiters.empty() && !_idle.empty()) {
+            Mysql_connection *conn = _idle.front();
+            _idle.pop_front();
+            lk.unlock();
+            record_wait(0);
+            return {this, conn};
+        }
+
+        Waiter waiter;
+        _waiters.push_back(&waiter);
+        _waited_amount++;
+        auto max_wait = std::chrono::milliseconds(_max_wait_ms.load());
+        auto handed_over = [&waiter] { return waiter.conn != nullptr; };
+        if (max_wait.count() > 0) {
+            if (!waiter.cv.wait_until(lk, start + max_wait, handed_over)) {
+                _waiters.remove(&waiter);
+                _timeouts_amount++;
+                throw std::runtime_error("Database ERROR: no free connection in pool after waiting " +
+                                         std::to_string(max_wait.count()) + " ms");
+            }
+        } else {
+            waiter.cv.wait(lk, handed_over);
+        }
+        lk.unlock();
+        record_wait(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        return {this, waiter.conn};
+    }
+
+    void Mysql_connection_pool::release(Mysql_connection *conn) {
+        std::unique_lock lk(_mutex);
+        if (_waiters.empty()) {
+            _idle.push_back(conn);
+            return;
+        }
+        Waiter *waiter = _waiters.front();
+        _waiters.pop_front();
+        waiter->conn = conn;
+        // notify under lock, waiter object lives on the waiting thread's stack
+        waiter->cv.notify_one();
+    }
+
+    Mysql_connection_pool_stats Mysql_connection_pool::get_stats() {
+        Mysql_connection_pool_stats stats;
+        {
+            std::unique_lock lk(_mutex);
+            stats.connections_amount = _connections_amount;
+            stats.idle_amount = _idle.size();
+            stats.waiters_amount = _waiters.size();
+        }
+        stats.acquired_amount = _acquired_amount;
+        stats.waited_amount = _waited_amount;
+        stats.timeouts_amount = _timeouts_amount;
+        stats.total_wait_us = _total_wait_us;
+        stats.max_wait_us = _max_wait_us;
+        for (size_t i = 0; i < _wait_histogram.size(); i++) {
+            stats.wait_histogram[i] = _wait_histogram[i];
+        }
+        return stats;
+    }
 } // namespace gb
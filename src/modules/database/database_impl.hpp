@@ -9,6 +9,11 @@
 #include "src/modules/config/config.hpp"
 #include "src/modules/logging/logging.hpp"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
 #include <list>
 #include <memory>
@@ -35,14 +40,48 @@ namespace gb {
      * @brief This class implements the Prepared_statement_params interface for MySQL prepared statements.
      *
      * The Mysql_prepared_statement_params class is responsible for managing the parameters
-     * used in MySQL prepared statements. It stores the parameters and provides methods to
-     * add new parameters and retrieve the stored parameters in a format suitable for MySQL
-     * operations.
+     * used in MySQL prepared statements. Values are stored in their native form next to
+     * the MYSQL_BIND structures pointing at them. The first inline_capacity parameters live
+     * in fixed arrays inside the object, so typical statements do not allocate per parameter.
      */
     class Mysql_prepared_statement_params : public Prepared_statement_params {
-        std::vector<MYSQL_BIND> _binds; ///< Container to hold the MySQL bind structures.
-        std::list<std::string> _string_data; ///< Container to hold the string data for the parameters.
     public:
+        /**
+         * @brief Amount of parameters stored without additional allocations.
+         */
+        static constexpr size_t inline_capacity = 8;
+
+    private:
+        /**
+         * @brief Storage of a single parameter value, referenced by its MYSQL_BIND.
+         */
+        struct Param_slot {
+            int64_t integer = 0; ///< Value of integer parameters (unsigned ones are bit cast).
+            double real = 0; ///< Value of floating point parameters.
+            MYSQL_TIME time{}; ///< Value of DATETIME parameters.
+            std::string data; ///< Value of text and binary parameters.
+        };
+
+        std::array<Param_slot, inline_capacity> _inline_slots{}; ///< Storage of the first parameters.
+        std::array<MYSQL_BIND, inline_capacity> _inline_binds{}; ///< Binds of the first parameters.
+        std::deque<Param_slot> _overflow_slots; ///< Storage of further parameters, deque keeps addresses stable.
+        std::vector<MYSQL_BIND> _overflow_binds; ///< All binds, filled only once inline capacity is exceeded.
+        size_t _size = 0; ///< Amount of added parameters.
+
+        /**
+         * @brief Reserves slot and bind for the next parameter.
+         *
+         * @return Pair of the new (zeroed) bind and its value storage.
+         */
+        std::pair<MYSQL_BIND &, Param_slot &> next_param();
+
+    public:
+        Mysql_prepared_statement_params() = default;
+
+        // Binds point into the object itself
+        Mysql_prepared_statement_params(const Mysql_prepared_statement_params &) = delete;
+        Mysql_prepared_statement_params &operator=(const Mysql_prepared_statement_params &) = delete;
+
         /**
          * @brief Destructor for Mysql_prepared_statement_params.
          *
@@ -52,24 +91,72 @@ namespace gb {
         virtual ~Mysql_prepared_statement_params() = default;
 
         /**
-         * @brief Adds a parameter to the prepared statement.
+         * @brief Adds text parameter, bound as MYSQL_TYPE_STRING.
          *
-         * This method adds a parameter to the MySQL prepared statement by storing
-         * the parameter string and creating a corresponding MYSQL_BIND structure.
+         * @param param The parameter to add.
+         */
+        void add_param(std::string_view param) override;
+
+        /**
+         * @brief Adds NULL parameter, bound as MYSQL_TYPE_NULL.
+         */
+        void add_null_param() override;
+
+        /**
+         * @brief Adds signed integer parameter, bound as MYSQL_TYPE_LONGLONG.
          *
-         * @param param The parameter to add, represented as a string.
+         * @param param The parameter to add.
          */
-        void add_param(const std::string &param) override;
+        void add_int_param(int64_t param) override;
 
         /**
-         * @brief Retrieves the stored parameters as a vector of MYSQL_BIND structures.
+         * @brief Adds unsigned integer parameter, bound as unsigned MYSQL_TYPE_LONGLONG.
          *
-         * This method returns the parameters stored in the class in a format that
-         * can be used with MySQL prepared statements.
+         * @param param The parameter to add.
+         */
+        void add_unsigned_param(uint64_t param) override;
+
+        /**
+         * @brief Adds floating point parameter, bound as MYSQL_TYPE_DOUBLE.
          *
-         * @return A vector of MYSQL_BIND structures representing the stored parameters.
+         * @param param The parameter to add.
          */
-        std::vector<MYSQL_BIND> get_binds();
+        void add_double_param(double param) override;
+
+        /**
+         * @brief Adds DATETIME parameter, bound as MYSQL_TYPE_DATETIME in UTC.
+         *
+         * @param param The parameter to add.
+         */
+        void add_datetime_param(std::chrono::sys_seconds param) override;
+
+        /**
+         * @brief Adds binary parameter, bound as MYSQL_TYPE_BLOB.
+         *
+         * @param param The parameter to add.
+         */
+        void add_blob_param(std::span<const std::byte> param) override;
+
+        /**
+         * @brief Appends copies of all parameters of another object, used to build multi-row statements.
+         *
+         * @param other Parameters to copy.
+         */
+        void append(Mysql_prepared_statement_params &other);
+
+        /**
+         * @brief Gets amount of added parameters.
+         */
+        size_t size() const { return _size; }
+
+        /**
+         * @brief Retrieves the stored parameters as a contiguous array of MYSQL_BIND structures.
+         *
+         * The returned pointer is valid until the next parameter is added or the object is destroyed.
+         *
+         * @return Pointer to size() MYSQL_BIND structures, nullptr if there are no parameters.
+         */
+        MYSQL_BIND *get_binds();
     };
 
     /**
@@ -104,10 +191,39 @@ namespace gb {
          */
         void _prepare_statement(const Prepared_statement &st);
 
+        /**
+         * @brief Binds parameters to a prepared statement and executes it.
+         *
+         * @param st The prepared statement to execute
+         * @param params The parameters for the prepared statement
+         * @return Executed statement, ready for fetching results
+         */
+        MYSQL_STMT *bind_and_execute(const Prepared_statement &st, Prepared_statement_params &params);
+
+        /**
+         * @brief Binds parameters to a statement handle and executes it.
+         *
+         * @param stmt Statement handle to execute
+         * @param params The parameters for the statement
+         * @return Executed statement, ready for fetching results
+         */
+        MYSQL_STMT *bind_and_execute(MYSQL_STMT *stmt, Prepared_statement_params &params);
+
+        /**
+         * @brief Gets (preparing on first use) multi-row variant of a single row insert statement.
+         *
+         * @param st The single row prepared statement
+         * @param rows Amount of rows inserted by the variant
+         * @return Statement handle owned by this connection
+         */
+        MYSQL_STMT *get_multi_row_statement(const Prepared_statement &st, size_t rows);
+
     public:
         std::mutex _mutex; ///< Mutex to protect shared resources
         std::atomic_bool _busy = false; ///< Atomic flag indicating if the connection is busy
         std::map<Prepared_statement, MYSQL_STMT *> _prepared_statements; ///< Map of prepared statements
+        std::map<std::pair<Prepared_statement, size_t>, MYSQL_STMT *>
+            _multi_row_statements; ///< Multi-row insert variants by statement and rows amount
 
         /**
          * @brief Constructor for Mysql_connection.
@@ -150,8 +266,45 @@ namespace gb {
          * @param params The parameters for the prepared statement
          * @return The result of the query as a Database_return_t
          */
-        Database_return_t execute_prepared_statement(const Prepared_statement &st,
-                                                     std::unique_ptr<Prepared_statement_params> params);
+        Database_return_t execute_prepared_statement(const Prepared_statement &st, Prepared_statement_params &params);
+
+        /**
+         * @brief Executes a prepared statement, binding result columns into native typed buffers.
+         *
+         * Rows of all result sets with the same column count as the first one are collected.
+         *
+         * @param st The prepared statement to execute
+         * @param params The parameters for the prepared statement
+         * @return The result of the query as a Database_result
+         */
+        Database_result query_prepared_statement(const Prepared_statement &st, Prepared_statement_params &params);
+
+        /**
+         * @brief Executes a statement of a background batch, discarding its results.
+         *
+         * Unlike execute_prepared_statement it does not reconnect on failure, since a reconnect
+         * would silently drop the open transaction.
+         *
+         * @param st The prepared statement to execute
+         * @param rows Amount of rows in params, more than one selects the multi-row insert variant
+         * @param params The parameters for all rows
+         */
+        void execute_batched(const Prepared_statement &st, size_t rows, Prepared_statement_params &params);
+
+        /**
+         * @brief Disables autocommit, starting a transaction.
+         */
+        void begin_transaction();
+
+        /**
+         * @brief Commits current transaction and restores autocommit.
+         */
+        void commit();
+
+        /**
+         * @brief Rolls back current transaction and restores autocommit. Never throws.
+         */
+        void rollback() noexcept;
 
         /**
          * @brief Prepares a MySQL statement.
@@ -172,12 +325,212 @@ namespace gb {
         void remove_statement(const Prepared_statement &st);
     };
 
+    class Mysql_connection_pool;
+
     /**
-     * @brief Represents a queue of database tasks.
+     * @class Mysql_connection_lease
+     * @brief RAII handle for a connection taken from Mysql_connection_pool.
      *
-     * Stores functions that return a Task representing a database operation.
+     * Holds the connection mutex while leased and hands the connection back to the pool
+     * (or directly to the next waiter) on destruction.
      */
-    typedef std::list<std::function<Task<Database_return_t>()>> Database_queue;
+    class Mysql_connection_lease {
+        Mysql_connection_pool *_pool = nullptr; ///< Pool the connection is returned to.
+        Mysql_connection *_conn = nullptr; ///< Leased connection.
+        std::unique_lock<std::mutex> _conn_lock; ///< Lock on the leased connection mutex.
+
+    public:
+        /**
+         * @brief Constructs a lease for an already acquired connection.
+         *
+         * @param pool Pool the connection belongs to.
+         * @param conn Connection taken from the pool.
+         */
+        Mysql_connection_lease(Mysql_connection_pool *pool, Mysql_connection *conn);
+
+        Mysql_connection_lease(const Mysql_connection_lease &) = delete;
+        Mysql_connection_lease &operator=(const Mysql_connection_lease &) = delete;
+        Mysql_connection_lease(Mysql_connection_lease &&other) noexcept;
+        Mysql_connection_lease &operator=(Mysql_connection_lease &&other) = delete;
+
+        /**
+         * @brief Returns the connection to the pool.
+         */
+        ~Mysql_connection_lease();
+
+        /**
+         * @brief Access to the leased connection.
+         */
+        Mysql_connection *operator->() const { return _conn; }
+
+        /**
+         * @brief Gets raw pointer to the leased connection.
+         */
+        Mysql_connection *get() const { return _conn; }
+    };
+
+    /**
+     * @brief Snapshot of connection pool counters, used for admin terminal output.
+     */
+    struct Mysql_connection_pool_stats {
+        size_t connections_amount = 0; ///< Total connections registered in pool.
+        size_t idle_amount = 0; ///< Connections currently in the free list.
+        size_t waiters_amount = 0; ///< Queries currently waiting for a connection.
+        uint64_t acquired_amount = 0; ///< Total successful acquisitions.
+        uint64_t waited_amount = 0; ///< Acquisitions which had to wait for a connection.
+        uint64_t timeouts_amount = 0; ///< Acquisitions which failed because of max wait.
+        uint64_t total_wait_us = 0; ///< Sum of wait time of all acquisitions in microseconds.
+        uint64_t max_wait_us = 0; ///< Longest single wait in microseconds.
+        std::array<uint64_t, 8> wait_histogram{}; ///< Wait time distribution, see Mysql_connection_pool::histogram_bounds_us.
+    };
+
+    /**
+     * @class Mysql_connection_pool
+     * @brief Free list of idle MySQL connections with FIFO handoff to waiting queries.
+     *
+     * Queries take a connection from the idle list if nobody is queued before them, otherwise they
+     * enqueue themselves and sleep on their own condition variable. Released connections are handed
+     * directly to the oldest waiter, so no query can be overtaken by a later one.
+     */
+    class Mysql_connection_pool {
+    public:
+        /**
+         * @brief Upper bounds (exclusive) of wait histogram buckets in microseconds, last bucket is unbounded.
+         */
+        static constexpr std::array<uint64_t, 7> histogram_bounds_us = {100, 1000, 5000, 10000, 50000, 100000, 1000000};
+
+    private:
+        /**
+         * @brief Query waiting for a free connection.
+         */
+        struct Waiter {
+            Mysql_connection *conn = nullptr; ///< Connection handed over by release().
+            std::condition_variable cv; ///< Signalled on handoff.
+        };
+
+        std::mutex _mutex; ///< Protects idle list, waiters queue and connections counter.
+        std::deque<Mysql_connection *> _idle; ///< Free list of idle connections.
+        std::list<Waiter *> _waiters; ///< FIFO queue of waiting queries.
+        size_t _connections_amount = 0; ///< Amount of connections registered in pool.
+        std::atomic<std::chrono::milliseconds::rep> _max_wait_ms = 0; ///< Max wait for connection, 0 means unlimited.
+
+        std::atomic_uint64_t _acquired_amount = 0; ///< Counter of successful acquisitions.
+        std::atomic_uint64_t _waited_amount = 0; ///< Counter of acquisitions which had to wait.
+        std::atomic_uint64_t _timeouts_amount = 0; ///< Counter of acquisitions that hit max wait.
+        std::atomic_uint64_t _total_wait_us = 0; ///< Sum of wait times.
+        std::atomic_uint64_t _max_wait_us = 0; ///< Longest observed wait.
+        std::array<std::atomic_uint64_t, 8> _wait_histogram{}; ///< Wait time distribution.
+
+        /**
+         * @brief Records acquisition wait time in metrics.
+         *
+         * @param wait_us Time spent waiting in microseconds.
+         */
+        void record_wait(uint64_t wait_us);
+
+    public:
+        /**
+         * @brief Sets maximum time a query may wait for a connection.
+         *
+         * @param max_wait Max wait, zero disables the limit.
+         */
+        void set_max_wait(std::chrono::milliseconds max_wait);
+
+        /**
+         * @brief Registers a new connection in the pool, giving it to a waiter if any.
+         *
+         * @param conn Connection to add. Ownership stays with the caller.
+         */
+        void add(Mysql_connection *conn);
+
+        /**
+         * @brief Forgets all connections. Must be called before the connections are destroyed.
+         */
+        void clear();
+
+        /**
+         * @brief Takes a connection, blocking in FIFO order until one is free.
+         *
+         * @return Lease which returns the connection to the pool when destroyed.
+         * @throws std::runtime_error if max wait is configured and exceeded.
+         */
+        Mysql_connection_lease acquire();
+
+        /**
+         * @brief Returns connection to the pool, handing it to the oldest waiter if any.
+         *
+         * @param conn Connection to return.
+         */
+        void release(Mysql_connection *conn);
+
+        /**
+         * @brief Gets snapshot of pool counters.
+         *
+         * @return Pool statistics.
+         */
+        Mysql_connection_pool_stats get_stats();
+    };
+
+    /**
+     * @brief Snapshot of background statements batching counters, used for admin terminal output.
+     */
+    struct Database_batch_stats {
+        uint64_t batches_amount = 0; ///< Flushed batches.
+        uint64_t statements_amount = 0; ///< Statements executed through batches.
+        uint64_t merged_rows_amount = 0; ///< Statements merged into multi-row inserts.
+        uint64_t failed_batches_amount = 0; ///< Batches rolled back and retried one by one.
+        uint64_t failed_statements_amount = 0; ///< Statements which failed even when executed alone.
+        uint64_t rejected_amount = 0; ///< Statements rejected because the queue was full.
+        size_t queue_size = 0; ///< Statements currently queued.
+    };
+
+    /**
+     * @brief Background prepared statement waiting to be batched.
+     */
+    typedef std::pair<Prepared_statement, std::unique_ptr<Prepared_statement_params>> Background_statement;
+
+    /**
+     * @brief Represents a queue of database jobs.
+     *
+     * Stores blocking database operations, picked up by connection worker threads.
+     */
+    typedef std::list<std::function<void()>> Database_queue;
+
+    /**
+     * @class Database_job
+     * @brief Awaitable which runs blocking database work on a connection worker thread.
+     *
+     * The awaiting coroutine is suspended while the work runs and then resumed on the executor
+     * it awaited on (D++ event threads for command handlers), falling back to the database scheduler,
+     * so neither the caller thread nor the worker is held by it.
+     *
+     * @tparam R Result type of the work.
+     */
+    template<typename R>
+    class Database_job {
+        Database_impl *_db; ///< Database which owns workers and scheduler.
+        std::function<R()> _work; ///< Blocking work to run.
+        R _result; ///< Result of the work.
+        std::exception_ptr _exception; ///< Exception thrown by the work, if any.
+
+    public:
+        /**
+         * @brief Constructs the job, it is queued once awaited.
+         *
+         * @param db Database to run the job on.
+         * @param work Blocking work to run on a worker thread.
+         */
+        Database_job(Database_impl *db, std::function<R()> work) : _db(db), _work(std::move(work)) {}
+
+        bool await_ready() { return false; }
+        void await_suspend(std::coroutine_handle<> h);
+        R await_resume() {
+            if (_exception) {
+                std::rethrow_exception(_exception);
+            }
+            return std::move(_result);
+        }
+    };
 
 
     /**
@@ -188,25 +541,50 @@ namespace gb {
      * Provides asynchronous execution of queries and supports background task execution.
      */
     class Database_impl : public Database {
+    public:
+        /**
+         * @brief Single row insert split into parts used to generate multi-row variants.
+         */
+        struct Multi_row_insert {
+            std::string head; ///< Statement up to and including VALUES.
+            std::string row; ///< Parenthesized row tuple.
+            size_t row_params_amount = 0; ///< Placeholders in the row.
+        };
+
     private:
         Logging_ptr _log; ///< Pointer to the logging module
         Config_ptr _config; ///< Pointer to the configuration module
         Admin_terminal_ptr _admin_terminal; ///< Pointer to the admin terminal module
         std::vector<std::unique_ptr<Mysql_connection>> _mysql_list{}; ///< List of MySQL connections
+        Mysql_connection_pool _pool; ///< Free list of connections from _mysql_list
         std::atomic_size_t queries_amount = 0; ///< Atomic counter for active queries
         std::condition_variable _cv_stop; ///< Condition variable for stopping background tasks
         std::thread _bg_thread; ///< Thread for background task execution
         std::queue<std::string> _bg_queue; ///< Queue of background SQL queries
         std::thread _bg_stmt_thread; ///< Thread for background prepared statements execution
-        std::queue<std::pair<Prepared_statement, std::unique_ptr<Prepared_statement_params>>>
-            _bg_stmt_queue; ///< Queue of background prepared statements queries
+        std::queue<Background_statement> _bg_stmt_queue; ///< Queue of background prepared statements queries
         bool _is_bg_running = true; ///< Flag indicating if background tasks are running
         std::condition_variable _cv_bg; ///< Condition variable for background task execution
         std::mutex _bg_thread_mutex; ///< Mutex for _bg_queue access synchronization
         std::condition_variable _cv_bg_stmt; ///< Condition variable for background prepared statements execution
         std::mutex _bg_thread_stmt_mutex; ///< Mutex for _bg_stmt_queue access synchronization
+        std::atomic_size_t _bg_batch_size = 64; ///< Max statements flushed in one batch
+        std::atomic_size_t _bg_batch_window_ms = 10; ///< Time to wait for a batch to fill up
+        std::atomic_size_t _bg_queue_limit = 10000; ///< Queue length at which droppable statements are rejected
+
+        std::atomic_uint64_t _batches_amount = 0; ///< Counter of flushed batches
+        std::atomic_uint64_t _batched_statements_amount = 0; ///< Counter of statements executed in batches
+        std::atomic_uint64_t _merged_rows_amount = 0; ///< Counter of statements merged into multi-row inserts
+        std::atomic_uint64_t _failed_batches_amount = 0; ///< Counter of rolled back batches
+        std::atomic_uint64_t _failed_statements_amount = 0; ///< Counter of failed background statements
+        std::atomic_uint64_t _rejected_amount = 0; ///< Counter of statements rejected on full queue
+        bool _is_rejecting = false; ///< Queue is full, set to log only the first rejection of an overflow
+
         std::map<Prepared_statement, std::string> _prepared_statements; ///< Map of prepared statements
+        std::map<Prepared_statement, Multi_row_insert>
+            _multi_row_inserts; ///< Statements which can be merged into multi-row inserts
         std::shared_mutex _prepared_statements_mutex; ///< Mutex for _prepared_statements access synchronization
+        std::unique_ptr<Thread_pool> _scheduler; ///< Pool resuming coroutines after their queries finished
         size_t _prepared_statements_index = 0; ///< Index for generating prepared statement identifiers
 
         /**
@@ -214,6 +592,17 @@ namespace gb {
          */
         void new_connection();
 
+        /**
+         * @brief Executes batch of background statements in one transaction.
+         *
+         * Consecutive rows of the same mergeable insert are sent as multi-row inserts. If the
+         * transaction fails it is rolled back and statements are retried one by one, so a single
+         * bad statement does not drop the whole batch.
+         *
+         * @param batch Statements in queue order.
+         */
+        void flush_background_batch(std::vector<Background_statement> &batch);
+
     protected:
         /**
          * @brief Creates a new Prepared_statement_params object.
@@ -237,14 +626,43 @@ namespace gb {
          *
          * @param p The prepared statement to execute
          * @param params The parameters for the prepared statement
+         * @param is_droppable Drop the statement if the queue is full, otherwise queue it past the limit
+         * @return False if the queue is full and the statement was dropped
+         */
+        bool _background_execute_prepared_statement(Prepared_statement p,
+                                                    std::unique_ptr<Prepared_statement_params> params,
+                                                    bool is_droppable) override;
+
+        /**
+         * @brief Executes a prepared statement asynchronously with typed result.
+         *
+         * @param st The prepared statement to execute
+         * @param params The parameters for the prepared statement
+         * @return A Task that, when awaited, returns the result of the query as a Database_result.
          */
-        void _background_execute_prepared_statement(Prepared_statement p,
-                                                    std::unique_ptr<Prepared_statement_params> params) override;
+        Task<Database_result> _query_prepared_statement(Prepared_statement st,
+                                                        std::unique_ptr<Prepared_statement_params> params) override;
 
     public:
         std::mutex _mutex; ///< Mutex for _sql_queue access synchronization
         std::condition_variable _cv; ///< Condition variable for task execution
-        Database_queue _sql_queue; ///< Queue of database tasks
+        Database_queue _sql_queue; ///< Queue of database jobs
+
+        /**
+         * @brief Queues blocking job for connection worker threads.
+         *
+         * @param job Job to run.
+         */
+        void enqueue_job(std::function<void()> job);
+
+        /**
+         * @brief Resumes coroutine on the executor it was suspended on, on the scheduler if it has none,
+         * or inline if the module is not running.
+         *
+         * @param h Coroutine to resume.
+         * @param executor Executor of the thread which awaited the job, may be nullptr.
+         */
+        void schedule_resume(std::coroutine_handle<> h, Executor *executor);
 
         /**
          * @brief Constructor for Database_impl.
@@ -326,8 +744,45 @@ namespace gb {
          * @return The SQL query of the prepared statement
          */
         std::string get_prepared_statement(const Prepared_statement &st);
+
+        /**
+         * @brief Gets amount of placeholders per row if statement is a single row insert which can be merged.
+         *
+         * @param st The identifier of the prepared statement
+         * @return Placeholders per row, nullopt if the statement can not be merged
+         */
+        std::optional<size_t> get_multi_row_params_amount(const Prepared_statement &st);
+
+        /**
+         * @brief Generates SQL inserting given amount of rows with a mergeable insert statement.
+         *
+         * @param st The identifier of the prepared statement
+         * @param rows Amount of rows
+         * @return The SQL query
+         */
+        std::string get_multi_row_statement(const Prepared_statement &st, size_t rows);
+
+        /**
+         * @brief Gets snapshot of background batching counters.
+         *
+         * @return Batching statistics.
+         */
+        Database_batch_stats get_batch_stats();
     };
 
+    template<typename R>
+    void Database_job<R>::await_suspend(std::coroutine_handle<> h) {
+        _db->enqueue_job([this, h, executor = Executor::current()]() {
+            try {
+                _result = _work();
+            } catch (...) {
+                _exception = std::current_exception();
+            }
+            // the job object lives in the suspended coroutine frame, do not touch it after this call
+            _db->schedule_resume(h, executor);
+        });
+    }
+
     /**
      * @brief Factory function to create an instance of Database_impl.
      *
@@ -32,6 +32,10 @@ namespace gb {
     /**
      * @brief Activates an achievement for a specific user within a Discord channel.
      *
+     * Ownership is checked in memory and nothing happens if user already has the achievement, so games may
+     * call it every time the achievement condition holds. Returns at once, the check and the announcement run
+     * in the background.
+     *
      * @param name The name of the achievement to activate.
      * @param user_id The ID of the Discord user for whom the achievement is activated.
      * @param channel_id The ID of the Discord channel where the activation is to be notified.
@@ -43,9 +47,9 @@ namespace gb {
      *
      * @param name The name of the achievement to check.
      * @param user_id The ID of the Discord user to check.
-     * @return True if the user has the achievement, false otherwise.
+     * @return Task resolving to true if the user has the achievement, false otherwise.
      */
-    virtual bool is_have_achievement(const std::string& name, const dpp::snowflake& user_id) = 0;
+    virtual Task<bool> is_have_achievement(const std::string& name, const dpp::snowflake& user_id) = 0;
 
 
     /**
@@ -55,9 +59,9 @@ namespace gb {
      * details) to generate an `Achievements_report` for the given Discord `snowflake` ID.
      *
      * @param user_id The Discord `snowflake` ID of the user.
-     * @return Achievements_report The achievements report for the specified user.
+     * @return Task resolving to the achievements report for the specified user.
      */
-    virtual Achievements_report get_achievements_report(const dpp::snowflake &user_id) = 0;
+    virtual Task<Achievements_report> get_achievements_report(const dpp::snowflake &user_id) = 0;
   };
 
   /**
@@ -6,10 +6,13 @@
 
 namespace gb {
     Discord_achievements_processing_impl::Discord_achievements_processing_impl() :
-        Discord_achievements_processing("discord_achievements_processing", {"achievements_processing", "discord_bot"}) {
-    }
+        Discord_achievements_processing("discord_achievements_processing",
+                                        {"achievements_processing", "discord_bot", "logging"}) {}
 
-    void Discord_achievements_processing_impl::stop() {}
+    void Discord_achievements_processing_impl::stop() {
+        std::unique_lock lk(_pending_mutex);
+        _pending_cv.wait(lk, [this]() { return _pending == 0; });
+    }
 
     void Discord_achievements_processing_impl::run() {}
 
@@ -18,37 +21,55 @@ namespace gb {
             std::static_pointer_cast<Achievements_processing>(modules.at("achievements_processing"));
 
         _bot = std::static_pointer_cast<Discord_bot>(modules.at("discord_bot"));
+        _log = std::static_pointer_cast<Logging>(modules.at("logging"));
     }
 
-    bool Discord_achievements_processing_impl::is_have_achievement(const std::string &name,
-                                                                   const dpp::snowflake &user_id) {
-        return _achievements_processing->is_have_achievement(name, user_id.str());
+    Task<bool> Discord_achievements_processing_impl::is_have_achievement(const std::string &name,
+                                                                         const dpp::snowflake &user_id) {
+        co_return co_await _achievements_processing->is_have_achievement(name, user_id.str());
     }
 
     void Discord_achievements_processing_impl::activate_achievement(const std::string &name,
                                                                     const dpp::snowflake &user_id,
                                                                     const dpp::snowflake &channel_id) {
-        if (this->is_have_achievement(name, user_id)) {
-            return;
+        {
+            std::unique_lock lk(_pending_mutex);
+            _pending++;
         }
+        // dropping the task detaches it
+        unlock_and_announce(name, user_id, channel_id);
+    }
 
-        Achievement a = _achievements_processing->activate_achievement(name, user_id.str());
+    Task<void> Discord_achievements_processing_impl::unlock_and_announce(std::string name, dpp::snowflake user_id,
+                                                                         dpp::snowflake channel_id) {
+        try {
+            std::optional<Achievement> unlocked =
+                co_await _achievements_processing->unlock_achievement(name, user_id.str());
+            if (unlocked) {
+                Achievement &a = *unlocked;
 
-        dpp::message m;
-        m.channel_id = channel_id;
-        dpp::embed embed;
-        embed.set_color(dpp::colors::gold)
-            .set_title(std::format("🎉| New {}achievement unlocked!", (a.is_secret ? "Secret " : "")))
-            .set_description(std::format("Unlocked by: {}", dpp::utility::user_mention(user_id)))
-            .add_field("Achievement", a.name)
-            .add_field("Description", a.description)
-            .set_thumbnail(a.image_url);
+                dpp::message m;
+                m.channel_id = channel_id;
+                dpp::embed embed;
+                embed.set_color(dpp::colors::gold)
+                    .set_title(std::format("🎉| New {}achievement unlocked!", (a.is_secret ? "Secret " : "")))
+                    .set_description(std::format("Unlocked by: {}", dpp::utility::user_mention(user_id)))
+                    .add_field("Achievement", a.name)
+                    .add_field("Description", a.description)
+                    .set_thumbnail(a.image_url);
 
-        _bot->message_create(m.add_embed(embed));
+                _bot->message_create(m.add_embed(embed));
+            }
+        } catch (const std::exception &e) {
+            _log->error("Discord_achievements_processing: failed to activate achievement " + name + ": " + e.what());
+        }
+        std::unique_lock lk(_pending_mutex);
+        _pending--;
+        _pending_cv.notify_all();
     }
 
-    Achievements_report Discord_achievements_processing_impl::get_achievements_report(const dpp::snowflake &user_id) {
-        return _achievements_processing->get_achievements_report(user_id.str());
+    Task<Achievements_report> Discord_achievements_processing_impl::get_achievements_report(const dpp::snowflake &user_id) {
+        co_return co_await _achievements_processing->get_achievements_report(user_id.str());
     }
 
     Module_ptr create() {
@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
 #include <src/modules/achievements_processing/achievements_processing.hpp>
 #include <src/modules/discord/discord_bot/discord_bot.hpp>
+#include <src/modules/logging/logging.hpp>
 #include "./discord_achievements_processing.hpp"
 
 namespace gb {
@@ -29,6 +32,27 @@ namespace gb {
          */
         Discord_bot_ptr _bot;
 
+        /**
+         * @brief Pointer to the logging module.
+         */
+        Logging_ptr _log;
+
+        std::mutex _pending_mutex; ///< Protects _pending.
+        std::condition_variable _pending_cv; ///< Notified when an activation finishes.
+        size_t _pending = 0; ///< Activations still running in the background, stop() waits for them.
+
+        /**
+         * @brief Unlocks achievement and announces it in the channel if it is new.
+         *
+         * Runs detached from activate_achievement(), so arguments are taken by value.
+         *
+         * @param name The name of the achievement to activate.
+         * @param user_id The ID of the Discord user for whom the achievement is activated.
+         * @param channel_id The ID of the Discord channel where the activation is to be notified.
+         * @return Task completing after the announcement is sent.
+         */
+        Task<void> unlock_and_announce(std::string name, dpp::snowflake user_id, dpp::snowflake channel_id);
+
     public:
         /**
          * @brief Constructs a Discord_achievements_processing_impl object.
@@ -62,13 +86,16 @@ namespace gb {
          *
          * @param name The name of the achievement to check.
          * @param user_id The ID of the Discord user to check.
-         * @return True if the user has the achievement, false otherwise.
+         * @return Task resolving to true if the user has the achievement, false otherwise.
          */
-        bool is_have_achievement(const std::string &name, const dpp::snowflake &user_id) override;
+        Task<bool> is_have_achievement(const std::string &name, const dpp::snowflake &user_id) override;
 
         /**
          * @brief Activates an achievement for a specific user within a Discord channel.
          *
+         * Does nothing if user already has the achievement, otherwise announces it in the channel. Users not
+         * cached yet are loaded in the background, so the calling game is never blocked by the database.
+         *
          * @param name The name of the achievement to activate.
          * @param user_id The ID of the Discord user for whom the achievement is activated.
          * @param channel_id The ID of the Discord channel where the activation is to be notified.
@@ -84,9 +111,9 @@ namespace gb {
          * more details) to generate an `Achievements_report` for the given Discord `snowflake` ID.
          *
          * @param user_id The Discord `snowflake` ID of the user.
-         * @return Achievements_report The achievements report for the specified user.
+         * @return Task resolving to the achievements report for the specified user.
          */
-        Achievements_report get_achievements_report(const dpp::snowflake &user_id) override;
+        Task<Achievements_report> get_achievements_report(const dpp::snowflake &user_id) override;
     };
 
     /**
@@ -7,6 +7,7 @@
 #include <dpp/dpp.h>
 #include "../../../module/module.hpp"
 #include "./discord_cluster.hpp"
+#include "src/utils/timer_wheel/timer_wheel.hpp"
 
 namespace gb {
 
@@ -39,6 +40,12 @@ namespace gb {
          */
         virtual Discord_cluster *get_bot() = 0;
 
+        /**
+         * @brief Getter for timer wheel shared by all timeouts of interactions, ticked once a second while bot runs.
+         * @return Timer_wheel& timer wheel reference.
+         */
+        virtual Timer_wheel &get_timer_wheel() = 0;
+
         /**
          * @brief Adds a pre-requirement function to be executed before the bot is
          * initialized or execute immediately if bot initialized.
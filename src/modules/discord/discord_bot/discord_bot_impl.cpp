@@ -20,6 +20,7 @@ namespace gb {
             throw std::runtime_error("Bot variable is not nullptr, memory leak possible");
         }
         _bot = std::make_unique<Discord_cluster>(_config->get_value("discord_bot_token"));
+        Executor::set_default(_bot.get());
 
         // Run all pre-requirements.
         {
@@ -98,6 +99,8 @@ namespace gb {
             },
             60 * 60 * 24); // once per day
 
+        _timer_wheel_timer = _bot->start_timer([this](const dpp::timer &timer) { _timer_wheel.tick(); }, 1);
+
         _bot->start(dpp::st_return);
 
         std::promise<void> ready_promise;
@@ -116,11 +119,15 @@ namespace gb {
             throw std::runtime_error("Bot is nullptr, no way to stop it");
         }
         _bot->stop_timer(_db_backup_timer);
+        _bot->stop_timer(_timer_wheel_timer);
+        Executor::set_default(nullptr);
         _bot->shutdown();
     }
 
     Discord_cluster *Discord_bot_impl::get_bot() { return _bot.get(); }
 
+    Timer_wheel &Discord_bot_impl::get_timer_wheel() { return _timer_wheel; }
+
     void Discord_bot_impl::add_pre_requirement(const std::function<void()> &func) {
         std::unique_lock<std::mutex> lock(_mutex);
         if (!_bot) {
@@ -43,6 +43,16 @@ namespace gb {
          */
         dpp::timer _db_backup_timer;
 
+        /**
+         * @brief Timer wheel shared by interaction timeouts.
+         */
+        Timer_wheel _timer_wheel;
+
+        /**
+         * @brief Dpp timer ticking _timer_wheel once a second.
+         */
+        dpp::timer _timer_wheel_timer;
+
         /**
          * @brief A pointer to the object representing the bot.
          */
@@ -99,6 +109,12 @@ namespace gb {
          */
         Discord_cluster *get_bot() override;
 
+        /**
+         * @brief Getter for timer wheel shared by all timeouts of interactions.
+         * @return Timer_wheel& timer wheel reference.
+         */
+        Timer_wheel &get_timer_wheel() override;
+
         /**
          * @brief Adds a pre-requirement function to be executed before the bot is
          * initialized or execute immediately if bot initialized.
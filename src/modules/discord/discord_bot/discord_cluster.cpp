@@ -6,4 +6,6 @@
 
 namespace gb {
     Discord_cluster::Discord_cluster(const std::string &token) : cluster(token,dpp::i_default_intents,0,0,1,true,dpp::cache_policy::cpol_none) {}
+
+    void Discord_cluster::post(std::function<void()> job) { queue_work(0, std::move(job)); }
 } // gb
\ No newline at end of file
@@ -4,13 +4,17 @@
 
 #pragma once
 #include <dpp/dpp.h>
+#include <src/utils/coro/coro.hpp>
 
 namespace gb {
 
     //wrapper class for dpp cluster to have more flexible behaviour if needed.
-    class Discord_cluster: public dpp::cluster {
+    //it is also the executor of dpp event threads, so coroutines started by events are resumed on them.
+    class Discord_cluster: public dpp::cluster, public Executor {
     public:
         Discord_cluster(const std::string &token);
+
+        void post(std::function<void()> job) override;
     };
 
 } // gb
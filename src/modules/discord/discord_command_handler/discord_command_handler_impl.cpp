@@ -7,6 +7,98 @@
 
 namespace gb {
 
+    Command_use_recorder::Command_use_recorder() : _ring(capacity) {}
+
+    Command_use_recorder::~Command_use_recorder() { stop(); }
+
+    void Command_use_recorder::start(std::function<bool(const Command_use_record &)> writer) {
+        std::unique_lock lk(_mutex);
+        _writer = std::move(writer);
+        _is_running = true;
+        _drain_thread = std::thread([this]() {
+            std::vector<Command_use_record> batch;
+            batch.reserve(capacity);
+            std::unique_lock lk(_mutex);
+            while (_is_running) {
+                _cv.wait_for(lk, flush_interval, [this]() { return !_is_running || _size >= capacity / 2; });
+                drain(lk, batch);
+            }
+            // flush everything recorded before stop
+            drain(lk, batch);
+        });
+    }
+
+    void Command_use_recorder::stop() {
+        {
+            std::unique_lock lk(_mutex);
+            _is_running = false;
+        }
+        _cv.notify_all();
+        if (_drain_thread.joinable()) {
+            _drain_thread.join();
+        }
+    }
+
+    void Command_use_recorder::record(Command_use_record record) {
+        bool notify;
+        {
+            std::unique_lock lk(_mutex);
+            if (_size == capacity) {
+                _head = (_head + 1) % capacity;
+                _size--;
+                _dropped_amount++;
+            }
+            _ring[(_head + _size) % capacity] = std::move(record);
+            _size++;
+            _max_size = std::max(_max_size, _size);
+            notify = _size == capacity / 2;
+        }
+        _recorded_amount++;
+        if (notify) {
+            _cv.notify_one();
+        }
+    }
+
+    void Command_use_recorder::drain(std::unique_lock<std::mutex> &lk, std::vector<Command_use_record> &batch) {
+        if (_size == 0) {
+            return;
+        }
+        for (; _size; _size--) {
+            batch.push_back(std::move(_ring[_head]));
+            _head = (_head + 1) % capacity;
+        }
+        lk.unlock();
+        _flushes_amount++;
+        for (auto &r: batch) {
+            try {
+                if (_writer(r)) {
+                    _written_amount++;
+                } else {
+                    _dropped_amount++;
+                }
+            } catch (...) {
+                _failed_amount++;
+            }
+        }
+        batch.clear();
+        lk.lock();
+    }
+
+    Command_use_recorder_stats Command_use_recorder::get_stats() {
+        Command_use_recorder_stats stats;
+        {
+            std::unique_lock lk(_mutex);
+            stats.buffered_amount = _size;
+            stats.max_buffered_amount = _max_size;
+        }
+        stats.recorded_amount = _recorded_amount;
+        stats.dropped_amount = _dropped_amount;
+        stats.written_amount = _written_amount;
+        stats.failed_amount = _failed_amount;
+        stats.flushes_amount = _flushes_amount;
+        return stats;
+    }
+
     void Discord_command_handler_impl::bulk_actions() {
         if (_bulk) {
             throw std::runtime_error("Discord_command_handler can not apply bulk as it set to true");
@@ -33,7 +125,14 @@ namespace gb {
     Discord_command_handler_impl::Discord_command_handler_impl() :
         Discord_command_handler("discord_command_handler", {"discord_bot", "admin_terminal", "database"}) {}
 
-    void Discord_command_handler_impl::run() { set_bulk(false); }
+    void Discord_command_handler_impl::run() {
+        _usage_recorder.start([this](const Command_use_record &r) {
+            // false if the database background queue is full, the record is counted as dropped
+            return _db->background_execute_prepared_statement(_insert_command_use_stmt, r.command, r.time, r.user_id,
+                                                              r.channel_id, r.guild_id);
+        });
+        set_bulk(false);
+    }
 
     void Discord_command_handler_impl::stop() {
         _discord_bot->get_bot()->on_ready.detach(_on_ready_handler);
@@ -53,6 +152,9 @@ namespace gb {
         _admin_terminal->remove_command("discord_command_handler_bulk_enable");
         _admin_terminal->remove_command("discord_command_handler_run_bulk");
         _admin_terminal->remove_command("discord_command_handler_get_bulk");
+        _admin_terminal->remove_command("discord_command_handler_usage_stats");
+        // handler is detached, so everything recorded is written before the statement goes away
+        _usage_recorder.stop();
         _db->remove_prepared_statement(_insert_command_use_stmt);
     }
 
@@ -62,7 +164,7 @@ namespace gb {
         this->_db = std::static_pointer_cast<Database>(modules.at("database"));
         this->_insert_command_use_stmt =
             _db->create_prepared_statement("INSERT INTO  `commands_use` (`command`, `time`, `user_id`, `channel_id`, "
-                                           "`guild_id`) VALUES (?, UTC_TIMESTAMP(), ?, ?, ? )");
+                                           "`guild_id`) VALUES (?, ?, ?, ?, ? )");
 
         _discord_bot->add_pre_requirement([this]() {
             this->_on_ready_handler = _discord_bot->get_bot()->on_ready([this](const dpp::ready_t &event) {
@@ -104,13 +206,26 @@ namespace gb {
                         name += " " + data.options[0].name + get_full_command_name(data.options[0]);
                     }
 
-                    co_await _db->execute_prepared_statement(_insert_command_use_stmt, name, event.command.usr.id,
-                                                             event.command.channel_id, event.command.guild_id);
+                    _usage_recorder.record({name, event.command.usr.id, event.command.channel_id,
+                                            event.command.guild_id,
+                                            std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now())});
                     co_await _commands.at(event.command.get_command_name())->get_handler()(event);
                     co_return;
                 });
         });
 
+        _admin_terminal->add_command(
+            "discord_command_handler_usage_stats", "Shows command use recorder buffer metrics.",
+            "Arguments: no arguments", [this](const std::vector<std::string> &arguments) {
+                auto stats = _usage_recorder.get_stats();
+                std::cout << std::format("Command use recorder:\nbuffered: {} (max {}, capacity {})\nrecorded: {}, "
+                                         "written: {}, dropped: {}, failed: {}, flushes: {}",
+                                         stats.buffered_amount, stats.max_buffered_amount,
+                                         Command_use_recorder::capacity, stats.recorded_amount, stats.written_amount,
+                                         stats.dropped_amount, stats.failed_amount, stats.flushes_amount)
+                          << std::endl;
+            });
+
         _admin_terminal->add_command("discord_command_handler_get_bulk", "Command to get current value of bulk status.",
                                      "Arguments: no arguments", [this](const std::vector<std::string> &arguments) {
                                          std::cout << "Command discord_command_handler_get_bulk: bulk: "
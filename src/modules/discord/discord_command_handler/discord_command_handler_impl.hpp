@@ -9,11 +9,120 @@
 #include "../../admin_terminal/admin_terminal.hpp"
 #include "src/modules/database/database.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <shared_mutex>
 #include <map>
+#include <thread>
+#include <vector>
 
 namespace gb {
 
+    /**
+     * @brief Single command use waiting to be written to database.
+     */
+    struct Command_use_record {
+        std::string command; ///< Full command name including subcommands.
+        dpp::snowflake user_id; ///< User who used the command.
+        dpp::snowflake channel_id; ///< Channel command was used in.
+        dpp::snowflake guild_id; ///< Guild command was used in.
+        std::chrono::sys_seconds time; ///< Time of use (UTC).
+    };
+
+    /**
+     * @brief Snapshot of Command_use_recorder counters, used for admin terminal output.
+     */
+    struct Command_use_recorder_stats {
+        size_t buffered_amount = 0; ///< Records currently in buffer.
+        size_t max_buffered_amount = 0; ///< Highest buffer occupancy observed.
+        uint64_t recorded_amount = 0; ///< Total recorded command uses.
+        uint64_t dropped_amount = 0; ///< Records dropped because buffer or database queue was full.
+        uint64_t written_amount = 0; ///< Records handed to database.
+        uint64_t failed_amount = 0; ///< Records which failed to be handed to database.
+        uint64_t flushes_amount = 0; ///< Buffer drains.
+    };
+
+    /**
+     * @class Command_use_recorder
+     * @brief Fixed size ring buffer of command uses, drained to database by a background thread.
+     *
+     * Recording never waits for the database. When the buffer is full the oldest record is dropped,
+     * so at most capacity records are lost if the database falls behind for a long time.
+     */
+    class Command_use_recorder {
+    public:
+        static constexpr size_t capacity = 4096; ///< Max amount of buffered records.
+        static constexpr std::chrono::milliseconds flush_interval{1000}; ///< Max time record stays in buffer.
+
+    private:
+        std::vector<Command_use_record> _ring; ///< Buffer storage.
+        size_t _head = 0; ///< Index of the oldest record.
+        size_t _size = 0; ///< Amount of buffered records.
+        std::mutex _mutex; ///< Protects ring buffer and running flag.
+        std::condition_variable _cv; ///< Wakes drain thread.
+        bool _is_running = false; ///< Flag indicating if drain thread should run.
+        std::thread _drain_thread; ///< Thread writing records to database.
+        std::function<bool(const Command_use_record &)> _writer; ///< Writes single record to database.
+
+        size_t _max_size = 0; ///< Highest observed occupancy, protected by _mutex.
+        std::atomic_uint64_t _recorded_amount = 0; ///< Counter of recorded uses.
+        std::atomic_uint64_t _dropped_amount = 0; ///< Counter of dropped records.
+        std::atomic_uint64_t _written_amount = 0; ///< Counter of written records.
+        std::atomic_uint64_t _failed_amount = 0; ///< Counter of records writer failed on.
+        std::atomic_uint64_t _flushes_amount = 0; ///< Counter of drains.
+
+        /**
+         * @brief Moves all buffered records out and writes them.
+         *
+         * @param lk Lock on _mutex, unlocked while writing.
+         * @param batch Reusable storage for taken records.
+         */
+        void drain(std::unique_lock<std::mutex> &lk, std::vector<Command_use_record> &batch);
+
+    public:
+        /**
+         * @brief Constructor, allocates the buffer.
+         */
+        Command_use_recorder();
+
+        Command_use_recorder(const Command_use_recorder &) = delete;
+        Command_use_recorder &operator=(const Command_use_recorder &) = delete;
+
+        /**
+         * @brief Stops and joins drain thread if the owner did not call stop(), for example on module unload.
+         */
+        ~Command_use_recorder();
+
+        /**
+         * @brief Starts drain thread.
+         *
+         * @param writer Function writing a single record to database, must not block for long. Returns false if
+         * the record was dropped.
+         */
+        void start(std::function<bool(const Command_use_record &)> writer);
+
+        /**
+         * @brief Stops drain thread, writing all buffered records first.
+         */
+        void stop();
+
+        /**
+         * @brief Adds record to buffer, dropping the oldest one if buffer is full.
+         *
+         * @param record Command use to record.
+         */
+        void record(Command_use_record record);
+
+        /**
+         * @brief Gets snapshot of recorder counters.
+         *
+         * @return Recorder statistics.
+         */
+        Command_use_recorder_stats get_stats();
+    };
+
     /**
      * @brief Implementation of the Discord_command_handler module.
      * This class manages the registration, removal, and bulk operations of Discord commands.
@@ -30,6 +139,7 @@ namespace gb {
         dpp::event_handle  _on_ready_handler = 0; ///< Handler of on ready event to remove in stop
         dpp::event_handle  _on_slashcommand_handler = 0; ///< Handler of on slashcommand event to remove in stop
         Prepared_statement _insert_command_use_stmt; ///< ID of insert command use database query.
+        Command_use_recorder _usage_recorder; ///< Buffers command uses so handlers do not wait for database.
 
         /**
          * @brief Perform bulk actions.
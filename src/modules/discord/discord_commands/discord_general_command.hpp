@@ -31,6 +31,7 @@ namespace gb {
          */
         std::condition_variable _cv;
 
+    protected:
         /**
          * @brief Increments the command counter to signify the start of a command.
          */
@@ -41,7 +42,6 @@ namespace gb {
          */
         void _command_end();
 
-    protected:
         /**
          * @brief Shared pointer to the Discord command handler.
          */
@@ -34,7 +34,10 @@ namespace gb {
                  {"game", "single-player"}}));
         });
     }
-    void Discord_2048_command_impl::run() { Discord_2048_command::run(); }
+    void Discord_2048_command_impl::run() {
+        Discord_2048_command::run();
+        resume_saved_games<Discord_game_2048>("2048");
+    }
 
     void Discord_2048_command_impl::stop() {
         _command_handler->remove_command("2048");
@@ -53,7 +53,8 @@ namespace gb {
          * @brief Runs the 2048 game command.
          *
          * This method starts the 2048 game, handling player interactions, moves, and
-         * the display of the game grid within the Discord environment.
+         * the display of the game grid within the Discord environment. Games saved before
+         * the bot went down are resumed here.
          */
         void run() override;
 
@@ -35,7 +35,10 @@ namespace gb {
             "https://media.discordapp.net/attachments/1010981120554320003/1146219816609398914/battleship.png";
     }
 
-    void Discord_battleships_command_impl::run() { Discord_battleships_command::run(); }
+    void Discord_battleships_command_impl::run() {
+        Discord_battleships_command::run();
+        resume_saved_games<Discord_battleships_game>("battleships");
+    }
 
     void Discord_battleships_command_impl::stop() {
         _command_handler->remove_command("battleships");
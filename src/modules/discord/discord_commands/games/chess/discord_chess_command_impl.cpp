@@ -9,6 +9,8 @@
 namespace gb {
     dpp::task<void> Discord_chess_command_impl::_command_callback(const dpp::slashcommand_t &event) {
 
+        auto computer_parameter = event.get_parameter("computer");
+        bool is_computer = std::holds_alternative<bool>(computer_parameter) && std::get<bool>(computer_parameter);
         std::vector<dpp::snowflake> players = {};
         auto parameter = event.get_parameter("player");
         if (std::holds_alternative<dpp::snowflake>(parameter)) {
@@ -27,6 +29,15 @@ namespace gb {
                             .set_title("Error!")
                             .set_description("move_timeout should be between 120 and 600"));
             _bot->reply(event, m);
+        } else if (is_computer) {
+            PREMIUM_STATUS status = co_await _premium->get_users_premium_status(event.command.usr.id);
+            // own game name, so wins against the computer do not count in chess stats
+            auto d = get_game_data_initialization("chess vs computer");
+            auto game = std::make_unique<Discord_chess_game>(
+                d, event.command.usr.id, _search_pool.get(),
+                status == PREMIUM_STATUS::BASIC ? _premium_move_budget : _move_budget, _search_cancel);
+            auto t = static_cast<int>(timeout);
+            co_await game->start_game(event, t);
         } else {
             Lobby_return r = co_await this->lobby(event, players, event.command.usr.id, 2);
             if (!r.is_timeout) {
@@ -40,7 +51,7 @@ namespace gb {
         co_return;
     }
 
-    Discord_chess_command_impl::Discord_chess_command_impl() : Discord_chess_command("discord_chess_command", {}) {
+    Discord_chess_command_impl::Discord_chess_command_impl() : Discord_chess_command("discord_chess_command", {"premium_manager", "config"}) {
 
         lobby_title = "Chess";
         lobby_description =
@@ -52,22 +63,38 @@ namespace gb {
         lobby_image_url = "https://cdn.discordapp.com/attachments/1010981120554320003/1013870289798570104/chess.png";
     }
 
-    void Discord_chess_command_impl::run() { Discord_chess_command::run(); }
+    void Discord_chess_command_impl::run() {
+        Discord_chess_command::run();
+        _search_cancel = std::make_shared<std::atomic_bool>(false);
+        _search_pool = std::make_unique<Thread_pool>(std::stoi(_config->get_value_or("chess_search_threads", "2")));
+        _move_budget = std::chrono::milliseconds(std::stoll(_config->get_value_or("chess_move_budget_ms", "250")));
+        _premium_move_budget =
+            std::chrono::milliseconds(std::stoll(_config->get_value_or("chess_premium_move_budget_ms", "1500")));
+        // only games of two players are saved, games against the computer are not resumable
+        resume_saved_games<Discord_chess_game>("chess");
+    }
 
     void Discord_chess_command_impl::stop() {
         _command_handler->remove_command("chess");
+        // cancels searches in progress before waiting for games, their games end as draws
+        *_search_cancel = true;
         Discord_chess_command::stop();
+        _search_pool.reset();
         _image_processing->cache_remove(Discord_chess_game::get_image_generators());
     }
 
     void Discord_chess_command_impl::init(const Modules &modules) {
         Discord_chess_command::init(modules);
+        _premium = std::static_pointer_cast<Premium_manager>(modules.at("premium_manager"));
+        _config = std::static_pointer_cast<Config>(modules.at("config"));
         _image_processing->cache_create(Discord_chess_game::get_image_generators());
         _bot->add_pre_requirement([this]() {
             dpp::slashcommand command("chess", "Command to start chess game", _bot->get_bot()->me.id);
             command.add_option(dpp::command_option(dpp::co_user, "player", "Player to play with.", false));
             command.add_option(dpp::command_option(dpp::co_integer, "move_timeout",
                                                    "Time for move in seconds 120 < time < 600 (default 60).", false));
+            command.add_option(
+                dpp::command_option(dpp::co_boolean, "computer", "Play against the computer.", false));
 
             _command_handler->register_command(_discord->create_discord_command(
                 command, _command_executor,
@@ -79,8 +106,9 @@ namespace gb {
                  "(The color under the selected piece is blue. Under the possible options for the move is green, if "
                  "you have been put a check, the red color will be under the king). There is also a 'back' button that "
                  "will take you back to the figure selection. If there is another figure on the cell where you want to "
-                 "go, the bot will draw an icon on the button.",
-                 {"game", "multiplayer"}}));
+                 "go, the bot will draw an icon on the button.\n\nSet `computer` option to play white against the "
+                 "computer, premium users get a stronger computer which thinks longer.",
+                 {"game", "single-player", "multiplayer"}}));
         });
     }
     Module_ptr create() { return std::dynamic_pointer_cast<Module>(std::make_shared<Discord_chess_command_impl>()); }
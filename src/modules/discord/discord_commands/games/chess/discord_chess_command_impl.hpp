@@ -3,6 +3,9 @@
 //
 
 #pragma once
+#include <src/modules/config/config.hpp>
+#include <src/modules/discord/premium_manager/premium_manager.hpp>
+#include <src/utils/coro/coro.hpp>
 #include "./discord_chess_command.hpp"
 
 namespace gb {
@@ -16,6 +19,12 @@ namespace gb {
      * such as registering the command, handling game logic, and user interaction in Discord.
      */
     class Discord_chess_command_impl : public Discord_chess_command {
+        Premium_manager_ptr _premium; ///< Premium manager, premium users get stronger computer opponent.
+        Config_ptr _config; ///< Config module.
+        std::unique_ptr<Thread_pool> _search_pool; ///< Threads searching computer moves, bounds search CPU usage.
+        std::shared_ptr<std::atomic_bool> _search_cancel; ///< Set on stop, cancels searches in progress.
+        std::chrono::milliseconds _move_budget{250}; ///< Computer thinking time per move.
+        std::chrono::milliseconds _premium_move_budget{1500}; ///< Computer thinking time per move for premium users.
 
     protected:
         /**
@@ -9,6 +9,14 @@
 namespace gb {
     dpp::task<void> Discord_connect_four_command_impl::_command_callback(const dpp::slashcommand_t &event) {
 
+        auto computer_parameter = event.get_parameter("computer");
+        if (std::holds_alternative<bool>(computer_parameter) && std::get<bool>(computer_parameter)) {
+            auto d = get_game_data_initialization("connect four vs computer");
+            auto game = std::make_unique<Discord_connect_four_game>(d, event.command.usr.id);
+            co_await game->start_game(event);
+            co_return;
+        }
+
         std::vector<dpp::snowflake> players = {};
         auto parameter = event.get_parameter("player");
         if (std::holds_alternative<dpp::snowflake>(parameter)) {
@@ -37,15 +45,18 @@ namespace gb {
         _bot->add_pre_requirement([this]() {
             dpp::slashcommand command("connect_four", "Command to start connect four game", _bot->get_bot()->me.id);
             command.add_option(dpp::command_option(dpp::co_user, "player", "Player to play with.", false));
+            command.add_option(
+                dpp::command_option(dpp::co_boolean, "computer", "Play against the computer.", false));
             _command_handler->register_command(_discord->create_discord_command(
                 command, _command_executor,
                 {"__**Rules**__:\n1.On your turn, drop one of your checkers down any of the slots in the top of the "
-                 "grid.\n\n2.Players alternates until one player gets 4 checkers of his color in a row."
+                 "grid.\n\n2.Players alternates until one player gets 4 checkers of his color in a row.\n\n3.Set "
+                 "`computer` option to play against the computer."
                  "\n\n\n__**How does it works in bot?**__\n"
                  "Bot gives you ability to choose column where you would like to place your figure. They are "
                  "numerated from 1 to 7. You can see number of column under it on picture in the message. Buttons "
                  "also have this numbers. Click on button with number of column you would like to place your sign.",
-                 {"game", "multiplayer"}}));
+                 {"game", "single-player", "multiplayer"}}));
         });
     }
     void Discord_connect_four_command_impl::stop() {
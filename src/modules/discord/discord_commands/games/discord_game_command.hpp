@@ -3,6 +3,7 @@
 //
 
 #pragma once
+#include <format>
 #include "src/module/module.hpp"
 #include "src/modules/discord/discord_games/discord_game.hpp"
 #include "src/modules/discord/discord_interactions_handler/discord_button_click_handler/discord_button_click_handler.hpp"
@@ -98,6 +99,44 @@ public:
      */
     dpp::task<Lobby_return> lobby(const dpp::slashcommand_t& event, std::vector<dpp::snowflake> players, const dpp::snowflake& host, unsigned int players_amount);
 
+    /**
+     * @brief Resumes all saved games of given type, each in its own coroutine.
+     *
+     * Call it once the bot is ready. Resumed games count as running commands, so stop() waits for them.
+     *
+     * @tparam Game Game class, must be resumable and constructible from initialization data and players.
+     * @param game_name The name of the game.
+     */
+    template<typename Game>
+    void resume_saved_games(const std::string &game_name) {
+        for (auto &saved: _games_manager->take_saved_games(game_name)) {
+            resume_saved_game<Game>(this, game_name, std::move(saved));
+        }
+    }
+
+    /**
+     * @brief Resumes one saved game, runs detached.
+     *
+     * Static because detached coroutines must not take references, including the implicit object one.
+     *
+     * @tparam Game Game class.
+     * @param command Command the game belongs to.
+     * @param game_name The name of the game.
+     * @param saved Saved game.
+     */
+    template<typename Game>
+    static dpp::job resume_saved_game(Discord_game_command *command, std::string game_name, Saved_game saved) {
+        command->_command_start();
+        try {
+            auto d = command->get_game_data_initialization(game_name);
+            auto game = std::make_unique<Game>(d, std::vector<dpp::snowflake>{});
+            co_await game->resume_game(saved.id, saved.snapshot);
+        } catch (const std::exception &e) {
+            command->_log->error(std::format("Failed to resume {} game {}: {}", game_name, saved.id, e.what()));
+        }
+        command->_command_end();
+    }
+
     /**
      * @brief Initializes the module with its dependencies.
      *
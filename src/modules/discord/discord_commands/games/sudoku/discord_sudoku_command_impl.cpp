@@ -7,15 +7,42 @@
 #include "src/modules/discord/discord_games/sudoku/discord_sudoku_game.hpp"
 
 namespace gb {
+    std::pair<size_t, sudoku::Sudoku> Discord_sudoku_command_impl::generate_puzzle() {
+        sudoku::Sudoku engine;
+        engine.create_seed();
+        engine.gen_puzzle();
+        engine.calculate_difficulty();
+        // singles only / up to two easy guesses / more guessing, roughly 40% / 40% / 20% of generated puzzles
+        int guessing = engine.get_difficulty_level() / 100;
+        return {guessing == 0 ? 0 : (guessing <= 2 ? 1 : 2), engine};
+    }
+
     dpp::task<void> Discord_sudoku_command_impl::_command_callback(const dpp::slashcommand_t &event) {
+        auto parameter = event.get_parameter("difficulty");
+        long difficulty = 2;
+        if (std::holds_alternative<long>(parameter)) {
+            difficulty = std::get<long>(parameter);
+        }
+
+        if (difficulty < 1 || difficulty > 3) {
+            dpp::embed embed;
+            embed.set_color(dpp::colors::red)
+                .set_title("Error!")
+                .set_description("Difficulty should be between 1 and 3, while you gave " + std::to_string(difficulty));
+
+            _bot->reply(event, dpp::message().add_embed(embed).set_flags(dpp::m_ephemeral));
+            co_return;
+        }
 
         auto d = get_game_data_initialization("sudoku");
-        auto game = std::make_unique<Discord_sudoku_game>(d, std::vector<dpp::snowflake>{event.command.usr.id});
+        auto game = std::make_unique<Discord_sudoku_game>(d, std::vector<dpp::snowflake>{event.command.usr.id},
+                                                          _puzzle_pool->take(difficulty - 1));
         co_await game->start_game(event);
         co_return;
     }
 
-    Discord_sudoku_command_impl::Discord_sudoku_command_impl() : Discord_sudoku_command("discord_sudoku_command", {}) {
+    Discord_sudoku_command_impl::Discord_sudoku_command_impl() :
+        Discord_sudoku_command("discord_sudoku_command", {"admin_terminal", "config"}) {
         lobby_title = "Sudoku";
         lobby_description = "The sudoku a puzzle in which missing numbers are to be filled into a 9 by 9 grid of "
                             "squares which are subdivided into 3 by 3 boxes so that every row, every column, and every "
@@ -28,15 +55,34 @@ namespace gb {
 
     void Discord_sudoku_command_impl::stop() {
         _command_handler->remove_command("sudoku");
+        _admin_terminal->remove_command("sudoku_pool_stats");
         Discord_sudoku_command::stop();
+        _puzzle_pool.reset();
         _image_processing->cache_remove(Discord_sudoku_game::get_image_generators());
     }
 
     void Discord_sudoku_command_impl::init(const Modules &modules) {
         Discord_sudoku_command::init(modules);
+        _admin_terminal = std::static_pointer_cast<Admin_terminal>(modules.at("admin_terminal"));
+        _config = std::static_pointer_cast<Config>(modules.at("config"));
         _image_processing->cache_create(Discord_sudoku_game::get_image_generators());
+        _admin_terminal->add_command(
+            "sudoku_pool_stats", "Prints statistics of pre-generated sudoku puzzles.", "Arguments: no arguments",
+            [this](const std::vector<std::string> &args) {
+                if (!_puzzle_pool) {
+                    std::cout << "Sudoku pool is not running" << std::endl;
+                    return;
+                }
+                auto stats = _puzzle_pool->get_stats();
+                std::cout << std::format(
+                                 "Sudoku pool: ready {}, hits {}, nearest {}, misses {}, generated {}, dropped {}",
+                                 stats.ready, stats.hits, stats.nearest, stats.misses, stats.generated, stats.dropped)
+                          << std::endl;
+            });
         _bot->add_pre_requirement([this]() {
             dpp::slashcommand command("sudoku", "Command to start sudoku game", _bot->get_bot()->me.id);
+            command.add_option(
+                dpp::command_option(dpp::co_integer, "difficulty", "Difficulty of the game between 1 and 3", false));
 
             _command_handler->register_command(_discord->create_discord_command(
                 command, _command_executor,
@@ -48,7 +94,13 @@ namespace gb {
         });
     }
 
-    void Discord_sudoku_command_impl::run() { Discord_sudoku_command::run(); }
+    void Discord_sudoku_command_impl::run() {
+        _puzzle_pool = std::make_unique<Puzzle_pool<sudoku::Sudoku>>(
+            3, std::stoull(_config->get_value_or("sudoku_pool_size", "32")),
+            std::stoull(_config->get_value_or("sudoku_pool_workers", "1")), [](size_t) { return generate_puzzle(); });
+        Discord_sudoku_command::run();
+        resume_saved_games<Discord_sudoku_game>("sudoku");
+    }
 
     Module_ptr create() { return std::dynamic_pointer_cast<Module>(std::make_shared<Discord_sudoku_command_impl>()); }
 
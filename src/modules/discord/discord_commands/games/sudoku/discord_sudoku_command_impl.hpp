@@ -5,6 +5,10 @@
 #pragma once
 
 #include "./discord_sudoku_command.hpp"
+#include <src/games/sudoku/sudoku.hpp>
+#include <src/modules/admin_terminal/admin_terminal.hpp>
+#include <src/modules/config/config.hpp>
+#include <src/utils/puzzle_pool/puzzle_pool.hpp>
 
 namespace gb {
 
@@ -17,6 +21,16 @@ namespace gb {
      * and overrides essential methods such as `run`, `init`, and `stop`.
      */
     class Discord_sudoku_command_impl : public Discord_sudoku_command {
+        Admin_terminal_ptr _admin_terminal; ///< Pointer to the admin terminal module.
+        Config_ptr _config; ///< Pointer to the config module.
+        std::unique_ptr<Puzzle_pool<sudoku::Sudoku>> _puzzle_pool; ///< Ready graded puzzles per difficulty.
+
+        /**
+         * @brief Generates graded puzzle.
+         *
+         * @return Difficulty (0-2) the puzzle grades to and the puzzle.
+         */
+        static std::pair<size_t, sudoku::Sudoku> generate_puzzle();
 
     protected:
         /**
@@ -43,7 +57,7 @@ namespace gb {
         /**
          * @brief Executes the Sudoku command.
          *
-         * Placeholder to implement abstract class.
+         * Starts the puzzle pool.
          */
         void run() override;
 
@@ -8,6 +8,15 @@
 namespace gb {
     dpp::task<void> Discord_tic_tac_toe_command_impl::_command_callback(const dpp::slashcommand_t &event) {
 
+        auto computer_parameter = event.get_parameter("computer");
+        if (std::holds_alternative<bool>(computer_parameter) && std::get<bool>(computer_parameter)) {
+            // own game name, so wins against the computer do not count in tic tac toe stats
+            auto d = get_game_data_initialization("tic tac toe vs computer");
+            auto game = std::make_unique<Discord_tic_tac_toe_game>(d, event.command.usr.id);
+            co_await game->start_game(event);
+            co_return;
+        }
+
         std::vector<dpp::snowflake> players = {};
         auto parameter = event.get_parameter("player");
         if (std::holds_alternative<dpp::snowflake>(parameter)) {
@@ -36,17 +45,20 @@ namespace gb {
         _bot->add_pre_requirement([this]() {
             dpp::slashcommand command("tic_tac_toe", "Command to start tic tac toe game", _bot->get_bot()->me.id);
             command.add_option(dpp::command_option(dpp::co_user, "player", "Player to play with.", false));
+            command.add_option(
+                dpp::command_option(dpp::co_boolean, "computer", "Play against the computer.", false));
             _command_handler->register_command(_discord->create_discord_command(
                 command, _command_executor,
                 {"__**Rules**__:\n1. The game is played on a grid that's 3 squares by 3 squares."
-                 "\n\n2. You are X, your friend (or the computer in this case) is O. Players take turns putting"
+                 "\n\n2. You are X, your friend (or the computer, if you set `computer` option) is O. Players "
+                 "take turns putting"
                  " their marks in empty squares.\n\n3. The first player to get 3 of her marks in a row (up, down,"
                  " across, or diagonally) is the winner.\n\n4. When all 9 squares are full, the game is over. If "
                  "no player has 3 marks in a row, the game ends in a tie."
                  "\n\n\n__**How does it works in bot?**__\n"
                  "Bot representing game field in buttons, just click on button where you would like to place your "
                  "sign.",
-                 {"game", "multiplayer"}}));
+                 {"game", "single-player", "multiplayer"}}));
         });
     }
 
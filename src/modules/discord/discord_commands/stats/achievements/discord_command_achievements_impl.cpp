@@ -49,7 +49,7 @@ namespace gb {
                                                                event.command.channel_id);
             }
         }
-        Achievements_report user_achievements = _achievements_processing->get_achievements_report(event.command.usr.id);
+        Achievements_report user_achievements = co_await _achievements_processing->get_achievements_report(event.command.usr.id);
         dpp::message m;
         if (filter == "unlocked" || filter == "all") {
             dpp::embed e = dpp::embed().set_title("Unlocked achievements").set_color(dpp::colors::green);
@@ -44,8 +44,8 @@ namespace gb {
                 }
             }
 
-            Database_return_t r =
-                co_await _db->execute_prepared_statement(_bot_commands_stmt, time_from, time_to, command_name);
+            Database_result r =
+                co_await _db->query_prepared_statement(_bot_commands_stmt, time_from, time_to, command_name);
             if (r.empty()) {
                 dpp::message m = dpp::message().add_embed(
                     dpp::embed().set_title("No data was found by your parameters").set_color(dpp::colors::blue));
@@ -56,17 +56,19 @@ namespace gb {
             emb.set_color(dpp::colors::blue);
             int total_cmd = 0;
             uint64_t total_calls = 0;
-            for (auto command_row: r) {
+            size_t command_col = r.get_column_index("command");
+            size_t amount_col = r.get_column_index("amount");
+            size_t last_use_col = r.get_column_index("last_use");
+            for (size_t row = 0; row < r.size(); row++) {
                 total_cmd++;
 
-                std::string calls_amount = command_row.at("amount");
-                uint64_t calls_cnt;
-                std::from_chars(calls_amount.data(), calls_amount.data() + calls_amount.size(), calls_cnt);
+                uint64_t calls_cnt = r.get_uint64(row, amount_col);
                 total_calls += calls_cnt;
 
-                emb.add_field(std::format("{}) {}", total_cmd, command_row.at("command")),
-                              std::format("Was used {} time(s).\nLast use: <t:{}> (<t:{}:R>)", calls_cnt,
-                                          command_row.at("last_use"), command_row.at("last_use")));
+                int64_t last_use = r.get_int64(row, last_use_col);
+                emb.add_field(std::format("{}) {}", total_cmd, r.get_string_view(row, command_col)),
+                              std::format("Was used {} time(s).\nLast use: <t:{}> (<t:{}:R>)", calls_cnt, last_use,
+                                          last_use));
             }
             emb.set_title(
                 std::format("There is {} different command(s) which were used {} times", total_cmd, total_calls));
@@ -133,7 +135,7 @@ namespace gb {
                 }
             }
 
-            Database_return_t r = co_await _db->execute_prepared_statement(
+            Database_result r = co_await _db->query_prepared_statement(
                 _bot_games_stmt, time_from_start, time_to_start, time_from_end, time_to_end, game_name);
             if (r.empty()) {
                 dpp::message m = dpp::message().add_embed(
@@ -146,25 +148,25 @@ namespace gb {
             int total_games = 0;
             int active_games = 0;
             uint64_t total_calls = 0;
-            for (auto game_row: r) {
+            size_t game_name_col = r.get_column_index("game_name");
+            size_t amount_col = r.get_column_index("amount");
+            size_t last_game_col = r.get_column_index("last_game");
+            size_t active_games_col = r.get_column_index("active_games");
+            for (size_t row = 0; row < r.size(); row++) {
                 total_games++;
 
-                std::string calls_amount = game_row.at("amount");
-                uint64_t calls_cnt;
-                std::from_chars(calls_amount.data(), calls_amount.data() + calls_amount.size(), calls_cnt);
+                uint64_t calls_cnt = r.get_uint64(row, amount_col);
                 total_calls += calls_cnt;
 
-                std::string active_amount_str = game_row.at("active_games");
-                uint64_t active_cnt;
-                std::from_chars(active_amount_str.data(), active_amount_str.data() + active_amount_str.size(),
-                                active_cnt);
+                uint64_t active_cnt = r.get_uint64(row, active_games_col);
                 active_games += active_cnt;
 
+                int64_t last_game = r.get_int64(row, last_game_col);
                 emb.add_field(
-                    std::format("{}) {}", total_games, game_row.at("game_name")),
+                    std::format("{}) {}", total_games, r.get_string_view(row, game_name_col)),
                     std::format(
                         "Was played {} time(s).\nLast time played: <t:{}> (<t:{}:R>).\n {} game(s) are active now.",
-                        game_row.at("amount"), game_row.at("last_game"), game_row.at("last_game"), active_cnt));
+                        calls_cnt, last_game, last_game, active_cnt));
             }
             emb.set_title(std::format(
                 "There is {} different game(s). They were played {} time(s). There is {} game(s) active now",
@@ -211,8 +213,8 @@ namespace gb {
                     command_name = std::get<std::string>(parameter.value);
                 }
             }
-            Database_return_t r = co_await _db->execute_prepared_statement(_me_commands_stmt, event.command.usr.id,
-                                                                           time_from, time_to, command_name);
+            Database_result r = co_await _db->query_prepared_statement(_me_commands_stmt, event.command.usr.id,
+                                                                        time_from, time_to, command_name);
             if (r.empty()) {
                 dpp::message m = dpp::message().add_embed(
                     dpp::embed().set_title("No data was found by your parameters").set_color(dpp::colors::blue));
@@ -223,17 +225,19 @@ namespace gb {
             emb.set_color(dpp::colors::blue);
             int total_cmd = 0;
             uint64_t total_calls = 0;
-            for (auto command_row: r) {
+            size_t command_col = r.get_column_index("command");
+            size_t amount_col = r.get_column_index("amount");
+            size_t last_use_col = r.get_column_index("last_use");
+            for (size_t row = 0; row < r.size(); row++) {
                 total_cmd++;
 
-                std::string calls_amount = command_row.at("amount");
-                uint64_t calls_cnt;
-                std::from_chars(calls_amount.data(), calls_amount.data() + calls_amount.size(), calls_cnt);
+                uint64_t calls_cnt = r.get_uint64(row, amount_col);
                 total_calls += calls_cnt;
 
-                emb.add_field(std::format("{}) {}", total_cmd, command_row.at("command")),
-                              std::format("Was used {} time(s).\nLast use: <t:{}> (<t:{}:R>)", calls_cnt,
-                                          command_row.at("last_use"), command_row.at("last_use")));
+                int64_t last_use = r.get_int64(row, last_use_col);
+                emb.add_field(std::format("{}) {}", total_cmd, r.get_string_view(row, command_col)),
+                              std::format("Was used {} time(s).\nLast use: <t:{}> (<t:{}:R>)", calls_cnt, last_use,
+                                          last_use));
             }
             emb.set_title(
                 std::format("There is {} different command(s) which were used {} times", total_cmd, total_calls));
@@ -319,7 +323,7 @@ namespace gb {
                     user2 = std::get<dpp::snowflake>(parameter.value);
                 }
             }
-            Database_return_t r = co_await _db->execute_prepared_statement(
+            Database_result r = co_await _db->query_prepared_statement(
                 _me_games_stmt, user2, user, time_from_start, time_to_start, time_from_end, time_to_end, game_name);
             if (r.empty()) {
                 dpp::message m = dpp::message().add_embed(
@@ -335,45 +339,42 @@ namespace gb {
             uint64_t lose_cnt = 0;
             uint64_t draw_cnt = 0;
             uint64_t total_calls = 0;
-            for (auto &game_row: r) {
+            size_t game_name_col = r.get_column_index("game_name");
+            size_t last_game_col = r.get_column_index("last_game");
+            size_t active_games_col = r.get_column_index("active_games");
+            size_t win_games_col = r.get_column_index("win_games");
+            size_t draw_games_col = r.get_column_index("draw_games");
+            size_t lose_games_col = r.get_column_index("lose_games");
+            size_t amount_col = r.get_column_index("amount");
+            for (size_t row = 0; row < r.size(); row++) {
                 total_cmd++;
 
-                auto data = game_row.at("active_games");
-                unsigned int active;
-                std::from_chars(data.data(), data.data() + data.size(), active);
+                auto active = static_cast<unsigned int>(r.get_uint64(row, active_games_col));
                 active_games += active;
 
-                data = game_row.at("win_games");
-                uint64_t win;
-                std::from_chars(data.data(), data.data() + data.size(), win);
+                uint64_t win = r.get_uint64(row, win_games_col);
                 win_cnt += win;
 
-                data = game_row.at("draw_games");
-                uint64_t draw;
-                std::from_chars(data.data(), data.data() + data.size(), draw);
+                uint64_t draw = r.get_uint64(row, draw_games_col);
                 draw_cnt += draw;
 
-                data = game_row.at("lose_games");
-                uint64_t lose;
-                std::from_chars(data.data(), data.data() + data.size(), lose);
+                uint64_t lose = r.get_uint64(row, lose_games_col);
                 lose_cnt += lose;
 
-                data = game_row.at("amount");
-                uint64_t amount;
-                std::from_chars(data.data(), data.data() + data.size(), amount);
+                uint64_t amount = r.get_uint64(row, amount_col);
                 total_calls += amount;
 
                 // calculate win percentage using formula https://en.wikipedia.org/wiki/Winning_percentage
                 double percentage = ((draw * 0.5 + win) / amount) * 100;
 
+                int64_t last_game = r.get_int64(row, last_game_col);
                 emb.add_field(
-                    std::format("{}) {}", total_cmd, game_row.at("game_name")),
+                    std::format("{}) {}", total_cmd, r.get_string_view(row, game_name_col)),
                     std::format(
                         "Was played {} time(s).\nLast time played: <t:{}> (<t:{}:R>).\n {} game(s) are active now.\n"
                         "You won {} time(s). You played in draw {} time(s). You lost {} time(s).\n"
                         "Win rate: {:.2f}%",
-                        amount, game_row.at("last_game"), game_row.at("last_game"), active, win, draw, lose,
-                        percentage));
+                        amount, last_game, last_game, active, win, draw, lose, percentage));
             }
 
             // calculate win percentage using formula https://en.wikipedia.org/wiki/Winning_percentage
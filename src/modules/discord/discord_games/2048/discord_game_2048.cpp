@@ -4,6 +4,8 @@
 
 #include "discord_game_2048.hpp"
 
+#include <bit>
+
 namespace gb {
     namespace n_2048 {
 
@@ -41,7 +43,28 @@ namespace gb {
             _data.button_click_handler->wait_for_with_reply(message, {get_current_player()}, 60);
         _data.bot->reply(sevent, message);
         Button_click_return r = co_await button_click_awaitable;
+        co_await play(std::move(message), std::move(r), std::move(sevent));
+        co_return;
+    }
+
+    dpp::task<void> Discord_game_2048::resume(dpp::message message) {
+        message.add_embed(dpp::embed());
+        this->find_clear();
+        this->get_possible_moves();
+        prepare_message(message);
+        dpp::task<Button_click_return> button_click_awaitable =
+            _data.button_click_handler->wait_for_with_reply(message, {get_current_player()}, 60);
+        _data.bot->message_edit(message);
+        Button_click_return r = co_await button_click_awaitable;
+        co_await play(std::move(message), std::move(r), std::nullopt);
+        co_return;
+    }
+
+    dpp::task<void> Discord_game_2048::play(dpp::message message, Button_click_return r,
+                                            std::optional<dpp::slashcommand_t> sevent) {
         dpp::button_click_t event;
+        bool is_clicked = false;
+        dpp::task<Button_click_return> button_click_awaitable;
         while (1) {
             if (r.second) {
                 // timeout
@@ -50,15 +73,19 @@ namespace gb {
                           get_current_player()) + " lost his game.\n";
                 message.embeds[0].set_color(dpp::colors::red).set_title("Game Timeout.").set_description(desc);
                 message.embeds[0].set_image(add_image(message, create_image()));
-                if (message.id !=0) {
+                if (is_clicked) {
                     _data.bot->event_edit_original_response(event,message);
                 }
+                else if (sevent) {
+                    _data.bot->event_edit_original_response(*sevent,message);
+                }
                 else {
-                    _data.bot->event_edit_original_response(sevent,message);
+                    _data.bot->message_edit(message);
                 }
                 remove_player(USER_REMOVE_REASON::TIMEOUT, get_current_player());
                 break;
             }
+            is_clicked = true;
             event = r.first;
             message.id = event.command.message_id;
             if (event.custom_id == "up") {
@@ -116,6 +143,7 @@ namespace gb {
                 break;
             }
             prepare_message(message);
+            save_checkpoint(message);
             button_click_awaitable =
                 _data.button_click_handler->wait_for_with_reply(message, {get_current_player()}, 60);
             _data.bot->event_edit_original_response(event, message);
@@ -124,6 +152,34 @@ namespace gb {
 
         co_return;
     }
+
+    bool Discord_game_2048::is_resumable() const { return true; }
+
+    void Discord_game_2048::save_state(Game_snapshot_writer &writer) const {
+        writer.write_varint(1); // state version
+        for (auto &row: _board) {
+            for (unsigned int cell: row) {
+                writer.write_varint(cell ? std::countr_zero(cell) : 0);
+            }
+        }
+    }
+
+    void Discord_game_2048::load_state(Game_snapshot_reader &reader) {
+        if (reader.read_varint() != 1) {
+            throw std::runtime_error("2048 snapshot error: unknown state version");
+        }
+        for (auto &row: _board) {
+            for (unsigned int &cell: row) {
+                uint64_t exponent = reader.read_varint();
+                // 2^17 is the largest tile a 4x4 board can hold
+                if (exponent > 17) {
+                    throw std::runtime_error("2048 snapshot error: invalid tile");
+                }
+                cell = exponent ? 1u << exponent : 0;
+            }
+        }
+    }
+
     Image_ptr Discord_game_2048::create_image() {
         _img_cnt++;
         int img_size = 256;
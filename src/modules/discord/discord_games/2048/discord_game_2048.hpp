@@ -3,6 +3,7 @@
 //
 
 #pragma once
+#include <optional>
 #include <random>
 #include <src/modules/discord/discord_games/discord_game.hpp>
 
@@ -30,6 +31,39 @@ namespace gb {
          */
         dpp::task<void> run(dpp::slashcommand_t sevent);
 
+        /**
+         * @brief Processes player moves until the game ends.
+         *
+         * @param message Message showing the game.
+         * @param r Result of waiting for the first move.
+         * @param sevent Slash command which started the game, empty for resumed games.
+         * @return dpp::task<void> Coroutine representing the game execution.
+         */
+        dpp::task<void> play(dpp::message message, Button_click_return r, std::optional<dpp::slashcommand_t> sevent);
+
+    protected:
+        /**
+         * @brief Writes board to snapshot, each cell as exponent of its tile.
+         *
+         * @param writer Snapshot writer.
+         */
+        void save_state(Game_snapshot_writer &writer) const override;
+
+        /**
+         * @brief Reads board written by save_state().
+         *
+         * @param reader Snapshot reader.
+         */
+        void load_state(Game_snapshot_reader &reader) override;
+
+        /**
+         * @brief Shows restored board with new buttons and continues the game.
+         *
+         * @param message Message which showed the game before it was saved.
+         * @return dpp::task<void> Coroutine representing the game execution.
+         */
+        dpp::task<void> resume(dpp::message message) override;
+
 
     public:
         /**
@@ -47,6 +81,13 @@ namespace gb {
          */
         static std::vector<std::pair<std::string, image_generator_t>> get_image_generators();
 
+        /**
+         * @brief 2048 games are saved and resumed after restarts.
+         *
+         * @return Always true.
+         */
+        bool is_resumable() const override;
+
         /**
          * @brief Creates an image of the current game state.
          *
@@ -46,6 +46,90 @@ namespace gb {
         return {{"battleships_grid", grid_generator}};
     }
 
+    bool Discord_battleships_game::is_resumable() const { return true; }
+
+    void Discord_battleships_game::save_state(Game_snapshot_writer &writer) const {
+        writer.write_varint(1); // state version
+        for (short ind = 0; ind < 2; ind++) {
+            const battleships_engine::Player &player = _engine.get_player_by_ind(ind);
+            for (auto &column: player.get_field()) {
+                for (battleships_engine::Cell_states cell: column) {
+                    writer.write_varint(cell);
+                }
+            }
+            for (auto &ship: player.get_ships()) {
+                writer.write_varint(ship->is_rotated());
+                auto position = ship->get_position();
+                writer.write_varint(position[0]);
+                writer.write_varint(position[1]);
+                for (auto &cell: ship->get_cells()) {
+                    writer.write_varint(cell._killed);
+                }
+            }
+        }
+    }
+
+    void Discord_battleships_game::load_state(Game_snapshot_reader &reader) {
+        if (reader.read_varint() != 1) {
+            throw std::runtime_error("Battleships snapshot error: unknown state version");
+        }
+        for (short ind = 0; ind < 2; ind++) {
+            battleships_engine::Player &player = _engine.get_player_by_ind(ind);
+            battleships_engine::Field field;
+            for (auto &column: field) {
+                for (battleships_engine::Cell_states &cell: column) {
+                    uint64_t state = reader.read_varint();
+                    if (state > battleships_engine::Cell_states::OCCUPIED) {
+                        throw std::runtime_error("Battleships snapshot error: invalid cell");
+                    }
+                    cell = static_cast<battleships_engine::Cell_states>(state);
+                }
+            }
+            // ships are placed again in saved rotation, so their cells are the same as before
+            for (auto &ship: player.get_ships()) {
+                bool is_rotated = reader.read_varint();
+                uint64_t x = reader.read_varint();
+                uint64_t y = reader.read_varint();
+                if (x > 9 || y > 9) {
+                    throw std::runtime_error("Battleships snapshot error: invalid ship position");
+                }
+                battleships_engine::Cell position(static_cast<int>(x), static_cast<int>(y));
+                if (ship->is_rotated() != is_rotated) {
+                    ship->rotate(player.get_ships(), player.get_field());
+                }
+                if (!ship->can_be_placed(player.get_ships(), position)) {
+                    throw std::runtime_error("Battleships snapshot error: invalid ship position");
+                }
+                ship->place(player.get_ships(), player.get_field(), position);
+                for (size_t i = 0; i < ship->get_cells().size(); i++) {
+                    battleships_engine::Cell cell = ship->get_cells()[i];
+                    if (reader.read_varint()) {
+                        ship->attack(cell, &player.get_field());
+                    }
+                }
+            }
+            player.make_ready();
+            player.get_field() = field;
+        }
+        _engine.start_game();
+    }
+
+    dpp::task<void> Discord_battleships_game::resume(dpp::message message) {
+        if (get_players().size() != 2) {
+            throw std::runtime_error("Battleships snapshot error: game needs two players");
+        }
+        int cnt = 0;
+        for (auto &i: get_players()) {
+            _user_to_player_id.emplace(i, cnt);
+            cnt++;
+        }
+        _engine.set_player_now(static_cast<short>(get_current_player_index()));
+        _message = std::move(message);
+        _message.add_embed(dpp::embed());
+        co_await play(dpp::button_click_t());
+        co_return;
+    }
+
     Image_ptr Discord_battleships_game::generate_view_field(int state) {
         Image_ptr img = _data.image_processing->create_image({_field_size, _field_size}, _default_background);
         auto tmp = _data.image_processing->cache_get(
@@ -277,204 +361,210 @@ namespace gb {
                 end_of_game_timeout(_is_timeout == 2);
             } else {
                 _engine.start_game();
-                _move_start = std::chrono::duration_cast<std::chrono::seconds>(
-                                  std::chrono::system_clock::now().time_since_epoch())
-                                  .count();
-                dpp::task<Button_click_return> button_click_awaiter;
-                Button_click_return r;
-                event.custom_id = "FIRST_TURN";
-                _states = {0, 0};
-                while (1) {
-                    auto back_row = dpp::component().set_type(dpp::cot_action_row);
-                    back_row.add_component(dpp::component()
-                                               .set_type(dpp::cot_button)
-                                               .set_id("back")
-                                               .set_label("Back")
-                                               .set_emoji("🔙")
-                                               .set_style(dpp::cos_danger));
+                co_await play(event);
+            }
+        }
+        co_return;
+    }
 
-                    _message.components.clear();
-                    _message.embeds[0]
-                        .set_title("Battleships game")
-                        .set_description(std::format(
-                            "Turn: {}\nTimeout: <t:{}:R>\nState: {}", dpp::utility::user_mention(get_current_player()),
-                            _move_start + 60ll,
-                            (_states[_user_to_player_id[get_current_player()]] == 0
-                                 ? "Select column"
-                                 : (_states[_user_to_player_id[get_current_player()]] == 1 ? "Select row"
-                                                                                           : "Submit action"))));
-                    dpp::component row = dpp::component().set_type(dpp::cot_action_row);
-
-                    if (_states[_user_to_player_id[get_current_player()]] == 0) {
-                        for (int i: _engine.get_free_cols_for_attack()) {
-                            if (row.components.size() == 5) {
-                                _message.add_component(row);
-                                row = dpp::component().set_type(dpp::cot_action_row);
-                            }
-                            row.add_component(dpp::component()
-                                                  .set_type(dpp::cot_button)
-                                                  .set_id(std::to_string(i))
-                                                  .set_label(std::string(1, static_cast<char>(65 + i))));
-                        }
-                        if (!row.components.empty()) {
-                            _message.add_component(row);
-                        }
+    dpp::task<void> Discord_battleships_game::play(dpp::button_click_t event) {
+        _move_start = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+        dpp::task<Button_click_return> button_click_awaiter;
+        Button_click_return r;
+        event.custom_id = "FIRST_TURN";
+        _states = {0, 0};
+        while (1) {
+            auto back_row = dpp::component().set_type(dpp::cot_action_row);
+            back_row.add_component(dpp::component()
+                                       .set_type(dpp::cot_button)
+                                       .set_id("back")
+                                       .set_label("Back")
+                                       .set_emoji("🔙")
+                                       .set_style(dpp::cos_danger));
+
+            _message.components.clear();
+            _message.embeds[0]
+                .set_title("Battleships game")
+                .set_description(std::format(
+                    "Turn: {}\nTimeout: <t:{}:R>\nState: {}", dpp::utility::user_mention(get_current_player()),
+                    _move_start + 60ll,
+                    (_states[_user_to_player_id[get_current_player()]] == 0
+                         ? "Select column"
+                         : (_states[_user_to_player_id[get_current_player()]] == 1 ? "Select row"
+                                                                                   : "Submit action"))));
+            dpp::component row = dpp::component().set_type(dpp::cot_action_row);
+
+            if (_states[_user_to_player_id[get_current_player()]] == 0) {
+                for (int i: _engine.get_free_cols_for_attack()) {
+                    if (row.components.size() == 5) {
+                        _message.add_component(row);
+                        row = dpp::component().set_type(dpp::cot_action_row);
                     }
+                    row.add_component(dpp::component()
+                                          .set_type(dpp::cot_button)
+                                          .set_id(std::to_string(i))
+                                          .set_label(std::string(1, static_cast<char>(65 + i))));
+                }
+                if (!row.components.empty()) {
+                    _message.add_component(row);
+                }
+            }
 
-                    else if (_states[_user_to_player_id[get_current_player()]] == 1) {
-                        for (int i:
-                             _engine.get_free_rows_for_attack(_temp_pos[_user_to_player_id[get_current_player()]][0])) {
-                            if (row.components.size() == 5) {
-                                _message.add_component(row);
-                                row = dpp::component().set_type(dpp::cot_action_row);
-                            }
-                            row.add_component(dpp::component()
-                                                  .set_type(dpp::cot_button)
-                                                  .set_id(std::to_string(i))
-                                                  .set_label(std::to_string(i + 1)));
-                        }
-                        if (!row.components.empty()) {
-                            _message.add_component(row);
-                        }
-                        _message.add_component(back_row);
+            else if (_states[_user_to_player_id[get_current_player()]] == 1) {
+                for (int i:
+                     _engine.get_free_rows_for_attack(_temp_pos[_user_to_player_id[get_current_player()]][0])) {
+                    if (row.components.size() == 5) {
+                        _message.add_component(row);
+                        row = dpp::component().set_type(dpp::cot_action_row);
                     }
+                    row.add_component(dpp::component()
+                                          .set_type(dpp::cot_button)
+                                          .set_id(std::to_string(i))
+                                          .set_label(std::to_string(i + 1)));
+                }
+                if (!row.components.empty()) {
+                    _message.add_component(row);
+                }
+                _message.add_component(back_row);
+            }
+
+            else {
+                back_row.add_component(dpp::component()
+                                           .set_type(dpp::cot_button)
+                                           .set_label("Attack")
+                                           .set_id("attack")
+                                           .set_style(dpp::cos_secondary)
+                                           .set_emoji("🎯"));
+                _message.add_component(back_row);
+            }
+
+            _img_cnt++;
+            Image_ptr img = _data.image_processing->create_image(_image_size, _default_background);
+            auto &player = _engine.get_player_by_ind(_user_to_player_id[get_current_player()]);
+            auto &player2 = _engine.get_player_by_ind(_user_to_player_id[get_current_player()] + 1 > 1 ? 0 : 1);
+            auto view_field = generate_view_field();
+            img->overlay_image(view_field, {0, 0});
+            view_field = generate_view_field(_states[_user_to_player_id[get_current_player()]] + 1);
+            img->overlay_image(view_field, {_field_size + _distance_between_fields, 0});
+
+            draw_public_field(img, {static_cast<int>(_sector_size), static_cast<int>(_sector_size)},
+                              player.get_field(), player.get_ships());
+            if (_states[_user_to_player_id[get_current_player()]] == 1) {
+                // add column draw on  field
+                Vector2i position_start = {
+                    static_cast<int>(_field_size + _distance_between_fields + _sector_size +
+                                     _sector_size * _temp_pos[_user_to_player_id[get_current_player()]][0] +
+                                     _line_width * _temp_pos[_user_to_player_id[get_current_player()]][0]),
+                    static_cast<int>(_sector_size)};
+                img->draw_rectangle(position_start,
+                                    position_start +
+                                        Vector2i{static_cast<int>(_sector_size),
+                                                 static_cast<int>(_sector_size * 10 + _line_width * 10)},
+                                    _selected_col_color, -1);
+            } else if (_states[_user_to_player_id[get_current_player()]] == 2) {
+                Vector2i position_start = {
+                    static_cast<int>(_field_size + _distance_between_fields + _sector_size +
+                                     _sector_size * _temp_pos[_user_to_player_id[get_current_player()]][0] +
+                                     _line_width * _temp_pos[_user_to_player_id[get_current_player()]][0]),
+                    static_cast<int>(_sector_size +
+                                     _sector_size * _temp_pos[_user_to_player_id[get_current_player()]][1] +
+                                     _line_width * _temp_pos[_user_to_player_id[get_current_player()]][1])};
+                img->draw_rectangle(
+                    position_start,
+                    position_start + Vector2i{static_cast<int>(_sector_size), static_cast<int>(_sector_size)},
+                    _selected_col_color, -1);
+            }
+            draw_public_field(img,
+                              {static_cast<int>(_field_size + _distance_between_fields + _sector_size),
+                               static_cast<int>(_sector_size)},
+                              player2.get_field(), player2.get_ships());
+
+
+            _message.embeds[0].set_image(add_image(_message, img));
+            save_checkpoint(_message);
+
+            button_click_awaiter = _data.button_click_handler->wait_for_with_reply(
+                _message, {get_current_player()},
+               60);
+            if (event.custom_id == "FIRST_TURN") {
+                _data.bot->message_edit(_message);
+            } else {
+                _data.bot->event_edit_original_response(event, _message);
+            }
+            r = co_await button_click_awaiter;
+
+            if (r.second) {
+                // timeout
+                end_of_game_timeout();
+                break;
+            }
+            event = r.first;
+            if (event.custom_id == "back") {
+                _states[_user_to_player_id[get_current_player()]]--;
+                continue;
+            }
 
-                    else {
-                        back_row.add_component(dpp::component()
-                                                   .set_type(dpp::cot_button)
-                                                   .set_label("Attack")
-                                                   .set_id("attack")
-                                                   .set_style(dpp::cos_secondary)
-                                                   .set_emoji("🎯"));
-                        _message.add_component(back_row);
+            if (_states[_user_to_player_id[get_current_player()]] == 0) {
+                _temp_pos[_user_to_player_id[get_current_player()]][0] = std::stoi(event.custom_id);
+            } else if (_states[_user_to_player_id[get_current_player()]] == 1) {
+                _temp_pos[_user_to_player_id[get_current_player()]][1] = std::stoi(event.custom_id);
+            } else {
+                if (!_engine.attack({_temp_pos[_user_to_player_id[get_current_player()]]})) {
+                    next_player();
+                } else {
+                    auto ind = _user_to_player_id[get_current_player()] == 1 ? 0 : 1;
+                    auto &ships = _engine.get_player_by_ind(ind).get_ships();
+                    for (const auto &i: ships) {
+                        if (i->get_type() == battleships_engine::Ship_types::Carrier && i->is_dead()) {
+                            _data.achievements_processing->activate_achievement(
+                                "44.92002°, 31.49265°", get_current_player(), event.command.channel_id);
+                        }
                     }
+                }
+                int winner = _engine.get_winner();
+                if (winner != -1) {
+                    // win
+                    auto winner_id = get_current_player();
+                    next_player();
+                    _message.components.clear();
+                    _message.embeds[0]
+                        .set_title("Game over")
+                        .set_description(std::format(
+                            "Player {} won a game.\nPlayer {} will be luckier next time.",
+                            dpp::utility::user_mention(winner_id),
+                            dpp::utility::user_mention(winner == 1 ? get_players()[0] : get_players()[1])))
+                        .set_color(dpp::colors::blue);
 
                     _img_cnt++;
                     Image_ptr img = _data.image_processing->create_image(_image_size, _default_background);
                     auto &player = _engine.get_player_by_ind(_user_to_player_id[get_current_player()]);
-                    auto &player2 = _engine.get_player_by_ind(_user_to_player_id[get_current_player()] + 1 > 1 ? 0 : 1);
+                    auto &player2 =
+                        _engine.get_player_by_ind(_user_to_player_id[get_current_player()] + 1 > 1 ? 0 : 1);
                     auto view_field = generate_view_field();
                     img->overlay_image(view_field, {0, 0});
                     view_field = generate_view_field(_states[_user_to_player_id[get_current_player()]] + 1);
                     img->overlay_image(view_field, {_field_size + _distance_between_fields, 0});
-
-                    draw_public_field(img, {static_cast<int>(_sector_size), static_cast<int>(_sector_size)},
-                                      player.get_field(), player.get_ships());
-                    if (_states[_user_to_player_id[get_current_player()]] == 1) {
-                        // add column draw on  field
-                        Vector2i position_start = {
-                            static_cast<int>(_field_size + _distance_between_fields + _sector_size +
-                                             _sector_size * _temp_pos[_user_to_player_id[get_current_player()]][0] +
-                                             _line_width * _temp_pos[_user_to_player_id[get_current_player()]][0]),
-                            static_cast<int>(_sector_size)};
-                        img->draw_rectangle(position_start,
-                                            position_start +
-                                                Vector2i{static_cast<int>(_sector_size),
-                                                         static_cast<int>(_sector_size * 10 + _line_width * 10)},
-                                            _selected_col_color, -1);
-                    } else if (_states[_user_to_player_id[get_current_player()]] == 2) {
-                        Vector2i position_start = {
-                            static_cast<int>(_field_size + _distance_between_fields + _sector_size +
-                                             _sector_size * _temp_pos[_user_to_player_id[get_current_player()]][0] +
-                                             _line_width * _temp_pos[_user_to_player_id[get_current_player()]][0]),
-                            static_cast<int>(_sector_size +
-                                             _sector_size * _temp_pos[_user_to_player_id[get_current_player()]][1] +
-                                             _line_width * _temp_pos[_user_to_player_id[get_current_player()]][1])};
-                        img->draw_rectangle(
-                            position_start,
-                            position_start + Vector2i{static_cast<int>(_sector_size), static_cast<int>(_sector_size)},
-                            _selected_col_color, -1);
-                    }
-                    draw_public_field(img,
-                                      {static_cast<int>(_field_size + _distance_between_fields + _sector_size),
-                                       static_cast<int>(_sector_size)},
-                                      player2.get_field(), player2.get_ships());
-
-
+                    draw_private_field(img, {static_cast<int>(_sector_size), static_cast<int>(_sector_size)},
+                                       player.get_field(), player.get_ships());
+                    draw_private_field(img,
+                                       {static_cast<int>(_field_size + _distance_between_fields + _sector_size),
+                                        static_cast<int>(_sector_size)},
+                                       player2.get_field(), player2.get_ships());
                     _message.embeds[0].set_image(add_image(_message, img));
+                    _data.bot->event_edit_original_response(event, _message);
 
-                    button_click_awaiter = _data.button_click_handler->wait_for_with_reply(
-                        _message, {get_current_player()},
-                       60);
-                    if (event.custom_id == "FIRST_TURN") {
-                        _data.bot->message_edit(_message);
-                    } else {
-                        _data.bot->event_edit_original_response(event, _message);
-                    }
-                    r = co_await button_click_awaiter;
-
-                    if (r.second) {
-                        // timeout
-                        end_of_game_timeout();
-                        break;
-                    }
-                    event = r.first;
-                    if (event.custom_id == "back") {
-                        _states[_user_to_player_id[get_current_player()]]--;
-                        continue;
-                    }
-
-                    if (_states[_user_to_player_id[get_current_player()]] == 0) {
-                        _temp_pos[_user_to_player_id[get_current_player()]][0] = std::stoi(event.custom_id);
-                    } else if (_states[_user_to_player_id[get_current_player()]] == 1) {
-                        _temp_pos[_user_to_player_id[get_current_player()]][1] = std::stoi(event.custom_id);
-                    } else {
-                        if (!_engine.attack({_temp_pos[_user_to_player_id[get_current_player()]]})) {
-                            next_player();
-                        } else {
-                            auto ind = _user_to_player_id[get_current_player()] == 1 ? 0 : 1;
-                            auto &ships = _engine.get_player_by_ind(ind).get_ships();
-                            for (const auto &i: ships) {
-                                if (i->get_type() == battleships_engine::Ship_types::Carrier && i->is_dead()) {
-                                    _data.achievements_processing->activate_achievement(
-                                        "44.92002°, 31.49265°", get_current_player(), event.command.channel_id);
-                                }
-                            }
-                        }
-                        int winner = _engine.get_winner();
-                        if (winner != -1) {
-                            // win
-                            auto winner_id = get_current_player();
-                            next_player();
-                            _message.components.clear();
-                            _message.embeds[0]
-                                .set_title("Game over")
-                                .set_description(std::format(
-                                    "Player {} won a game.\nPlayer {} will be luckier next time.",
-                                    dpp::utility::user_mention(winner_id),
-                                    dpp::utility::user_mention(winner == 1 ? get_players()[0] : get_players()[1])))
-                                .set_color(dpp::colors::blue);
-
-                            _img_cnt++;
-                            Image_ptr img = _data.image_processing->create_image(_image_size, _default_background);
-                            auto &player = _engine.get_player_by_ind(_user_to_player_id[get_current_player()]);
-                            auto &player2 =
-                                _engine.get_player_by_ind(_user_to_player_id[get_current_player()] + 1 > 1 ? 0 : 1);
-                            auto view_field = generate_view_field();
-                            img->overlay_image(view_field, {0, 0});
-                            view_field = generate_view_field(_states[_user_to_player_id[get_current_player()]] + 1);
-                            img->overlay_image(view_field, {_field_size + _distance_between_fields, 0});
-                            draw_private_field(img, {static_cast<int>(_sector_size), static_cast<int>(_sector_size)},
-                                               player.get_field(), player.get_ships());
-                            draw_private_field(img,
-                                               {static_cast<int>(_field_size + _distance_between_fields + _sector_size),
-                                                static_cast<int>(_sector_size)},
-                                               player2.get_field(), player2.get_ships());
-                            _message.embeds[0].set_image(add_image(_message, img));
-                            _data.bot->event_edit_original_response(event, _message);
-
-                            remove_player(USER_REMOVE_REASON::WIN, winner_id);
-                            remove_player(USER_REMOVE_REASON::LOSE, get_current_player());
-                            break;
-                        }
-                        _move_start = std::chrono::duration_cast<std::chrono::seconds>(
-                                          std::chrono::system_clock::now().time_since_epoch())
-                                          .count();
-                        _states[_user_to_player_id[get_current_player()]] = -1;
-                    }
-                    _states[_user_to_player_id[get_current_player()]]++;
+                    remove_player(USER_REMOVE_REASON::WIN, winner_id);
+                    remove_player(USER_REMOVE_REASON::LOSE, get_current_player());
+                    break;
                 }
+                _move_start = std::chrono::duration_cast<std::chrono::seconds>(
+                                  std::chrono::system_clock::now().time_since_epoch())
+                                  .count();
+                _states[_user_to_player_id[get_current_player()]] = -1;
             }
+            _states[_user_to_player_id[get_current_player()]]++;
         }
         co_return;
     }
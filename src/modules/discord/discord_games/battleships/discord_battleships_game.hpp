@@ -84,6 +84,39 @@ namespace gb {
          */
         dpp::task<void> run(dpp::button_click_t event);
 
+        /**
+         * @brief Runs the attack phase, after both players placed their ships.
+         *
+         * @param event The button click event which started the game, its response is replaced by the game message.
+         * @return A task that processes the attacks asynchronously.
+         */
+        dpp::task<void> play(dpp::button_click_t event);
+
+    protected:
+        /**
+         * @brief Writes fields and ships of both players to snapshot.
+         *
+         * Only the attack phase is saved, ships are placed in private messages which are not restored.
+         *
+         * @param writer Snapshot writer.
+         */
+        void save_state(Game_snapshot_writer &writer) const override;
+
+        /**
+         * @brief Reads fields and ships written by save_state() and starts the engine.
+         *
+         * @param reader Snapshot reader.
+         */
+        void load_state(Game_snapshot_reader &reader) override;
+
+        /**
+         * @brief Continues the attack phase of restored game.
+         *
+         * @param message Message which showed the game before it was saved.
+         * @return A task that processes the attacks asynchronously.
+         */
+        dpp::task<void> resume(dpp::message message) override;
+
     public:
         /**
          * @brief Constructor for the Discord Battleships game.
@@ -102,6 +135,13 @@ namespace gb {
          */
         static std::vector<std::pair<std::string, image_generator_t>> get_image_generators();
 
+        /**
+         * @brief Battleships games are saved and resumed after restarts once both players placed their ships.
+         *
+         * @return Always true.
+         */
+        bool is_resumable() const override;
+
         /**
          * @brief Generates a view of the game field.
          *
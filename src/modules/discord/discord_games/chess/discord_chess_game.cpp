@@ -7,6 +7,31 @@
 
 namespace gb {
 
+    /**
+     * @brief Gets engine of the calling search thread, its table is shared by games searched on the thread.
+     */
+    static chess_engine::Chess_engine &get_engine() {
+        static thread_local chess_engine::Chess_engine engine;
+        return engine;
+    }
+
+    /**
+     * @brief Searches computer move on the search pool, so the search never blocks event threads.
+     *
+     * The caller is resumed back on the executor it called from, so rendering and replies do not hold search threads.
+     */
+    static Task<chess_engine::Search_result> search_move(Thread_pool *pool, chess::Board board,
+                                                         std::chrono::steady_clock::time_point deadline,
+                                                         std::shared_ptr<std::atomic_bool> cancel) {
+        Executor *caller = Executor::current();
+        co_await pool->schedule();
+        chess_engine::Search_result result = get_engine().search(std::move(board), deadline, *cancel);
+        if (caller) {
+            co_await caller->schedule();
+        }
+        co_return result;
+    }
+
     Vector2i Discord_chess_game::chess_board_cords_to_numbers(std::string to_convert) {
         return {static_cast<int>(to_convert[0]) - 97, 8 - (to_convert[1] - '0')};
     }
@@ -96,15 +121,85 @@ namespace gb {
     Discord_chess_game::Discord_chess_game(Game_data_initialization &_data,
                                            const std::vector<dpp::snowflake> &players) : Discord_game(_data, players,&Discord_chess_game::run) {}
 
+    Discord_chess_game::Discord_chess_game(Game_data_initialization &_data, const dpp::snowflake &player,
+                                           Thread_pool *search_pool, std::chrono::milliseconds computer_move_budget,
+                                           std::shared_ptr<std::atomic_bool> search_cancel) :
+        Discord_game(_data, {player}, &Discord_chess_game::run_vs_computer), _search_pool(search_pool),
+        _computer_move_budget(computer_move_budget), _search_cancel(std::move(search_cancel)) {}
+
     dpp::task<void> Discord_chess_game::run(dpp::button_click_t event, int timeout) {
         dpp::message message;
         message.add_embed(dpp::embed());
         message.id = event.command.message_id;
         message.channel_id = event.command.channel_id;
         message.guild_id = event.command.guild_id;
+        event.reply(dpp::ir_update_message,"Game is starting");
+        _timeout = timeout;
+        co_await play(message, [this, event](const dpp::message &m) { _data.bot->event_edit_original_response(event, m); });
+        co_return;
+    }
+
+    dpp::task<void> Discord_chess_game::resume(dpp::message message) {
+        message.add_embed(dpp::embed());
+        co_await play(std::move(message), [this](const dpp::message &m) { _data.bot->message_edit(m); });
+        co_return;
+    }
+
+    bool Discord_chess_game::is_resumable() const { return !_search_pool; }
+
+    void Discord_chess_game::save_state(Game_snapshot_writer &writer) const {
+        writer.write_varint(1); // state version
+        writer.write_string(_board.fen());
+        writer.write_varint(_moves_amount);
+        writer.write_varint(_timeout);
+    }
+
+    void Discord_chess_game::load_state(Game_snapshot_reader &reader) {
+        if (reader.read_varint() != 1) {
+            throw std::runtime_error("Chess snapshot error: unknown state version");
+        }
+        std::string fen = reader.read_string();
+        try {
+            _board = chess::Board(fen);
+        } catch (const std::exception &e) {
+            throw std::runtime_error(std::string("Chess snapshot error: invalid position: ") + e.what());
+        }
+        _moves_amount = static_cast<int>(reader.read_varint());
+        _timeout = static_cast<int>(reader.read_varint());
+    }
+
+    dpp::task<void> Discord_chess_game::run_vs_computer(dpp::slashcommand_t sevent, int timeout) {
+        dpp::message message;
+        message.add_embed(dpp::embed());
+        message.channel_id = sevent.command.channel_id;
+        message.guild_id = sevent.command.guild_id;
+        bool is_replied = false;
+        _timeout = timeout;
+        co_await play(message,
+                      [this, sevent, is_replied](const dpp::message &m) mutable {
+                          if (is_replied) {
+                              _data.bot->event_edit_original_response(sevent, m);
+                          } else {
+                              _data.bot->reply(sevent, m);
+                              is_replied = true;
+                          }
+                      });
+        co_return;
+    }
+
+    dpp::task<void> Discord_chess_game::play(dpp::message message,
+                                             std::function<void(const dpp::message &)> first_response) {
+        std::optional<dpp::button_click_t> event;
+        auto respond = [&](const dpp::message &m) {
+            if (event) {
+                _data.bot->event_edit_original_response(*event, m);
+            } else {
+                first_response(m);
+            }
+        };
         dpp::task<Button_click_return> button_click_awaitable;
         Button_click_return r;
-        time_t clock = time(nullptr) + timeout;
+        time_t clock = time(nullptr) + _timeout;
 
         auto send_message = [&]() -> dpp::task<void> {
 
@@ -148,10 +243,11 @@ namespace gb {
 
                 }
                 message.embeds[0].set_image(add_image(message, generate_image()));
+                save_checkpoint(message);
                 button_click_awaitable = _data.button_click_handler->wait_for_with_reply(
                     message, {get_current_player()},
                     (clock - time(nullptr)));
-                _data.bot->event_edit_original_response(event, message);
+                respond(message);
                 r = co_await button_click_awaitable;
             } else {
                 message.embeds[0].set_description(
@@ -236,15 +332,65 @@ namespace gb {
                 button_click_awaitable = _data.button_click_handler->wait_for_with_reply(
                     message, {get_current_player()},
                     (clock - time(nullptr)));
-                _data.bot->event_edit_original_response(event, message);
+                respond(message);
                 r = co_await button_click_awaitable;
             }
             co_return;
         };
-        event.reply(dpp::ir_update_message,"Game is starting");
+        // result of the last move for the player who made it, empty if the game goes on
+        auto get_result = [&]() -> std::optional<USER_REMOVE_REASON> {
+            if (!_board.legal_moves().count()) {
+                return _board.is_check() ? USER_REMOVE_REASON::WIN : USER_REMOVE_REASON::DRAW;
+            }
+            if (_board.is_fivefold_repetition() || _board.is_insufficient_material()) {
+                return USER_REMOVE_REASON::DRAW;
+            }
+            return std::nullopt;
+        };
+
+        // ends game against the computer, reason is from the player's side
+        auto finish_vs_computer = [&](USER_REMOVE_REASON reason) {
+            std::string player = dpp::utility::user_mention(get_current_player());
+            message.components.clear();
+            message.embeds[0].set_title("Game over");
+            switch (reason) {
+                case USER_REMOVE_REASON::WIN:
+                    message.embeds[0]
+                        .set_description("Player " + player + " *won* the game against the computer.")
+                        .set_color(dpp::colors::blue);
+                    break;
+                case USER_REMOVE_REASON::DRAW:
+                    message.embeds[0]
+                        .set_description("Player " + player +
+                                         " and the computer tried their best, but the game ended in a *DRAW!!!*")
+                        .set_color(dpp::colors::yellow);
+                    break;
+                case USER_REMOVE_REASON::TIMEOUT:
+                    message.embeds[0]
+                        .set_title("Game Timeout.")
+                        .set_description("The computer was automatically selected as the winner.\nPlayer " + player +
+                                         " should think faster next time.")
+                        .set_color(dpp::colors::red);
+                    break;
+                default:
+                    message.embeds[0]
+                        .set_description("The computer *won* the game.\nPlayer " + player +
+                                         " will be luckier next time")
+                        .set_color(dpp::colors::red);
+                    break;
+            }
+            message.embeds[0].set_image(add_image(message, generate_image()));
+            respond(message);
+            remove_player(reason, get_current_player());
+        };
+
         co_await send_message();
 
         while (1) {
+            if (r.second && _search_pool) {
+                finish_vs_computer(USER_REMOVE_REASON::TIMEOUT);
+                break;
+            }
             if (r.second) {
                 // timeout
                 next_player();
@@ -254,7 +400,7 @@ namespace gb {
                 message.embeds[0].set_color(dpp::colors::red).set_title("Game Timeout.").set_description(desc);
                 message.embeds[0].set_image(add_image(message,generate_image()));
                 message.components.clear();
-                _data.bot->event_edit_original_response(event,message);
+                respond(message);
                 remove_player(USER_REMOVE_REASON::TIMEOUT,get_current_player());
                 remove_player(USER_REMOVE_REASON::WIN,get_current_player());
                 break;
@@ -262,7 +408,7 @@ namespace gb {
             event = r.first;
 
 
-            if (event.custom_id == "back") {
+            if (event->custom_id == "back") {
                 if (_next) {
                     _next = false;
                     _choose_figure = !_choose_figure;
@@ -271,15 +417,42 @@ namespace gb {
                     _selected_figure = "";
                 }
                 co_await send_message();
-            } else if (event.custom_id == "next") {
+            } else if (event->custom_id == "next") {
                 _next = true;
                 _choose_figure = !_choose_figure;
                 co_await send_message();
             } else if (_choose_figure) {
                 _next = false;
                 _selected_figure = "";
-               // std::cout << event.custom_id << '\n';
-                _board.push(chess::Move::from_uci(event.custom_id));
+               // std::cout << event->custom_id << '\n';
+                _board.push(chess::Move::from_uci(event->custom_id));
+
+                if (_search_pool) {
+                    std::optional<USER_REMOVE_REASON> result = get_result();
+                    if (result) {
+                        // computer games grant no achievements
+                        finish_vs_computer(*result);
+                        break;
+                    }
+                    // deadline is taken before the search is queued, so a busy pool shortens thinking, not the reply
+                    chess_engine::Search_result found = co_await search_move(
+                        _search_pool, _board, std::chrono::steady_clock::now() + _computer_move_budget, _search_cancel);
+                    if (found.is_cancelled || !found.move) {
+                        // the command is stopping, the game is aborted as a draw
+                        finish_vs_computer(USER_REMOVE_REASON::DRAW);
+                        break;
+                    }
+                    _board.push(*found.move);
+                    result = get_result();
+                    if (result) {
+                        finish_vs_computer(result == USER_REMOVE_REASON::WIN ? USER_REMOVE_REASON::LOSE : *result);
+                        break;
+                    }
+                    _moves_amount++;
+                    clock = time(nullptr) + _timeout;
+                    co_await send_message();
+                    continue;
+                }
 
                 if (!_board.legal_moves().count()) {
                     if (!_board.is_check()) {
@@ -291,16 +464,16 @@ namespace gb {
                                              dpp::utility::user_mention(get_players()[1]) +
                                              " tried their best, but the game ended in a *DRAW!!!*")
                             .set_color(dpp::colors::yellow);
-                        _data.bot->event_edit_original_response(event, message);
+                        respond(message);
                         remove_player(USER_REMOVE_REASON::DRAW, get_current_player());
                         remove_player(USER_REMOVE_REASON::DRAW, get_current_player());
                         break;
                     } else {
                         _data.achievements_processing->activate_achievement(
-                            "Chess.com wait for me", get_current_player(), event.command.channel_id);
+                            "Chess.com wait for me", get_current_player(), message.channel_id);
                         if (_moves_amount < 20) {
                             _data.achievements_processing->activate_achievement("Blitzkrieg", get_current_player(),
-                                                                                event.command.channel_id);
+                                                                                message.channel_id);
                         }
                         message.components.clear();
                         std::string desc ="Player "+dpp::utility::user_mention(get_current_player())+ " *won* the game.";
@@ -308,7 +481,7 @@ namespace gb {
                         desc += "\nPlayer "+dpp::utility::user_mention(get_current_player())+" will be luckier next time";
                         message.embeds[0].set_title("Game over").set_description(desc).set_color(dpp::colors::blue);
                         message.embeds[0].set_image(add_image(message,generate_image()));
-                        _data.bot->event_edit_original_response(event,message);
+                        respond(message);
                         remove_player(USER_REMOVE_REASON::LOSE,get_current_player());
                         remove_player(USER_REMOVE_REASON::WIN,get_current_player());
                         break;
@@ -323,18 +496,18 @@ namespace gb {
                                          " tried their best, but the game ended in a *DRAW!!!*")
                         .set_color(dpp::colors::yellow);
                     message.embeds[0].set_image(add_image(message,generate_image()));
-                    _data.bot->event_edit_original_response(event, message);
+                    respond(message);
                     remove_player(USER_REMOVE_REASON::DRAW, get_current_player());
                     remove_player(USER_REMOVE_REASON::DRAW, get_current_player());
                     break;
                 } else {
                     _moves_amount++;
-                    clock = time(nullptr) + timeout;
+                    clock = time(nullptr) + _timeout;
                     next_player();
                     co_await send_message();
                 }
             } else {
-                _selected_figure = event.custom_id;
+                _selected_figure = event->custom_id;
                 co_await send_message();
             }
         }
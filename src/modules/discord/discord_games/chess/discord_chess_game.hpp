@@ -5,7 +5,9 @@
 #pragma once
 
 #include <src/modules/discord/discord_games/discord_game.hpp>
+#include <src/utils/coro/coro.hpp>
 #include "src/games/chess/chess/chess.h"
+#include "src/games/chess_engine/chess_engine.hpp"
 
 namespace chess {
 
@@ -43,6 +45,10 @@ namespace gb {
         bool _next = false; ///< Indicates whether the select turn menu should show second page.
         int _moves_amount = 0; ///< The number of moves made in the game.
         bool is_view = false; ///< Indicates if the current game state is being viewed (as opposed to played).
+        Thread_pool *_search_pool = nullptr; ///< Pool searching moves of the computer, nullptr if two people play.
+        std::chrono::milliseconds _computer_move_budget{0}; ///< Time the computer may think about a move.
+        std::shared_ptr<std::atomic_bool> _search_cancel; ///< Set when the chess command stops, cancels running search.
+        int _timeout = 60; ///< The amount of time (in seconds) before a move times out.
 
         /**
          * @brief Runs the main loop of the chess game, handling button clicks and moves.
@@ -53,6 +59,46 @@ namespace gb {
          */
         dpp::task<void> run(dpp::button_click_t event, int timeout = 60);
 
+        /**
+         * @brief Runs the game of the only player against the computer, the player is white.
+         *
+         * @param sevent The slash command which started the game.
+         * @param timeout The amount of time (in seconds) before a move times out.
+         * @return A task representing the asynchronous execution of the game.
+         */
+        dpp::task<void> run_vs_computer(dpp::slashcommand_t sevent, int timeout);
+
+        /**
+         * @brief Main loop shared by both game modes.
+         *
+         * @param message Message showing the game, with channel and guild set.
+         * @param first_response Shows message before the first button click, later clicks are answered directly.
+         * @return A task representing the asynchronous execution of the game.
+         */
+        dpp::task<void> play(dpp::message message, std::function<void(const dpp::message &)> first_response);
+
+    protected:
+        /**
+         * @brief Writes position as FEN, amount of moves and move timeout to snapshot.
+         *
+         * @param writer Snapshot writer.
+         */
+        void save_state(Game_snapshot_writer &writer) const override;
+
+        /**
+         * @brief Reads state written by save_state().
+         *
+         * @param reader Snapshot reader.
+         */
+        void load_state(Game_snapshot_reader &reader) override;
+
+        /**
+         * @brief Shows restored board with new buttons and continues the game from choosing a figure.
+         *
+         * @param message Message which showed the game before it was saved.
+         * @return A task representing the asynchronous execution of the game.
+         */
+        dpp::task<void> resume(dpp::message message) override;
 
     public:
         /**
@@ -78,6 +124,19 @@ namespace gb {
          */
         Discord_chess_game(Game_data_initialization &_data, const std::vector<dpp::snowflake> &players);
 
+        /**
+         * @brief Constructs a Discord chess game of one player against the computer.
+         *
+         * @param _data Game initialization data such as game settings.
+         * @param player The only player, started with the slash command event.
+         * @param search_pool Pool the computer moves are searched on, must outlive the game.
+         * @param computer_move_budget Time the computer may think about a move.
+         * @param search_cancel Flag which cancels the running search, set when the chess command stops.
+         */
+        Discord_chess_game(Game_data_initialization &_data, const dpp::snowflake &player, Thread_pool *search_pool,
+                           std::chrono::milliseconds computer_move_budget,
+                           std::shared_ptr<std::atomic_bool> search_cancel);
+
         /**
          * @brief Retrieves the image generators used to render the chess board.
          *
@@ -85,6 +144,15 @@ namespace gb {
          * generator function.
          */
         static std::vector<std::pair<std::string, image_generator_t>> get_image_generators();
+
+        /**
+         * @brief Games of two players are saved and resumed after restarts.
+         *
+         * Games against the computer are not, their search pool is owned by the chess command.
+         *
+         * @return True if two people play.
+         */
+        bool is_resumable() const override;
     };
 
 } // namespace gb
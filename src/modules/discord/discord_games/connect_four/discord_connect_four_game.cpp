@@ -5,10 +5,25 @@
 #include "discord_connect_four_game.hpp"
 
 namespace gb {
+    /**
+     * @brief Gets solver of the calling thread.
+     *
+     * Every event thread keeps its own solver, so games share transposition tables without locking. Coroutines
+     * can resume on other thread, so the solver must not be kept across co_await.
+     */
+    static connect_four::Connect_four_solver &get_solver() {
+        static thread_local connect_four::Connect_four_solver solver;
+        return solver;
+    }
+
     Discord_connect_four_game::Discord_connect_four_game(Game_data_initialization &_data,
                                                          const std::vector<dpp::snowflake> &players) :
         Discord_game(_data, players, &Discord_connect_four_game::run) {}
 
+    Discord_connect_four_game::Discord_connect_four_game(Game_data_initialization &_data,
+                                                         const dpp::snowflake &player) :
+        Discord_game(_data, {player}, &Discord_connect_four_game::run_vs_computer) {}
+
     std::vector<std::pair<std::string, image_generator_t>> Discord_connect_four_game::get_image_generators() {
         return {};
     }
@@ -20,19 +35,20 @@ namespace gb {
         int distance_between = 2;
         int circle_size = size / 12 - distance_between / 2;
         Image_ptr img = _data.image_processing->create_image({ size/6*7+distance_between,size+for_numbers}, {0, 0, 255});
-        for (int y = 0; y < static_cast<int>(std::size(_board)); y++) {
-            for (int x = 0; x < static_cast<int>(std::size(_board[y])); x++) {
+        for (int y = 0; y < connect_four::height; y++) {
+            for (int x = 0; x < connect_four::width; x++) {
+                int cell = _board.get_cell(y, x);
                 img->draw_circle({circle_size + distance_between + circle_size * x * 2 + distance_between * x,
                                   circle_size + distance_between + circle_size * y * 2 + distance_between * y},
                                  circle_size,
-                                 _board[y][x] == " "   ? Color(0, 0, 0)
-                                 : _board[y][x] == "r" ? Color(255, 0, 0)
-                                                      : Color(204, 204, 0),
+                                 cell == 0   ? Color(0, 0, 0)
+                                 : cell == 1 ? Color(255, 0, 0)
+                                             : Color(204, 204, 0),
                                  -1);
             }
         }
 
-        for (int x = 0; x < static_cast<int>(std::size(_board[0])); x++) {
+        for (int x = 0; x < connect_four::width; x++) {
             img->draw_text(std::to_string(x + 1),
                            {distance_between + circle_size / 2 + circle_size * x * 2 + distance_between * x,
                             size + for_numbers - for_numbers / 3},
@@ -43,6 +59,24 @@ namespace gb {
 
 
 
+    void Discord_connect_four_game::create_components(dpp::message &message) {
+        dpp::component row = dpp::component().set_type(dpp::cot_action_row);
+        for (int i = 0; i < connect_four::width; i++) {
+
+            row.add_component(dpp::component()
+                                  .set_type(dpp::cot_button)
+                                  .set_id(std::to_string(i))
+                                  .set_label(std::to_string(i + 1))
+                                  .set_disabled(!_board.can_play(i))
+                                  .set_style(dpp::cos_primary));
+            if (row.components.size() == 5) {
+                message.add_component(row);
+                row = dpp::component().set_type(dpp::cot_action_row);
+            }
+        }
+        message.add_component(row);
+    }
+
     dpp::task<void> Discord_connect_four_game::run(dpp::button_click_t event) {
         dpp::message message;
         message.add_embed(dpp::embed());
@@ -71,26 +105,12 @@ namespace gb {
                 .set_title("Connect four game")
                 .set_description(std::format(
                     "Turn: {}\nYour color is {}\nTimeout: <t:{}:R>", dpp::utility::user_mention(get_current_player()),
-                    (this->_signs[get_current_player_index()] == "r" ? "**red**" : "**yellow**"),
+                    (get_current_player_index() == 0 ? "**red**" : "**yellow**"),
                     std::chrono::duration_cast<std::chrono::seconds>(
                         std::chrono::system_clock::now().time_since_epoch())
                             .count() +
                         60));
-            dpp::component row = dpp::component().set_type(dpp::cot_action_row);
-            for (int i = 0; i < static_cast<int>(std::size(this->_board[0])); i++) {
-
-                row.add_component(dpp::component()
-                                      .set_type(dpp::cot_button)
-                                      .set_id(std::to_string(i))
-                                      .set_label(std::to_string(i + 1))
-                                      .set_disabled(this->_board[0][i] != " ")
-                                      .set_style(dpp::cos_primary));
-                if (row.components.size() == 5) {
-                    message.add_component(row);
-                    row = dpp::component().set_type(dpp::cot_action_row);
-                }
-            }
-            message.add_component(row);
+            create_components(message);
 
             message.embeds[0].set_image(add_image(message, generate_image()));
             button_click_awaitable = _data.button_click_handler->wait_for_with_reply(message, {get_current_player()}, 60);
@@ -101,8 +121,7 @@ namespace gb {
         event.reply(dpp::ir_update_message,"Game is starting");
         co_await send_message();
 
-        bool end = false;
-        while (!end) {
+        while (true) {
             if (r.second) {
                 // timeout
                 next_player();
@@ -119,70 +138,19 @@ namespace gb {
             }
             event = r.first;
 
-            // place object
-            for (int i = static_cast<int>(std::size(_board) - 1); i >= 0; i--) {
-                if (_board[i][std::stoi(event.custom_id)] == " ") {
-                    _board[i][std::stoi(event.custom_id)] = _signs[get_current_player_index()];
-                    break;
-                }
-            }
-            // check win
-            std::string player = _signs[get_current_player_index()];
-            for (int r = 0; r < 3; r++) {
-                for (int c = 0; c < 4; c++) {
-                    if (_board[r][c] == player && _board[r + 1][c + 1] == player && _board[r + 2][c + 2] == player &&
-                        _board[r + 3][c + 3] == player && !end) {
-                        end_game();
-                        end = true;
-                    }
-                }
-            }
-            for (int r = 0; r < 3; r++) {
-                for (int c = 0; c < 7; c++) {
-                    if (_board[r][c] == player && _board[r + 1][c] == player && _board[r + 2][c] == player &&
-                        _board[r + 3][c] == player && !end) {
-                        end_game();
-                        end = true;
-                    }
-                }
-            }
-            for (int r = 0; r < 6; r++) {
-                for (int c = 0; c < 4; c++) {
-                    if (_board[r][c] == player && _board[r][c + 1] == player && _board[r][c + 2] == player &&
-                        _board[r][c + 3] == player&& !end) {
-                        end_game();
-                        end = true;
-                    }
-                }
-            }
-            for (int r = 5; r > 2; r--) {
-                for (int c = 0; c < 4; c++) {
-                    if (_board[r][c] == player && _board[r - 1][c + 1] == player && _board[r - 2][c + 2] == player &&
-                        _board[r - 3][c + 3] == player&& !end) {
-                        end_game();
-                        end = true;
-                    }
-                }
+            _board.play(std::stoi(event.custom_id));
+            if (_board.is_won()) {
+                end_game();
+                break;
             }
 
             // usual move
-            bool skip = false;
-            for (int i = 0; i < static_cast<int>(std::size(_board[0])) && !end; i++) {
-                if (_board[0][i] == " ") {
-                    next_player();
-                    co_await send_message();
-                    skip = true;
-                    break;
-                }
-            }
-            if (skip) {
+            if (!_board.is_full()) {
+                next_player();
+                co_await send_message();
                 continue;
             }
 
-            if(end) {
-                break;
-            }
-
             // draw
             message.components.clear();
             message.embeds[0]
@@ -200,4 +168,104 @@ namespace gb {
         }
         co_return;
     }
+
+    dpp::task<void> Discord_connect_four_game::run_vs_computer(dpp::slashcommand_t sevent) {
+        dpp::message message;
+        message.add_embed(dpp::embed());
+        message.channel_id = sevent.command.channel_id;
+        message.guild_id = sevent.command.guild_id;
+        dpp::button_click_t event;
+        bool is_first_move = true;
+        auto edit_response = [&]() {
+            message.components.clear();
+            message.embeds[0].set_image(add_image(message, generate_image()));
+            if (is_first_move) {
+                _data.bot->event_edit_original_response(sevent, message);
+            } else {
+                _data.bot->event_edit_original_response(event, message);
+            }
+        };
+
+        while (true) {
+            message.components.clear();
+            message.embeds[0]
+                .set_title("Connect four game")
+                .set_description(std::format(
+                    "{} plays **red** against the computer.\nTimeout: <t:{}:R>",
+                    dpp::utility::user_mention(get_current_player()),
+                    std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                            .count() +
+                        60))
+                .set_color(dpp::colors::blue);
+            create_components(message);
+            message.embeds[0].set_image(add_image(message, generate_image()));
+            auto button_click_awaitable =
+                _data.button_click_handler->wait_for_with_reply(message, {get_current_player()}, 60);
+            if (is_first_move) {
+                _data.bot->reply(sevent, message);
+            } else {
+                _data.bot->event_edit_original_response(event, message);
+            }
+            Button_click_return r = co_await button_click_awaitable;
+            if (r.second) {
+                message.embeds[0]
+                    .set_color(dpp::colors::red)
+                    .set_title("Game Timeout.")
+                    .set_description("The computer was automatically selected as the winner.\nPlayer " +
+                                     dpp::utility::user_mention(get_current_player()) +
+                                     " should think faster next time.");
+                edit_response();
+                remove_player(USER_REMOVE_REASON::TIMEOUT, get_current_player());
+                break;
+            }
+            is_first_move = false;
+            event = r.first;
+
+            int col = std::stoi(event.custom_id);
+            if (!_board.can_play(col)) {
+                continue;
+            }
+            _board.play(col);
+            if (_board.is_won()) {
+                message.embeds[0]
+                    .set_color(dpp::colors::blue)
+                    .set_title("Game over")
+                    .set_description("Player " + dpp::utility::user_mention(get_current_player()) +
+                                     " *won* against the computer in **Connect four**.");
+                edit_response();
+                remove_player(USER_REMOVE_REASON::WIN, get_current_player());
+                break;
+            }
+
+            if (!_board.is_full()) {
+                // search is bounded by microseconds, so the computer answers within the same interaction
+                _board.play(get_solver().best_move(_board, computer_move_budget));
+                if (_board.is_won()) {
+                    message.embeds[0]
+                        .set_color(dpp::colors::blue)
+                        .set_title("Game over")
+                        .set_description("The computer *won* against player " +
+                                         dpp::utility::user_mention(get_current_player()) + " in **Connect four**.\n" +
+                                         dpp::utility::user_mention(get_current_player()) +
+                                         " you will be luckier next time");
+                    edit_response();
+                    remove_player(USER_REMOVE_REASON::LOSE, get_current_player());
+                    break;
+                }
+            }
+
+            if (_board.is_full()) {
+                message.embeds[0]
+                    .set_color(dpp::colors::yellow)
+                    .set_title("Game over")
+                    .set_description("Player " + dpp::utility::user_mention(get_current_player()) +
+                                     " and the computer tried their best, but the game ended in a *DRAW!!!*");
+                edit_response();
+                remove_player(USER_REMOVE_REASON::DRAW, get_current_player());
+                break;
+            }
+        }
+        co_return;
+    }
 } // namespace gb
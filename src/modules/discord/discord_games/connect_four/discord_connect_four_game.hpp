@@ -3,6 +3,7 @@
 //
 
 #pragma once
+#include <src/games/connect_four/connect_four.hpp>
 #include <src/modules/discord/discord_games/discord_game.hpp>
 
 namespace gb {
@@ -16,22 +17,10 @@ namespace gb {
      */
     class Discord_connect_four_game : public Discord_game {
     private:
-        /**
-         * @brief The game board represented as a 2D array of strings.
-         *
-         * Each element in the board represents a cell, with empty cells containing a space (" "),
-         * red player cells containing "r", and yellow player cells containing "y".
-         */
-        std::string _board[6][7] = {{" ", " ", " ", " ", " ", " ", " "}, {" ", " ", " ", " ", " ", " ", " "},
-                                    {" ", " ", " ", " ", " ", " ", " "}, {" ", " ", " ", " ", " ", " ", " "},
-                                    {" ", " ", " ", " ", " ", " ", " "}, {" ", " ", " ", " ", " ", " ", " "}};
+        /// Time the computer may think about a move, short enough to answer within the same interaction.
+        static constexpr std::chrono::microseconds computer_move_budget{500};
 
-        /**
-         * @brief The player tokens representing the two players.
-         *
-         * The first player is represented by "r" (red), and the second player is represented by "y" (yellow).
-         */
-        std::string _signs[2] = {"r", "y"};
+        connect_four::Connect_four _board; ///< Game position, the first player plays red.
 
         /**
          * @brief Runs the Connect Four game in response to a button click event.
@@ -44,6 +33,24 @@ namespace gb {
          */
         dpp::task<void> run(dpp::button_click_t event);
 
+        /**
+         * @brief Runs the game of the only player against the computer.
+         *
+         * The player is red and moves first, the computer answers with a time-bounded search within the same
+         * interaction.
+         *
+         * @param sevent The slash command which started the game.
+         * @return A task that handles the asynchronous game execution.
+         */
+        dpp::task<void> run_vs_computer(dpp::slashcommand_t sevent);
+
+        /**
+         * @brief Adds a button for every column, full columns are disabled.
+         *
+         * @param message Message to add buttons to.
+         */
+        void create_components(dpp::message &message);
+
     public:
         /**
          * @brief Constructs a new `Discord_connect_four_game` object.
@@ -55,6 +62,14 @@ namespace gb {
          */
         Discord_connect_four_game(Game_data_initialization &_data, const std::vector<dpp::snowflake> &players);
 
+        /**
+         * @brief Constructs a new `Discord_connect_four_game` object against the computer.
+         *
+         * @param _data Reference to the game data required for initialization.
+         * @param player The only player, started with the slash command event.
+         */
+        Discord_connect_four_game(Game_data_initialization &_data, const dpp::snowflake &player);
+
         /**
          * @breif Define destructor.
          */
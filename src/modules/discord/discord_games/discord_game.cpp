@@ -36,7 +36,7 @@ Discord_game::~Discord_game() {
         return {"database","logging","discord_bot","discord_games_manager","image_processing","discord_button_click_handler","discord_achievements_processing"};
     }
 
-    Discord_game::Discord_game(Game_data_initialization &_data, const std::vector<dpp::snowflake> &players): _game_create_req({}) {
+    Discord_game::Discord_game(Game_data_initialization &_data, const std::vector<dpp::snowflake> &players) {
         this->_players = players;
         this->_data = _data;
     }
@@ -83,7 +83,9 @@ Discord_game::~Discord_game() {
 
     void Discord_game::game_start(const dpp::snowflake& channel_id,const dpp::snowflake& guild_id) {
         _is_game_started = true;
-        _game_create_req = _data.games_manager->add_game(this,channel_id,guild_id);
+        _channel_id = channel_id;
+        _guild_id = guild_id;
+        _unique_game_id = _data.games_manager->add_game(this,channel_id,guild_id);
     }
 
     void Discord_game::game_stop(const std::string& additional_data ) {
@@ -91,23 +93,113 @@ Discord_game::~Discord_game() {
         _data.games_manager->remove_game(this,GAME_END_REASON::FINISHED,additional_data);
     }
 
-    std::string Discord_game::add_image(dpp::message &m, const Image_ptr &image) {
-        auto str = image->convert_to_string();
-        m.set_filename("test"+str.first).set_file_content(str.second);
-        return "attachment://test"+str.first;
+    bool Discord_game::is_resumable() const { return false; }
+
+    void Discord_game::save_state(Game_snapshot_writer &writer) const {}
+
+    void Discord_game::load_state(Game_snapshot_reader &reader) {}
+
+    dpp::task<void> Discord_game::resume(dpp::message message) {
+        throw std::runtime_error("Game " + get_name() + " can not be resumed");
+        co_return;
     }
 
-    std::string Discord_game::get_name() const { return _data.name; }
+    std::string Discord_game::make_snapshot(const dpp::message &message) const {
+        Game_snapshot_writer writer;
+        writer.write_raw("GB");
+        writer.write_varint(snapshot_format_version);
+        writer.write_varint(_players.size());
+        for (auto &player: _players) {
+            writer.write_varint(player);
+        }
+        writer.write_varint(_current_player_ind);
+        writer.write_varint(_img_cnt);
+        writer.write_varint(_channel_id);
+        writer.write_varint(_guild_id);
+        writer.write_varint(message.id);
+        save_state(writer);
+        return writer.release();
+    }
+
+    dpp::message Discord_game::load_snapshot(Game_snapshot_reader &reader) {
+        if (reader.read_raw(2) != "GB") {
+            throw std::runtime_error("Game snapshot error: not a game snapshot");
+        }
+        if (reader.read_varint() != snapshot_format_version) {
+            throw std::runtime_error("Game snapshot error: unknown snapshot format version");
+        }
+        std::vector<dpp::snowflake> players(reader.read_varint());
+        for (auto &player: players) {
+            player = reader.read_varint();
+        }
+        size_t current_player_ind = reader.read_varint();
+        if (current_player_ind >= std::max<size_t>(players.size(), 1)) {
+            throw std::runtime_error("Game snapshot error: current player is out of range");
+        }
+        uint64_t img_cnt = reader.read_varint();
+        dpp::message message;
+        message.channel_id = reader.read_varint();
+        message.guild_id = reader.read_varint();
+        message.id = reader.read_varint();
+        load_state(reader);
+        if (!reader.is_finished()) {
+            throw std::runtime_error("Game snapshot error: unexpected data after game state");
+        }
+        _players = std::move(players);
+        _current_player_ind = current_player_ind;
+        _img_cnt = img_cnt;
+        _channel_id = message.channel_id;
+        _guild_id = message.guild_id;
+        return message;
+    }
 
-    uint64_t Discord_game::get_uid() {
-        if (_unique_game_id == std::numeric_limits<uint64_t>::max()) {
-            Database_return_t r = sync_wait(_game_create_req);
-            std::istringstream iss(r.at(0)["id"]);
-            iss >> _unique_game_id;
+    void Discord_game::save_checkpoint(const dpp::message &message) {
+        if (!is_resumable() || message.id == 0) {
+            return;
+        }
+        _data.games_manager->save_snapshot(this, make_snapshot(message));
+    }
+
+    dpp::task<void> Discord_game::resume_game(uint64_t game_id, const std::string &snapshot) {
+        _unique_game_id = game_id;
+        _is_game_started = true;
+        dpp::message message;
+        try {
+            Game_snapshot_reader reader(snapshot);
+            message = load_snapshot(reader);
+        } catch (...) {
+            // register anyway so stopping the game closes its history record and drops the broken snapshot
+            _data.games_manager->resume_game(this, game_id, _channel_id, _guild_id);
+            game_stop();
+            throw;
+        }
+        _data.games_manager->resume_game(this, game_id, _channel_id, _guild_id);
+        try {
+            co_await resume(std::move(message));
+        } catch (...) {
+            game_stop();
+            throw;
+        }
+        game_stop();
+    }
+
+    std::string Discord_game::add_image(dpp::message &m, const Image_ptr &image) {
+        auto [extension, data] = image->convert_to_string();
+        // same as set_filename + set_file_content (replace last attached file), but moves encoded data in
+        if (m.file_data.empty()) {
+            m.file_data.emplace_back();
         }
-        return _unique_game_id;
+        dpp::message_file_data &file = m.file_data.back();
+        file.name = "test" + extension;
+        file.content = std::move(data);
+        file.mimetype.clear();
+        return "attachment://test" + extension;
     }
 
+    std::string Discord_game::get_name() const { return _data.name; }
+
+    uint64_t Discord_game::get_uid() { return _unique_game_id; }
+
     void Discord_game::set_current_player_index(size_t index) {
         if (index >= this->_players.size()) {
             throw std::runtime_error("index of player is out of range.");
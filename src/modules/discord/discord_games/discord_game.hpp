@@ -8,6 +8,7 @@
 #include <src/modules/discord/discord_achievements_processing/discord_achievements_processing.hpp>
 #include <src/modules/discord/discord_interactions_handler/discord_button_click_handler/discord_button_click_handler.hpp>
 #include "./discord_games_manager/discord_games_manager.hpp"
+#include "./game_snapshot.hpp"
 #include "src/module/module.hpp"
 #include "src/modules/database/database.hpp"
 #include "src/modules/discord/discord_bot/discord_bot.hpp"
@@ -107,10 +108,22 @@ namespace gb {
     private:
         std::vector<dpp::snowflake> _players; ///< List of players participating in the game.
         size_t _current_player_ind = 0; ///< Index of the current player.
-        Task<Database_return_t> _game_create_req; ///< Async request to create a DB game record.
         uint64_t _unique_game_id = std::numeric_limits<uint64_t>::max(); ///< Unique ID of the game.
         bool _is_game_started = false; ///< Indicates whether the game has started.
         bool _is_game_stopped = false; ///< Indicates whether the game has stopped.
+        dpp::snowflake _channel_id; ///< Channel where the game runs.
+        dpp::snowflake _guild_id; ///< Guild where the game runs.
+
+        /// Version of the snapshot layout written by make_snapshot(), game state has its own version.
+        static constexpr uint64_t snapshot_format_version = 1;
+
+        /**
+         * @brief Restores players and location written by make_snapshot().
+         *
+         * @return Message showing the game, with id, channel and guild set.
+         * @throws std::runtime_error If snapshot is malformed or has unknown version.
+         */
+        dpp::message load_snapshot(Game_snapshot_reader &reader);
 
         /**
          * @brief Type-erased stored game entry callback.
@@ -160,6 +173,42 @@ namespace gb {
         Game_data_initialization _data; ///< Initialization data for the game.
         uint64_t _img_cnt = 0; ///< Counter for generated images.
 
+        /**
+         * @brief Writes game specific state to snapshot.
+         *
+         * Resumable games override it together with load_state(), resume() and is_resumable(), writing their
+         * own state version first so old snapshots can still be read after the layout changes.
+         *
+         * @param writer Snapshot writer.
+         */
+        virtual void save_state(Game_snapshot_writer &writer) const;
+
+        /**
+         * @brief Reads game specific state written by save_state().
+         *
+         * @param reader Snapshot reader.
+         * @throws std::runtime_error If state is malformed or has unknown version.
+         */
+        virtual void load_state(Game_snapshot_reader &reader);
+
+        /**
+         * @brief Continues restored game, counterpart of the coroutine passed to the constructor.
+         *
+         * @param message Message which showed the game before it was saved, its components are stale.
+         * @return Coroutine running the rest of the game.
+         */
+        virtual dpp::task<void> resume(dpp::message message);
+
+        /**
+         * @brief Hands snapshot of the game to the games manager, which writes it at next checkpoint.
+         *
+         * Call it whenever the game waits for players. Does nothing for not resumable games and until the
+         * message showing the game has an id.
+         *
+         * @param message Message showing the game.
+         */
+        void save_checkpoint(const dpp::message &message);
+
     public:
         /**
          * @brief Result type for private message creation.
@@ -271,6 +320,35 @@ namespace gb {
         }
 
 
+        /**
+         * @brief Resumes game saved before the bot went down.
+         *
+         * Restores the snapshot, registers the game with its old id, runs resume() and stops the game. Games
+         * with broken snapshots are stopped at once, so their snapshots are not loaded again.
+         *
+         * @param game_id Unique id of the saved game.
+         * @param snapshot Snapshot made by make_snapshot().
+         * @throws std::runtime_error If snapshot can not be restored.
+         */
+        dpp::task<void> resume_game(uint64_t game_id, const std::string &snapshot);
+
+        /**
+         * @brief Checks if game supports snapshots.
+         *
+         * @return True if game overrides save_state(), load_state() and resume().
+         */
+        virtual bool is_resumable() const;
+
+        /**
+         * @brief Makes snapshot of the game.
+         *
+         * Holds players, turn, location and game specific state in compact binary form.
+         *
+         * @param message Message showing the game.
+         * @return Snapshot bytes.
+         */
+        std::string make_snapshot(const dpp::message &message) const;
+
         /**
          * @brief Retrieves the list of players.
          *
@@ -332,7 +410,7 @@ namespace gb {
         /**
          * @brief Gets the unique game ID.
          *
-         * Waits for DB creation if necessary.
+         * Assigned by games manager when the game starts.
          *
          * @return Unique game identifier.
          */
@@ -43,6 +43,15 @@ namespace gb {
      */
     class Discord_game;
 
+    /**
+     * @struct Saved_game
+     * @brief Snapshot of a game which was running when the bot went down, loaded at startup.
+     */
+    struct Saved_game {
+        uint64_t id; ///< Unique id of the game, kept when it is resumed.
+        std::string snapshot; ///< Snapshot made by Discord_game::make_snapshot().
+    };
+
     /**
      * @class Discord_games_manager
      * @brief Abstract base class for managing Discord games.
@@ -77,10 +86,37 @@ namespace gb {
          * @param game Pointer to the Discord game to add.
          * @param channel_id Channel id where game is happening.
          * @param guild_id Guild id where game is happening.
-         * @returns Awaitable request to database which will return unique id of game.
+         * @returns Unique id of the game, available immediately, database record is written in background.
+         */
+        virtual uint64_t add_game(Discord_game *game, const dpp::snowflake &channel_id,
+                                  const dpp::snowflake &guild_id) = 0;
+
+        /**
+         * @brief Adds a game restored from snapshot to the manager, keeping its id and database record.
+         *
+         * @param game Pointer to the resumed Discord game.
+         * @param game_id Unique id the game had before it was saved.
+         * @param channel_id Channel id where game is happening.
+         * @param guild_id Guild id where game is happening.
+         */
+        virtual void resume_game(Discord_game *game, uint64_t game_id, const dpp::snowflake &channel_id,
+                                 const dpp::snowflake &guild_id) = 0;
+
+        /**
+         * @brief Stores latest snapshot of a game, snapshots are written to the database periodically in batches.
+         *
+         * @param game Pointer to the Discord game.
+         * @param snapshot Snapshot made by Discord_game::make_snapshot(), replaces not yet written one.
          */
-        virtual Task<Database_return_t> add_game(Discord_game *game, const dpp::snowflake &channel_id,
-                                                 const dpp::snowflake &guild_id) = 0;
+        virtual void save_snapshot(Discord_game *game, std::string snapshot) = 0;
+
+        /**
+         * @brief Takes snapshots of saved games loaded at startup, each snapshot is handed out once.
+         *
+         * @param game_name Name of the game.
+         * @return Saved games with given name.
+         */
+        virtual std::vector<Saved_game> take_saved_games(const std::string &game_name) = 0;
 
         /**
          * @brief Removes a game from the manager.
@@ -115,6 +151,33 @@ namespace gb {
          * @return Time in seconds since last played game
          */
         virtual Task<time_t> get_seconds_since_last_game(const std::string &game_name, const dpp::snowflake &user_id) = 0;
+
+        /**
+         * @brief Gets amount of games running right now.
+         * @return Amount of active games.
+         */
+        virtual size_t get_active_games_amount() = 0;
+
+        /**
+         * @brief Gets amount of games of specific type running right now.
+         * @param game_name Name of the game.
+         * @return Amount of active games with given name.
+         */
+        virtual size_t get_active_games_amount(const std::string &game_name) = 0;
+
+        /**
+         * @brief Checks if user takes part in any active game.
+         * @param user_id ID of the user.
+         * @return True if user is a player of at least one active game.
+         */
+        virtual bool is_user_playing(const dpp::snowflake &user_id) = 0;
+
+        /**
+         * @brief Gets amount of games running in specific channel.
+         * @param channel_id ID of the channel.
+         * @return Amount of active games in the channel.
+         */
+        virtual size_t get_channel_games_amount(const dpp::snowflake &channel_id) = 0;
     };
 
     /**
@@ -4,19 +4,202 @@
 
 #include "discord_games_manager_impl.hpp"
 
+#include <format>
+#include <iostream>
+#include <random>
+#include <span>
+
 namespace gb {
-    Task<Database_return_t> Discord_games_manager_impl::add_game(Discord_game *game, const dpp::snowflake &channel_id,
-                                                                 const dpp::snowflake &guild_id) {
+    /**
+     * @brief Removes game from index entry, erasing entry once it has no games.
+     */
+    static void unindex_game(std::unordered_map<dpp::snowflake, std::vector<Discord_game *>> &index,
+                             const dpp::snowflake &key, Discord_game *game) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return;
+        }
+        auto &games = it->second;
+        auto e = std::ranges::find(games, game);
+        if (e != games.end()) {
+            *e = games.back();
+            games.pop_back();
+        }
+        if (games.empty()) {
+            index.erase(it);
+        }
+    }
+
+    void Discord_games_manager_impl::register_game(Discord_game *game, Active_game active_game) {
+        std::atomic_size_t *type_amount = &_games_amount_by_type.get(active_game.name);
+        active_game.type_amount = type_amount;
         std::unique_lock lock(_mutex);
-        _games.push_back(game);
-        return _db->execute_prepared_statement(_create_game_stmt, game->get_name(), channel_id, guild_id);
+        auto [it, inserted] = _games.try_emplace(game, std::move(active_game));
+        if (inserted) {
+            for (auto &player: it->second.players) {
+                _games_by_player[player].push_back(game);
+            }
+            _games_by_channel[it->second.channel_id].push_back(game);
+            (*type_amount)++;
+            _games_amount++;
+        }
+    }
+
+    uint64_t Discord_games_manager_impl::add_game(Discord_game *game, const dpp::snowflake &channel_id,
+                                                  const dpp::snowflake &guild_id) {
+        uint64_t id;
+        bool block_needed = false;
+        {
+            std::unique_lock lock(_game_id_mutex);
+            if (_next_game_id == _game_id_block_end && !_spare_game_id_block) {
+                // both blocks are used up, only happens when the database failed to reserve the spare in time
+                lock.unlock();
+                request_game_id_block();
+                lock.lock();
+                _game_id_cv.wait(lock, [this]() {
+                    return _next_game_id != _game_id_block_end || _spare_game_id_block || _is_game_id_stopped;
+                });
+            }
+            if (_next_game_id == _game_id_block_end) {
+                if (!_spare_game_id_block) {
+                    throw std::runtime_error("Discord_games_manager: stopped while waiting for game id block");
+                }
+                _next_game_id = _spare_game_id_block * game_id_block_size;
+                _game_id_block_end = _next_game_id + game_id_block_size;
+                _spare_game_id_block = 0;
+                block_needed = true;
+            }
+            id = _next_game_id++;
+        }
+        if (block_needed) {
+            request_game_id_block();
+        }
+        auto start_time = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+        std::string name = game->get_name();
+        register_game(game, Active_game{id, name, channel_id, guild_id, game->get_players()});
+        // queued before any result or finish statement of this game, background statements run in order
+        _db->background_execute_critical_prepared_statement(_create_game_stmt, id, name, channel_id, guild_id,
+                                                            start_time);
+        return id;
+    }
+
+    uint64_t Discord_games_manager_impl::reserve_game_id_block() {
+        static thread_local std::mt19937_64 rng{std::random_device{}()};
+        // token only finds our row again, the statements may run on different connections
+        uint64_t token = std::uniform_int_distribution<uint64_t>{1, UINT64_MAX}(rng);
+        sync_wait(_db->execute_prepared_statement(_reserve_id_block_stmt, token));
+        Database_return_t r = sync_wait(_db->execute_prepared_statement(_get_id_block_stmt, token));
+        const std::string &block_str = r.at(0).at("block");
+        uint64_t block = 0;
+        std::from_chars(block_str.data(), block_str.data() + block_str.size(), block);
+        if (block == 0) {
+            throw std::runtime_error("Discord_games_manager: failed to reserve game id block");
+        }
+        return block;
+    }
+
+    bool Discord_games_manager_impl::refill_spare_game_id_block() {
+        {
+            std::unique_lock lock(_game_id_mutex);
+            if (_spare_game_id_block) {
+                return true;
+            }
+        }
+        try {
+            uint64_t block = reserve_game_id_block();
+            {
+                std::unique_lock lock(_game_id_mutex);
+                _spare_game_id_block = block;
+            }
+            _game_id_cv.notify_all();
+            return true;
+        } catch (const std::exception &e) {
+            _log->error(std::string("Discord_games_manager: failed to reserve game id block: ") + e.what());
+            return false;
+        }
+    }
+
+    void Discord_games_manager_impl::request_game_id_block() {
+        {
+            std::unique_lock lock(_mutex);
+            _game_id_block_needed = true;
+        }
+        _checkpoint_cv.notify_all();
+    }
+
+    void Discord_games_manager_impl::resume_game(Discord_game *game, uint64_t game_id, const dpp::snowflake &channel_id,
+                                                 const dpp::snowflake &guild_id) {
+        Active_game active_game{game_id, game->get_name(), channel_id, guild_id, game->get_players()};
+        active_game.has_stored_snapshot = true;
+        register_game(game, std::move(active_game));
+    }
+
+    void Discord_games_manager_impl::save_snapshot(Discord_game *game, std::string snapshot) {
+        std::unique_lock lock(_mutex);
+        auto it = _games.find(game);
+        if (it == _games.end()) {
+            return;
+        }
+        it->second.snapshot = std::move(snapshot);
+        if (!it->second.has_unsaved_snapshot) {
+            it->second.has_unsaved_snapshot = true;
+            _unsaved_games.push_back(game);
+        }
+    }
+
+    std::vector<Saved_game> Discord_games_manager_impl::take_saved_games(const std::string &game_name) {
+        std::unique_lock lock(_mutex);
+        auto it = _saved_games.find(game_name);
+        if (it == _saved_games.end()) {
+            return {};
+        }
+        std::vector<Saved_game> r = std::move(it->second);
+        _saved_games.erase(it);
+        return r;
+    }
+
+    void Discord_games_manager_impl::checkpoint() {
+        std::unique_lock lock(_mutex);
+        // statements are queued under the lock, so a delete queued by remove_game always follows the last write
+        for (Discord_game *game: _unsaved_games) {
+            auto it = _games.find(game);
+            if (it == _games.end() || !it->second.has_unsaved_snapshot) {
+                continue;
+            }
+            Active_game &active_game = it->second;
+            _db->background_execute_critical_prepared_statement(_save_snapshot_stmt, active_game.id,
+                                                                active_game.name,
+                                                                std::as_bytes(std::span(active_game.snapshot)));
+            active_game.snapshot.clear();
+            active_game.has_unsaved_snapshot = false;
+            active_game.has_stored_snapshot = true;
+        }
+        _unsaved_games.clear();
+    }
+
+    void Discord_games_manager_impl::unregister_game(std::unordered_map<Discord_game *, Active_game>::iterator it) {
+        for (auto &player: it->second.players) {
+            unindex_game(_games_by_player, player, it->first);
+        }
+        unindex_game(_games_by_channel, it->second.channel_id, it->first);
+        (*it->second.type_amount)--;
+        _games_amount--;
+        _games.erase(it);
     }
 
     void Discord_games_manager_impl::remove_game(Discord_game *game, GAME_END_REASON end_reason,
                                                  const std::string &additional_data) {
-        std::unique_lock lock(_mutex);
-        auto e = std::ranges::remove(_games, game);
-        _games.erase(e.begin(), e.end());
+        bool has_stored_snapshot = false;
+        {
+            std::unique_lock lock(_mutex);
+            auto it = _games.find(game);
+            if (it == _games.end()) {
+                // already ended as SAVED by stop(), its record and snapshot must stay as they are
+                return;
+            }
+            has_stored_snapshot = it->second.has_stored_snapshot;
+            unregister_game(it);
+        }
         std::string end_r_str;
         switch (end_reason) {
             case GAME_END_REASON::ERROR:
@@ -31,15 +214,31 @@ namespace gb {
             default:
                 throw std::runtime_error("No known to_string conversion for GAME_END_REASON");
         }
-        _db->background_execute_prepared_statement(_finish_game_stmt, end_r_str, game->get_image_cnt(), additional_data,
-                                                   game->get_uid());
+        _db->background_execute_critical_prepared_statement(_finish_game_stmt, end_r_str, game->get_image_cnt(),
+                                                            additional_data, game->get_uid());
+        if (has_stored_snapshot) {
+            _db->background_execute_critical_prepared_statement(_delete_snapshot_stmt, game->get_uid());
+        }
         _cv.notify_all();
     }
 
     void Discord_games_manager_impl::record_user_result(Discord_game *game, const dpp::snowflake &player,
                                                         const std::string &result) {
-        _db->background_execute_prepared_statement(_user_game_result_stmt, result, game->get_uid(), player,
-                                                   game->get_uid());
+        // results are recorded when player leaves the game
+        {
+            std::unique_lock lock(_mutex);
+            auto it = _games.find(game);
+            if (it != _games.end()) {
+                auto &players = it->second.players;
+                auto e = std::ranges::find(players, player);
+                if (e != players.end()) {
+                    players.erase(e);
+                    unindex_game(_games_by_player, player, game);
+                }
+            }
+        }
+        _db->background_execute_critical_prepared_statement(_user_game_result_stmt, result, game->get_uid(), player,
+                                                            game->get_uid());
     }
 
     Task<time_t> Discord_games_manager_impl::get_seconds_since_last_game(const std::string &game_name,
@@ -54,24 +253,136 @@ namespace gb {
         co_return value;
     }
 
+    size_t Discord_games_manager_impl::get_active_games_amount() { return _games_amount; }
+
+    size_t Discord_games_manager_impl::get_active_games_amount(const std::string &game_name) {
+        return _games_amount_by_type.get_amount(game_name);
+    }
+
+    bool Discord_games_manager_impl::is_user_playing(const dpp::snowflake &user_id) {
+        std::unique_lock lock(_mutex);
+        return _games_by_player.contains(user_id);
+    }
+
+    size_t Discord_games_manager_impl::get_channel_games_amount(const dpp::snowflake &channel_id) {
+        std::unique_lock lock(_mutex);
+        auto it = _games_by_channel.find(channel_id);
+        return it == _games_by_channel.end() ? 0 : it->second.size();
+    }
+
     void Discord_games_manager_impl::stop() {
-        std::mutex m;
-        std::unique_lock lk(m);
-        _cv.wait(lk, [this]() {
+        _admin_terminal->remove_command("discord_games_census");
+        {
             std::unique_lock lk(_mutex);
-            return _games.empty();
-        });
+            // resumable games would wait for players forever, they are saved and continue after restart
+            for (auto it = _games.begin(); it != _games.end();) {
+                Active_game &active_game = it->second;
+                if (!active_game.has_unsaved_snapshot && !active_game.has_stored_snapshot) {
+                    ++it;
+                    continue;
+                }
+                if (active_game.has_unsaved_snapshot) {
+                    _db->background_execute_critical_prepared_statement(
+                        _save_snapshot_stmt, active_game.id, active_game.name,
+                        std::as_bytes(std::span(active_game.snapshot)));
+                }
+                _db->background_execute_critical_prepared_statement(_finish_game_stmt, "SAVED",
+                                                                    it->first->get_image_cnt(), "", active_game.id);
+                unregister_game(it++);
+            }
+            _unsaved_games.clear();
+            _cv.wait(lk, [this]() { return _games.empty(); });
+            _is_running = false;
+        }
+        {
+            std::unique_lock lock(_game_id_mutex);
+            _is_game_id_stopped = true;
+        }
+        _game_id_cv.notify_all();
+        _checkpoint_cv.notify_all();
+        if (_checkpoint_thread.joinable()) {
+            _checkpoint_thread.join();
+        }
         _db->remove_prepared_statement(_create_game_stmt);
         _db->remove_prepared_statement(_user_game_result_stmt);
         _db->remove_prepared_statement(_finish_game_stmt);
+        _db->remove_prepared_statement(_reserve_id_block_stmt);
+        _db->remove_prepared_statement(_get_id_block_stmt);
         _db->remove_prepared_statement(_get_last_user_game_played);
+        _db->remove_prepared_statement(_save_snapshot_stmt);
+        _db->remove_prepared_statement(_delete_snapshot_stmt);
     }
 
-    void Discord_games_manager_impl::run() {}
+    void Discord_games_manager_impl::run() {
+        _checkpoint_period = std::chrono::milliseconds(std::stoll(_config->get_value_or("games_checkpoint_period_ms", "30000")));
+        {
+            std::unique_lock lk(_mutex);
+            _is_running = true;
+        }
+        {
+            std::unique_lock lock(_game_id_mutex);
+            _is_game_id_stopped = false;
+        }
+        _checkpoint_thread = std::thread([this]() {
+            std::unique_lock lk(_mutex);
+            bool is_refilled = true;
+            while (_is_running) {
+                // a failed reservation is retried soon, games may be waiting for it
+                _checkpoint_cv.wait_for(lk, is_refilled ? _checkpoint_period : game_id_block_retry_delay,
+                                        [this]() { return !_is_running || _game_id_block_needed; });
+                _game_id_block_needed = false;
+                lk.unlock();
+                is_refilled = refill_spare_game_id_block();
+                checkpoint();
+                lk.lock();
+            }
+        });
+    }
 
     void Discord_games_manager_impl::init(const Modules &modules) {
         _db = std::static_pointer_cast<Database>(modules.at("database"));
-        _create_game_stmt = _db->create_prepared_statement("CALL create_game(?,?,?);");
+        _config = std::static_pointer_cast<Config>(modules.at("config"));
+        _log = std::static_pointer_cast<Logging>(modules.at("logging"));
+        _admin_terminal = std::static_pointer_cast<Admin_terminal>(modules.at("admin_terminal"));
+
+        _admin_terminal->add_command(
+            "discord_games_census", "Prints amount of active games by type, channels and players in games.",
+            "Arguments: no arguments.", [this](const std::vector<std::string> &arguments) {
+                std::string r = std::format("Active games: {}", _games_amount.load());
+                _games_amount_by_type.for_each(
+                    [&r](const std::string &name, size_t amount) { r += std::format("\n{}: {}", name, amount); });
+                {
+                    std::unique_lock lock(_mutex);
+                    r += std::format("\nchannels with games: {}, players in games: {}", _games_by_channel.size(),
+                                     _games_by_player.size());
+                }
+                std::cout << r << std::endl;
+            });
+
+        _create_game_stmt = _db->create_prepared_statement(
+            "INSERT INTO `games_history` (`id`, `game_name`, `channel_id`, `guild_id`, `start_time`, `game_state`) "
+            "VALUES (?, ?, ?, ?, ?, 'ACTIVE');");
+
+        // ids are handed out locally from reserved blocks, so games start without waiting for the database
+        sync_wait(_db->execute(R"XXX(
+        CREATE TABLE IF NOT EXISTS `games_id_blocks` (
+            `block` BIGINT UNSIGNED NOT NULL AUTO_INCREMENT PRIMARY KEY,
+            `token` BIGINT UNSIGNED NOT NULL UNIQUE,
+            `reserved_at` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP
+        );
+        )XXX"));
+        // first start on a database with history: token 0 row puts blocks above existing ids, ignored afterwards
+        sync_wait(_db->execute(std::format(
+            "INSERT IGNORE INTO `games_id_blocks` (`block`, `token`) "
+            "SELECT COALESCE(MAX(`id`), 0) DIV {} + 1, 0 FROM `games_history`;",
+            game_id_block_size)));
+        _reserve_id_block_stmt = _db->create_prepared_statement("INSERT INTO `games_id_blocks` (`token`) VALUES (?);");
+        _get_id_block_stmt =
+            _db->create_prepared_statement("SELECT `block` FROM `games_id_blocks` WHERE `token` = ?;");
+        uint64_t block = reserve_game_id_block();
+        _next_game_id = block * game_id_block_size;
+        _game_id_block_end = _next_game_id + game_id_block_size;
+        _spare_game_id_block = reserve_game_id_block();
 
         _user_game_result_stmt = _db->create_prepared_statement(
             R"XXX(INSERT INTO `user_game_results` (`result`, `game`, `user`, `time_played`)
@@ -100,10 +411,33 @@ namespace gb {
         _finish_game_stmt =
             _db->create_prepared_statement("UPDATE `games_history` SET `end_time`=UTC_TIMESTAMP(), `game_state`=?, "
                                            "`images_generated`=?, `additional_data`=? WHERE `id`=?");
+
+        sync_wait(_db->execute(R"XXX(
+        CREATE TABLE IF NOT EXISTS `games_snapshots` (
+            `game_id` BIGINT UNSIGNED NOT NULL PRIMARY KEY,
+            `game_name` VARCHAR(64) NOT NULL,
+            `snapshot` BLOB NOT NULL,
+            `updated_at` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP
+        );
+        )XXX"));
+
+        _save_snapshot_stmt = _db->create_prepared_statement(
+            "REPLACE INTO `games_snapshots` (`game_id`, `game_name`, `snapshot`) VALUES (?, ?, ?);");
+        _delete_snapshot_stmt = _db->create_prepared_statement("DELETE FROM `games_snapshots` WHERE `game_id` = ?;");
+
+        // games which were running when the bot went down, resumed by their commands
+        Database_return_t saved =
+            sync_wait(_db->execute("SELECT `game_id`, `game_name`, `snapshot` FROM `games_snapshots`;"));
+        for (auto &row: saved) {
+            std::string &id_str = row.at("game_id");
+            uint64_t id = 0;
+            std::from_chars(id_str.data(), id_str.data() + id_str.size(), id);
+            _saved_games[row.at("game_name")].push_back({id, std::move(row.at("snapshot"))});
+        }
     }
 
     Discord_games_manager_impl::Discord_games_manager_impl() :
-        Discord_games_manager("discord_games_manager", {"database"}) {}
+        Discord_games_manager("discord_games_manager", {"database", "admin_terminal", "config", "logging"}) {}
 
     Module_ptr create() { return std::dynamic_pointer_cast<Module>(std::make_shared<Discord_games_manager_impl>()); }
 } // namespace gb
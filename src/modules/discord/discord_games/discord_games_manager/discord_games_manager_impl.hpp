@@ -3,11 +3,128 @@
 //
 
 #pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
 #include "./discord_games_manager.hpp"
+#include "src/modules/admin_terminal/admin_terminal.hpp"
+#include "src/modules/config/config.hpp"
+#include "src/modules/logging/logging.hpp"
 
 namespace gb {
 
+    /**
+     * @brief Registry entry of an active game.
+     */
+    struct Active_game {
+        uint64_t id; ///< Unique id of the game.
+        std::string name; ///< Name of the game.
+        dpp::snowflake channel_id; ///< Channel where game is happening.
+        dpp::snowflake guild_id; ///< Guild where game is happening.
+        std::vector<dpp::snowflake> players; ///< Players still in the game.
+        std::atomic_size_t *type_amount; ///< Counter of active games of this type.
+        std::string snapshot; ///< Latest snapshot not yet written to the database.
+        bool has_unsaved_snapshot = false; ///< Snapshot was changed since last checkpoint.
+        bool has_stored_snapshot = false; ///< Database has a snapshot row of the game.
+    };
+
+    /**
+     * @class Game_type_counters
+     * @brief Counters of active games by game name, found and read without locks.
+     *
+     * Fixed size open addressing table which never removes names: a slot's name is published once and never
+     * changes, so lookups are only atomic loads. Adding a name not seen before takes the mutex.
+     */
+    class Game_type_counters {
+    public:
+        static constexpr size_t capacity = 128; ///< Max amount of game names, far above the amount of games.
+
+    private:
+        /**
+         * @brief Counter of one game name.
+         */
+        struct Slot {
+            std::atomic<const std::string *> name = nullptr; ///< Game name, nullptr for free slot.
+            std::atomic_size_t amount = 0; ///< Active games of this name.
+        };
+
+        std::array<Slot, capacity> _slots; ///< Counters.
+        std::mutex _mutex; ///< Serializes adding names.
+        std::deque<std::string> _names; ///< Storage of names, deque keeps their addresses stable.
+
+        /**
+         * @brief Finds slot of the name, or the free slot the name would be added to.
+         *
+         * @return Slot, nullptr if the name is unknown and the table is full.
+         */
+        Slot *probe(const std::string &name) {
+            size_t start = std::hash<std::string>{}(name) % capacity;
+            for (size_t i = 0; i < capacity; i++) {
+                Slot &slot = _slots[(start + i) % capacity];
+                const std::string *slot_name = slot.name.load();
+                if (!slot_name || *slot_name == name) {
+                    return &slot;
+                }
+            }
+            return nullptr;
+        }
+
+    public:
+        /**
+         * @brief Gets counter of the name, adding it if it is new.
+         *
+         * @param name Game name.
+         * @return Counter, valid as long as this object.
+         * @throws std::length_error If there are more than capacity game names.
+         */
+        std::atomic_size_t &get(const std::string &name) {
+            Slot *slot = probe(name);
+            if (slot && slot->name.load()) {
+                return slot->amount;
+            }
+            std::unique_lock lock(_mutex);
+            slot = probe(name);
+            if (!slot) {
+                throw std::length_error("Too many game types for Game_type_counters");
+            }
+            if (!slot->name.load()) {
+                slot->name.store(&_names.emplace_back(name));
+            }
+            return slot->amount;
+        }
+
+        /**
+         * @brief Gets amount of active games of the name without locking.
+         *
+         * @param name Game name.
+         * @return Amount, 0 for unknown names.
+         */
+        size_t get_amount(const std::string &name) {
+            Slot *slot = probe(name);
+            return slot && slot->name.load() ? slot->amount.load() : 0;
+        }
+
+        /**
+         * @brief Calls function with every known name and its amount, without locking.
+         *
+         * @param f Function taking name and amount.
+         */
+        template<typename F>
+        void for_each(F &&f) const {
+            for (const Slot &slot: _slots) {
+                if (const std::string *name = slot.name.load()) {
+                    f(*name, slot.amount.load());
+                }
+            }
+        }
+    };
+
     /**
      * @class Discord_games_manager_impl
      * @brief Implementation of the Discord games manager.
@@ -15,14 +132,80 @@ namespace gb {
      * This class manages a collection of Discord games, allowing games to be added and removed.
      */
     class Discord_games_manager_impl : public Discord_games_manager {
-        /// Mutex for synchronizing access to the games list.
+        /// Mutex for synchronizing access to the games registry.
         std::mutex _mutex;
 
         /// Condition variable to notify when games are removed.
         std::condition_variable _cv;
 
-        /// Vector holding pointers to the Discord games.
-        std::vector<Discord_game *> _games;
+        /// Active games.
+        std::unordered_map<Discord_game *, Active_game> _games;
+
+        /// Active games by player, players rarely have more than one so vectors stay tiny.
+        std::unordered_map<dpp::snowflake, std::vector<Discord_game *>> _games_by_player;
+
+        /// Active games by channel.
+        std::unordered_map<dpp::snowflake, std::vector<Discord_game *>> _games_by_channel;
+
+        /// Amount of active games.
+        std::atomic_size_t _games_amount = 0;
+
+        /// Amount of game ids in one block reserved from the database.
+        static constexpr uint64_t game_id_block_size = 1024;
+
+        /// Time between attempts to reserve spare id block while the database fails.
+        static constexpr std::chrono::milliseconds game_id_block_retry_delay{1000};
+
+        /// Mutex for _next_game_id, _game_id_block_end, _spare_game_id_block and _is_game_id_stopped.
+        std::mutex _game_id_mutex;
+
+        /// Signalled when spare id block is reserved or the manager stops.
+        std::condition_variable _game_id_cv;
+
+        /// Next game id to hand out from the reserved block.
+        uint64_t _next_game_id = 0;
+
+        /// End of the reserved id block, exclusive.
+        uint64_t _game_id_block_end = 0;
+
+        /// Reserved block used once the current one runs out, 0 while checkpoint thread is reserving it.
+        uint64_t _spare_game_id_block = 0;
+
+        /// Manager stops, games waiting for an id block fail instead.
+        bool _is_game_id_stopped = false;
+
+        /// Checkpoint thread should reserve new spare id block, guarded by _mutex.
+        bool _game_id_block_needed = false;
+
+        /// Amount of active games by game name, counters are never removed so they can be kept by pointer.
+        Game_type_counters _games_amount_by_type;
+
+        /// Games with snapshots changed since last checkpoint, may contain already removed games.
+        std::vector<Discord_game *> _unsaved_games;
+
+        /// Snapshots loaded at startup by game name, not yet taken by game commands.
+        std::unordered_map<std::string, std::vector<Saved_game>> _saved_games;
+
+        /// Thread writing snapshots to the database.
+        std::thread _checkpoint_thread;
+
+        /// Condition variable to wake checkpoint thread on stop.
+        std::condition_variable _checkpoint_cv;
+
+        /// Checkpoint thread should keep running.
+        bool _is_running = false;
+
+        /// Time between checkpoints.
+        std::chrono::milliseconds _checkpoint_period{30000};
+
+        /// Pointer to config module.
+        Config_ptr _config;
+
+        /// Pointer to logging module.
+        Logging_ptr _log;
+
+        /// Pointer to admin terminal module.
+        Admin_terminal_ptr _admin_terminal;
 
         /// Pointer to database object.
         Database_ptr _db;
@@ -33,17 +216,69 @@ namespace gb {
         /// Prepared statement to finish the game.
         Prepared_statement _finish_game_stmt;
 
+        /// Prepared statement to reserve a block of game ids under random token.
+        Prepared_statement _reserve_id_block_stmt;
+
+        /// Prepared statement to get reserved block of game ids by its token.
+        Prepared_statement _get_id_block_stmt;
+
         /// Prepared statement to record user game result.
         Prepared_statement _user_game_result_stmt;
 
         /// Prepared statement to get how much time passed since user last played specific game.
         Prepared_statement _get_last_user_game_played;
 
+        /// Prepared statement to write game snapshot.
+        Prepared_statement _save_snapshot_stmt;
+
+        /// Prepared statement to delete snapshot of finished game.
+        Prepared_statement _delete_snapshot_stmt;
+
+        /**
+         * @brief Reserves next block of game ids in the database, blocks until it is done.
+         *
+         * Block numbers come from AUTO_INCREMENT, so blocks are never handed out twice, not after a crash and
+         * not to another bot instance sharing the database. Never called from D++ threads: add_game only
+         * switches to the spare block and the checkpoint thread reserves the next one.
+         *
+         * @return Block number, its ids are [block * game_id_block_size, (block + 1) * game_id_block_size).
+         */
+        uint64_t reserve_game_id_block();
+
+        /**
+         * @brief Reserves spare id block if there is none, errors are logged.
+         *
+         * @return False if reserving failed, the checkpoint thread retries after game_id_block_retry_delay.
+         */
+        bool refill_spare_game_id_block();
+
+        /**
+         * @brief Wakes checkpoint thread to reserve spare id block.
+         */
+        void request_game_id_block();
+
+        /**
+         * @brief Removes game from active games and indexes, must be called with _mutex locked.
+         *
+         * @param it Game entry, invalidated.
+         */
+        void unregister_game(std::unordered_map<Discord_game *, Active_game>::iterator it);
+
+        /**
+         * @brief Adds game to registry and indexes.
+         */
+        void register_game(Discord_game *game, Active_game active_game);
+
+        /**
+         * @brief Queues all changed snapshots for writing, background statements are batched by the database.
+         */
+        void checkpoint();
+
     public:
         /**
          * @brief Constructor for Discord_games_manager_impl.
          *
-         * Initializes the manager with no dependencies.
+         * Initializes the manager with its dependencies.
          */
         Discord_games_manager_impl();
 
@@ -58,10 +293,39 @@ namespace gb {
          * @param game Pointer to the Discord game to add.
          * @param channel_id Channel id where game is happening.
          * @param guild_id Guild id where game is happening.
-         * @returns Awaitable request to database which will return unique id of game.
+         * @returns Unique id of the game, database record is written in background. Available immediately,
+         * unless both reserved id blocks are used up, then it waits for the checkpoint thread to reserve one.
+         * @throws std::runtime_error if the manager stops while waiting.
          */
-        Task<Database_return_t> add_game(Discord_game *game, const dpp::snowflake &channel_id,
-                                         const dpp::snowflake &guild_id) override;
+        uint64_t add_game(Discord_game *game, const dpp::snowflake &channel_id,
+                          const dpp::snowflake &guild_id) override;
+
+        /**
+         * @brief Adds a game restored from snapshot to the manager, keeping its id and database record.
+         *
+         * @param game Pointer to the resumed Discord game.
+         * @param game_id Unique id the game had before it was saved.
+         * @param channel_id Channel id where game is happening.
+         * @param guild_id Guild id where game is happening.
+         */
+        void resume_game(Discord_game *game, uint64_t game_id, const dpp::snowflake &channel_id,
+                         const dpp::snowflake &guild_id) override;
+
+        /**
+         * @brief Stores latest snapshot of a game until next checkpoint.
+         *
+         * @param game Pointer to the Discord game.
+         * @param snapshot Snapshot made by Discord_game::make_snapshot().
+         */
+        void save_snapshot(Discord_game *game, std::string snapshot) override;
+
+        /**
+         * @brief Takes snapshots of saved games loaded at startup.
+         *
+         * @param game_name Name of the game.
+         * @return Saved games with given name.
+         */
+        std::vector<Saved_game> take_saved_games(const std::string &game_name) override;
 
         /**
          * @brief Removes a game from the manager.
@@ -90,15 +354,42 @@ namespace gb {
          */
         Task<time_t> get_seconds_since_last_game(const std::string &game_name, const dpp::snowflake &user_id) override;
 
+        /**
+         * @brief Gets amount of games running right now, without locking.
+         * @return Amount of active games.
+         */
+        size_t get_active_games_amount() override;
+
+        /**
+         * @brief Gets amount of games of specific type running right now.
+         * @param game_name Name of the game.
+         * @return Amount of active games with given name.
+         */
+        size_t get_active_games_amount(const std::string &game_name) override;
+
+        /**
+         * @brief Checks if user takes part in any active game.
+         * @param user_id ID of the user.
+         * @return True if user is a player of at least one active game.
+         */
+        bool is_user_playing(const dpp::snowflake &user_id) override;
+
+        /**
+         * @brief Gets amount of games running in specific channel.
+         * @param channel_id ID of the channel.
+         * @return Amount of active games in the channel.
+         */
+        size_t get_channel_games_amount(const dpp::snowflake &channel_id) override;
+
         /**
          * @brief Stops the manager's operation.
          *
-         * Waits until all games are removed.
+         * Waits until all games are removed and stops checkpointing.
          */
         void stop() override;
 
         /**
-         * @brief Starts the manager's operation.
+         * @brief Starts the manager's operation, periodically checkpointing game snapshots.
          */
         void run() override;
 
@@ -0,0 +1,169 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace gb {
+
+    /**
+     * @class Game_snapshot_writer
+     * @brief Builds compact binary snapshot of a game.
+     *
+     * Integers are written as LEB128 varints, so small values such as board cells and indexes take one byte,
+     * strings are length prefixed.
+     */
+    class Game_snapshot_writer {
+        std::string _data; ///< Written bytes.
+
+    public:
+        /**
+         * @brief Writes unsigned integer.
+         *
+         * @param value Value to write.
+         */
+        void write_varint(uint64_t value) {
+            while (value >= 0x80) {
+                _data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            _data.push_back(static_cast<char>(value));
+        }
+
+        /**
+         * @brief Writes signed integer, zigzag encoded so small negative values stay short.
+         *
+         * @param value Value to write.
+         */
+        void write_signed(int64_t value) {
+            write_varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        /**
+         * @brief Writes length prefixed string.
+         *
+         * @param value String to write, may contain any bytes.
+         */
+        void write_string(std::string_view value) {
+            write_varint(value.size());
+            _data.append(value);
+        }
+
+        /**
+         * @brief Writes raw bytes without length.
+         *
+         * @param value Bytes to write, reader must know their amount.
+         */
+        void write_raw(std::string_view value) { _data.append(value); }
+
+        /**
+         * @brief Gets written snapshot.
+         *
+         * @return Snapshot bytes.
+         */
+        const std::string &data() const { return _data; }
+
+        /**
+         * @brief Takes written snapshot out of the writer.
+         *
+         * @return Snapshot bytes.
+         */
+        std::string release() { return std::move(_data); }
+    };
+
+    /**
+     * @class Game_snapshot_reader
+     * @brief Reads snapshot built by Game_snapshot_writer.
+     *
+     * Reads are checked against the end of data, truncated or corrupted snapshots throw instead of
+     * producing half restored games.
+     */
+    class Game_snapshot_reader {
+        std::string_view _data; ///< Not yet read bytes.
+
+        /**
+         * @brief Throws if fewer than amount bytes are left.
+         */
+        void require(size_t amount) const {
+            if (_data.size() < amount) {
+                throw std::runtime_error("Game snapshot error: unexpected end of data");
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructs reader of snapshot.
+         *
+         * @param data Snapshot bytes, must outlive the reader.
+         */
+        explicit Game_snapshot_reader(std::string_view data) : _data(data) {}
+
+        /**
+         * @brief Reads unsigned integer.
+         *
+         * @return Read value.
+         * @throws std::runtime_error If data is truncated or varint is longer than 64 bits.
+         */
+        uint64_t read_varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                require(1);
+                auto byte = static_cast<uint8_t>(_data.front());
+                _data.remove_prefix(1);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("Game snapshot error: malformed varint");
+        }
+
+        /**
+         * @brief Reads signed integer.
+         *
+         * @return Read value.
+         */
+        int64_t read_signed() {
+            uint64_t value = read_varint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        /**
+         * @brief Reads length prefixed string.
+         *
+         * @return Read string.
+         */
+        std::string read_string() {
+            uint64_t size = read_varint();
+            require(size);
+            std::string r(_data.substr(0, size));
+            _data.remove_prefix(size);
+            return r;
+        }
+
+        /**
+         * @brief Reads raw bytes.
+         *
+         * @param amount Amount of bytes to read.
+         * @return View of read bytes, valid while snapshot data is.
+         */
+        std::string_view read_raw(size_t amount) {
+            require(amount);
+            std::string_view r = _data.substr(0, amount);
+            _data.remove_prefix(amount);
+            return r;
+        }
+
+        /**
+         * @brief Checks if whole snapshot was read.
+         *
+         * @return True if no bytes are left.
+         */
+        bool is_finished() const { return _data.empty(); }
+    };
+
+} // namespace gb
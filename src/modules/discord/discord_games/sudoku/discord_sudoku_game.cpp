@@ -6,11 +6,48 @@
 
 namespace gb {
     Discord_sudoku_game::Discord_sudoku_game(Game_data_initialization &_data,
-                                             const std::vector<dpp::snowflake> &players) :
-        Discord_game(_data, players,&Discord_sudoku_game::run) {}
+                                             const std::vector<dpp::snowflake> &players, sudoku::Sudoku engine) :
+        Discord_game(_data, players,&Discord_sudoku_game::run), _engine(std::move(engine)) {}
 
     std::vector<std::pair<std::string, image_generator_t>> Discord_sudoku_game::get_image_generators() { return {}; }
 
+    bool Discord_sudoku_game::is_resumable() const { return true; }
+
+    void Discord_sudoku_game::save_state(Game_snapshot_writer &writer) const {
+        writer.write_varint(1); // state version
+        writer.write_varint(_available_mistakes);
+        for (auto &field: {_engine.get_field(), _engine.get_solution_field()}) {
+            for (auto &row: field) {
+                for (int cell: row) {
+                    writer.write_varint(cell);
+                }
+            }
+        }
+    }
+
+    void Discord_sudoku_game::load_state(Game_snapshot_reader &reader) {
+        if (reader.read_varint() != 1) {
+            throw std::runtime_error("Sudoku snapshot error: unknown state version");
+        }
+        uint64_t available_mistakes = reader.read_varint();
+        if (available_mistakes < 1 || available_mistakes > 3) {
+            throw std::runtime_error("Sudoku snapshot error: invalid amount of available mistakes");
+        }
+        std::array<std::array<std::array<int, 9>, 9>, 2> fields;
+        for (auto &field: fields) {
+            for (auto &row: field) {
+                for (int &cell: row) {
+                    // out of range values are rejected by restore()
+                    cell = static_cast<int>(std::min<uint64_t>(reader.read_varint(), 10));
+                }
+            }
+        }
+        if (!_engine.restore(fields[0], fields[1])) {
+            throw std::runtime_error("Sudoku snapshot error: grid does not match its solution");
+        }
+        _available_mistakes = static_cast<int>(available_mistakes);
+    }
+
     void Discord_sudoku_game::prepare_message(dpp::message &message) {
         message.components.clear();
         message.embeds[0]
@@ -163,15 +200,31 @@ namespace gb {
         message.guild_id = sevent.command.guild_id;
         message.id = 0;
 
-        Button_click_return r;
-        _engine.create_seed();
-        _engine.gen_puzzle();
         prepare_message(message);
         dpp::task<Button_click_return> button_click_awaitable =
             _data.button_click_handler->wait_for_with_reply(message, {get_current_player()}, _timeout);
         _data.bot->reply(sevent, message);
-        r = co_await button_click_awaitable;
+        Button_click_return r = co_await button_click_awaitable;
+        co_await play(std::move(message), std::move(r), std::move(sevent));
+        co_return;
+    }
+
+    dpp::task<void> Discord_sudoku_game::resume(dpp::message message) {
+        message.add_embed(dpp::embed());
+        prepare_message(message);
+        dpp::task<Button_click_return> button_click_awaitable =
+            _data.button_click_handler->wait_for_with_reply(message, {get_current_player()}, _timeout);
+        _data.bot->message_edit(message);
+        Button_click_return r = co_await button_click_awaitable;
+        co_await play(std::move(message), std::move(r), std::nullopt);
+        co_return;
+    }
+
+    dpp::task<void> Discord_sudoku_game::play(dpp::message message, Button_click_return r,
+                                              std::optional<dpp::slashcommand_t> sevent) {
         dpp::button_click_t event;
+        bool is_clicked = false;
+        dpp::task<Button_click_return> button_click_awaitable;
         while (1) {
             _is_mistake = false;
             if (r.second) {
@@ -185,16 +238,20 @@ namespace gb {
                                                  dpp::utility::user_mention(get_current_player())))
                     .set_color(dpp::colors::red);
                 message.embeds[0].set_image(add_image(message, create_image()));
-                if (message.id !=0) {
+                if (is_clicked) {
                     _data.bot->event_edit_original_response(event,message);
                 }
+                else if (sevent) {
+                    _data.bot->event_edit_original_response(*sevent,message);
+                }
                 else {
-                    _data.bot->event_edit_original_response(sevent,message);
+                    _data.bot->message_edit(message);
                 }
 
                 remove_player(USER_REMOVE_REASON::TIMEOUT, get_current_player());
                 break;
             }
+            is_clicked = true;
             event = r.first;
             message.id = event.command.message_id;
             if (event.custom_id == "back") {
@@ -238,6 +295,7 @@ namespace gb {
                     }
                     _is_mistake = true;
                     prepare_message(message);
+                    save_checkpoint(message);
                     button_click_awaitable =
                         _data.button_click_handler->wait_for_with_reply(message, {get_current_player()}, _timeout);
                     _data.bot->event_edit_original_response(event, message);
@@ -263,6 +321,7 @@ namespace gb {
                     break;
                 }
                 prepare_message(message);
+                save_checkpoint(message);
                 button_click_awaitable =
                     _data.button_click_handler->wait_for_with_reply(message, {get_current_player()}, _timeout);
                 _data.bot->event_edit_original_response(event, message);
@@ -18,7 +18,7 @@ namespace gb {
      * and determining the end conditions, such as winning or losing based on mistakes.
      */
     class Discord_sudoku_game : public Discord_game {
-        sudoku::Sudoku _engine = sudoku::Sudoku(); /**< The Sudoku game engine instance managing the puzzle. */
+        sudoku::Sudoku _engine; /**< The Sudoku game engine instance managing the puzzle. */
         int _state = 0; /**< Represents the current state of the game:
                          * 0 - select column,
                          * 1 - select row,
@@ -41,13 +41,49 @@ namespace gb {
          */
         dpp::task<void> run(dpp::slashcommand_t sevent);
 
+        /**
+         * @brief Game loop after the message was shown, shared by new and resumed games.
+         *
+         * @param message Message showing the game.
+         * @param r Result of waiting for the first button click.
+         * @param sevent The slash command event that initiated the game, empty for resumed games.
+         * @return A task representing the asynchronous execution of the game loop.
+         */
+        dpp::task<void> play(dpp::message message, Button_click_return r, std::optional<dpp::slashcommand_t> sevent);
+
+    protected:
+        /**
+         * @brief Writes available mistakes, the grid and its solution to snapshot.
+         *
+         * @param writer Snapshot writer.
+         */
+        void save_state(Game_snapshot_writer &writer) const override;
+
+        /**
+         * @brief Reads state written by save_state().
+         *
+         * @param reader Snapshot reader.
+         */
+        void load_state(Game_snapshot_reader &reader) override;
+
+        /**
+         * @brief Shows restored grid with new buttons and continues the game from choosing a column.
+         *
+         * @param message Message which showed the game before it was saved.
+         * @return A task representing the asynchronous execution of the game loop.
+         */
+        dpp::task<void> resume(dpp::message message) override;
+
     public:
         /**
          * @brief Constructor for initializing the Sudoku game.
          * @param _data The game data initialization object.
          * @param players A vector of player IDs participating in the game.
+         * @param engine Generated puzzle, usually taken from the command's puzzle pool. Resumed games get theirs
+         * from the snapshot.
          */
-        Discord_sudoku_game(Game_data_initialization &_data, const std::vector<dpp::snowflake> &players);
+        Discord_sudoku_game(Game_data_initialization &_data, const std::vector<dpp::snowflake> &players,
+                            sudoku::Sudoku engine = sudoku::Sudoku());
 
         /**
          * @breif Define destructor.
@@ -60,6 +96,13 @@ namespace gb {
          */
         static std::vector<std::pair<std::string, image_generator_t>> get_image_generators();
 
+        /**
+         * @brief Sudoku games are saved and resumed after restarts.
+         *
+         * @return Always true.
+         */
+        bool is_resumable() const override;
+
         /**
          * @brief Prepares the Discord message with the current game state and UI components.
          * @param message The message to be updated with game details and interactive elements.
@@ -94,6 +94,46 @@ namespace gb {
                                                        const std::vector<dpp::snowflake> &players) :
         Discord_game(_data, players,&Discord_tic_tac_toe_game::run) {}
 
+    Discord_tic_tac_toe_game::Discord_tic_tac_toe_game(Game_data_initialization &_data, const dpp::snowflake &player) :
+        Discord_game(_data, {player}, &Discord_tic_tac_toe_game::run_vs_computer) {}
+
+    int Discord_tic_tac_toe_game::get_position() const {
+        int position = 0;
+        for (int i = 0; i < 9; i++) {
+            SIGNS sign = board[i / 3][i % 3];
+            position += (sign == SIGNS::X ? tic_tac_toe::X : sign == SIGNS::O ? tic_tac_toe::O : tic_tac_toe::EMPTY) *
+                        tic_tac_toe::cell_weights[i];
+        }
+        return position;
+    }
+
+    dpp::message Discord_tic_tac_toe_game::finish_vs_computer(USER_REMOVE_REASON reason) {
+        dpp::message m;
+        dpp::embed embed;
+        embed.set_title("Game over!");
+        std::string player = dpp::utility::user_mention(get_current_player());
+        switch (reason) {
+            case USER_REMOVE_REASON::WIN:
+                embed.set_color(dpp::colors::green).set_description(std::format("Player {} beat the computer!", player));
+                break;
+            case USER_REMOVE_REASON::DRAW:
+                embed.set_color(dpp::colors::yellow)
+                    .set_description(std::format("Player {} and the computer played a draw!", player));
+                break;
+            case USER_REMOVE_REASON::TIMEOUT:
+                embed.set_color(dpp::colors::red)
+                    .set_description(std::format("The computer won the game!\n{} should think faster next time.", player));
+                break;
+            default:
+                embed.set_color(dpp::colors::red)
+                    .set_description(std::format("The computer won the game!\n{} will be luckier next time.", player));
+                break;
+        }
+        create_image(m, embed);
+        remove_player(reason, get_current_player());
+        return m.add_embed(embed);
+    }
+
     std::vector<std::pair<std::string, image_generator_t>> Discord_tic_tac_toe_game::get_image_generators() {
         image_generator_t base = [](const Image_processing_ptr &image_processing, const Vector2i &resolution) {
             auto image = image_processing->create_image(resolution, {0, 0, 0});
@@ -198,4 +238,73 @@ namespace gb {
         }
         co_return;
     }
+
+    dpp::task<void> Discord_tic_tac_toe_game::run_vs_computer(dpp::slashcommand_t sevent) {
+        bool is_first_move = true;
+        auto edit_response = [&](const dpp::message &m) {
+            if (is_first_move) {
+                _data.bot->event_edit_original_response(sevent, m);
+            } else {
+                _data.bot->event_edit_original_response(_event, m);
+            }
+        };
+        while (1) {
+            dpp::message m;
+            dpp::embed embed;
+            embed.set_color(dpp::colors::blue)
+                .set_title("Tic Tac Toe game.")
+                .set_description(std::format("Timeout: <t:{}:R>\nYou play **X** against the computer.\nSelect where "
+                                             "to place your sign.",
+                                             std::chrono::duration_cast<std::chrono::seconds>(
+                                                 std::chrono::system_clock::now().time_since_epoch())
+                                                     .count() +
+                                                 60));
+            create_image(m, embed);
+            create_components(m);
+            m.add_embed(embed);
+            auto button_click_awaiter = _data.button_click_handler->wait_for_with_reply(m, {get_current_player()}, 60);
+            if (is_first_move) {
+                _data.bot->reply(sevent, m);
+            } else {
+                _data.bot->event_edit_original_response(_event, m);
+            }
+            Button_click_return r = co_await button_click_awaiter;
+            if (r.second) {
+                edit_response(finish_vs_computer(USER_REMOVE_REASON::TIMEOUT));
+                break;
+            }
+            is_first_move = false;
+            _event = r.first;
+
+            std::string id = _event.custom_id;
+            if (id.size() < 2 || !std::isdigit(id[0]) || !std::isdigit(id[1]) ||
+                board[id[0] - '0'][id[1] - '0'] != SIGNS::EMPTY) {
+                continue;
+            }
+            board[id[0] - '0'][id[1] - '0'] = SIGNS::X;
+            int position = get_position();
+            if (tic_tac_toe::get_winner(position) != tic_tac_toe::EMPTY) {
+                edit_response(finish_vs_computer(USER_REMOVE_REASON::WIN));
+                break;
+            }
+
+            // table lookup is instant, so the computer answers within the same interaction
+            int move = tic_tac_toe::get_best_move(position);
+            if (move < 0) {
+                edit_response(finish_vs_computer(USER_REMOVE_REASON::DRAW));
+                break;
+            }
+            board[move / 3][move % 3] = SIGNS::O;
+            position = get_position();
+            if (tic_tac_toe::get_winner(position) != tic_tac_toe::EMPTY) {
+                edit_response(finish_vs_computer(USER_REMOVE_REASON::LOSE));
+                break;
+            }
+            if (tic_tac_toe::get_best_move(position) < 0) {
+                edit_response(finish_vs_computer(USER_REMOVE_REASON::DRAW));
+                break;
+            }
+        }
+        co_return;
+    }
 } // namespace gb
@@ -3,6 +3,7 @@
 //
 
 #pragma once
+#include <src/games/tic_tac_toe/tic_tac_toe.hpp>
 #include "../discord_game.hpp"
 
 namespace gb {
@@ -44,6 +45,30 @@ namespace gb {
          */
         dpp::task<void> run(const dpp::button_click_t &_event);
 
+        /**
+         * @brief Runs the game of the only player against the computer.
+         *
+         * The player is X and moves first, the computer answers from the perfect play table within the same
+         * interaction.
+         *
+         * @param sevent The slash command which started the game.
+         * @return dpp::task<void> A task representing the game's execution.
+         */
+        dpp::task<void> run_vs_computer(dpp::slashcommand_t sevent);
+
+        /**
+         * @brief Gets index of the board in the perfect play table.
+         */
+        int get_position() const;
+
+        /**
+         * @brief Handles the end of a game against the computer and returns a message to be sent.
+         *
+         * @param reason Result of the player.
+         * @return dpp::message The message showing the result.
+         */
+        dpp::message finish_vs_computer(USER_REMOVE_REASON reason);
+
         /**
          * @brief Creates an image representation of the current game state.
          *
@@ -85,6 +110,14 @@ namespace gb {
          */
         Discord_tic_tac_toe_game(Game_data_initialization &_data, const std::vector<dpp::snowflake> &players);
 
+        /**
+         * @brief Constructs a new Discord Tic Tac Toe game against the computer.
+         *
+         * @param _data The initialization data required to start the game.
+         * @param player The only player, started with the slash command event.
+         */
+        Discord_tic_tac_toe_game(Game_data_initialization &_data, const dpp::snowflake &player);
+
         /**
          * @breif Define destructor.
          */
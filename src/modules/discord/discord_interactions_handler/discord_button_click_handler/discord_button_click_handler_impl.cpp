@@ -5,16 +5,25 @@
 #include "discord_button_click_handler_impl.hpp"
 
 namespace gb {
+    Interaction_dispatcher<dpp::button_click_t>::filter_t
+    Discord_button_click_handler_impl::users_filter(const std::vector<dpp::snowflake> &users) {
+        return [this, users](const dpp::button_click_t &b) {
+            if (users.empty() || std::ranges::find(users, b.command.member.user_id) != users.end()) {
+                return true;
+            }
+            _bot->reply_new(b, dpp::message()
+                                   .set_flags(dpp::m_ephemeral)
+                                   .add_embed(dpp::embed()
+                                                  .set_color(dpp::colors::red)
+                                                  .set_title("Error")
+                                                  .set_description("This interaction is not for you!")));
+            return false;
+        };
+    }
+
     dpp::task<Button_click_return>
     gb::Discord_button_click_handler_impl::wait_for(dpp::message &m, const std::vector<dpp::snowflake> &users,
                                                     time_t timeout, bool generate_ids, bool clear_ids) {
-        auto to_uint64 = [](const std::string &v) -> uint64_t {
-            uint64_t value;
-            std::istringstream iss(v);
-            iss >> value;
-            return value;
-        };
-
         std::vector<uint64_t> ids;
         if (generate_ids) {
             ids = _cache.component_init(m);
@@ -30,25 +39,11 @@ namespace gb {
         }
         _bot->get_bot()->log(dpp::ll_info, "Button click awaiter created with timeout: " + std::to_string(timeout) +
                                                "\nWaiting for users: " + users_list);
-        auto result = co_await dpp::when_any{
-            _bot->get_bot()->on_button_click.when([this, &ids, &to_uint64, users](const dpp::button_click_t &b) {
-                bool res = std::ranges::find(ids, to_uint64(b.custom_id)) != ids.end() &&
-                           (users.empty() || std::ranges::find(users, b.command.member.user_id) != users.end());
-                if (!res && std::ranges::find(ids, to_uint64(b.custom_id)) != ids.end()) {
-                    _bot->reply_new(b, dpp::message()
-                                           .set_flags(dpp::m_ephemeral)
-                                           .add_embed(dpp::embed()
-                                                          .set_color(dpp::colors::red)
-                                                          .set_title("Error")
-                                                          .set_description("This interaction is not for you!")));
-                }
-                return res;
-            }),
-            _bot->get_bot()->co_sleep(timeout)};
+        auto result = co_await _dispatcher.wait(ids, users_filter(users), timeout);
 
-        if (result.index() == 0) {
-            dpp::button_click_t click_event = result.get<0>();
-            click_event.custom_id = _cache.get_value(to_uint64(click_event.custom_id));
+        if (result) {
+            dpp::button_click_t click_event = std::move(*result);
+            click_event.custom_id = _cache.get_value(parse_component_id(click_event.custom_id));
             _bot->get_bot()->log(dpp::ll_info, "Button click event: " + click_event.custom_id +
                                                    "\nuser ID: " + std::to_string(click_event.command.member.user_id));
             if (clear_ids) {
@@ -64,14 +59,6 @@ namespace gb {
     dpp::task<Button_click_return>
     Discord_button_click_handler_impl::wait_for_with_reply(dpp::message &m, const std::vector<dpp::snowflake> &users,
                                                            time_t timeout, bool generate_ids, bool clear_ids) {
-
-        auto to_uint64 = [](const std::string &v) -> uint64_t {
-            uint64_t value;
-            std::istringstream iss(v);
-            iss >> value;
-            return value;
-        };
-
         std::vector<uint64_t> ids;
         if (generate_ids) {
             ids = _cache.component_init(m);
@@ -88,25 +75,11 @@ namespace gb {
         _bot->get_bot()->log(dpp::ll_info, "Button click awaiter created with timeout: " + std::to_string(timeout) +
                                                "\nWaiting for users: " + users_list);
         while (true) {
-            auto result = co_await dpp::when_any{
-                _bot->get_bot()->on_button_click.when([this, &ids, &to_uint64, users](const dpp::button_click_t &b) {
-                    bool res = std::ranges::find(ids, to_uint64(b.custom_id)) != ids.end() &&
-                               (users.empty() || std::ranges::find(users, b.command.member.user_id) != users.end());
-                    if (!res && std::ranges::find(ids, to_uint64(b.custom_id)) != ids.end()) {
-                        _bot->reply_new(b, dpp::message()
-                                               .set_flags(dpp::m_ephemeral)
-                                               .add_embed(dpp::embed()
-                                                              .set_color(dpp::colors::red)
-                                                              .set_title("Error")
-                                                              .set_description("This interaction is not for you!")));
-                    }
-                    return res;
-                }),
-                _bot->get_bot()->co_sleep(timeout)};
+            auto result = co_await _dispatcher.wait(ids, users_filter(users), timeout);
 
-            if (result.index() == 0) {
-                dpp::button_click_t click_event = result.get<0>();
-                click_event.custom_id = _cache.get_value(to_uint64(click_event.custom_id));
+            if (result) {
+                dpp::button_click_t click_event = std::move(*result);
+                click_event.custom_id = _cache.get_value(parse_component_id(click_event.custom_id));
                 _bot->get_bot()->log(dpp::ll_info, "Button click event: " + click_event.custom_id +
                                                        "\nuser ID: " + std::to_string(click_event.command.member.user_id));
                 //send loading message and if it has failed, do retry of awaiting;
@@ -129,13 +102,21 @@ namespace gb {
 
     void Discord_button_click_handler_impl::clear_ids(const dpp::message &m) { _cache.clear_ids(_cache.get_ids(m)); }
 
-    void Discord_button_click_handler_impl::run() {}
+    void Discord_button_click_handler_impl::run() {
+        _on_button_click_handler = _bot->get_bot()->on_button_click(
+            [this](const dpp::button_click_t &event) { _dispatcher.dispatch(event); });
+    }
 
     void Discord_button_click_handler_impl::init(const Modules &modules) {
         _bot = std::static_pointer_cast<Discord_bot>(modules.at("discord_bot"));
+        _dispatcher.set_timer_wheel(&_bot->get_timer_wheel());
     }
 
-    void Discord_button_click_handler_impl::stop() { _cache.stop(); }
+    void Discord_button_click_handler_impl::stop() {
+        // waiters still need clicks to finish
+        _cache.stop();
+        _bot->get_bot()->on_button_click.detach(_on_button_click_handler);
+    }
 
     Discord_button_click_handler_impl::Discord_button_click_handler_impl() :
         Discord_button_click_handler("discord_button_click_handler", {"discord_bot"}) {}
@@ -6,6 +6,7 @@
 #include "./discord_button_click_handler.hpp"
 #include "src/modules/discord/discord_bot/discord_bot.hpp"
 #include "src/modules/discord/discord_interactions_handler/id_cache.hpp"
+#include "src/modules/discord/discord_interactions_handler/interaction_dispatcher.hpp"
 
 namespace gb {
 
@@ -24,6 +25,20 @@ namespace gb {
         /// Cache for managing unique component IDs.
         Id_cache _cache{};
 
+        /// Routes button clicks to waiting coroutines.
+        Interaction_dispatcher<dpp::button_click_t> _dispatcher;
+
+        /// Handle of the button click listener feeding _dispatcher.
+        dpp::event_handle _on_button_click_handler;
+
+        /**
+         * @brief Creates filter accepting clicks of given users and replying with error to others.
+         *
+         * @param users Allowed users, empty to allow everyone.
+         * @return Filter for _dispatcher.
+         */
+        Interaction_dispatcher<dpp::button_click_t>::filter_t users_filter(const std::vector<dpp::snowflake> &users);
+
     public:
         /**
          * @brief Constructor for Discord_button_click_handler_impl.
@@ -86,6 +101,8 @@ namespace gb {
 
         /**
          * @brief Starts the handler's operation.
+         *
+         * Attaches button click listener.
          */
         void run() override;
 
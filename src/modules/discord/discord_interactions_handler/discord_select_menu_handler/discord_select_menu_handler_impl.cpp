@@ -11,28 +11,19 @@ namespace gb {
     dpp::task<Select_menu_return>
     Discord_select_menu_handler_impl::wait_for(dpp::message &m, const std::vector<dpp::snowflake> &users,
                                                time_t timeout) {
-        auto to_uint64 = [](const std::string& v) -> uint64_t{
-            uint64_t value;
-            std::istringstream iss(v);
-            iss >> value;
-            return value;
-        };
-
         auto ids = _cache.component_init(m);
-        auto result = co_await dpp::when_any{
-            _bot->get_bot()->on_select_click.when([this,&ids,&to_uint64,users](const dpp::select_click_t &b){
-                return std::ranges::find(ids,to_uint64(b.values[0])) != ids.end() &&
-                       (users.empty() || std::ranges::find(users,b.command.member.user_id) != users.end());
-            }),
-
-            _bot->get_bot()->co_sleep(timeout)
-        };
-
-        if (result.index() == 0) {
-            dpp::select_click_t click_event = result.get<0>();
-            click_event.custom_id = _cache.get_value(to_uint64(click_event.custom_id));
+        auto result = co_await _dispatcher.wait(
+            ids,
+            [users](const dpp::select_click_t &b) {
+                return users.empty() || std::ranges::find(users, b.command.member.user_id) != users.end();
+            },
+            timeout);
+
+        if (result) {
+            dpp::select_click_t click_event = std::move(*result);
+            click_event.custom_id = _cache.get_value(parse_component_id(click_event.custom_id));
             for (auto& i: click_event.values){
-                i = _cache.get_value(to_uint64(i));
+                i = _cache.get_value(parse_component_id(i));
             }
             _cache.clear_ids(ids);
             co_return {click_event,false};
@@ -41,14 +32,20 @@ namespace gb {
         co_return {{},true};
     }
 
-    void Discord_select_menu_handler_impl::run() {}
+    void Discord_select_menu_handler_impl::run() {
+        _on_select_click_handler = _bot->get_bot()->on_select_click(
+            [this](const dpp::select_click_t &event) { _dispatcher.dispatch(event); });
+    }
 
     void Discord_select_menu_handler_impl::init(const Modules &modules) {
         _bot = std::static_pointer_cast<Discord_bot>(modules.at("discord_bot"));
+        _dispatcher.set_timer_wheel(&_bot->get_timer_wheel());
     }
 
     void Discord_select_menu_handler_impl::stop() {
+        // waiters still need clicks to finish
         _cache.stop();
+        _bot->get_bot()->on_select_click.detach(_on_select_click_handler);
     }
 
 
@@ -5,6 +5,7 @@
 #pragma once
 #include "./discord_select_menu_handler.hpp"
 #include "../id_cache.hpp"
+#include "../interaction_dispatcher.hpp"
 #include "../../discord_bot/discord_bot.hpp"
 
 namespace gb {
@@ -23,6 +24,12 @@ namespace gb {
         /// Cache for managing unique component IDs.
         Id_cache _cache{};
 
+        /// Routes select menu clicks to waiting coroutines.
+        Interaction_dispatcher<dpp::select_click_t> _dispatcher;
+
+        /// Handle of the select click listener feeding _dispatcher.
+        dpp::event_handle _on_select_click_handler;
+
     public:
         /**
          * @brief Constructor initializes the handler with the necessary dependencies.
@@ -49,6 +56,8 @@ namespace gb {
 
         /**
          * @brief Runs the select menu handler.
+         *
+         * Attaches select click listener.
          */
         void run() override;
 
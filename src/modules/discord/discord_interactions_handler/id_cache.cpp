@@ -4,36 +4,125 @@
 
 #include "./id_cache.hpp"
 
+#include <bit>
+#include <cstring>
+#include <random>
+
 namespace gb {
 
+    void Component_value::assign(std::string_view value) {
+        _size = value.size();
+        if (_size <= inline_capacity) {
+            _heap.reset();
+            std::memcpy(_inline.data(), value.data(), _size);
+        } else {
+            _heap = std::make_unique<char[]>(_size);
+            std::memcpy(_heap.get(), value.data(), _size);
+        }
+    }
+
+    void Component_value::clear() {
+        _heap.reset();
+        _size = 0;
+    }
+
+    std::string_view Component_value::view() const {
+        return {_size <= inline_capacity ? _inline.data() : _heap.get(), _size};
+    }
+
     Id_cache::Id_cache() {
         static std::random_device _rd;
-        _rng = std::mt19937(_rd());
+        _salt = (static_cast<uint64_t>(_rd()) << 32) | _rd();
+    }
+
+    uint64_t Id_cache::generate_id() {
+        uint64_t id;
+        do {
+            // multiplying by an odd constant and xoring are both bijective, so distinct counters give distinct ids
+            id = (_counter.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull) ^ _salt;
+        } while (id <= erased_id);
+        return id;
+    }
+
+    Id_cache::Shard &Id_cache::get_shard(uint64_t id) { return _shards[id % shards_amount]; }
+
+    Id_cache::Slot *Id_cache::find(Shard &shard, uint64_t id) {
+        // ids of foreign components parse as 0 and must not match empty or erased slots
+        if (id <= erased_id || shard.slots.empty()) {
+            return nullptr;
+        }
+        size_t mask = shard.slots.size() - 1;
+        for (size_t i = (id / shards_amount) & mask;; i = (i + 1) & mask) {
+            Slot &slot = shard.slots[i];
+            if (slot.id == id) {
+                return &slot;
+            }
+            if (slot.id == empty_id) {
+                return nullptr;
+            }
+        }
+    }
+
+    void Id_cache::insert(Shard &shard, uint64_t id, std::string_view value) {
+        // keep at most 3/4 of slots non empty so probe sequences stay short
+        if ((shard.used + 1) * 4 > shard.slots.size() * 3) {
+            rehash(shard, std::max<size_t>(16, std::bit_ceil((shard.size + 1) * 2)));
+        }
+        size_t mask = shard.slots.size() - 1;
+        size_t i = (id / shards_amount) & mask;
+        // ids are unique, so the first free slot can be taken without looking further
+        while (shard.slots[i].id > erased_id) {
+            i = (i + 1) & mask;
+        }
+        Slot &slot = shard.slots[i];
+        if (slot.id == empty_id) {
+            shard.used++;
+        }
+        slot.id = id;
+        slot.value.assign(value);
+        shard.size++;
+    }
+
+    void Id_cache::rehash(Shard &shard, size_t slots_amount) {
+        std::vector<Slot> old = std::move(shard.slots);
+        shard.slots = std::vector<Slot>(slots_amount);
+        shard.used = shard.size;
+        size_t mask = slots_amount - 1;
+        for (Slot &slot: old) {
+            if (slot.id <= erased_id) {
+                continue;
+            }
+            size_t i = (slot.id / shards_amount) & mask;
+            while (shard.slots[i].id != empty_id) {
+                i = (i + 1) & mask;
+            }
+            shard.slots[i] = std::move(slot);
+        }
+    }
+
+    uint64_t Id_cache::add(std::string_view value) {
+        uint64_t id = generate_id();
+        Shard &shard = get_shard(id);
+        {
+            std::unique_lock lk(shard.mutex);
+            insert(shard, id, value);
+        }
+        _size++;
+        return id;
     }
 
     std::vector<uint64_t> Id_cache::component_init(dpp::message &m) {
         std::vector<uint64_t> occupied_ids;
 
         auto manage_id = [this, &occupied_ids](dpp::component &component) {
-            std::unique_lock lk(_mutex);
-            uint64_t id;
-            do {
-                id = _dist(_rng);
-            } while (_ids_map.contains(id));
-
-            _ids_map[id] = component.custom_id;
+            uint64_t id = add(component.custom_id);
             occupied_ids.push_back(id);
             component.custom_id = std::to_string(id);
         };
 
         auto selectmenu = [this, &occupied_ids](dpp::component &component) {
             for (auto &i: component.options) {
-                std::unique_lock lk(_mutex);
-                uint64_t id;
-                do {
-                    id = _dist(_rng);
-                } while (_ids_map.contains(id));
-                _ids_map[id] = i.value;
+                uint64_t id = add(i.value);
                 occupied_ids.push_back(id);
                 i.value = std::to_string(id);
             }
@@ -58,42 +147,48 @@ namespace gb {
     }
 
     void Id_cache::clear_ids(const std::vector<uint64_t> &ids) {
-        std::unique_lock lk(_mutex);
+        size_t erased = 0;
         for (auto &i: ids) {
-            _ids_map.erase(i);
+            Shard &shard = get_shard(i);
+            std::unique_lock lk(shard.mutex);
+            if (Slot *slot = find(shard, i)) {
+                slot->id = erased_id;
+                slot->value.clear();
+                shard.size--;
+                erased++;
+            }
+        }
+        if (erased && _size.fetch_sub(erased) == erased) {
+            std::unique_lock lk(_empty_mutex);
+            _cv.notify_all();
         }
-        _cv.notify_all();
     }
 
     void Id_cache::stop() {
-        std::mutex m;
-        std::unique_lock lk(m);
-        _cv.wait(lk, [this]() { return _ids_map.empty(); });
+        std::unique_lock lk(_empty_mutex);
+        _cv.wait(lk, [this]() { return _size == 0; });
     }
 
     std::string Id_cache::get_value(uint64_t key) {
-        std::shared_lock lk(_mutex);
-        return _ids_map.at(key);
+        Shard &shard = get_shard(key);
+        std::unique_lock lk(shard.mutex);
+        Slot *slot = find(shard, key);
+        if (!slot) {
+            throw std::out_of_range("Id_cache error: id " + std::to_string(key) + " is not stored");
+        }
+        return std::string(slot->value.view());
     }
 
     std::vector<uint64_t> Id_cache::get_ids(const dpp::message &m) {
         std::vector<uint64_t> occupied_ids;
 
-        auto to_uint64 = [](const std::string& s) {
-            uint64_t value;
-            std::istringstream iss(s);
-            iss >> value;
-            return value;
-        };
-
-
-        auto manage_id = [this, &occupied_ids,&to_uint64](const dpp::component &component) {
-            occupied_ids.push_back(to_uint64(component.custom_id));
+        auto manage_id = [&occupied_ids](const dpp::component &component) {
+            occupied_ids.push_back(parse_component_id(component.custom_id));
         };
 
-        auto selectmenu = [this, &occupied_ids,&to_uint64](const dpp::component &component) {
+        auto selectmenu = [&occupied_ids](const dpp::component &component) {
             for (auto &i: component.options) {
-                occupied_ids.push_back(to_uint64(i.value));
+                occupied_ids.push_back(parse_component_id(i.value));
             }
         };
         for (auto &cmp: m.components) {
@@ -113,4 +208,4 @@ namespace gb {
         }
         return occupied_ids;
     }
-} //gb
\ No newline at end of file
+} //gb
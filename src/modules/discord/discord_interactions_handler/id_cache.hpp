@@ -3,40 +3,157 @@
 //
 
 #pragma once
-#include <random>
-#include <shared_mutex>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string_view>
 #include <dpp/dpp.h>
 
 namespace gb {
 
+    /**
+     * @brief Parses component id generated by Id_cache.
+     *
+     * @param value Custom id or select option value of the component.
+     * @return Parsed id, 0 if value is not a number.
+     */
+    inline uint64_t parse_component_id(std::string_view value) {
+        uint64_t id = 0;
+        std::from_chars(value.data(), value.data() + value.size(), id);
+        return id;
+    }
+
+    /**
+     * @brief String stored inline when short, custom ids and option values almost always are.
+     */
+    class Component_value {
+        static constexpr size_t inline_capacity = 40; ///< Longest string stored without allocation.
+
+        std::unique_ptr<char[]> _heap; ///< Data of long strings.
+        uint32_t _size = 0; ///< String length.
+        std::array<char, inline_capacity> _inline; ///< Data of short strings.
+
+    public:
+        Component_value() = default;
+
+        /**
+         * @brief Stores copy of the string.
+         *
+         * @param value String to store.
+         */
+        void assign(std::string_view value);
+
+        /**
+         * @brief Frees long string data.
+         */
+        void clear();
+
+        /**
+         * @brief Gets stored string.
+         *
+         * @return View valid until value is changed.
+         */
+        std::string_view view() const;
+    };
+
     /**
      * @brief A class to manage unique component IDs for DPP messages.
      *
-     * The Id_cache class generates unique IDs for DPP message components, ensures
-     * that they do not collide, and maintains a mapping from the generated IDs
-     * to the original component custom IDs. It also provides functionality to
-     * clear these IDs when they are no longer needed.
+     * The Id_cache class generates unique IDs for DPP message components and maintains a mapping from the
+     * generated IDs to the original component custom IDs. It also provides functionality to clear these IDs
+     * when they are no longer needed.
+     *
+     * Ids are a counter passed through a salted bijection, so they never collide and look random. The mapping
+     * is split into shards, each an open addressing table with its own lock.
      */
     class Id_cache {
     protected:
-        /// Map to store the association between generated IDs and custom component IDs.
-        std::map<uint64_t, std::string> _ids_map;
+        /// Amount of shards, ids are spread over them evenly.
+        static constexpr size_t shards_amount = 16;
 
-        /// Random number generator.
-        std::mt19937 _rng;
+        /// Slot key of never used slot.
+        static constexpr uint64_t empty_id = 0;
 
-        /// Uniform distribution for generating random IDs.
-        std::uniform_int_distribution<uint64_t> _dist{0, std::numeric_limits<uint64_t>::max()};
+        /// Slot key of erased slot, generated ids are never below 2.
+        static constexpr uint64_t erased_id = 1;
 
-        /// Mutex for thread-safe access to _ids_map.
-        std::shared_mutex _mutex;
+        /**
+         * @brief Slot of open addressing table.
+         */
+        struct Slot {
+            uint64_t id = empty_id; ///< Generated id, or empty_id / erased_id.
+            Component_value value; ///< Original custom id or option value.
+        };
 
-        /// Condition variable to notify when _ids_map is empty.
+        /**
+         * @brief Part of the mapping with its own lock.
+         */
+        struct Shard {
+            std::mutex mutex; ///< Protects shard.
+            std::vector<Slot> slots; ///< Table, size is a power of two.
+            size_t size = 0; ///< Amount of stored ids.
+            size_t used = 0; ///< Amount of non empty slots, including erased ones.
+        };
+
+        /// Shards of the mapping.
+        std::array<Shard, shards_amount> _shards;
+
+        /// Counter of generated ids.
+        std::atomic_uint64_t _counter = 0;
+
+        /// Random salt making ids differ between runs.
+        uint64_t _salt;
+
+        /// Amount of stored ids.
+        std::atomic_size_t _size = 0;
+
+        /// Mutex for waiting for cache to become empty.
+        std::mutex _empty_mutex;
+
+        /// Condition variable to notify when cache is empty.
         std::condition_variable _cv;
 
+        /**
+         * @brief Generates new unique id.
+         */
+        uint64_t generate_id();
+
+        /**
+         * @brief Gets shard storing id.
+         */
+        Shard &get_shard(uint64_t id);
+
+        /**
+         * @brief Finds slot of stored id. Requires shard lock.
+         *
+         * @return Slot pointer, nullptr if id is not stored.
+         */
+        static Slot *find(Shard &shard, uint64_t id);
+
+        /**
+         * @brief Stores new id. Requires shard lock.
+         */
+        static void insert(Shard &shard, uint64_t id, std::string_view value);
+
+        /**
+         * @brief Rebuilds table with given amount of slots dropping erased slots. Requires shard lock.
+         */
+        static void rehash(Shard &shard, size_t slots_amount);
+
+        /**
+         * @brief Generates id for value and stores it.
+         *
+         * @param value Original custom id or option value.
+         * @return Generated id.
+         */
+        uint64_t add(std::string_view value);
+
     public:
         /**
-         * @brief Constructor initializes the random number generator.
+         * @brief Constructor initializes the salt.
          */
         Id_cache();
 
@@ -49,7 +166,7 @@ namespace gb {
          * @brief Initializes the component IDs for a given DPP message.
          *
          * This function generates unique IDs for each component in the message
-         * and stores the mapping in _ids_map.
+         * and stores the mapping.
          *
          * @param m The DPP message whose components need IDs.
          * @return A vector of generated IDs that were assigned to the components.
@@ -57,19 +174,18 @@ namespace gb {
         std::vector<uint64_t> component_init(dpp::message& m);
 
         /**
-         * @brief Clears the stored IDs from the map.
+         * @brief Clears the stored IDs.
          *
-         * This function removes the specified IDs from the _ids_map, indicating
-         * that they are no longer in use.
+         * This function removes the specified IDs, indicating that they are no longer in use.
          *
          * @param ids A vector of IDs to be cleared.
          */
         void clear_ids(const std::vector<uint64_t>& ids);
 
         /**
-         * @brief Waits for the ID map to be empty before proceeding.
+         * @brief Waits for the cache to be empty before proceeding.
          *
-         * This function blocks until all IDs in the _ids_map have been cleared.
+         * This function blocks until all IDs have been cleared.
          */
         void stop();
 
@@ -78,6 +194,7 @@ namespace gb {
          *
          * @param key The generated ID for which to retrieve the custom component ID.
          * @return The custom component ID associated with the given generated ID.
+         * @throws std::out_of_range If the id is not stored.
          */
         std::string get_value(uint64_t key);
 
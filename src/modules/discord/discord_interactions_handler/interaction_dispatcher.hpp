@@ -0,0 +1,179 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#pragma once
+#include <coroutine>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "id_cache.hpp"
+#include "src/utils/coro/coro.hpp"
+#include "src/utils/timer_wheel/timer_wheel.hpp"
+
+namespace gb {
+
+    /**
+     * @class Interaction_dispatcher
+     * @brief Routes component interactions to the coroutines waiting for them.
+     *
+     * A single event listener passes every interaction to dispatch(), which finds its waiter by component id
+     * in a hash map, so routing costs the same no matter how many waiters exist. Timeouts are scheduled on
+     * a shared Timer_wheel.
+     *
+     * @tparam Event Interaction event type, must have custom_id.
+     */
+    template<typename Event>
+    class Interaction_dispatcher {
+    public:
+        /// Decides if interaction is accepted by waiter, may reply to rejected ones.
+        typedef std::function<bool(const Event &)> filter_t;
+
+    private:
+        /**
+         * @brief Coroutine waiting for interaction with some components.
+         */
+        struct Waiter {
+            std::vector<uint64_t> ids; ///< Component ids waited for.
+            filter_t filter; ///< Accepts or rejects interactions.
+            std::optional<Event> event; ///< Accepted interaction, empty on timeout.
+            std::coroutine_handle<> handle; ///< Suspended coroutine.
+            Timer_wheel::Handle timeout; ///< Timeout timer.
+            bool is_finished = false; ///< Interaction accepted or timed out.
+        };
+
+        Timer_wheel *_timer_wheel = nullptr; ///< Wheel timeouts are scheduled on.
+        std::mutex _mutex; ///< Protects all members below.
+        std::unordered_map<uint64_t, std::shared_ptr<Waiter>> _waiters; ///< Waiters by component id.
+
+        /**
+         * @brief Registers waiter for its ids and timeout.
+         */
+        void add(const std::shared_ptr<Waiter> &waiter, time_t timeout) {
+            std::unique_lock lk(_mutex);
+            for (uint64_t id: waiter->ids) {
+                _waiters[id] = waiter;
+            }
+            waiter->timeout = _timer_wheel->add(timeout, [this, waiter]() { expire(waiter); });
+        }
+
+        /**
+         * @brief Resumes waiter with timeout, unless it got interaction first.
+         *
+         * Called on the timer thread for a whole wheel slot, so the game over path of the waiter is posted to the
+         * executor instead of running inline and delaying the other timeouts.
+         */
+        void expire(const std::shared_ptr<Waiter> &waiter) {
+            {
+                std::unique_lock lk(_mutex);
+                if (!finish(waiter)) {
+                    return;
+                }
+            }
+            if (Executor *executor = Executor::current()) {
+                executor->post([handle = waiter->handle]() { handle.resume(); });
+            } else {
+                waiter->handle.resume();
+            }
+        }
+
+        /**
+         * @brief Unregisters waiter. Requires _mutex.
+         *
+         * @return True if waiter was not finished before.
+         */
+        bool finish(const std::shared_ptr<Waiter> &waiter) {
+            if (waiter->is_finished) {
+                return false;
+            }
+            waiter->is_finished = true;
+            for (uint64_t id: waiter->ids) {
+                auto it = _waiters.find(id);
+                // id may be already waited again by another waiter
+                if (it != _waiters.end() && it->second == waiter) {
+                    _waiters.erase(it);
+                }
+            }
+            _timer_wheel->cancel(waiter->timeout);
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Sets wheel timeouts are scheduled on, must be called before first wait.
+         *
+         * @param timer_wheel Timer wheel ticked once a second.
+         */
+        void set_timer_wheel(Timer_wheel *timer_wheel) { _timer_wheel = timer_wheel; }
+
+        /**
+         * @brief Awaitable returned by wait(), resumes with accepted interaction or empty optional on timeout.
+         */
+        class Awaiter {
+            Interaction_dispatcher *_dispatcher; ///< Dispatcher to register in.
+            std::shared_ptr<Waiter> _waiter; ///< State shared with dispatcher.
+            time_t _timeout; ///< Timeout in seconds.
+
+        public:
+            Awaiter(Interaction_dispatcher *dispatcher, std::shared_ptr<Waiter> waiter, time_t timeout) :
+                _dispatcher(dispatcher), _waiter(std::move(waiter)), _timeout(timeout) {}
+
+            bool await_ready() { return false; }
+            void await_suspend(std::coroutine_handle<> h) {
+                _waiter->handle = h;
+                // may be resumed from another thread right after registering, do not touch the frame after this
+                _dispatcher->add(std::shared_ptr<Waiter>(_waiter), _timeout);
+            }
+            std::optional<Event> await_resume() { return std::move(_waiter->event); }
+        };
+
+        /**
+         * @brief Waits for interaction with one of given components.
+         *
+         * @param ids Component ids generated by Id_cache.
+         * @param filter Accepts or rejects interactions.
+         * @param timeout Timeout in seconds, precision is one second.
+         * @return Awaitable resuming with accepted interaction or empty optional on timeout.
+         */
+        Awaiter wait(const std::vector<uint64_t> &ids, filter_t filter, time_t timeout) {
+            auto waiter = std::make_shared<Waiter>();
+            waiter->ids = ids;
+            waiter->filter = std::move(filter);
+            return Awaiter(this, std::move(waiter), timeout);
+        }
+
+        /**
+         * @brief Passes interaction to its waiter, if it is accepted waiter is resumed on calling thread.
+         *
+         * @param event Interaction event.
+         */
+        void dispatch(const Event &event) {
+            std::shared_ptr<Waiter> waiter;
+            {
+                std::unique_lock lk(_mutex);
+                auto it = _waiters.find(parse_component_id(event.custom_id));
+                if (it == _waiters.end()) {
+                    return;
+                }
+                waiter = it->second;
+            }
+            // filter may reply to the interaction, so it is called without holding the lock
+            if (!waiter->filter(event)) {
+                return;
+            }
+            {
+                std::unique_lock lk(_mutex);
+                if (!finish(waiter)) {
+                    return;
+                }
+            }
+            waiter->event = event;
+            waiter->handle.resume();
+        }
+    };
+
+} // namespace gb
@@ -11,8 +11,8 @@ namespace gb {
     void Discord_reports_impl::run() {
         _loop_timer = _bot->get_bot()->start_timer(
             [this](const dpp::timer &t) -> dpp::task<void> {
-                uint64_t servers_cnt = co_await _discord_stats->get_servers_cnt();
-                uint64_t users_cnt = co_await _discord_stats->get_users_cnt();
+                auto [servers_cnt, users_cnt] =
+                    co_await when_all(_discord_stats->get_servers_cnt(), _discord_stats->get_users_cnt());
                 _bot->get_bot()->log(dpp::ll_info, "Running reports to websites!");
                 _bot->get_bot()->set_presence(dpp::presence(
                     dpp::ps_online,
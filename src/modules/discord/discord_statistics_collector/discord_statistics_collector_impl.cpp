@@ -81,27 +81,27 @@ namespace gb {
     }
 
     Task<uint64_t> Discord_statistics_collector_impl::get_servers_cnt() {
-        Database_return_t r = co_await _db->execute_prepared_statement(_get_servers_cnt);
-        uint64_t value;
-        std::string s = r.at(0).at("cnt");
-        std::from_chars(s.data(), s.data() + s.size(), value);
-        co_return value;
+        Database_result r = co_await _db->query_prepared_statement(_get_servers_cnt);
+        if (r.is_null(0, "cnt")) {
+            co_return 0;
+        }
+        co_return r.get_uint64(0, "cnt");
     }
 
     Task<uint64_t> Discord_statistics_collector_impl::get_users_cnt() {
-        Database_return_t r = co_await _db->execute_prepared_statement(_get_users_cnt_stmt);
-        uint64_t value;
-        std::string s = r.at(0).at("cnt");
-        std::from_chars(s.data(), s.data() + s.size(), value);
-        co_return value;
+        Database_result r = co_await _db->query_prepared_statement(_get_users_cnt_stmt);
+        if (r.is_null(0, "cnt")) {
+            co_return 0;
+        }
+        co_return r.get_uint64(0, "cnt");
     }
 
     Task<uint64_t> Discord_statistics_collector_impl::get_users_on_server_cnt(const dpp::snowflake &guild_id) {
-        Database_return_t r = co_await _db->execute_prepared_statement(_get_users_cnt_on_server_stmt,guild_id);
-        uint64_t value;
-        std::string s = r.at(0).at("cnt");
-        std::from_chars(s.data(), s.data() + s.size(), value);
-        co_return value;
+        Database_result r = co_await _db->query_prepared_statement(_get_users_cnt_on_server_stmt,guild_id);
+        if (r.is_null(0, "cnt")) {
+            co_return 0;
+        }
+        co_return r.get_uint64(0, "cnt");
     }
 
     Module_ptr create() {
@@ -51,7 +51,11 @@ namespace gb {
         //always ordered
         virtual  Task<std::vector<Gamescoin_transaction>> get_user_transactions_between (const dpp::snowflake& user_id, uint64_t t_start, uint64_t t_end, uint32_t limit = std::numeric_limits<uint32_t>::max()) = 0;
 
+        //applied immediately, flushed to database in background, throws std::runtime_error if balance would become negative
         virtual Task<void> execute_transaction(const dpp::snowflake& user_id, GAMESCOIN_TRANSACTION_TYPE type, int32_t amount) = 0;
+
+        //must be called after user's balance was changed in database bypassing this module
+        virtual void invalidate_user_balance(const dpp::snowflake& user_id) = 0;
     };
 
 typedef std::shared_ptr<Gamescoin_manager> Gamescoin_manager_ptr;
@@ -4,10 +4,72 @@
 
 #include "gamescoin_manager_impl.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
 #include <ranges>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace gb {
 
+    /**
+     * @brief Formats transaction record of journal.
+     */
+    static std::string journal_record(uint64_t seq, uint64_t user_id, int32_t amount, GAMESCOIN_TRANSACTION_TYPE type,
+                                      uint64_t timestamp) {
+        return std::format("T {} {} {} {} {}\n", seq, user_id, amount, to_string(type), timestamp);
+    }
+
+    /**
+     * @brief Writes whole data to file.
+     *
+     * @throws std::runtime_error If writing fails.
+     */
+    static void write_all(int fd, std::string_view data, const std::string &path) {
+        while (!data.empty()) {
+            ssize_t written = ::write(fd, data.data(), data.size());
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Gamescoin error: failed to write " + path + ": " + std::strerror(errno));
+            }
+            data.remove_prefix(static_cast<size_t>(written));
+        }
+    }
+
+    /**
+     * @brief Writes whole data to file and syncs it to disk.
+     *
+     * @throws std::runtime_error If writing or syncing fails.
+     */
+    static void write_synced(int fd, std::string_view data, const std::string &path) {
+        write_all(fd, data, path);
+        if (::fsync(fd) != 0) {
+            throw std::runtime_error("Gamescoin error: failed to sync " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    /**
+     * @brief Opens file for appending.
+     *
+     * @throws std::runtime_error If the file can not be opened.
+     */
+    static int open_append(const std::string &path, int extra_flags = 0) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | extra_flags, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Gamescoin error: failed to open " + path + ": " + std::strerror(errno));
+        }
+        return fd;
+    }
+
     Gamescoin_transaction Gamescoin_manager_impl::db_return_to_transaction(Database_return_record_t &data) {
         return {static_cast<int32_t>(std::stol(data["amount"])), gamescoin_transaction_type_from_string(data["source"]), std::stoull(data["transaction_time"])};
     }
@@ -20,11 +82,288 @@ namespace gb {
         return {view.begin(), view.end()};
     }
 
-    Gamescoin_manager_impl::Gamescoin_manager_impl() : Gamescoin_manager("gamescoin_manager", {"database"}) {}
+    Gamescoin_manager_impl::Gamescoin_manager_impl() : Gamescoin_manager("gamescoin_manager", {"database", "config", "logging"}) {}
+
+    void Gamescoin_manager_impl::recover_journal(uint64_t applied_seq) {
+        std::map<uint64_t, Ledger_entry> entries;
+        // F records are not synced, the database knows best what it has applied
+        uint64_t flushed_seq = applied_seq;
+        _next_seq = std::max(_next_seq, applied_seq + 1);
+        {
+            std::ifstream in(_journal_path);
+            std::string line;
+            // line without trailing newline was torn by a crash, its transaction was never acknowledged
+            while (std::getline(in, line) && !in.eof()) {
+                std::istringstream ss(line);
+                char kind = 0;
+                ss >> kind;
+                if (kind == 'T') {
+                    Ledger_entry e;
+                    uint64_t user_id;
+                    std::string type;
+                    ss >> e.seq >> user_id >> e.amount >> type >> e.timestamp;
+                    if (!ss) {
+                        throw std::runtime_error("Gamescoin error: malformed journal record: " + line);
+                    }
+                    e.user_id = user_id;
+                    e.type = gamescoin_transaction_type_from_string(type);
+                    entries[e.seq] = e;
+                } else if (kind == 'F') {
+                    uint64_t seq;
+                    ss >> seq;
+                    if (!ss) {
+                        throw std::runtime_error("Gamescoin error: malformed journal record: " + line);
+                    }
+                    flushed_seq = std::max(flushed_seq, seq);
+                }
+            }
+        }
+
+        for (auto &[seq, e]: entries) {
+            _next_seq = std::max(_next_seq, seq + 1);
+            if (seq > flushed_seq) {
+                _queue.push_back(e);
+                _users[e.user_id].pending += e.amount;
+            }
+        }
+
+        // rewrite journal with only unflushed records, rename is atomic so a crash keeps one of the versions
+        std::string tmp_path = _journal_path + ".tmp";
+        std::string records;
+        for (auto &e: _queue) {
+            records += journal_record(e.seq, e.user_id, e.amount, e.type, e.timestamp);
+        }
+        int tmp_fd = open_append(tmp_path, O_TRUNC);
+        try {
+            write_synced(tmp_fd, records, tmp_path);
+        } catch (...) {
+            ::close(tmp_fd);
+            throw;
+        }
+        ::close(tmp_fd);
+        std::filesystem::rename(tmp_path, _journal_path);
+        _journal_fd = open_append(_journal_path);
+        _written_seq = _synced_seq = _next_seq - 1;
+    }
+
+    void Gamescoin_manager_impl::append_journal(std::string_view records) {
+        write_all(_journal_fd, records, _journal_path);
+    }
+
+    bool Gamescoin_manager_impl::add_sync_waiter(uint64_t seq, std::coroutine_handle<> h) {
+        std::unique_lock lk(_mutex);
+        if (seq <= _synced_seq) {
+            return false;
+        }
+        _sync_waiters.push_back({seq, h, Executor::current()});
+        return true;
+    }
+
+    void Gamescoin_manager_impl::sync_journal() {
+        std::unique_lock lk(_mutex);
+        while (true) {
+            _sync_cv.wait(lk, [this]() { return _stop || _synced_seq < _written_seq; });
+            if (_synced_seq == _written_seq) {
+                break;
+            }
+            // records written while syncing are left for the next round
+            uint64_t seq = _written_seq;
+            lk.unlock();
+            bool is_synced = ::fsync(_journal_fd) == 0;
+            int error = errno;
+            lk.lock();
+            if (!is_synced) {
+                // transactions are applied already, only the database flush makes them durable now
+                _log->critical(std::format("Gamescoin: failed to sync {}: {}, transactions up to {} are lost if "
+                                           "the bot stops before flushing them",
+                                           _journal_path, std::strerror(error), seq));
+            }
+            _synced_seq = seq;
+            std::vector<Sync_waiter> ready;
+            std::erase_if(_sync_waiters, [&](const Sync_waiter &w) {
+                if (w.seq > seq) {
+                    return false;
+                }
+                ready.push_back(w);
+                return true;
+            });
+            lk.unlock();
+            for (auto &w: ready) {
+                if (w.executor) {
+                    w.executor->post([h = w.handle]() { h.resume(); });
+                } else {
+                    w.handle.resume();
+                }
+            }
+            lk.lock();
+        }
+    }
+
+    void Gamescoin_manager_impl::dead_letter_head() {
+        Ledger_entry e = _queue.front();
+        int fd = open_append(_dead_letter_path);
+        try {
+            write_synced(fd, journal_record(e.seq, e.user_id, e.amount, e.type, e.timestamp), _dead_letter_path);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+        _queue.pop_front();
+        _head_attempts = 0;
+        // cached balance counted the transaction, the database never will
+        User_balance &u = _users[e.user_id];
+        u.pending -= e.amount;
+        u.is_loaded = false;
+        u.version = ++_version_counter;
+        // synced, a replayed transaction would be applied by the database it was dead-lettered from
+        write_synced(_journal_fd, std::format("F {}\n", e.seq), _journal_path);
+        _log->critical(std::format("Gamescoin: transaction {} of user {} amount {} moved to {} after {} failed "
+                                   "attempts, apply it manually",
+                                   e.seq, static_cast<uint64_t>(e.user_id), e.amount, _dead_letter_path,
+                                   _flush_max_attempts));
+    }
+
+    bool Gamescoin_manager_impl::flush_batch() {
+        std::vector<Ledger_entry> batch;
+        {
+            std::unique_lock lk(_mutex);
+            size_t amount = std::min(_queue.size(), _flush_batch_size);
+            batch.assign(_queue.begin(), _queue.begin() + amount);
+            for (auto &e: batch) {
+                _users[e.user_id].in_flight++;
+            }
+        }
+        if (batch.empty()) {
+            return false;
+        }
+
+        // one by one in journal order, so a failed transaction stops the ones after it
+        size_t flushed = 0;
+        bool is_rejected = false;
+        try {
+            for (auto &e: batch) {
+                sync_wait(_db->execute_prepared_statement(_execute_transaction_stmt, e.seq, e.user_id, e.amount,
+                                                          to_string(e.type)));
+                flushed++;
+            }
+        }
+        catch (...) {
+            std::string what = "unknown error";
+            try {
+                throw;
+            } catch (const std::exception &ex) {
+                what = ex.what();
+            } catch (...) {
+            }
+            const Ledger_entry &e = batch[flushed];
+            _log->error(std::format("Gamescoin: failed to flush transaction {} of user {}: {}", e.seq,
+                                    static_cast<uint64_t>(e.user_id), what));
+            // only failures while the database answers count, an outage must not dead-letter transactions
+            try {
+                sync_wait(_db->execute("SELECT 1;"));
+                is_rejected = true;
+            } catch (...) {
+            }
+        }
+
+        std::unique_lock lk(_mutex);
+        for (size_t i = 0; i < batch.size(); i++) {
+            User_balance &u = _users[batch[i].user_id];
+            u.in_flight--;
+            if (i < flushed) {
+                u.pending -= batch[i].amount;
+                u.version = ++_version_counter;
+                _queue.pop_front();
+            }
+        }
+        if (flushed) {
+            _head_attempts = 0;
+        }
+        try {
+            if (is_rejected && ++_head_attempts >= _flush_max_attempts) {
+                dead_letter_head();
+            }
+            if (_queue.empty()) {
+                // everything is in database, start journal over
+                if (::ftruncate(_journal_fd, 0) != 0) {
+                    _log->error("Gamescoin: failed to truncate journal " + _journal_path + ": " + std::strerror(errno));
+                }
+            } else if (flushed) {
+                append_journal(std::format("F {}\n", batch[flushed - 1].seq));
+            }
+        } catch (const std::exception &ex) {
+            // a missing F record only makes the next start replay transactions the database skips
+            _log->error(std::string("Gamescoin: ") + ex.what());
+        }
+        return flushed == batch.size() && !_queue.empty();
+    }
+
+    uint64_t Gamescoin_manager_impl::read_version(const dpp::snowflake &user_id) {
+        auto it = _users.find(user_id);
+        if (it == _users.end()) {
+            if (_users.size() >= _cache_max_users) {
+                std::erase_if(_users, [](const auto &i) { return !i.second.pending && !i.second.in_flight; });
+            }
+            it = _users.emplace(user_id, User_balance{}).first;
+            it->second.version = ++_version_counter;
+        }
+        return (it->second.version << 1) | (it->second.in_flight ? 1 : 0);
+    }
 
-    void Gamescoin_manager_impl::run() {}
+    std::vector<Gamescoin_transaction> Gamescoin_manager_impl::get_pending_transactions(const dpp::snowflake &user_id) {
+        std::vector<Gamescoin_transaction> r;
+        for (auto &e: std::views::reverse(_queue)) {
+            if (e.user_id == user_id) {
+                r.push_back({e.amount, e.type, e.timestamp});
+            }
+        }
+        return r;
+    }
+
+    void Gamescoin_manager_impl::run() {
+        _journal_path = _config->get_value_or("gamescoin_journal_path", "gamescoin.journal");
+        _dead_letter_path = _config->get_value_or("gamescoin_dead_letter_path", _journal_path + ".dead");
+        _flush_max_attempts = std::stoull(_config->get_value_or("gamescoin_flush_max_attempts", "5"));
+        _flush_period = std::chrono::milliseconds(std::stoll(_config->get_value_or("gamescoin_flush_period_ms", "1000")));
+        _flush_batch_size = std::stoull(_config->get_value_or("gamescoin_flush_batch_size", "256"));
+        _cache_max_users = std::stoull(_config->get_value_or("gamescoin_cache_users", "100000"));
+        Database_return_t applied =
+            sync_wait(_db->execute("SELECT `last_seq` FROM `gamescoin_journal_state` WHERE `id` = 1;"));
+        {
+            std::unique_lock lk(_mutex);
+            _stop = false;
+            recover_journal(applied.empty() ? 0 : std::stoull(applied[0]["last_seq"]));
+        }
+        _sync_worker = std::thread([this]() { sync_journal(); });
+        _flush_worker = std::thread([this]() {
+            std::unique_lock lk(_mutex);
+            while (true) {
+                _cv.wait_for(lk, _flush_period, [this]() { return _stop || _queue.size() >= _flush_batch_size; });
+                bool stopping = _stop;
+                lk.unlock();
+                while (flush_batch()) {
+                }
+                lk.lock();
+                if (stopping) {
+                    break;
+                }
+            }
+        });
+    }
 
     void Gamescoin_manager_impl::stop() {
+        {
+            std::unique_lock lk(_mutex);
+            _stop = true;
+            _cv.notify_all();
+            _sync_cv.notify_all();
+        }
+        // worker flushes what it can before exiting, the rest is replayed from journal on next start
+        _flush_worker.join();
+        _sync_worker.join();
+        ::close(_journal_fd);
+        _journal_fd = -1;
         _db->remove_prepared_statement(_get_user_balance_stmt);
         _db->remove_prepared_statement(_get_user_last_transaction_stmt);
         _db->remove_prepared_statement(_get_user_transactions_between_stmt);
@@ -33,7 +372,37 @@ namespace gb {
 
     void Gamescoin_manager_impl::init(const Modules &modules) {
         _db = std::static_pointer_cast<Database>(modules.at("database"));
-        _execute_transaction_stmt = _db->create_prepared_statement("CALL gamescoin_transaction(?,?,?);");
+        _config = std::static_pointer_cast<Config>(modules.at("config"));
+        _log = std::static_pointer_cast<Logging>(modules.at("logging"));
+        // last applied journal record is stored in the same database transaction as the one it applies
+        sync_wait(_db->execute(R"XXX(
+        CREATE TABLE IF NOT EXISTS `gamescoin_journal_state` (
+            `id` TINYINT UNSIGNED NOT NULL PRIMARY KEY,
+            `last_seq` BIGINT UNSIGNED NOT NULL
+        );
+        )XXX"));
+        sync_wait(_db->execute("INSERT IGNORE INTO `gamescoin_journal_state` (`id`, `last_seq`) VALUES (1, 0);"));
+        sync_wait(_db->execute("DROP PROCEDURE IF EXISTS `gamescoin_journal_transaction`;"));
+        sync_wait(_db->execute(R"XXX(
+        CREATE PROCEDURE `gamescoin_journal_transaction`(IN p_seq BIGINT UNSIGNED, IN p_user_id BIGINT UNSIGNED,
+                                                         IN p_amount INT, IN p_source VARCHAR(64))
+        BEGIN
+            DECLARE v_last_seq BIGINT UNSIGNED;
+            DECLARE EXIT HANDLER FOR SQLEXCEPTION
+            BEGIN
+                ROLLBACK;
+                RESIGNAL;
+            END;
+            START TRANSACTION;
+            SELECT `last_seq` INTO v_last_seq FROM `gamescoin_journal_state` WHERE `id` = 1 FOR UPDATE;
+            IF p_seq > v_last_seq THEN
+                CALL gamescoin_transaction(p_user_id, p_amount, p_source);
+                UPDATE `gamescoin_journal_state` SET `last_seq` = p_seq WHERE `id` = 1;
+            END IF;
+            COMMIT;
+        END
+        )XXX"));
+        _execute_transaction_stmt = _db->create_prepared_statement("CALL gamescoin_journal_transaction(?,?,?,?);");
         _get_user_balance_stmt =
             _db->create_prepared_statement("SELECT balance from gamescoin_balances where user_id=?;");
         _get_user_last_transaction_stmt =
@@ -42,31 +411,136 @@ namespace gb {
         _get_user_transactions_between_stmt = _db->create_prepared_statement("select amount,`source`,transaction_time from gamescoin_transactions where user_id = ? and transaction_time >= ? and transaction_time <= ? Order by transaction_time ASC LIMIT ?;");
     }
 
-    Task<uint32_t> Gamescoin_manager_impl::get_user_balance(const dpp::snowflake &user_id) {
-        Database_return_t r = co_await _db->execute_prepared_statement(_get_user_balance_stmt, user_id);
-        if (r.empty()) {
-            co_return 0;
+    Task<int64_t> Gamescoin_manager_impl::load_user_balance(const dpp::snowflake &user_id) {
+        while (true) {
+            uint64_t version;
+            {
+                std::unique_lock lk(_mutex);
+                version = read_version(user_id);
+                User_balance &u = _users[user_id];
+                if (u.is_loaded) {
+                    co_return u.balance;
+                }
+            }
+            Database_return_t r = co_await _db->execute_prepared_statement(_get_user_balance_stmt, user_id);
+            int64_t db_balance = r.empty() ? 0 : std::stoll(r[0]["balance"]);
+            std::unique_lock lk(_mutex);
+            // database balance matches pending only if no flush or invalidation of the user ran meanwhile
+            if (!(version & 1) && version == read_version(user_id)) {
+                User_balance &u = _users[user_id];
+                if (!u.is_loaded) {
+                    u.balance = db_balance + u.pending;
+                    u.is_loaded = true;
+                }
+                co_return u.balance;
+            }
         }
-        co_return static_cast<uint32_t>(std::stoul(r[0]["balance"]));
+    }
+
+    Task<uint32_t> Gamescoin_manager_impl::get_user_balance(const dpp::snowflake &user_id) {
+        int64_t balance = co_await load_user_balance(user_id);
+        co_return static_cast<uint32_t>(std::max<int64_t>(balance, 0));
     };
 
     Task<std::vector<Gamescoin_transaction>>
     Gamescoin_manager_impl::get_user_last_transactions(const dpp::snowflake &user_id, uint32_t amount, uint32_t offset) {
-        auto r = co_await _db->execute_prepared_statement(_get_user_last_transaction_stmt, user_id, amount, offset);
-        co_return db_records_to_transactions(r);
+        while (true) {
+            uint64_t version;
+            std::vector<Gamescoin_transaction> pending;
+            {
+                std::unique_lock lk(_mutex);
+                version = read_version(user_id);
+                pending = get_pending_transactions(user_id);
+            }
+            // unflushed transactions are newer than any stored one
+            std::vector<Gamescoin_transaction> result;
+            for (size_t i = offset; i < pending.size() && result.size() < amount; i++) {
+                result.push_back(pending[i]);
+            }
+            if (result.size() == amount) {
+                co_return result;
+            }
+            uint32_t db_offset = offset > pending.size() ? offset - static_cast<uint32_t>(pending.size()) : 0;
+            auto r = co_await _db->execute_prepared_statement(_get_user_last_transaction_stmt, user_id,
+                                                              amount - static_cast<uint32_t>(result.size()), db_offset);
+            std::unique_lock lk(_mutex);
+            if (!(version & 1) && version == read_version(user_id)) {
+                auto stored = db_records_to_transactions(r);
+                result.insert(result.end(), stored.begin(), stored.end());
+                co_return result;
+            }
+        }
     }
 
     Task<std::vector<Gamescoin_transaction>>
     Gamescoin_manager_impl::get_user_transactions_between(const dpp::snowflake &user_id, uint64_t t_start,
                                                           uint64_t t_end, uint32_t limit) {
-        auto r = co_await _db->execute_prepared_statement(_get_user_transactions_between_stmt,user_id,t_start,t_end,limit);
-        co_return db_records_to_transactions(r);
+        while (true) {
+            uint64_t version;
+            std::vector<Gamescoin_transaction> pending;
+            {
+                std::unique_lock lk(_mutex);
+                version = read_version(user_id);
+                pending = get_pending_transactions(user_id);
+            }
+            auto r = co_await _db->execute_prepared_statement(_get_user_transactions_between_stmt,user_id,t_start,t_end,limit);
+            std::unique_lock lk(_mutex);
+            if (!(version & 1) && version == read_version(user_id)) {
+                std::vector<Gamescoin_transaction> result = db_records_to_transactions(r);
+                for (auto &i: std::views::reverse(pending)) {
+                    if (result.size() >= limit) {
+                        break;
+                    }
+                    if (i.timestamp >= t_start && i.timestamp <= t_end) {
+                        result.push_back(i);
+                    }
+                }
+                co_return result;
+            }
+        }
     }
 
     Task<void> Gamescoin_manager_impl::execute_transaction(const dpp::snowflake &user_id,
                                                            GAMESCOIN_TRANSACTION_TYPE type, int32_t amount) {
-        co_await _db->execute_prepared_statement(_execute_transaction_stmt, user_id, amount,to_string(type));
-        co_return;
+        uint64_t seq;
+        while (true) {
+            co_await load_user_balance(user_id);
+            std::unique_lock lk(_mutex);
+            User_balance &u = _users[user_id];
+            // invalidated or swept after loading
+            if (!u.is_loaded) {
+                continue;
+            }
+            if (u.balance + amount < 0) {
+                throw std::runtime_error("Gamescoin error: insufficient balance");
+            }
+            uint64_t timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count();
+            append_journal(journal_record(_next_seq, user_id, amount, type, timestamp));
+            seq = _next_seq++;
+            _written_seq = seq;
+            _sync_cv.notify_one();
+            u.balance += amount;
+            u.pending += amount;
+            _queue.push_back({seq, user_id, amount, type, timestamp});
+            if (_queue.size() >= _flush_batch_size) {
+                _cv.notify_all();
+            }
+            break;
+        }
+        // transaction is acknowledged only once its record is on disk, one sync covers records written meanwhile
+        co_await Sync_awaiter{this, seq};
+    }
+
+    void Gamescoin_manager_impl::invalidate_user_balance(const dpp::snowflake &user_id) {
+        std::unique_lock lk(_mutex);
+        auto it = _users.find(user_id);
+        if (it == _users.end()) {
+            return;
+        }
+        it->second.is_loaded = false;
+        it->second.version = ++_version_counter;
     }
 
 
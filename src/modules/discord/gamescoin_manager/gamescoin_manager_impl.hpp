@@ -4,21 +4,172 @@
 
 #pragma once
 #include "gamescoin_manager.hpp"
+#include "src/modules/config/config.hpp"
+#include "src/modules/logging/logging.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace gb {
+    /**
+     * @class Gamescoin_manager_impl
+     * @brief Write-behind ledger of gamescoin balances.
+     *
+     * Transactions are applied to in-memory balances and appended to a local journal, then flushed to the
+     * database in order by a background worker, so callers never wait for the stored procedure. Journal is
+     * synced by its own worker, one fsync acknowledges every transaction written meanwhile. Unflushed journal
+     * records are replayed on startup, the database stores the last applied sequence number together with each
+     * transaction, so replaying one it already has changes nothing. A transaction the database keeps rejecting
+     * is moved to the dead-letter file after a few attempts, so it does not hold back the ones after it.
+     */
     class Gamescoin_manager_impl : public Gamescoin_manager {
+        /**
+         * @brief Transaction applied in memory but not yet confirmed by the database.
+         */
+        struct Ledger_entry {
+            uint64_t seq;                    ///< Journal sequence number, flushed in increasing order.
+            dpp::snowflake user_id;          ///< User the transaction belongs to.
+            int32_t amount;                  ///< Credited (positive) or debited (negative) amount.
+            GAMESCOIN_TRANSACTION_TYPE type; ///< Source of the transaction.
+            uint64_t timestamp;              ///< Unix time of the transaction.
+        };
+
+        /**
+         * @brief Cached balance of a user.
+         */
+        struct User_balance {
+            int64_t balance = 0;    ///< Database balance plus pending, valid only if is_loaded.
+            int64_t pending = 0;    ///< Sum of queued amounts not yet confirmed by the database.
+            size_t in_flight = 0;   ///< Amount of user's transactions in the batch being flushed.
+            uint64_t version = 0;   ///< Changed whenever user's database rows change under the cache.
+            bool is_loaded = false; ///< Balance was read from the database.
+        };
+
+        /**
+         * @brief Coroutine waiting for its journal record to be synced.
+         */
+        struct Sync_waiter {
+            uint64_t seq;                   ///< Sequence number of the awaited record.
+            std::coroutine_handle<> handle; ///< Suspended coroutine.
+            Executor *executor;             ///< Executor to resume coroutine on, nullptr to resume inline.
+        };
+
+        /**
+         * @brief Awaitable resuming once journal is synced up to the record.
+         */
+        struct Sync_awaiter {
+            Gamescoin_manager_impl *manager; ///< Manager whose journal is awaited.
+            uint64_t seq;                    ///< Sequence number of the awaited record.
+
+            bool await_ready() { return false; }
+            bool await_suspend(std::coroutine_handle<> h) { return manager->add_sync_waiter(seq, h); }
+            void await_resume() {}
+        };
 
         Database_ptr _db;
+        Config_ptr _config;
+        Logging_ptr _log;
 
         Prepared_statement _get_user_balance_stmt;
         Prepared_statement _get_user_last_transaction_stmt;
         Prepared_statement _get_user_transactions_between_stmt;
         Prepared_statement _execute_transaction_stmt;
 
+        std::mutex _mutex;                                     ///< Protects all members below.
+        std::condition_variable _cv;                           ///< Wakes the flush worker.
+        std::condition_variable _sync_cv;                      ///< Wakes the journal sync worker.
+        std::unordered_map<dpp::snowflake, User_balance> _users; ///< Cached balances.
+        std::deque<Ledger_entry> _queue;                       ///< Unflushed transactions in journal order.
+        int _journal_fd = -1;                                  ///< Append-only journal, synced before acknowledging.
+        uint64_t _written_seq = 0;                             ///< Last transaction written to journal.
+        uint64_t _synced_seq = 0;                              ///< Last transaction synced to disk.
+        std::vector<Sync_waiter> _sync_waiters;                ///< Transactions waiting for journal sync.
+        std::string _journal_path;                             ///< Journal file path.
+        std::string _dead_letter_path;                         ///< File of transactions the database rejected.
+        size_t _head_attempts = 0;                             ///< Failed attempts to flush head of the queue.
+        uint64_t _next_seq = 1;                                ///< Sequence number of next transaction.
+        uint64_t _version_counter = 0;                         ///< Source of User_balance versions, never reused.
+        bool _stop = false;                                    ///< Flag to signal the workers to stop.
+        std::thread _flush_worker;                             ///< Flushes queued transactions to the database.
+        std::thread _sync_worker;                              ///< Syncs journal for waiting transactions.
+
+        std::chrono::milliseconds _flush_period{1000}; ///< Maximal time transaction waits for flush.
+        size_t _flush_batch_size = 256;                ///< Transactions flushed per batch.
+        size_t _flush_max_attempts = 5;                ///< Failed attempts before transaction is dead-lettered.
+        size_t _cache_max_users = 100000;              ///< Amount of cached users after which flushed ones are swept.
 
         Gamescoin_transaction db_return_to_transaction(Database_return_record_t& data);
         std::vector<Gamescoin_transaction> db_records_to_transactions(Database_return_t& data);
 
+        /**
+         * @brief Reads unflushed transactions from journal and rewrites it with only them.
+         *
+         * @param applied_seq Last transaction the database has applied, older records are dropped.
+         */
+        void recover_journal(uint64_t applied_seq);
+
+        /**
+         * @brief Appends records to journal without syncing it. Requires _mutex.
+         *
+         * @throws std::runtime_error If the journal can not be written.
+         */
+        void append_journal(std::string_view records);
+
+        /**
+         * @brief Registers coroutine to be resumed once journal is synced up to seq.
+         *
+         * @return False if the record is already synced and the coroutine must not suspend.
+         */
+        bool add_sync_waiter(uint64_t seq, std::coroutine_handle<> h);
+
+        /**
+         * @brief Syncs journal whenever transactions are written to it and resumes their waiters.
+         */
+        void sync_journal();
+
+        /**
+         * @brief Moves head of the queue to the dead-letter file and drops its effect on cached balance.
+         *
+         * Requires _mutex.
+         */
+        void dead_letter_head();
+
+        /**
+         * @brief Flushes one batch of queued transactions to the database.
+         *
+         * @return True if whole batch was flushed and more transactions are queued.
+         */
+        bool flush_batch();
+
+        /**
+         * @brief Reads user's balance from the database unless it is cached.
+         *
+         * @param user_id User to load.
+         * @return Cached balance.
+         */
+        Task<int64_t> load_user_balance(const dpp::snowflake &user_id);
+
+        /**
+         * @brief Gets version of user's database rows, adding the user to cache. Requires _mutex.
+         *
+         * A database read of the user is consistent with pending transactions if the version was even
+         * before the read and did not change after it.
+         *
+         * @return Version, odd while user's transactions are being flushed.
+         */
+        uint64_t read_version(const dpp::snowflake &user_id);
+
+        /**
+         * @brief Gets user's unflushed transactions, newest first. Requires _mutex.
+         */
+        std::vector<Gamescoin_transaction> get_pending_transactions(const dpp::snowflake &user_id);
+
     public:
         Gamescoin_manager_impl();
 
@@ -40,6 +191,8 @@ namespace gb {
                                       uint32_t limit = std::numeric_limits<uint32_t>::max()) override;
 
         Task<void> execute_transaction(const dpp::snowflake& user_id, GAMESCOIN_TRANSACTION_TYPE type, int32_t amount) override;
+
+        void invalidate_user_balance(const dpp::snowflake &user_id) override;
     };
 
     extern "C" Module_ptr create();
@@ -115,6 +115,19 @@ namespace gb {
          */
         virtual Task<PREMIUM_STATUS> get_users_premium_status(const dpp::snowflake& user_id) = 0;
 
+        /**
+         * Drops cached premium status of a user, call it after changing premium of the user in database.
+         *
+         * @param user_id The Discord user ID (snowflake) of the user.
+         */
+        virtual void invalidate_premium_status(const dpp::snowflake& user_id) = 0;
+
+        /**
+         * Drops all cached premium statuses and reschedules expiry, call it after changes which may move
+         * subscriptions between users.
+         */
+        virtual void invalidate_premium_statuses() = 0;
+
         /**
          *
          * @return A url to buy subscription.
@@ -4,27 +4,64 @@
 
 #include "premium_manager_impl.hpp"
 
+#include <algorithm>
+
 namespace gb {
-    Premium_manager_impl::Premium_manager_impl() : Premium_manager("premium_manager", {"database"}) {}
+    Premium_manager_impl::Premium_manager_impl() : Premium_manager("premium_manager", {"database", "config"}) {}
 
     void Premium_manager_impl::init(const Modules &modules) {
         _db = std::static_pointer_cast<Database>(modules.at("database"));
+        _config = std::static_pointer_cast<Config>(modules.at("config"));
         _remove_all_expired_subscriptions_stmt = _db->create_prepared_statement(
             "UPDATE `premium` SET status='ENDED' where `end_time` IS NOT NULL AND `end_time` < UTC_TIMESTAMP()");
+        // subscriptions past end_time are treated as ended even before the background worker marks them,
+        // prepared statements return NULL as empty string, so NULL end_time is reported by a flag column
         _get_user_premium_status_stmt = _db->create_prepared_statement(
-            "SELECT `type` from `premium` where `status`='ACTIVE' and `user_id`=? order by `type` desc limit 1;");
+            "SELECT `type`, `end_time` IS NULL AS `is_unlimited`, "
+            "COALESCE(TIMESTAMPDIFF(SECOND, UTC_TIMESTAMP(), `end_time`), 0) AS `seconds_left` from `premium` "
+            "where `status`='ACTIVE' and `user_id`=? and (`end_time` IS NULL OR `end_time` > UTC_TIMESTAMP()) "
+            "order by `type` desc limit 1;");
+        _get_next_expiry_stmt = _db->create_prepared_statement(
+            "SELECT COUNT(*) AS `expiring`, "
+            "COALESCE(TIMESTAMPDIFF(SECOND, UTC_TIMESTAMP(), MIN(`end_time`)), 0) AS `seconds_left` from `premium` "
+            "where `status`='ACTIVE' and `end_time` IS NOT NULL;");
+    }
+
+    std::chrono::seconds Premium_manager_impl::get_time_to_next_expiry() {
+        constexpr std::chrono::seconds max_sleep = std::chrono::hours(1);
+        // runs on the background worker, so nothing may escape
+        try {
+            Database_return_t r = sync_wait(_db->execute_prepared_statement(_get_next_expiry_stmt));
+            if (r.empty() || std::stoll(r.at(0).at("expiring")) == 0) {
+                return max_sleep;
+            }
+            // one second past end_time, so the UPDATE sees the subscription as expired
+            return std::clamp(std::chrono::seconds(std::stoll(r.at(0).at("seconds_left")) + 1),
+                              std::chrono::seconds(1), max_sleep);
+        }
+        catch (...) {
+            // retry soon, the expiry UPDATE still runs on timeout
+            return std::chrono::seconds(60);
+        }
     }
 
     void Premium_manager_impl::run() {
+        _cache_ttl = std::chrono::seconds(std::stoll(_config->get_value_or("premium_cache_ttl_s", "300")));
+        _cache_max_size = std::stoull(_config->get_value_or("premium_cache_max_users", "100000"));
         _background_worker = std::thread{[this]() {
             while (1) {
+                std::chrono::seconds sleep_time = get_time_to_next_expiry();
                 std::unique_lock lk(_mutex);
-                // Wait for either _stop == true or a 60-second timeout
-                bool result = _cv.wait_for(lk, std::chrono::seconds(60), [this]() { return _stop; });
+                // Wait for _stop, subscriptions change or the next subscription end
+                bool result = _cv.wait_for(lk, sleep_time, [this]() { return _stop || _reschedule; });
 
-                if (result) {
+                if (_stop) {
                     break;
                 }
+                if (result) {
+                    _reschedule = false;
+                    continue;
+                }
                 _db->background_execute_prepared_statement(_remove_all_expired_subscriptions_stmt);
             }
             return;
@@ -40,14 +77,67 @@ namespace gb {
         _background_worker.join();
         _db->remove_prepared_statement(_remove_all_expired_subscriptions_stmt);
         _db->remove_prepared_statement(_get_user_premium_status_stmt);
+        _db->remove_prepared_statement(_get_next_expiry_stmt);
+    }
+
+    void Premium_manager_impl::cache_put(const dpp::snowflake &user_id, PREMIUM_STATUS status,
+                                         std::chrono::steady_clock::time_point valid_until, uint64_t generation) {
+        std::unique_lock lk(_cache_mutex);
+        if (_cache_generation != generation) {
+            return;
+        }
+        if (_cache.size() >= _cache_max_size) {
+            auto now = std::chrono::steady_clock::now();
+            std::erase_if(_cache, [now](const auto &i) { return i.second.valid_until <= now; });
+            if (_cache.size() >= _cache_max_size) {
+                _cache.clear();
+            }
+        }
+        _cache[user_id] = {status, valid_until};
     }
 
     Task<PREMIUM_STATUS> Premium_manager_impl::get_users_premium_status(const dpp::snowflake &user_id) {
+        {
+            std::unique_lock lk(_cache_mutex);
+            auto it = _cache.find(user_id);
+            if (it != _cache.end()) {
+                if (it->second.valid_until > std::chrono::steady_clock::now()) {
+                    co_return it->second.status;
+                }
+                _cache.erase(it);
+            }
+        }
+        uint64_t generation = _cache_generation;
+        auto now = std::chrono::steady_clock::now();
         Database_return_t r = co_await _db->execute_prepared_statement(_get_user_premium_status_stmt, user_id);
         if (r.empty()) {
+            cache_put(user_id, PREMIUM_STATUS::NO_SUBSCRIPTION, now + _cache_ttl, generation);
             co_return PREMIUM_STATUS::NO_SUBSCRIPTION;
         }
-        co_return premium_status_from_string(r.at(0).at("type"));
+        PREMIUM_STATUS status = premium_status_from_string(r.at(0).at("type"));
+        auto valid_until = now + _cache_ttl;
+        if (std::stoll(r.at(0).at("is_unlimited")) == 0) {
+            valid_until = std::min(valid_until, now + std::chrono::seconds(std::stoll(r.at(0).at("seconds_left"))));
+        }
+        cache_put(user_id, status, valid_until, generation);
+        co_return status;
+    }
+
+    void Premium_manager_impl::invalidate_premium_status(const dpp::snowflake &user_id) {
+        std::unique_lock lk(_cache_mutex);
+        _cache_generation++;
+        _cache.erase(user_id);
+    }
+
+    void Premium_manager_impl::invalidate_premium_statuses() {
+        {
+            std::unique_lock lk(_cache_mutex);
+            _cache_generation++;
+            _cache.clear();
+        }
+        std::unique_lock lk(_mutex);
+        _reschedule = true;
+        _cv.notify_all();
     }
 
     std::string Premium_manager_impl::get_premium_buy_url() {
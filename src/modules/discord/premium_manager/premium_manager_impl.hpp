@@ -3,11 +3,15 @@
 //
 
 #pragma once
+#include <src/modules/config/config.hpp>
 #include <src/modules/database/database.hpp>
 #include "./premium_manager.hpp"
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <condition_variable>
 #include <mutex>
+#include <unordered_map>
 
 namespace gb {
 
@@ -19,14 +23,49 @@ namespace gb {
      * with the database to update subscription information.
      */
     class Premium_manager_impl : public Premium_manager {
+        /**
+         * Cached premium status of a user.
+         */
+        struct Cached_status {
+            PREMIUM_STATUS status;                             ///< Premium status of the user.
+            std::chrono::steady_clock::time_point valid_until; ///< TTL or end of the subscription, whichever is first.
+        };
+
         Database_ptr _db;                           ///< Pointer to the database module used for managing premium subscription data.
+        Config_ptr _config;                         ///< Pointer to the config module.
         std::thread _background_worker;             ///< Background worker thread responsible for running periodic tasks.
         std::condition_variable _cv;                ///< Condition variable to manage background worker sleep and stop behavior.
         std::mutex _mutex;                          ///< Mutex to synchronize access to shared data between threads.
         bool _stop = false;                         ///< Flag to signal the background worker to stop.
+        bool _reschedule = false;                   ///< Subscriptions changed, background worker should recompute next expiry.
 
         Prepared_statement _remove_all_expired_subscriptions_stmt; ///< Prepared statement for removing expired premium subscriptions.
         Prepared_statement _get_user_premium_status_stmt;          ///< Prepared statement for retrieving a user's premium status.
+        Prepared_statement _get_next_expiry_stmt;                  ///< Prepared statement for retrieving seconds until next subscription ends.
+
+        std::mutex _cache_mutex;                                  ///< Protects _cache.
+        std::unordered_map<dpp::snowflake, Cached_status> _cache; ///< Cached premium statuses by user.
+        std::atomic_uint64_t _cache_generation = 0;               ///< Bumped on invalidation, loads started before are not cached.
+        std::chrono::seconds _cache_ttl{300};                     ///< Maximal time status is cached.
+        size_t _cache_max_size = 100000;                          ///< Amount of cached users after which expired entries are swept.
+
+        /**
+         * Stores loaded status unless cache was invalidated since the load started.
+         *
+         * @param user_id The Discord user ID (snowflake) of the user.
+         * @param status Loaded premium status.
+         * @param valid_until Time the status stops being valid.
+         * @param generation Value of _cache_generation when the load started.
+         */
+        void cache_put(const dpp::snowflake& user_id, PREMIUM_STATUS status,
+                       std::chrono::steady_clock::time_point valid_until, uint64_t generation);
+
+        /**
+         * Gets time until the next active subscription ends, capped to one hour.
+         *
+         * @return Time to sleep before next expiry run.
+         */
+        std::chrono::seconds get_time_to_next_expiry();
 
     public:
         /**
@@ -49,7 +88,7 @@ namespace gb {
         void init(const Modules &modules) override;
 
         /**
-         * Starts the background worker that periodically checks and updates premium subscriptions.
+         * Starts the background worker that marks subscriptions ended, waking when the next one ends.
          */
         void run() override;
 
@@ -68,11 +107,25 @@ namespace gb {
         /**
          * Retrieves the premium status of a specific user.
          *
+         * Answered from memory while cached, a cache miss runs one query.
+         *
          * @param user_id The Discord user ID (snowflake) of the user whose premium status is being queried.
          * @return A Task that resolves to the user's current PREMIUM_STATUS.
          */
         Task<PREMIUM_STATUS> get_users_premium_status(const dpp::snowflake& user_id) override;
 
+        /**
+         * Drops cached premium status of a user.
+         *
+         * @param user_id The Discord user ID (snowflake) of the user.
+         */
+        void invalidate_premium_status(const dpp::snowflake& user_id) override;
+
+        /**
+         * Drops all cached premium statuses and wakes the background worker to reschedule expiry.
+         */
+        void invalidate_premium_statuses() override;
+
     };
 
     /**
@@ -222,6 +222,16 @@ namespace gb {
      */
     class Image;
 
+    /**
+     * @brief File formats an image can be encoded to.
+     */
+    enum class Image_encoding {
+        AUTO, ///< Chosen from image content: PNG for flat or translucent images, JPEG (or WebP) otherwise.
+        JPEG, ///< Lossy, best for detailed images.
+        PNG, ///< Lossless, best for boards made of few flat colors.
+        WEBP ///< Lossy, smaller than JPEG; falls back to JPEG if not supported by OpenCV build.
+    };
+
     /**
      * @brief Defines a shared pointer type for the Image class.
      */
@@ -242,7 +252,7 @@ namespace gb {
          * @brief Converts the image to a string representation.
          *
          * @return std::pair<std::string, std::string> A pair where the first element is
-         *         the file encoding (e.g., ".jpg") and the second element is the actual image data.
+         *         the file encoding (e.g., ".png") and the second element is the actual image data.
          */
         virtual std::pair<std::string, std::string> convert_to_string() = 0;
 
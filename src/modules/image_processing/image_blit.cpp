@@ -0,0 +1,161 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include "image_blit.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GB_BLIT_X86 1
+#endif
+
+namespace gb {
+
+    /**
+     * @brief Rounded x / 255 for x in [0, 255 * 255].
+     */
+    static inline uint32_t div255(uint32_t x) {
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    void premultiply_row(const uint8_t *src, uint8_t *dst, size_t pixels) {
+        for (size_t i = 0; i < pixels; i++, src += 4, dst += 4) {
+            uint32_t a = src[3];
+            dst[0] = static_cast<uint8_t>(div255(src[0] * a));
+            dst[1] = static_cast<uint8_t>(div255(src[1] * a));
+            dst[2] = static_cast<uint8_t>(div255(src[2] * a));
+            dst[3] = static_cast<uint8_t>(a);
+        }
+    }
+
+    namespace detail {
+        void blend_row_scalar(const uint8_t *src, uint8_t *dst, size_t pixels) {
+            for (size_t i = 0; i < pixels; i++, src += 4, dst += 4) {
+                uint32_t inv = 255 - src[3];
+                if (inv == 255) {
+                    continue;
+                }
+                if (dst[3] == 255) {
+                    // opaque destination, result stays opaque and needs no unpremultiplying
+                    for (int c = 0; c < 3; c++) {
+                        dst[c] = static_cast<uint8_t>(src[c] + div255(dst[c] * inv));
+                    }
+                    continue;
+                }
+                uint32_t dst_alpha = dst[3];
+                uint32_t alpha = src[3] + div255(dst_alpha * inv);
+                for (int c = 0; c < 3; c++) {
+                    uint32_t premultiplied = src[c] + div255(div255(dst[c] * dst_alpha) * inv);
+                    dst[c] = static_cast<uint8_t>(std::min<uint32_t>((premultiplied * 255 + alpha / 2) / alpha, 255));
+                }
+                dst[3] = static_cast<uint8_t>(alpha);
+            }
+        }
+
+#if defined(GB_BLIT_X86)
+        /**
+         * @brief dst * (255 - alpha) / 255 for 8 pixels unpacked to 16 bit lanes.
+         */
+        static inline __m128i scale_sse2(__m128i dst, __m128i inv) {
+            __m128i x = _mm_add_epi16(_mm_mullo_epi16(dst, inv), _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+        }
+
+        __attribute__((target("sse2"))) void blend_row_sse2(const uint8_t *src, uint8_t *dst, size_t pixels) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+            size_t i = 0;
+            for (; i + 4 <= pixels; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+                // fully transparent pixels are common around sprites
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alpha_mask), zero)) == 0xFFFF) {
+                    continue;
+                }
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i * 4));
+                // the shortcut below is only right for opaque destination
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(d, alpha_mask), alpha_mask)) != 0xFFFF) {
+                    blend_row_scalar(src + i * 4, dst + i * 4, 4);
+                    continue;
+                }
+                // broadcast alpha of every pixel to its 4 bytes and invert it
+                __m128i a = _mm_srli_epi32(s, 24);
+                a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+                a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+                __m128i inv = _mm_xor_si128(a, _mm_set1_epi8(-1));
+                __m128i lo = scale_sse2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(inv, zero));
+                __m128i hi = scale_sse2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(inv, zero));
+                __m128i r = _mm_adds_epu8(s, _mm_packus_epi16(lo, hi));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), r);
+            }
+            blend_row_scalar(src + i * 4, dst + i * 4, pixels - i);
+        }
+
+        __attribute__((target("avx2"))) static inline __m256i scale_avx2(__m256i dst, __m256i inv) {
+            __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(dst, inv), _mm256_set1_epi16(128));
+            return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+        }
+
+        __attribute__((target("avx2"))) void blend_row_avx2(const uint8_t *src, uint8_t *dst, size_t pixels) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i alpha_mask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+            size_t i = 0;
+            for (; i + 8 <= pixels; i += 8) {
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 4));
+                if (_mm256_testz_si256(s, alpha_mask)) {
+                    continue;
+                }
+                __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i * 4));
+                if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(d, alpha_mask), alpha_mask)) != -1) {
+                    blend_row_scalar(src + i * 4, dst + i * 4, 8);
+                    continue;
+                }
+                __m256i a = _mm256_srli_epi32(s, 24);
+                a = _mm256_or_si256(a, _mm256_slli_epi32(a, 8));
+                a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+                __m256i inv = _mm256_xor_si256(a, _mm256_set1_epi8(-1));
+                // unpack and pack both work within 128 bit lanes, so pixel order is preserved
+                __m256i lo = scale_avx2(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(inv, zero));
+                __m256i hi = scale_avx2(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(inv, zero));
+                __m256i r = _mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), r);
+            }
+            blend_row_sse2(src + i * 4, dst + i * 4, pixels - i);
+        }
+#endif
+
+    } // namespace detail
+
+    void blend_premultiplied_row(const uint8_t *src, uint8_t *dst, size_t pixels) {
+        using Blend_row_t = void (*)(const uint8_t *, uint8_t *, size_t);
+        static const Blend_row_t impl = []() -> Blend_row_t {
+#if defined(GB_BLIT_X86)
+            if (__builtin_cpu_supports("avx2")) {
+                return detail::blend_row_avx2;
+            }
+            if (__builtin_cpu_supports("sse2")) {
+                return detail::blend_row_sse2;
+            }
+#endif
+            return detail::blend_row_scalar;
+        }();
+        impl(src, dst, pixels);
+    }
+
+    void blend_premultiplied_row_bgr(const uint8_t *src, uint8_t *dst, size_t pixels) {
+        for (size_t i = 0; i < pixels; i++, src += 4, dst += 3) {
+            uint32_t inv = 255 - src[3];
+            if (inv == 0) {
+                std::memcpy(dst, src, 3);
+                continue;
+            }
+            for (int c = 0; c < 3; c++) {
+                dst[c] = static_cast<uint8_t>(src[c] + div255(dst[c] * inv));
+            }
+        }
+    }
+
+} // namespace gb
@@ -0,0 +1,62 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gb {
+
+    /**
+     * @brief Converts a row of BGRA pixels to premultiplied alpha.
+     *
+     * @param src Source pixels, 4 bytes each.
+     * @param dst Destination pixels, may be the same as src.
+     * @param pixels Amount of pixels in the row.
+     */
+    void premultiply_row(const uint8_t *src, uint8_t *dst, size_t pixels);
+
+    /**
+     * @brief Composites a row of premultiplied BGRA pixels over straight alpha BGRA pixels ("source over").
+     *
+     * Uses AVX2 or SSE2 for blocks of opaque destination pixels, which is the common case of drawing on a
+     * background; blocks with translucent destination pixels go through the full operator in scalar code.
+     * Results are identical on all paths.
+     *
+     * @param src Premultiplied source pixels, 4 bytes each.
+     * @param dst Straight alpha destination pixels, 4 bytes each, blended in place.
+     * @param pixels Amount of pixels in the row.
+     */
+    void blend_premultiplied_row(const uint8_t *src, uint8_t *dst, size_t pixels);
+
+    /**
+     * @brief Composites a row of premultiplied BGRA pixels over BGR pixels, dropping alpha.
+     *
+     * @param src Premultiplied source pixels, 4 bytes each.
+     * @param dst Destination pixels, 3 bytes each, blended in place.
+     * @param pixels Amount of pixels in the row.
+     */
+    void blend_premultiplied_row_bgr(const uint8_t *src, uint8_t *dst, size_t pixels);
+
+    namespace detail {
+        /**
+         * @brief Scalar path of blend_premultiplied_row, also used for row tails and translucent blocks.
+         */
+        void blend_row_scalar(const uint8_t *src, uint8_t *dst, size_t pixels);
+
+#if defined(__x86_64__) || defined(__i386__)
+        /**
+         * @brief SSE2 path of blend_premultiplied_row, the CPU must support SSE2.
+         */
+        void blend_row_sse2(const uint8_t *src, uint8_t *dst, size_t pixels);
+
+        /**
+         * @brief AVX2 path of blend_premultiplied_row, the CPU must support AVX2.
+         */
+        void blend_row_avx2(const uint8_t *src, uint8_t *dst, size_t pixels);
+#endif
+    } // namespace detail
+
+} // namespace gb
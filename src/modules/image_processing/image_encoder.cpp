@@ -0,0 +1,124 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include "image_encoder.hpp"
+
+#include <array>
+#include <mutex>
+
+namespace gb {
+
+    static std::mutex settings_mutex;
+    static Image_encoder_settings encoder_settings;
+
+    void set_image_encoder_settings(const Image_encoder_settings &settings) {
+        std::unique_lock lk(settings_mutex);
+        encoder_settings = settings;
+    }
+
+    Image_encoder_settings get_image_encoder_settings() {
+        std::unique_lock lk(settings_mutex);
+        return encoder_settings;
+    }
+
+    /**
+     * @brief Result of sampling image pixels.
+     */
+    struct Image_sample {
+        bool is_opaque = true; ///< No sampled pixel has alpha below 255.
+        bool is_flat = true; ///< Sampled pixels have at most flat_colors_limit distinct colors.
+    };
+
+    /**
+     * @brief Samples up to ~4096 pixels on a regular grid to decide encoding.
+     */
+    static Image_sample sample_image(const cv::Mat &image, size_t flat_colors_limit) {
+        Image_sample sample;
+        // open addressing set of seen colors, sized so it never fills above half
+        constexpr size_t set_size = 1024;
+        std::array<uint32_t, set_size> colors;
+        std::array<bool, set_size> used{};
+        size_t colors_amount = 0;
+        flat_colors_limit = std::min(flat_colors_limit, set_size / 2);
+
+        int step_y = std::max(1, image.rows / 64);
+        int step_x = std::max(1, image.cols / 64);
+        for (int y = 0; y < image.rows; y += step_y) {
+            const uint8_t *row = image.ptr<uint8_t>(y);
+            for (int x = 0; x < image.cols; x += step_x) {
+                const uint8_t *p = row + x * 4;
+                if (p[3] != 255) {
+                    sample.is_opaque = false;
+                }
+                if (!sample.is_flat) {
+                    continue;
+                }
+                uint32_t color = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+                size_t slot = (color * 2654435761u) % set_size;
+                while (used[slot] && colors[slot] != color) {
+                    slot = (slot + 1) % set_size;
+                }
+                if (!used[slot]) {
+                    used[slot] = true;
+                    colors[slot] = color;
+                    if (++colors_amount > flat_colors_limit) {
+                        sample.is_flat = false;
+                    }
+                }
+            }
+            if (!sample.is_opaque && !sample.is_flat) {
+                break;
+            }
+        }
+        return sample;
+    }
+
+    std::pair<std::string, std::string> encode_image(const cv::Mat &image, Image_encoding encoding) {
+        static const bool can_write_webp = cv::haveImageWriter(".webp");
+        thread_local std::vector<uchar> buffer;
+        thread_local cv::Mat bgr;
+
+        Image_encoder_settings settings = get_image_encoder_settings();
+        Image_sample sample = image.type() == CV_8UC4 ? sample_image(image, settings.flat_colors_limit)
+                                                      : Image_sample{true, false};
+        if (encoding == Image_encoding::AUTO) {
+            if (!sample.is_opaque || sample.is_flat) {
+                encoding = Image_encoding::PNG;
+            } else {
+                encoding = settings.prefer_webp ? Image_encoding::WEBP : Image_encoding::JPEG;
+            }
+        }
+        if (encoding == Image_encoding::WEBP && !can_write_webp) {
+            encoding = Image_encoding::JPEG;
+        }
+
+        std::string extension;
+        std::vector<int> params;
+        switch (encoding) {
+            case Image_encoding::PNG:
+                extension = ".png";
+                params = {cv::IMWRITE_PNG_COMPRESSION, settings.png_compression};
+                break;
+            case Image_encoding::WEBP:
+                extension = ".webp";
+                params = {cv::IMWRITE_WEBP_QUALITY, settings.webp_quality};
+                break;
+            default:
+                extension = ".jpg";
+                params = {cv::IMWRITE_JPEG_QUALITY, settings.jpeg_quality};
+                break;
+        }
+
+        const cv::Mat *source = &image;
+        // JPEG has no alpha anyway, for others dropping an opaque alpha channel saves a quarter of raw data
+        if (image.type() == CV_8UC4 && (sample.is_opaque || encoding == Image_encoding::JPEG)) {
+            cv::cvtColor(image, bgr, cv::COLOR_BGRA2BGR);
+            source = &bgr;
+        }
+        buffer.clear();
+        cv::imencode(extension, *source, buffer, params);
+        return {extension, std::string(reinterpret_cast<const char *>(buffer.data()), buffer.size())};
+    }
+
+} // namespace gb
@@ -0,0 +1,55 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#pragma once
+
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#include "image.hpp"
+
+namespace gb {
+
+    /**
+     * @brief Encoder parameters shared by all images, set from config by Image_processing_impl.
+     */
+    struct Image_encoder_settings {
+        int jpeg_quality = 90; ///< JPEG quality, 0 to 100.
+        int webp_quality = 90; ///< WebP quality, 1 to 100.
+        int png_compression = 3; ///< PNG zlib compression level, 0 to 9.
+        bool prefer_webp = false; ///< Use WebP instead of JPEG for detailed images when OpenCV can write it.
+        size_t flat_colors_limit = 64; ///< Images with at most this many sampled colors are encoded as PNG.
+    };
+
+    /**
+     * @brief Sets encoder parameters used by all following encode_image calls.
+     *
+     * @param settings New encoder parameters.
+     */
+    void set_image_encoder_settings(const Image_encoder_settings &settings);
+
+    /**
+     * @brief Gets current encoder parameters.
+     *
+     * @return Encoder parameters.
+     */
+    Image_encoder_settings get_image_encoder_settings();
+
+    /**
+     * @brief Encodes BGRA image.
+     *
+     * With Image_encoding::AUTO a sparse pixel sample decides the format: images with translucent pixels or
+     * few distinct colors (flat boards) go lossless PNG, everything else goes JPEG (or WebP if preferred).
+     * Opaque images are encoded without alpha channel. Encoding uses a per-thread output buffer, so the only
+     * allocation is the returned string; OpenCV encodes only into a vector, so one copy into the string remains,
+     * the string is then moved into the message by Discord_game::add_image.
+     *
+     * @param image BGRA image to encode.
+     * @param encoding Requested format.
+     * @return Pair of file extension (e.g. ".png") and encoded data.
+     */
+    std::pair<std::string, std::string> encode_image(const cv::Mat &image, Image_encoding encoding);
+
+} // namespace gb
@@ -3,6 +3,8 @@
 //
 
 #include "image_impl.hpp"
+#include "image_blit.hpp"
+#include "image_encoder.hpp"
 
 #include <iostream>
 
@@ -38,68 +40,114 @@ namespace gb {
     }
 
     std::pair<std::string, std::string> Image_impl::convert_to_string() {
-        std::vector<uchar> buf;
-        cv::imencode(".jpg", _image, buf);
-        std::string s(buf.begin(), buf.end());
-        return {".jpg", s};
+        flush_draws();
+        return encode_image(_image, Image_encoding::AUTO);
     }
 
-    void Image_impl::draw_line(const Vector2i &from, const Vector2i &to, const Color &color, int thickness) {
-        // Create a copy of the image as overlay
-        cv::Mat overlay;
-        _image.copyTo(overlay);
+    void Image_impl::add_draw_command(const cv::Rect &bounds, float alpha,
+                                      std::function<void(cv::Mat &, const cv::Point &)> draw) {
+        cv::Rect clipped = bounds & cv::Rect(0, 0, _image.cols, _image.rows);
+        if (clipped.empty() || alpha <= 0) {
+            // nothing visible would change
+            return;
+        }
+        _pending_draws.push_back({std::move(draw), clipped, alpha});
+    }
 
-        // Draw the line on the overlay
-        cv::line(overlay, vector_to_cv_point(from), vector_to_cv_point(to), color_to_cv_scalar(color), thickness,
-                 cv::LINE_8);
+    void Image_impl::flush_draws() {
+        if (_pending_draws.empty()) {
+            return;
+        }
+        make_writable();
+        _premultiplied.release();
+        // amount of translucent primitives blended together, keeps overlap checks cheap
+        constexpr size_t max_layer_size = 64;
+        size_t i = 0;
+        while (i < _pending_draws.size()) {
+            Draw_command &command = _pending_draws[i];
+            if (command.alpha >= 1) {
+                command.draw(_image, {0, 0});
+                i++;
+                continue;
+            }
+            // primitives blended in one layer must not overlap, otherwise later ones would not blend over earlier
+            cv::Rect layer = command.bounds;
+            size_t layer_end = i + 1;
+            while (layer_end < _pending_draws.size() && layer_end - i < max_layer_size &&
+                   _pending_draws[layer_end].alpha == command.alpha) {
+                const cv::Rect &bounds = _pending_draws[layer_end].bounds;
+                bool overlaps = false;
+                for (size_t k = i; k < layer_end && !overlaps; k++) {
+                    overlaps = !(bounds & _pending_draws[k].bounds).empty();
+                }
+                if (overlaps) {
+                    break;
+                }
+                layer |= bounds;
+                layer_end++;
+            }
+            cv::Mat base = _image(layer);
+            cv::Mat overlay = base.clone();
+            for (size_t k = i; k < layer_end; k++) {
+                _pending_draws[k].draw(overlay, layer.tl());
+            }
+            blend_images(base, overlay, command.alpha);
+            i = layer_end;
+        }
+        _pending_draws.clear();
+    }
 
-        // Blend the overlay with the base image using the alpha value from the color
-        blend_images(_image, overlay, color.a);
+    void Image_impl::draw_line(const Vector2i &from, const Vector2i &to, const Color &color, int thickness) {
+        cv::Point p1 = vector_to_cv_point(from);
+        cv::Point p2 = vector_to_cv_point(to);
+        int margin = std::abs(thickness) + 2;
+        cv::Rect bounds(cv::Point(std::min(p1.x, p2.x) - margin, std::min(p1.y, p2.y) - margin),
+                        cv::Point(std::max(p1.x, p2.x) + margin + 1, std::max(p1.y, p2.y) + margin + 1));
+        add_draw_command(bounds, color.a, [=, scalar = color_to_cv_scalar(color)](cv::Mat &target, const cv::Point &offset) {
+            cv::line(target, p1 - offset, p2 - offset, scalar, thickness, cv::LINE_8);
+        });
     }
 
 
     void Image_impl::draw_text(const std::string &text, const Vector2i &position, double font_scale, const Color &color,
                                int thickness) {
-        // Create a copy of the image as overlay
-        cv::Mat overlay;
-        _image.copyTo(overlay);
-
-        // Draw the text on the overlay
-        cv::putText(overlay, text, vector_to_cv_point(position), cv::FONT_HERSHEY_DUPLEX, font_scale,
-                    color_to_cv_scalar(color), thickness);
-
-        // Blend the overlay with the base image using the alpha value from the color
-        blend_images(_image, overlay, color.a);
+        cv::Point origin = vector_to_cv_point(position);
+        int baseline = 0;
+        cv::Size size = cv::getTextSize(text, cv::FONT_HERSHEY_DUPLEX, font_scale, thickness, &baseline);
+        // hershey glyphs can slightly exceed the reported box, so the margin is generous
+        int margin = std::abs(thickness) + 2 + size.height / 2;
+        cv::Rect bounds(origin.x - margin, origin.y - size.height - margin, size.width + 2 * margin,
+                        size.height + baseline + 2 * margin);
+        add_draw_command(bounds, color.a, [=, scalar = color_to_cv_scalar(color)](cv::Mat &target, const cv::Point &offset) {
+            cv::putText(target, text, origin - offset, cv::FONT_HERSHEY_DUPLEX, font_scale, scalar, thickness);
+        });
     }
 
     void Image_impl::draw_rectangle(const Vector2i &position_start, const Vector2i &position_end, const Color &color,
                                     int thickness) {
-        // Create a copy of the image as overlay
-        cv::Mat overlay;
-        _image.copyTo(overlay);
-
-        // Draw the rectangle on the overlay
-        cv::rectangle(overlay, vector_to_cv_point(position_start), vector_to_cv_point(position_end),
-                      color_to_cv_scalar(color), thickness);
-
-        // Blend the overlay with the base image using the alpha value from the color
-        blend_images(_image, overlay, color.a);
+        cv::Point p1 = vector_to_cv_point(position_start);
+        cv::Point p2 = vector_to_cv_point(position_end);
+        int margin = std::abs(thickness) + 2;
+        cv::Rect bounds(cv::Point(std::min(p1.x, p2.x) - margin, std::min(p1.y, p2.y) - margin),
+                        cv::Point(std::max(p1.x, p2.x) + margin + 1, std::max(p1.y, p2.y) + margin + 1));
+        add_draw_command(bounds, color.a, [=, scalar = color_to_cv_scalar(color)](cv::Mat &target, const cv::Point &offset) {
+            cv::rectangle(target, p1 - offset, p2 - offset, scalar, thickness);
+        });
     }
 
     void Image_impl::draw_circle(const Vector2i &position, const int radius, const Color &color, const int thickness) {
-        // Create a copy of the image as overlay
-        cv::Mat overlay;
-        _image.copyTo(overlay);
-
-        // Draw the circle on the overlay
-        cv::circle(overlay, vector_to_cv_point(position), radius, color_to_cv_scalar(color), thickness);
-
-        // Blend the overlay with the base image using the alpha value from the color
-        blend_images(_image, overlay, color.a);
+        cv::Point center = vector_to_cv_point(position);
+        int extent = radius + std::abs(thickness) + 2;
+        cv::Rect bounds(center.x - extent, center.y - extent, 2 * extent + 1, 2 * extent + 1);
+        add_draw_command(bounds, color.a, [=, scalar = color_to_cv_scalar(color)](cv::Mat &target, const cv::Point &offset) {
+            cv::circle(target, center - offset, radius, scalar, thickness);
+        });
     }
 
 
     void Image_impl::rotate(double angle) {
+        flush_draws();
+        _premultiplied.release();
         // Get the image center
         cv::Point2f src_center(_image.cols / 2.0F, _image.rows / 2.0F);
 
@@ -123,6 +171,7 @@ namespace gb {
 
         // Update the original image with the rotated result
         _image = dst;
+        _copy_on_write = false;
     }
 
     Vector2i Image_impl::get_text_size(const std::string &text, double font_scale, int thickness) {
@@ -130,51 +179,61 @@ namespace gb {
         return {t_size.width, t_size.height};
     }
 
-    void Image_impl::overlay_image(Image_ptr &image, const Vector2i &position) {
-        int x = position.x;
-        int y = position.y;
-        auto upcoming = std::static_pointer_cast<Image_impl>(image);
-        auto handle_cv_8uc4 = [=, this](int i, int j) {
-            if (upcoming->_image.at<cv::Vec4b>(j, i)[3] > 10) {
-                _image.at<cv::Vec4b>(y + j, x + i) = upcoming->_image.at<cv::Vec4b>(j, i);
-            }
-        };
-
-        auto handle_cv_8uc3 = [=, this](int i, int j) {
-            _image.at<cv::Vec4b>(y + j, x + i)[0] = upcoming->_image.at<cv::Vec3b>(j, i)[0];
-            _image.at<cv::Vec4b>(y + j, x + i)[1] = upcoming->_image.at<cv::Vec3b>(j, i)[1];
-            _image.at<cv::Vec4b>(y + j, x + i)[2] = upcoming->_image.at<cv::Vec3b>(j, i)[2];
-            _image.at<cv::Vec4b>(y + j, x + i)[3] = 255;
-        };
-        for (int i = 0; i < upcoming->_image.cols; i++) {
-            for (int j = 0; j < upcoming->_image.rows; j++) {
-                if (j + y >= _image.rows) {
-                    break;
-                }
-
-                if (x + i >= _image.cols) {
-                    return;
-                }
-
-                switch (upcoming->_image.channels()) {
-                    case 3: {
-                        handle_cv_8uc3(i, j);
-                        break;
+    const cv::Mat &Image_impl::get_premultiplied() {
+        flush_draws();
+        if (_premultiplied.empty()) {
+            _premultiplied.create(_image.rows, _image.cols, CV_8UC4);
+            for (int row = 0; row < _image.rows; row++) {
+                if (_image.channels() == 4) {
+                    premultiply_row(_image.ptr<uint8_t>(row), _premultiplied.ptr<uint8_t>(row), _image.cols);
+                } else {
+                    // opaque source, premultiplying changes nothing
+                    const cv::Vec3b *src = _image.ptr<cv::Vec3b>(row);
+                    cv::Vec4b *dst = _premultiplied.ptr<cv::Vec4b>(row);
+                    for (int col = 0; col < _image.cols; col++) {
+                        dst[col] = {src[col][0], src[col][1], src[col][2], 255};
                     }
+                }
+            }
+        }
+        return _premultiplied;
+    }
 
-                    case 4: {
-                        handle_cv_8uc4(i, j);
-                        break;
-                    }
+    void Image_impl::overlay_image(Image_ptr &image, const Vector2i &position) {
+        auto upcoming = std::static_pointer_cast<Image_impl>(image);
+        flush_draws();
+        // header copy shares the buffer, it stays valid even if the image overlays itself
+        cv::Mat source = upcoming->get_premultiplied();
 
-                    default: {
-                    }
-                }
+        cv::Rect target = cv::Rect(position.x, position.y, source.cols, source.rows) &
+                          cv::Rect(0, 0, _image.cols, _image.rows);
+        if (target.empty()) {
+            return;
+        }
+        make_writable();
+        _premultiplied.release();
+        int src_x = target.x - position.x;
+        int src_y = target.y - position.y;
+        for (int row = 0; row < target.height; row++) {
+            const uint8_t *src = source.ptr<uint8_t>(src_y + row) + src_x * 4;
+            uint8_t *dst = _image.ptr<uint8_t>(target.y + row) + target.x * _image.channels();
+            if (_image.channels() == 4) {
+                blend_premultiplied_row(src, dst, target.width);
+            } else {
+                blend_premultiplied_row_bgr(src, dst, target.width);
             }
         }
     }
 
-    void Image_impl::resize(const Vector2i &size) { cv::resize(_image, _image, vector_to_cv_point(size)); }
+    void Image_impl::resize(const Vector2i &size) {
+        flush_draws();
+        _premultiplied.release();
+        // resize into new buffer, the current one may be shared
+        cv::Mat resized;
+        cv::resize(_image, resized, vector_to_cv_point(size));
+        _image = resized;
+        _copy_on_write = false;
+    }
 
     void Image_impl::draw_polygon(const std::vector<Vector2i> &contour, const Color &color,const Color &lines_color, int thickness) {
         if (contour.size() < 3) {
@@ -182,10 +241,6 @@ namespace gb {
             return;
         }
 
-        // Create a copy of the image as an overlay
-        cv::Mat overlay;
-        _image.copyTo(overlay);
-
         // Convert std::vector<Vector2i> to std::vector<cv::Point>
         std::vector<cv::Point> cv_contour;
         cv_contour.reserve(contour.size());
@@ -193,17 +248,50 @@ namespace gb {
             cv_contour.emplace_back(vector_to_cv_point(point));
         }
 
-        // Create a pointer to the contour data
-        const cv::Point *pts = cv_contour.data();
-        int npts = static_cast<int>(cv_contour.size());
+        int margin = std::abs(thickness) + 2;
+        cv::Rect bounds = cv::boundingRect(cv_contour);
+        bounds = cv::Rect(bounds.x - margin, bounds.y - margin, bounds.width + 2 * margin, bounds.height + 2 * margin);
+        add_draw_command(bounds, color.a,
+                         [cv_contour = std::move(cv_contour), fill = color_to_cv_scalar(color),
+                          lines = color_to_cv_scalar(lines_color), thickness](cv::Mat &target, const cv::Point &offset) {
+                             std::vector<cv::Point> shifted;
+                             shifted.reserve(cv_contour.size());
+                             for (const auto &point: cv_contour) {
+                                 shifted.push_back(point - offset);
+                             }
+
+                             // Create a pointer to the contour data
+                             const cv::Point *pts = shifted.data();
+                             int npts = static_cast<int>(shifted.size());
+
+                             cv::fillPoly(target, &pts, &npts, 1, fill);
+                             cv::polylines(target, &pts, &npts, 1, true, lines, thickness);
+                         });
+    }
+
 
-        cv::fillPoly(overlay, &pts, &npts, 1, color_to_cv_scalar(color));
-        cv::polylines(overlay, &pts, &npts, 1, true, color_to_cv_scalar(lines_color), thickness);
+    cv::Mat &Image_impl::get_image() {
+        flush_draws();
+        // caller can modify pixels through the reference
+        make_writable();
+        _premultiplied.release();
+        return _image;
+    }
 
-        // Blend the overlay with the base image using the alpha value from the color
-        blend_images(_image, overlay, color.a);
+    void Image_impl::make_writable() {
+        if (_copy_on_write) {
+            _image = _image.clone();
+            _copy_on_write = false;
+        }
     }
 
+    std::shared_ptr<Image_impl> Image_impl::share() {
+        flush_draws();
+        _copy_on_write = true;
+        return std::make_shared<Image_impl>(*this);
+    }
 
-    cv::Mat &Image_impl::get_image() { return _image; }
+    size_t Image_impl::get_bytes_size() const {
+        return _image.total() * _image.elemSize() + _premultiplied.total() * _premultiplied.elemSize();
+    }
 } // namespace gb
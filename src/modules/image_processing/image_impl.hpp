@@ -7,15 +7,54 @@
 
 #include <opencv2/opencv.hpp>
 
+#include <functional>
+
 namespace gb {
 
+    /**
+     * @brief Draw primitive recorded by Image_impl, applied when pending draws are flushed.
+     */
+    struct Draw_command {
+        std::function<void(cv::Mat &target, const cv::Point &offset)>
+            draw; ///< Draws the primitive onto target, with coordinates shifted by -offset.
+        cv::Rect bounds; ///< Area the primitive can touch, clipped to the image.
+        float alpha; ///< Opacity of the primitive.
+    };
+
     /**
      * @brief Concrete implementation of the Image interface using OpenCV.
      *
      * The Image_impl class provides functionality to load, manipulate, and save images using OpenCV.
+     *
+     * Draw primitives are recorded and composited in one pass before the pixels are used: opaque ones
+     * are drawn directly, translucent ones are blended only inside their bounds, and consecutive
+     * non-overlapping translucent primitives of the same alpha share a single blend.
      */
     class Image_impl : public Image {
         cv::Mat _image; ///< OpenCV matrix that stores the image data.
+        std::vector<Draw_command> _pending_draws; ///< Primitives not yet drawn onto _image.
+        cv::Mat _premultiplied; ///< Premultiplied alpha copy of _image used when overlaying it, empty if outdated.
+        bool _copy_on_write = false; ///< Pixel buffer may be shared with other images, clone before writing.
+
+        /**
+         * @brief Clones the pixel buffer if it is shared, must be called before writing into _image.
+         */
+        void make_writable();
+
+        /**
+         * @brief Records draw primitive.
+         *
+         * @param bounds Area the primitive can touch, does not need to be clipped.
+         * @param alpha Opacity of the primitive.
+         * @param draw Function drawing the primitive onto target, shifted by -offset.
+         */
+        void add_draw_command(const cv::Rect &bounds, float alpha,
+                              std::function<void(cv::Mat &target, const cv::Point &offset)> draw);
+
+        /**
+         * @brief Draws all recorded primitives onto the image.
+         */
+        void flush_draws();
 
         /**
          * @brief Converts the internal image to RGBA format.
@@ -83,7 +122,7 @@ namespace gb {
          * @brief Converts the image to a string representation.
          *
          * @return std::pair<std::string, std::string> A pair where the first element is the file encoding
-         *         (e.g., ".jpg") and the second element is the image data in string format.
+         *         (e.g., ".png") and the second element is the image data in string format.
          */
         std::pair<std::string, std::string> convert_to_string() override;
 
@@ -152,6 +191,8 @@ namespace gb {
         /**
          * @breif Overlays given image with current on provided position.
          *
+         * Source pixels are alpha composited over the image ("source over"), parts outside the image are clipped.
+         *
          * @param image Image to overlay with.
          * @param position Top left corner of overlay.
          */
@@ -177,7 +218,29 @@ namespace gb {
                           int thickness) override;
 
         /**
-         * @brief Gets a reference to the internal OpenCV image matrix.
+         * @brief Creates a copy sharing pixel buffers with this image.
+         *
+         * Both images clone the buffer on their first write, so sharing costs nothing until then.
+         * Not thread safe, images shared between threads (cached ones) must be shared under one lock.
+         *
+         * @return Copy of the image.
+         */
+        std::shared_ptr<Image_impl> share();
+
+        /**
+         * @brief Gets premultiplied alpha copy of the image, computing it if outdated.
+         *
+         * @return Premultiplied BGRA image.
+         */
+        const cv::Mat &get_premultiplied();
+
+        /**
+         * @brief Gets amount of memory used by pixel buffers in bytes.
+         */
+        size_t get_bytes_size() const;
+
+        /**
+         * @brief Gets a reference to the internal OpenCV image matrix, with all pending draws applied.
          *
          * @return cv::Mat& Reference to the internal image matrix.
          */
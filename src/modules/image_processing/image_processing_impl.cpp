@@ -3,13 +3,105 @@
 //
 
 #include "image_processing_impl.hpp"
+#include "image_encoder.hpp"
 
 #include <filesystem>
+#include <format>
 
 namespace gb {
     static const std::string base_dir_path = "./cache/image/";
 
-    Image_processing_impl::Image_processing_impl(): Image_processing("image_processing", {}) {
+    std::string Image_memory_cache::make_key(const std::string &name, const Vector2i &resolution) {
+        return name + "/" + to_string(resolution);
+    }
+
+    void Image_memory_cache::evict() {
+        while (_bytes_size > _max_bytes_size && !_lru.empty()) {
+            auto it = _entries.find(_lru.back());
+            _bytes_size -= it->second.bytes_size;
+            _entries.erase(it);
+            _lru.pop_back();
+            _evictions_amount++;
+        }
+    }
+
+    void Image_memory_cache::set_max_bytes_size(size_t max_bytes_size) {
+        std::unique_lock lk(_mutex);
+        _max_bytes_size = max_bytes_size;
+        evict();
+    }
+
+    std::shared_ptr<Image_impl> Image_memory_cache::get(const std::string &key) {
+        std::unique_lock lk(_mutex);
+        auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            _misses_amount++;
+            return nullptr;
+        }
+        _hits_amount++;
+        _lru.splice(_lru.begin(), _lru, it->second.lru_position);
+        return it->second.image->share();
+    }
+
+    std::shared_ptr<Image_impl> Image_memory_cache::put(const std::string &key, const std::shared_ptr<Image_impl> &image) {
+        // computed once here, every copy then overlays without premultiplying again
+        image->get_premultiplied();
+        size_t bytes_size = image->get_bytes_size();
+        std::unique_lock lk(_mutex);
+        // cached images are shared only under the lock, share() writes their copy on write flag
+        std::shared_ptr<Image_impl> r = image->share();
+        if (bytes_size > _max_bytes_size) {
+            return r;
+        }
+        auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            _bytes_size -= it->second.bytes_size;
+            _lru.erase(it->second.lru_position);
+            _entries.erase(it);
+        }
+        _lru.push_front(key);
+        _entries.emplace(key, Entry{image, bytes_size, _lru.begin()});
+        _bytes_size += bytes_size;
+        evict();
+        return r;
+    }
+
+    void Image_memory_cache::remove(const std::string &name) {
+        std::unique_lock lk(_mutex);
+        std::string prefix = name + "/";
+        for (auto it = _entries.begin(); it != _entries.end();) {
+            if (it->first.starts_with(prefix)) {
+                _bytes_size -= it->second.bytes_size;
+                _lru.erase(it->second.lru_position);
+                it = _entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void Image_memory_cache::clear() {
+        std::unique_lock lk(_mutex);
+        _entries.clear();
+        _lru.clear();
+        _bytes_size = 0;
+    }
+
+    Image_memory_cache_stats Image_memory_cache::get_stats() {
+        Image_memory_cache_stats stats;
+        {
+            std::unique_lock lk(_mutex);
+            stats.entries_amount = _entries.size();
+            stats.bytes_size = _bytes_size;
+            stats.max_bytes_size = _max_bytes_size;
+        }
+        stats.hits_amount = _hits_amount;
+        stats.misses_amount = _misses_amount;
+        stats.evictions_amount = _evictions_amount;
+        return stats;
+    }
+
+    Image_processing_impl::Image_processing_impl(): Image_processing("image_processing", {"config", "admin_terminal"}) {
     }
 
     Image_ptr Image_processing_impl::create_image(const std::string &file) {
@@ -17,9 +109,22 @@ namespace gb {
     }
 
     void Image_processing_impl::stop() {
+        _admin_terminal->remove_command("image_processing_cache_stats");
+        _admin_terminal->remove_command("image_processing_cache_clear");
+        _memory_cache.clear();
     }
 
     void Image_processing_impl::run() {
+        _memory_cache.set_max_bytes_size(
+            std::stoull(_config->get_value_or("image_cache_max_bytes", std::to_string(256 * 1024 * 1024))));
+
+        Image_encoder_settings settings;
+        settings.jpeg_quality = std::stoi(_config->get_value_or("image_jpeg_quality", "90"));
+        settings.webp_quality = std::stoi(_config->get_value_or("image_webp_quality", "90"));
+        settings.png_compression = std::stoi(_config->get_value_or("image_png_compression", "3"));
+        settings.prefer_webp = _config->get_value_or("image_prefer_webp", "0") == "1";
+        settings.flat_colors_limit = std::stoull(_config->get_value_or("image_flat_colors_limit", "64"));
+        set_image_encoder_settings(settings);
     }
 
     void Image_processing_impl::cache_create(const std::string &name,const image_generator_t &image_generator) { {
@@ -46,6 +151,7 @@ namespace gb {
             std::unique_lock lk(_mutex);
             _image_cache.erase(name);
         }
+        _memory_cache.remove(name);
         std::filesystem::remove_all(base_dir_path + name);
     }
 
@@ -66,20 +172,47 @@ namespace gb {
         if (!_image_cache.contains(name)) {
             throw std::runtime_error("Image cache does not contain image generator "+ name);
         }
-        if (std::filesystem::exists(filename)) {
-            return create_image(filename);
+        auto key = Image_memory_cache::make_key(name, resolution);
+        if (auto cached = _memory_cache.get(key)) {
+            return cached;
         }
-        Image_ptr image;
-        {
-            std::shared_lock lk (_mutex);
-            image = _image_cache.at(name)(shared_from_this(),resolution);
+        std::shared_ptr<Image_impl> image_impl;
+        if (std::filesystem::exists(filename)) {
+            image_impl = std::static_pointer_cast<Image_impl>(create_image(filename));
+        } else {
+            Image_ptr image;
+            {
+                std::shared_lock lk (_mutex);
+                image = _image_cache.at(name)(shared_from_this(),resolution);
+            }
+            image_impl = std::static_pointer_cast<Image_impl>(image);
+            cv::imwrite(filename,image_impl->get_image());
         }
-        auto image_impl = std::static_pointer_cast<Image_impl>(image);
-        cv::imwrite(filename,image_impl->get_image());
-        return image;
+        return _memory_cache.put(key, image_impl);
     }
 
     void Image_processing_impl::init(const Modules &modules) {
+        _config = std::static_pointer_cast<Config>(modules.at("config"));
+        _admin_terminal = std::static_pointer_cast<Admin_terminal>(modules.at("admin_terminal"));
+
+        _admin_terminal->add_command(
+            "image_processing_cache_stats", "Shows decoded images memory cache metrics.", "Arguments: no arguments.",
+            [this](const std::vector<std::string> &arguments) {
+                auto stats = _memory_cache.get_stats();
+                uint64_t lookups = stats.hits_amount + stats.misses_amount;
+                std::cout << std::format("Decoded images cache:\nimages: {}, memory: {} / {} bytes\nhits: {}, "
+                                         "misses: {}, hit rate: {}%, evictions: {}",
+                                         stats.entries_amount, stats.bytes_size, stats.max_bytes_size,
+                                         stats.hits_amount, stats.misses_amount,
+                                         lookups ? stats.hits_amount * 100 / lookups : 0, stats.evictions_amount)
+                          << std::endl;
+            });
+
+        _admin_terminal->add_command("image_processing_cache_clear", "Drops all decoded images from memory cache.",
+                                     "Arguments: no arguments.", [this](const std::vector<std::string> &arguments) {
+                                         _memory_cache.clear();
+                                         std::cout << "Decoded images cache cleared." << std::endl;
+                                     });
     }
 
     Image_ptr Image_processing_impl::create_image(size_t x, size_t y, const Color &color) {
@@ -4,14 +4,118 @@
 
 #pragma once
 
+#include <atomic>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include "image_impl.hpp"
 #include "image_processing.hpp"
+#include "src/modules/admin_terminal/admin_terminal.hpp"
+#include "src/modules/config/config.hpp"
 
 namespace gb {
 
+    /**
+     * @brief Snapshot of decoded images cache counters, used for admin terminal output.
+     */
+    struct Image_memory_cache_stats {
+        size_t entries_amount = 0; ///< Images currently cached.
+        size_t bytes_size = 0; ///< Memory used by cached pixel buffers.
+        size_t max_bytes_size = 0; ///< Memory limit.
+        uint64_t hits_amount = 0; ///< Lookups served from memory.
+        uint64_t misses_amount = 0; ///< Lookups which had to read disk or generate image.
+        uint64_t evictions_amount = 0; ///< Images dropped to stay within the limit.
+    };
+
+    /**
+     * @class Image_memory_cache
+     * @brief Bounded LRU of decoded images keyed by cache name and resolution.
+     *
+     * Stored images are never modified, lookups return copies sharing their pixel buffers
+     * (see Image_impl::share), so a hit is a pointer copy instead of a file read and decode.
+     */
+    class Image_memory_cache {
+        /**
+         * @brief Cached image with its position in the LRU list.
+         */
+        struct Entry {
+            std::shared_ptr<Image_impl> image; ///< Stored image, never modified.
+            size_t bytes_size; ///< Memory used by image.
+            std::list<std::string>::iterator lru_position; ///< Position in _lru.
+        };
+
+        std::mutex _mutex; ///< Protects all members below.
+        std::list<std::string> _lru; ///< Keys from most to least recently used.
+        std::unordered_map<std::string, Entry> _entries; ///< Cached images by key.
+        size_t _bytes_size = 0; ///< Memory used by cached images.
+        size_t _max_bytes_size = 256 * 1024 * 1024; ///< Memory limit.
+
+        std::atomic_uint64_t _hits_amount = 0; ///< Counter of hits.
+        std::atomic_uint64_t _misses_amount = 0; ///< Counter of misses.
+        std::atomic_uint64_t _evictions_amount = 0; ///< Counter of evictions.
+
+        /**
+         * @brief Drops least recently used entries until memory limit is satisfied. Requires _mutex.
+         */
+        void evict();
+
+    public:
+        /**
+         * @brief Builds cache key.
+         *
+         * @param name Image cache name.
+         * @param resolution Image resolution.
+         * @return Key of the image.
+         */
+        static std::string make_key(const std::string &name, const Vector2i &resolution);
+
+        /**
+         * @brief Sets memory limit, evicting images if needed.
+         *
+         * @param max_bytes_size Memory limit in bytes.
+         */
+        void set_max_bytes_size(size_t max_bytes_size);
+
+        /**
+         * @brief Gets copy of cached image.
+         *
+         * @param key Key of the image.
+         * @return Copy sharing pixels with cached image, nullptr on miss.
+         */
+        std::shared_ptr<Image_impl> get(const std::string &key);
+
+        /**
+         * @brief Stores image. The image passed must not be used afterwards, work with the returned copy.
+         *
+         * @param key Key of the image.
+         * @param image Image to store.
+         * @return Copy sharing pixels with the stored image, taken under the cache lock like in get().
+         */
+        std::shared_ptr<Image_impl> put(const std::string &key, const std::shared_ptr<Image_impl> &image);
+
+        /**
+         * @brief Removes all images of a cache name.
+         *
+         * @param name Image cache name.
+         */
+        void remove(const std::string &name);
+
+        /**
+         * @brief Removes all images.
+         */
+        void clear();
+
+        /**
+         * @brief Gets snapshot of cache counters.
+         *
+         * @return Cache statistics.
+         */
+        Image_memory_cache_stats get_stats();
+    };
+
     /**
      * @brief Concrete implementation of the Image_processing interface.
      *
@@ -22,6 +126,9 @@ namespace gb {
     class Image_processing_impl : public Image_processing, public std::enable_shared_from_this<Image_processing> {
         std::map<std::string, image_generator_t> _image_cache; ///< Map to store image generators associated with names.
         std::shared_mutex _mutex; ///< Mutex for synchronizing access to the image cache.
+        Image_memory_cache _memory_cache; ///< Decoded images, checked before disk cache.
+        Config_ptr _config; ///< Pointer to the configuration module.
+        Admin_terminal_ptr _admin_terminal; ///< Pointer to the admin terminal module.
 
     public:
         /**
@@ -68,14 +175,14 @@ namespace gb {
         /**
          * @brief Stops the image processing operations.
          *
-         * This method is a placeholder and does not perform any actions in this implementation.
+         * Removes admin terminal commands and releases decoded images cache.
          */
         void stop() override;
 
         /**
          * @brief Runs the image processing operations.
          *
-         * This method is a placeholder and does not perform any actions in this implementation.
+         * Applies image_cache_max_bytes config value to decoded images cache and image_* encoder config values.
          */
         void run() override;
 
@@ -119,6 +226,9 @@ namespace gb {
         /**
          * @brief Retrieves an image from the cache or generates it if not present.
          *
+         * Decoded images are kept in memory, returned images share pixels with the cached one
+         * and copy them on first modification.
+         *
          * @param name The name of the image generator to use.
          * @param resolution The resolution of the image to retrieve.
          * @return Image_ptr A shared pointer to the retrieved or generated Image.
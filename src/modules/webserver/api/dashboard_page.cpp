@@ -328,7 +328,7 @@ ORDER BY dr.day asc;
                 }
 
                 dpp::user &user = validation.second.discord_user;
-                Achievements_report report = server->achievements_manager->get_achievements_report(user.id);
+                Achievements_report report = co_await server->achievements_manager->get_achievements_report(user.id);
                 callback(drogon::HttpResponse::newHttpJsonResponse(to_json(report)));
                 co_return;
             });
@@ -29,12 +29,9 @@ namespace gb {
             "/api/get-index-page-counters",
             [=](drogon::HttpRequestPtr req,
                 std::function<void(const drogon::HttpResponsePtr &)> callback) -> drogon::Task<> {
-                auto server_cnt_task = server->discord_stats->get_servers_cnt();
-                auto users_cnt_task = server->discord_stats->get_users_cnt();
-                auto images_and_games_cnt_task = server->db->execute_prepared_statement(get_games_images_stmt);
-                uint64_t servers_cnt = co_await server_cnt_task;
-                uint64_t users_cnt = co_await users_cnt_task;
-                Database_return_t images_and_games = co_await images_and_games_cnt_task;
+                auto [servers_cnt, users_cnt, images_and_games] =
+                    co_await when_all(server->discord_stats->get_servers_cnt(), server->discord_stats->get_users_cnt(),
+                                      server->db->execute_prepared_statement(get_games_images_stmt));
                 Json::Value ret;
                 ret["users_cnt"] = users_cnt;
                 ret["servers_cnt"] = servers_cnt;
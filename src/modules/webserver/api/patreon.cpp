@@ -106,6 +106,7 @@ namespace gb {
                     co_return;
                 }
                 co_await server->db->execute_prepared_statement(patreon_logout_stmt, validation.second.discord_user.id);
+                server->premium_manager->invalidate_premium_status(validation.second.discord_user.id);
                 auto dashboard_redirect = drogon::HttpResponse::newRedirectionResponse("/dashboard");
                 callback(dashboard_redirect);
                 co_return;
@@ -213,6 +214,8 @@ namespace gb {
                 }
                 co_await server->db->execute_prepared_statement(patreon_website_login_stmt, patreon_id, discord_id,
                                                                 is_from_patreon, nickname);
+                // procedure may relink subscription from another discord user
+                server->premium_manager->invalidate_premium_statuses();
                 auto dashboard_redirect = drogon::HttpResponse::newRedirectionResponse("/dashboard");
                 callback(dashboard_redirect);
                 co_return;
@@ -286,6 +289,7 @@ namespace gb {
                 }
                 co_await server->db->execute_prepared_statement(patreon_webhook_stmt, patreon_id, discord_id,
                                                                 to_string(patron_status), nickname);
+                server->premium_manager->invalidate_premium_statuses();
 
 
                 drogon::HttpResponsePtr resp = drogon::HttpResponse::newHttpResponse();
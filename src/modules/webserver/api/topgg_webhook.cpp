@@ -113,6 +113,8 @@ void gb::topgg_webhook(Webserver_impl *server) {
                 dpp::snowflake user_id = user_id_str;
 
                 co_await server->db->execute_prepared_statement(vote_webhook_stmt, user_id);
+                // vote reward is credited by the procedure, bypassing the cached balance
+                server->gamescoin_manager->invalidate_user_balance(user_id);
             } catch (const std::exception &e) {
                 server->log->warn(std::format("Invalid payload structure: {}", e.what()));
                 make_response(drogon::k400BadRequest);
@@ -16,7 +16,7 @@
 namespace gb {
     Webserver_impl::Webserver_impl() :
         Webserver("webserver", {"discord_statistics_collector", "database", "config", "discord_command_handler",
-                                "logging", "premium_manager", "discord_achievements_processing"}) {}
+                                "logging", "premium_manager", "discord_achievements_processing", "gamescoin_manager"}) {}
 
 
     void Webserver_impl::stop() {
@@ -168,6 +168,7 @@ namespace gb {
         premium_manager = std::static_pointer_cast<Premium_manager>(modules.at("premium_manager"));
         achievements_manager =
             std::static_pointer_cast<Discord_achievements_processing>(modules.at("discord_achievements_processing"));
+        gamescoin_manager = std::static_pointer_cast<Gamescoin_manager>(modules.at("gamescoin_manager"));
     }
 
     Task<void> Webserver_impl::delete_cookie(uint64_t id) {
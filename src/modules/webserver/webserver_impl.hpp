@@ -14,6 +14,7 @@
 #include <src/modules/database/database.hpp>
 #include <src/modules/discord/discord_achievements_processing/discord_achievements_processing.hpp>
 #include <src/modules/discord/discord_command_handler/discord_command_handler.hpp>
+#include <src/modules/discord/gamescoin_manager/gamescoin_manager.hpp>
 #include <src/modules/discord/premium_manager/premium_manager.hpp>
 #include <src/modules/logging/logging.hpp>
 
@@ -43,6 +44,7 @@ namespace gb {
         Logging_ptr log; ///< Pointer to the logging module.
         Premium_manager_ptr premium_manager; ///< Pointer to the premium manager module.
         Discord_achievements_processing_ptr achievements_manager; ///< Pointer to the achievements processing module.
+        Gamescoin_manager_ptr gamescoin_manager; ///< Pointer to the gamescoin manager module.
 
         std::atomic_uint64_t current_jwt_id; ///< Atomic counter for generating unique JWT identifiers.
 
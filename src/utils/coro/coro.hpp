@@ -1,20 +1,132 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <coroutine>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 namespace gb {
 
+    namespace detail {
+        /**
+         * @brief State shared by promises of all Task types.
+         *
+         * Tasks start eagerly and may complete on a different thread than the one that awaits them,
+         * so the handoff between the finishing coroutine and its awaiter goes through a single atomic
+         * word. It holds one of:
+         * - nullptr: task is running and nobody awaits it yet;
+         * - address of the awaiting coroutine: task is running and will resume the awaiter on completion;
+         * - completed_marker(): task has finished, result is ready;
+         * - detached_marker(): owning Task object was destroyed, coroutine frame destroys itself on completion.
+         *
+         * Markers are addresses inside the promise itself, so they stay valid across shared libraries.
+         */
+        struct Task_promise_base {
+            std::atomic<void *> state = nullptr; ///< Handoff word, see struct description.
+            std::exception_ptr exception; ///< Exception thrown from the coroutine body, rethrown on await.
+
+            void *completed_marker() noexcept { return this; } ///< Marker for finished task
+            void *detached_marker() noexcept { return &exception; } ///< Marker for task without owner
+
+            /**
+             * @brief Final awaiter which resumes the awaiting coroutine, if any.
+             */
+            struct Final_awaiter {
+                bool await_ready() noexcept { return false; }
+
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+                    Task_promise_base &p = h.promise();
+                    void *prev = p.state.exchange(p.completed_marker(), std::memory_order_acq_rel);
+                    if (prev == p.detached_marker()) {
+                        h.destroy();
+                        return std::noop_coroutine();
+                    }
+                    if (prev == nullptr) {
+                        return std::noop_coroutine();
+                    }
+                    return std::coroutine_handle<>::from_address(prev);
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            std::suspend_never initial_suspend() noexcept {
+                return {};
+            } ///< Tasks start eagerly, the body runs until the first real suspension
+            Final_awaiter final_suspend() noexcept { return {}; } ///< Hands control back to the awaiter
+            void unhandled_exception() {
+                exception = std::current_exception();
+            } ///< Stores exception to rethrow it in the awaiter
+
+            /**
+             * @brief Checks whether the coroutine has already finished.
+             */
+            bool is_completed() noexcept { return state.load(std::memory_order_acquire) == completed_marker(); }
+
+            /**
+             * @brief Registers awaiting coroutine.
+             *
+             * @param awaiter Coroutine to resume when the task finishes.
+             * @return False if the task has already finished and the awaiter should continue immediately.
+             */
+            bool set_continuation(std::coroutine_handle<> awaiter) noexcept {
+                void *expected = nullptr;
+                return state.compare_exchange_strong(expected, awaiter.address(), std::memory_order_acq_rel);
+            }
+
+            /**
+             * @brief Releases the coroutine frame from its owner.
+             *
+             * @return True if the task has already finished and the frame must be destroyed by the caller.
+             */
+            bool detach() noexcept {
+                return state.exchange(detached_marker(), std::memory_order_acq_rel) == completed_marker();
+            }
+
+            /**
+             * @brief Rethrows the exception from the coroutine body if there was one.
+             */
+            void rethrow_if_exception() {
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+            }
+        };
+
+        /**
+         * @brief Destroys or detaches a task coroutine frame depending on whether it has finished.
+         *
+         * @param h Handle of the frame, may be null.
+         */
+        template<typename Handle>
+        void release_task_frame(Handle h) noexcept {
+            if (h && h.promise().detach()) {
+                h.destroy();
+            }
+        }
+    } // namespace detail
+
     /**
      * @brief Represents an asynchronous task that can return a result of type T.
      *
      * This structure utilizes C++20 coroutines to enable asynchronous programming
      * patterns, allowing functions to be suspended and resumed without blocking.
+     * The task starts running as soon as it is created; awaiting it suspends the caller
+     * until the task finishes, possibly on another thread (for example a database worker).
+     * Destroying a task which is still running detaches it, so it is safe to drop tasks
+     * you are not interested in.
      *
      * @tparam T The type of result returned by the task.
      */
@@ -35,31 +147,37 @@ namespace gb {
 
         Task(const Task &) = delete; ///< Deleted copy constructor
         Task(Task &&t) noexcept : coro(t.coro) { t.coro = nullptr; } ///< Move constructor
-        ~Task() {
-            if (coro)
-                coro.destroy();
-        } ///< Destructor that cleans up the coroutine
+        ~Task() { detail::release_task_frame(coro); } ///< Destroys finished coroutine or detaches running one
 
         Task &operator=(const Task &) = delete; ///< Deleted copy assignment operator
         Task &operator=(Task &&t) noexcept {
             if (this != &t) {
-                if (coro)
-                    coro.destroy();
+                detail::release_task_frame(coro);
                 coro = t.coro;
                 t.coro = nullptr;
             }
             return *this;
         }
 
+        /**
+         * @brief Checks whether the task has already finished.
+         */
+        bool is_ready() const { return coro.promise().is_completed(); }
+
         /**
          * @brief Awaitable structure to allow awaiting on the task using co_await.
          */
         struct Awaitable {
             handle_type coro; ///< Handle to the coroutine
 
-            bool await_ready() { return coro.done(); } ///< Checks if the coroutine is already done
-            void await_suspend(std::coroutine_handle<> h) { coro.resume(); } ///< Resumes the coroutine when suspended
-            T await_resume() { return coro.promise().result.value(); } ///< Returns the result of the coroutine
+            bool await_ready() { return coro.promise().is_completed(); } ///< Checks if the coroutine is already done
+            bool await_suspend(std::coroutine_handle<> h) {
+                return coro.promise().set_continuation(h);
+            } ///< Registers the awaiter to be resumed on completion
+            T await_resume() {
+                coro.promise().rethrow_if_exception();
+                return std::move(coro.promise().result.value());
+            } ///< Returns the result of the coroutine
         };
 
         Awaitable operator co_await() { return Awaitable{coro}; } ///< Provides co_await support for the task
@@ -68,25 +186,13 @@ namespace gb {
          * @brief The promise_type represents the state of the coroutine and provides
          * methods for resuming and completing the coroutine.
          */
-        struct promise_type {
+        struct promise_type : detail::Task_promise_base {
             std::optional<T> result; ///< Optional result of the task
-            std::function<void()> continuation; ///< Optional continuation to be called on completion
 
             Task get_return_object() {
                 return Task{handle_type::from_promise(*this)};
             } ///< Creates the Task from the promise
-            std::suspend_never initial_suspend() {
-                return {};
-            } ///< Indicates no suspension at the start of the coroutine
-            std::suspend_always final_suspend() noexcept { ///< Indicates suspension at
-                                                           ///< the end of the coroutine
-                if (continuation) {
-                    continuation(); ///< If a continuation is set, call it
-                }
-                return {};
-            }
-            void return_value(T v) { result = v; } ///< Sets the result value of the coroutine
-            void unhandled_exception() { std::terminate(); } ///< Terminates if an exception is unhandled
+            void return_value(T v) { result = std::move(v); } ///< Sets the result value of the coroutine
         };
     };
 
@@ -110,31 +216,32 @@ namespace gb {
 
         Task(const Task &) = delete; ///< Deleted copy constructor
         Task(Task &&t) noexcept : coro(t.coro) { t.coro = nullptr; } ///< Move constructor
-        ~Task() {
-            if (coro)
-                coro.destroy();
-        } ///< Destructor that cleans up the coroutine
+        ~Task() { detail::release_task_frame(coro); } ///< Destroys finished coroutine or detaches running one
 
         Task &operator=(const Task &) = delete; ///< Deleted copy assignment operator
         Task &operator=(Task &&t) noexcept {
             if (this != &t) {
-                if (coro)
-                    coro.destroy();
+                detail::release_task_frame(coro);
                 coro = t.coro;
                 t.coro = nullptr;
             }
             return *this;
         }
 
+        /**
+         * @brief Checks whether the task has already finished.
+         */
+        bool is_ready() const;
+
         /**
          * @brief Awaitable structure to allow awaiting on the task using co_await.
          */
         struct Awaitable {
             handle_type coro; ///< Handle to the coroutine
 
-            bool await_ready() { return coro.done(); } ///< Checks if the coroutine is already done
-            void await_suspend(std::coroutine_handle<> h) { coro.resume(); } ///< Resumes the coroutine when suspended
-            void await_resume() { coro.promise().result; } ///< Nothing to return for void tasks
+            bool await_ready(); ///< Checks if the coroutine is already done
+            bool await_suspend(std::coroutine_handle<> h); ///< Registers the awaiter to be resumed on completion
+            void await_resume(); ///< Rethrows exception of the task if any
         };
 
         Awaitable operator co_await() { return Awaitable{coro}; } ///< Provides co_await support for the task
@@ -143,35 +250,464 @@ namespace gb {
          * @brief The promise_type represents the state of the coroutine and provides
          * methods for resuming and completing the coroutine.
          */
-        struct promise_type {
-            std::optional<int> result; ///< Optional integer to track completion
-            std::function<void()> continuation; ///< Optional continuation to be called on completion
-
+        struct promise_type : detail::Task_promise_base {
             Task get_return_object() {
                 return Task{handle_type::from_promise(*this)};
             } ///< Creates the Task from the promise
-            std::suspend_never initial_suspend() {
-                return {};
-            } ///< Indicates no suspension at the start of the coroutine
-            std::suspend_always final_suspend() noexcept { ///< Indicates suspension at
-                                                           ///< the end of the coroutine
-                if (continuation) {
-                    continuation(); ///< If a continuation is set, call it
+            void return_void() {} ///< Nothing to store for void tasks
+        };
+    };
+
+    inline bool Task<void>::is_ready() const { return coro.promise().is_completed(); }
+
+    inline bool Task<void>::Awaitable::await_ready() { return coro.promise().is_completed(); }
+
+    inline bool Task<void>::Awaitable::await_suspend(std::coroutine_handle<> h) {
+        return coro.promise().set_continuation(h);
+    }
+
+    inline void Task<void>::Awaitable::await_resume() { coro.promise().rethrow_if_exception(); }
+
+    /**
+     * @class Executor
+     * @brief Something which runs jobs on its own threads, used to resume coroutines where they came from.
+     */
+    class Executor {
+    protected:
+        /**
+         * @brief Executor owning the current thread, nullptr for threads outside any executor.
+         */
+        static Executor *&thread_executor() {
+            static thread_local Executor *executor = nullptr;
+            return executor;
+        }
+
+        /**
+         * @brief Executor used for threads which do not belong to any executor.
+         */
+        static std::atomic<Executor *> &default_executor() {
+            static std::atomic<Executor *> executor = nullptr;
+            return executor;
+        }
+
+        /**
+         * @brief Marks calling thread as owned by executor, called by executors on their threads.
+         *
+         * @param executor Executor or nullptr once the thread leaves it.
+         */
+        static void set_thread_executor(Executor *executor) { thread_executor() = executor; }
+
+    public:
+        virtual ~Executor() = default;
+
+        /**
+         * @brief Enqueues job to be run on one of executor threads.
+         *
+         * @param job Job to run.
+         */
+        virtual void post(std::function<void()> job) = 0;
+
+        /**
+         * @brief Gets executor of the calling thread.
+         *
+         * @return Executor owning the thread. For foreign threads (for example D++ event threads) an executor of
+         * the thread which hands jobs to the default executor, nullptr if there is no default executor.
+         */
+        static Executor *current();
+
+        /**
+         * @brief Sets executor for threads which do not belong to any executor.
+         *
+         * @param executor Executor, nullptr to unset. It must stay alive until unset.
+         */
+        static void set_default(Executor *executor) { default_executor().store(executor, std::memory_order_release); }
+
+        /**
+         * @brief Awaitable which moves the awaiting coroutine onto this executor.
+         *
+         * @return Awaitable to co_await.
+         */
+        auto schedule() {
+            struct Schedule_awaitable {
+                Executor *executor;
+
+                bool await_ready() { return false; }
+                void await_suspend(std::coroutine_handle<> h) { executor->post([h] { h.resume(); }); }
+                void await_resume() {}
+            };
+            return Schedule_awaitable{this};
+        }
+    };
+
+    namespace detail {
+        /**
+         * @class Foreign_thread_executor
+         * @brief Executor of one foreign thread, jobs posted to it go to the default executor.
+         *
+         * Each job is kept in the queue of the thread and the default executor only gets a job taking it from
+         * there. A thread blocked in sync_wait serves its queue itself, so it never waits for a job stuck behind
+         * it in the default executor, which may be the very pool the thread belongs to.
+         */
+        class Foreign_thread_executor : public Executor {
+            /**
+             * @brief Queue of jobs, shared with jobs given to the default executor.
+             */
+            struct Queue {
+                std::mutex mutex; ///< Protects jobs.
+                std::condition_variable cv; ///< Signalled on new job or wake.
+                std::deque<std::function<void()>> jobs; ///< Jobs not taken yet.
+
+                /**
+                 * @brief Runs the oldest job if no one has taken it yet.
+                 */
+                void run_one() {
+                    std::unique_lock lk(mutex);
+                    if (jobs.empty()) {
+                        return;
+                    }
+                    auto job = std::move(jobs.front());
+                    jobs.pop_front();
+                    lk.unlock();
+                    job();
+                }
+            };
+
+            std::shared_ptr<Queue> _queue = std::make_shared<Queue>(); ///< Jobs of the thread.
+
+            /**
+             * @brief Executor of the calling thread, nullptr until created.
+             */
+            static Foreign_thread_executor *&thread_foreign_executor() {
+                static thread_local Foreign_thread_executor *executor = nullptr;
+                return executor;
+            }
+
+        public:
+            /**
+             * @brief Gets executor of the calling thread, creating it on the first call.
+             *
+             * It is never destroyed, jobs may be posted to it after the thread has exited.
+             */
+            static Foreign_thread_executor *get() {
+                Foreign_thread_executor *&executor = thread_foreign_executor();
+                if (!executor) {
+                    executor = new Foreign_thread_executor();
+                }
+                return executor;
+            }
+
+            /**
+             * @brief Gets executor of the calling thread if it was created.
+             */
+            static Foreign_thread_executor *find() { return thread_foreign_executor(); }
+
+            /**
+             * @brief Queues job and hands it to the default executor, runs it inline if there is none.
+             */
+            void post(std::function<void()> job) override {
+                {
+                    std::unique_lock lk(_queue->mutex);
+                    _queue->jobs.push_back(std::move(job));
+                }
+                _queue->cv.notify_all();
+                if (Executor *executor = default_executor().load(std::memory_order_acquire)) {
+                    executor->post([queue = _queue] { queue->run_one(); });
+                } else {
+                    _queue->run_one();
                 }
-                return {};
             }
-            void return_void() { result = 0; } ///< Sets result to 0 to indicate completion for void tasks
-            void unhandled_exception() { std::terminate(); } ///< Terminates if an exception is unhandled
+
+            /**
+             * @brief Runs jobs of the thread until done is set, sleeping while there are none.
+             *
+             * @param done Flag to stop at, whoever sets it must call wake() afterwards.
+             */
+            void run_until(const std::atomic_bool &done) {
+                std::unique_lock lk(_queue->mutex);
+                while (true) {
+                    _queue->cv.wait(lk, [this, &done] {
+                        return !_queue->jobs.empty() || done.load(std::memory_order_acquire);
+                    });
+                    if (done.load(std::memory_order_acquire)) {
+                        return;
+                    }
+                    auto job = std::move(_queue->jobs.front());
+                    _queue->jobs.pop_front();
+                    lk.unlock();
+                    job();
+                    lk.lock();
+                }
+            }
+
+            /**
+             * @brief Wakes the thread sleeping in run_until() so it rechecks its flag.
+             */
+            void wake() {
+                // taking the lock orders the flag store before the sleeper's check
+                { std::unique_lock lk(_queue->mutex); }
+                _queue->cv.notify_all();
+            }
         };
+    } // namespace detail
+
+    inline Executor *Executor::current() {
+        if (Executor *r = thread_executor()) {
+            return r;
+        }
+        if (!default_executor().load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return detail::Foreign_thread_executor::get();
+    }
+
+    /**
+     * @class Thread_pool
+     * @brief Fixed size pool of threads used to resume coroutines and run short jobs.
+     *
+     * Used as scheduler for coroutines which were suspended on blocking work (for example
+     * database queries), so that continuation code does not run on the worker which did the work.
+     */
+    class Thread_pool : public Executor {
+        std::mutex _mutex; ///< Protects job queue and running flag.
+        std::condition_variable _cv; ///< Signalled on new job or stop.
+        std::deque<std::function<void()>> _jobs; ///< Queue of pending jobs.
+        bool _is_running = true; ///< False once pool is being destroyed.
+        std::vector<std::thread> _threads; ///< Worker threads.
+
+        /**
+         * @brief Pool the current thread belongs to, nullptr for threads outside any pool.
+         */
+        static Thread_pool *&current_pool() {
+            static thread_local Thread_pool *pool = nullptr;
+            return pool;
+        }
+
+        /**
+         * @brief Worker thread main loop.
+         */
+        void worker() {
+            current_pool() = this;
+            set_thread_executor(this);
+            while (true) {
+                std::unique_lock lk(_mutex);
+                _cv.wait(lk, [this] { return !_jobs.empty() || !_is_running; });
+                if (_jobs.empty()) {
+                    break;
+                }
+                auto job = std::move(_jobs.front());
+                _jobs.pop_front();
+                lk.unlock();
+                job();
+            }
+            current_pool() = nullptr;
+            set_thread_executor(nullptr);
+        }
+
+    public:
+        /**
+         * @brief Starts the pool.
+         *
+         * @param threads_amount Number of worker threads, at least one is always created.
+         */
+        explicit Thread_pool(size_t threads_amount) {
+            threads_amount = std::max<size_t>(threads_amount, 1);
+            _threads.reserve(threads_amount);
+            for (size_t i = 0; i < threads_amount; i++) {
+                _threads.emplace_back([this] { worker(); });
+            }
+        }
+
+        Thread_pool(const Thread_pool &) = delete;
+        Thread_pool &operator=(const Thread_pool &) = delete;
+
+        /**
+         * @brief Runs all jobs left in the queue and joins worker threads.
+         */
+        ~Thread_pool() {
+            {
+                std::unique_lock lk(_mutex);
+                _is_running = false;
+            }
+            _cv.notify_all();
+            for (auto &t: _threads) {
+                t.join();
+            }
+        }
+
+        /**
+         * @brief Enqueues job to be run on one of the pool threads.
+         *
+         * @param job Job to run.
+         */
+        void post(std::function<void()> job) override {
+            {
+                std::unique_lock lk(_mutex);
+                _jobs.push_back(std::move(job));
+            }
+            _cv.notify_one();
+        }
+
+        /**
+         * @brief Runs one pending job on the calling thread.
+         *
+         * @return False if there was nothing to run.
+         */
+        bool run_one() {
+            std::unique_lock lk(_mutex);
+            if (_jobs.empty()) {
+                return false;
+            }
+            auto job = std::move(_jobs.front());
+            _jobs.pop_front();
+            lk.unlock();
+            job();
+            return true;
+        }
+
+        /**
+         * @brief Runs pending jobs on the calling thread until done is set, sleeping while there are none.
+         *
+         * @param done Flag to stop at, whoever sets it must call wake() afterwards.
+         */
+        void run_until(const std::atomic_bool &done) {
+            std::unique_lock lk(_mutex);
+            while (true) {
+                _cv.wait(lk, [this, &done] { return !_jobs.empty() || done.load(std::memory_order_acquire); });
+                if (done.load(std::memory_order_acquire)) {
+                    return;
+                }
+                auto job = std::move(_jobs.front());
+                _jobs.pop_front();
+                lk.unlock();
+                job();
+                lk.lock();
+            }
+        }
+
+        /**
+         * @brief Wakes threads sleeping in run_until() so they recheck their flag.
+         */
+        void wake() {
+            // taking the lock orders the flag store before a sleeper's check
+            { std::unique_lock lk(_mutex); }
+            _cv.notify_all();
+        }
+
+        /**
+         * @brief Gets amount of jobs waiting to be run.
+         */
+        size_t get_queue_size() {
+            std::unique_lock lk(_mutex);
+            return _jobs.size();
+        }
+
+        /**
+         * @brief Gets amount of worker threads.
+         */
+        size_t get_threads_amount() const { return _threads.size(); }
+
+        /**
+         * @brief Gets pool which owns the calling thread.
+         *
+         * @return Pool pointer or nullptr if called outside of pool threads.
+         */
+        static Thread_pool *current() { return current_pool(); }
     };
 
+    namespace detail {
+        /**
+         * @brief Self destroying coroutine used to observe task completion from synchronous code.
+         */
+        struct Sync_wait_coroutine {
+            struct promise_type {
+                Sync_wait_coroutine get_return_object() { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() {}
+                void unhandled_exception() { std::terminate(); }
+            };
+        };
+
+        /**
+         * @brief Synchronisation state of one sync_wait call.
+         */
+        struct Sync_wait_state {
+            std::mutex mtx;
+            std::condition_variable cv;
+            std::atomic_bool done = false;
+            std::exception_ptr exception;
+            Thread_pool *pool = Thread_pool::current(); ///< Pool of the waiting thread, served while waiting.
+            /// Executor of the waiting foreign thread, served while waiting, nullptr if nothing was posted to it.
+            Foreign_thread_executor *foreign = pool ? nullptr : Foreign_thread_executor::find();
+
+            /**
+             * @brief Marks wait as finished. State lives on waiting thread stack, so it is not touched after
+             * the waiter may have seen done.
+             */
+            void finish() {
+                if (Thread_pool *p = pool) {
+                    done.store(true, std::memory_order_release);
+                    p->wake();
+                    return;
+                }
+                if (Foreign_thread_executor *f = foreign) {
+                    done.store(true, std::memory_order_release);
+                    f->wake();
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(mtx);
+                done = true;
+                cv.notify_one();
+            }
+
+            /**
+             * @brief Blocks until finish() is called.
+             *
+             * Jobs of the waiting thread keep being run while waiting, otherwise a task which needs them to
+             * resume could never finish.
+             */
+            void wait() {
+                if (pool) {
+                    pool->run_until(done);
+                } else if (foreign) {
+                    foreign->run_until(done);
+                } else {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [this] { return done.load(); });
+                }
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+            }
+        };
+
+        template<typename T>
+        Sync_wait_coroutine sync_wait_observer(Task<T> &task, Sync_wait_state &state, std::optional<T> &result) {
+            try {
+                result.emplace(co_await task);
+            } catch (...) {
+                state.exception = std::current_exception();
+            }
+            state.finish();
+        }
+
+        inline Sync_wait_coroutine sync_wait_observer(Task<void> &task, Sync_wait_state &state) {
+            try {
+                co_await task;
+            } catch (...) {
+                state.exception = std::current_exception();
+            }
+            state.finish();
+        }
+    } // namespace detail
+
     /**
      * @brief Synchronously waits for a coroutine task to complete and returns the
      * result.
      *
      * This function blocks the calling thread until the coroutine completes, making
      * it useful when you need to integrate coroutines into existing synchronous
-     * code.
+     * code. Exceptions thrown by the task are rethrown.
      *
      * @tparam T The type of the result returned by the task.
      * @param task The coroutine task to wait on.
@@ -179,33 +715,11 @@ namespace gb {
      */
     template<typename T>
     inline T sync_wait(Task<T> &task) { // Overload for lvalue reference
-        std::mutex mtx;
-        std::condition_variable cv;
+        detail::Sync_wait_state state;
         std::optional<T> result;
-        bool done = false;
-
-        auto handle = task.coro;
-
-        // If the coroutine is not already completed, set up a continuation
-        if (!handle.done()) {
-            handle.promise().continuation = [&]() {
-                {
-                    std::lock_guard<std::mutex> lock(mtx);
-                    done = true;
-                    result = std::move(handle.promise().result); ///< Store the result
-                }
-                cv.notify_one(); ///< Notify that the task is done
-            };
-
-            handle.resume(); ///< Resume the coroutine
-
-            std::unique_lock<std::mutex> lock(mtx);
-            cv.wait(lock, [&]() { return done; }); ///< Wait for the task to complete
-        } else {
-            result = std::move(handle.promise().result); ///< Task already completed
-        }
-
-        return result.value();
+        detail::sync_wait_observer(task, state, result);
+        state.wait();
+        return std::move(result.value());
     }
 
     template<typename T>
@@ -221,31 +735,58 @@ namespace gb {
      * @param task The coroutine task to wait on.
      */
     inline void sync_wait(Task<void> &task) { // Overload for lvalue reference
-        std::mutex mtx;
-        std::condition_variable cv;
-        bool done = false;
-
-        auto handle = task.coro;
+        detail::Sync_wait_state state;
+        detail::sync_wait_observer(task, state);
+        state.wait();
+    }
 
-        // If the coroutine is not already completed, set up a continuation
-        if (!handle.done()) {
-            handle.promise().continuation = [&]() {
-                {
-                    std::lock_guard<std::mutex> lock(mtx);
-                    done = true;
-                }
-                cv.notify_one(); ///< Notify that the task is done
-            };
+    inline void sync_wait(Task<void> &&task) { // Overload for rvalue reference
+        sync_wait(task); // Delegate to the lvalue overload
+    }
 
-            handle.resume(); ///< Resume the coroutine
+    /**
+     * @brief Awaits all tasks and collects their results.
+     *
+     * Tasks start running when they are created, so they already execute concurrently;
+     * this only joins them. Total wait is the longest task, not the sum.
+     *
+     * @tparam T Result type of the tasks.
+     * @param tasks Tasks to join.
+     * @return Results in the same order as the tasks.
+     */
+    template<typename T>
+    Task<std::vector<T>> when_all(std::vector<Task<T>> tasks) {
+        std::vector<T> results;
+        results.reserve(tasks.size());
+        for (auto &t: tasks) {
+            results.push_back(co_await t);
+        }
+        co_return results;
+    }
 
-            std::unique_lock<std::mutex> lock(mtx);
-            cv.wait(lock, [&]() { return done; }); ///< Wait for the task to complete
+    /**
+     * @brief Awaits all void tasks.
+     *
+     * @param tasks Tasks to join.
+     */
+    inline Task<void> when_all(std::vector<Task<void>> tasks) {
+        for (auto &t: tasks) {
+            co_await t;
         }
+        co_return;
     }
 
-    inline void sync_wait(Task<void> &&task) { // Overload for rvalue reference
-        sync_wait(task); // Delegate to the lvalue overload
+    /**
+     * @brief Awaits tasks of different result types and collects results into a tuple.
+     *
+     * @tparam Ts Result types of the tasks, void tasks are not supported.
+     * @param tasks Tasks to join.
+     * @return Tuple of results in argument order.
+     */
+    template<typename... Ts>
+    Task<std::tuple<Ts...>> when_all(Task<Ts>... tasks) {
+        static_assert((!std::is_void_v<Ts> && ...), "when_all with tuple result does not accept void tasks.");
+        co_return std::tuple<Ts...>{co_await tasks...};
     }
 
 
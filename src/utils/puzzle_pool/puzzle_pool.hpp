@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace gb {
+
+    /**
+     * @class Puzzle_pool
+     * @brief Keeps ready puzzles per difficulty level, refilled by low priority background workers.
+     *
+     * Games take a puzzle with take(), which is a queue pop when the level has one ready and otherwise serves
+     * the nearest ready level. Workers run at raised nice value on Linux, so refilling never competes with
+     * event handling. Generator reports the level it actually produced, so graded puzzles are stored under
+     * their real level; puzzles of levels which are already full are dropped.
+     *
+     * @tparam Puzzle Ready to play puzzle, must be movable.
+     */
+    template<typename Puzzle>
+    class Puzzle_pool {
+    public:
+        /// Generates puzzle, preferably of the wanted level, and returns its real level with it.
+        typedef std::function<std::pair<size_t, Puzzle>(size_t wanted_level)> generator_t;
+
+        /**
+         * @brief Counters of the pool.
+         */
+        struct Stats {
+            size_t ready; ///< Puzzles ready over all levels.
+            size_t hits; ///< Takes served from the wanted level.
+            size_t nearest; ///< Takes served from another level.
+            size_t misses; ///< Takes which had to generate, the pool was empty.
+            size_t generated; ///< Puzzles generated by workers.
+            size_t dropped; ///< Generated puzzles whose level was full.
+        };
+
+    private:
+        generator_t _generator; ///< Puzzle generator.
+        size_t _capacity; ///< Ready puzzles kept per level.
+
+        std::mutex _mutex; ///< Protects members below.
+        std::condition_variable _cv; ///< Wakes workers when a puzzle is taken or the pool stops.
+        std::vector<std::deque<Puzzle>> _levels; ///< Ready puzzles by level.
+        std::vector<size_t> _in_progress; ///< Generations running for every level.
+        bool _is_running = true; ///< False once pool is being destroyed.
+        std::vector<std::thread> _workers; ///< Refilling threads.
+
+        std::atomic_size_t _hits = 0; ///< Takes served from the wanted level.
+        std::atomic_size_t _nearest = 0; ///< Takes served from another level.
+        std::atomic_size_t _misses = 0; ///< Takes which had to generate.
+        std::atomic_size_t _generated = 0; ///< Puzzles generated by workers.
+        std::atomic_size_t _dropped = 0; ///< Generated puzzles whose level was full.
+
+        /**
+         * @brief Finds level with the most missing puzzles. Requires _mutex.
+         *
+         * @return Level, nullopt if all levels are full or being filled.
+         */
+        std::optional<size_t> find_missing_level() const {
+            std::optional<size_t> r;
+            size_t max_missing = 0;
+            for (size_t i = 0; i < _levels.size(); i++) {
+                size_t have = _levels[i].size() + _in_progress[i];
+                if (have < _capacity && _capacity - have > max_missing) {
+                    max_missing = _capacity - have;
+                    r = i;
+                }
+            }
+            return r;
+        }
+
+        /**
+         * @brief Finds ready level closest to the wanted one, easier one on a tie. Requires _mutex.
+         *
+         * @return Level, nullopt if no puzzle is ready.
+         */
+        std::optional<size_t> find_nearest_level(size_t level) const {
+            for (size_t distance = 0; distance < _levels.size() + level; distance++) {
+                if (distance <= level && level - distance < _levels.size() && !_levels[level - distance].empty()) {
+                    return level - distance;
+                }
+                if (level + distance < _levels.size() && !_levels[level + distance].empty()) {
+                    return level + distance;
+                }
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Stores generated puzzle if its level has room. Requires _mutex.
+         */
+        void store(size_t level, Puzzle &&puzzle) {
+            if (level < _levels.size() && _levels[level].size() < _capacity) {
+                _levels[level].push_back(std::move(puzzle));
+            } else {
+                _dropped++;
+            }
+        }
+
+        /**
+         * @brief Worker thread main loop.
+         */
+        void worker() {
+#ifdef __linux__
+            // nice value is per thread on Linux, 0 refers to the calling thread; elsewhere it is per process
+            setpriority(PRIO_PROCESS, 0, 10);
+#endif
+            std::unique_lock lk(_mutex);
+            while (true) {
+                std::optional<size_t> level;
+                _cv.wait(lk, [this, &level] {
+                    level = find_missing_level();
+                    return !_is_running || level;
+                });
+                if (!_is_running) {
+                    break;
+                }
+                _in_progress[*level]++;
+                lk.unlock();
+                std::optional<std::pair<size_t, Puzzle>> generated;
+                try {
+                    generated.emplace(_generator(*level));
+                }
+                catch (...) {
+                }
+                lk.lock();
+                _in_progress[*level]--;
+                if (generated) {
+                    _generated++;
+                    store(generated->first, std::move(generated->second));
+                }
+            }
+        }
+
+    public:
+        /**
+         * @brief Starts the pool, workers fill it right away.
+         *
+         * @param levels_amount Amount of difficulty levels.
+         * @param capacity Ready puzzles kept per level.
+         * @param workers_amount Amount of refilling threads.
+         * @param generator Puzzle generator, called concurrently from workers and take().
+         */
+        Puzzle_pool(size_t levels_amount, size_t capacity, size_t workers_amount, generator_t generator) :
+            _generator(std::move(generator)), _capacity(capacity), _levels(levels_amount),
+            _in_progress(levels_amount, 0) {
+            _workers.reserve(workers_amount);
+            for (size_t i = 0; i < workers_amount; i++) {
+                _workers.emplace_back([this] { worker(); });
+            }
+        }
+
+        Puzzle_pool(const Puzzle_pool &) = delete;
+        Puzzle_pool &operator=(const Puzzle_pool &) = delete;
+
+        /**
+         * @brief Stops workers, waiting for generations in progress.
+         */
+        ~Puzzle_pool() {
+            {
+                std::unique_lock lk(_mutex);
+                _is_running = false;
+            }
+            _cv.notify_all();
+            for (auto &t: _workers) {
+                t.join();
+            }
+        }
+
+        /**
+         * @brief Takes puzzle of the level, or of the nearest level which has one ready.
+         *
+         * Only when the whole pool is empty one puzzle is generated on the calling thread, its level is
+         * whatever the generator produced.
+         *
+         * @param level Difficulty level.
+         * @return Puzzle.
+         */
+        Puzzle take(size_t level) {
+            {
+                std::unique_lock lk(_mutex);
+                if (std::optional<size_t> ready = find_nearest_level(level)) {
+                    Puzzle r = std::move(_levels[*ready].front());
+                    _levels[*ready].pop_front();
+                    lk.unlock();
+                    (*ready == level ? _hits : _nearest)++;
+                    _cv.notify_one();
+                    return r;
+                }
+            }
+            _misses++;
+            Puzzle r = std::move(_generator(level).second);
+            _cv.notify_one();
+            return r;
+        }
+
+        /**
+         * @brief Gets pool counters.
+         *
+         * @return Stats.
+         */
+        Stats get_stats() {
+            size_t ready = 0;
+            {
+                std::unique_lock lk(_mutex);
+                for (auto &i: _levels) {
+                    ready += i.size();
+                }
+            }
+            return {ready, _hits, _nearest, _misses, _generated, _dropped};
+        }
+    };
+
+} // namespace gb
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace gb {
+
+    /**
+     * @class Timer_wheel
+     * @brief Hierarchical timer wheel with one second resolution.
+     *
+     * Timers are kept in 4 levels of 64 slots, level k slot covering 64^k seconds, so adding and cancelling a
+     * timer is O(1) for any timeout up to ~194 days (longer ones are rescheduled on their way down). tick()
+     * must be called once a second: it moves timers of the next level down when a level wraps and fires
+     * the whole due slot as one batch, callbacks run on the ticking thread without the wheel lock held.
+     */
+    class Timer_wheel {
+        static constexpr size_t level_bits = 6; ///< log2 of slots per level.
+        static constexpr size_t slots_amount = 1 << level_bits; ///< Slots per level.
+        static constexpr size_t levels_amount = 4; ///< Amount of levels.
+
+        /**
+         * @brief Scheduled timer.
+         */
+        struct Timer {
+            uint64_t expires; ///< Tick at which the timer fires.
+            std::function<void()> callback; ///< Called when the timer fires.
+            size_t level; ///< Level the timer is in.
+            size_t slot; ///< Slot the timer is in.
+            std::list<std::shared_ptr<Timer>>::iterator position; ///< Position in the slot.
+            bool is_active = true; ///< Not fired and not cancelled.
+        };
+
+        typedef std::list<std::shared_ptr<Timer>> Slot; ///< Timers of one slot.
+
+        std::mutex _mutex; ///< Protects all members below.
+        std::array<std::array<Slot, slots_amount>, levels_amount> _levels; ///< Timers by level and slot.
+        uint64_t _now = 0; ///< Ticks since the wheel was created.
+        std::atomic_size_t _size = 0; ///< Amount of active timers.
+
+        /**
+         * @brief Puts timer into the slot matching its expiry. Requires _mutex.
+         */
+        void place(const std::shared_ptr<Timer> &timer) {
+            uint64_t delta = timer->expires > _now ? timer->expires - _now : 0;
+            size_t level = 0;
+            while (level + 1 < levels_amount && delta >= (uint64_t(1) << (level_bits * (level + 1)))) {
+                level++;
+            }
+            timer->level = level;
+            timer->slot = (timer->expires >> (level_bits * level)) & (slots_amount - 1);
+            Slot &slot = _levels[level][timer->slot];
+            slot.push_front(timer);
+            timer->position = slot.begin();
+        }
+
+        /**
+         * @brief Moves all timers of the slot to lower levels. Requires _mutex.
+         */
+        void cascade(size_t level, size_t slot_index) {
+            Slot slot = std::move(_levels[level][slot_index]);
+            _levels[level][slot_index].clear();
+            for (auto &timer: slot) {
+                place(timer);
+            }
+        }
+
+    public:
+        /**
+         * @brief Handle of scheduled timer, used to cancel it. Default constructed handle refers to no timer.
+         */
+        class Handle {
+            friend class Timer_wheel;
+            std::weak_ptr<Timer> _timer; ///< Timer, expired once it fired or was cancelled.
+        };
+
+        /**
+         * @brief Schedules callback.
+         *
+         * @param timeout Seconds until callback is called, it is called on the first tick for timeouts below 1.
+         * @param callback Function to call, runs on the thread calling tick().
+         * @return Handle to cancel the timer.
+         */
+        Handle add(time_t timeout, std::function<void()> callback) {
+            auto timer = std::make_shared<Timer>();
+            timer->callback = std::move(callback);
+            Handle handle;
+            handle._timer = timer;
+            std::unique_lock lk(_mutex);
+            timer->expires = _now + std::max<time_t>(timeout, 1);
+            place(timer);
+            _size++;
+            return handle;
+        }
+
+        /**
+         * @brief Cancels timer.
+         *
+         * @param handle Handle returned by add.
+         * @return True if timer was cancelled, false if it already fired, is firing or was cancelled before.
+         */
+        bool cancel(const Handle &handle) {
+            auto timer = handle._timer.lock();
+            if (!timer) {
+                return false;
+            }
+            std::unique_lock lk(_mutex);
+            if (!timer->is_active) {
+                return false;
+            }
+            timer->is_active = false;
+            _levels[timer->level][timer->slot].erase(timer->position);
+            _size--;
+            return true;
+        }
+
+        /**
+         * @brief Advances the wheel by one second and fires due timers.
+         */
+        void tick() {
+            Slot due;
+            {
+                std::unique_lock lk(_mutex);
+                _now++;
+                // when a level wraps, the next slot of the level above is spread over the levels below
+                for (size_t level = 1; level < levels_amount; level++) {
+                    if (_now & ((uint64_t(1) << (level_bits * level)) - 1)) {
+                        break;
+                    }
+                    cascade(level, (_now >> (level_bits * level)) & (slots_amount - 1));
+                }
+                due = std::move(_levels[0][_now & (slots_amount - 1)]);
+                _levels[0][_now & (slots_amount - 1)].clear();
+                for (auto &timer: due) {
+                    timer->is_active = false;
+                }
+                _size -= due.size();
+            }
+            for (auto &timer: due) {
+                timer->callback();
+            }
+        }
+
+        /**
+         * @brief Gets amount of scheduled timers.
+         *
+         * @return Amount of timers which did not fire and were not cancelled.
+         */
+        size_t size() const { return _size; }
+    };
+
+} // namespace gb
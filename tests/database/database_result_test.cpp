@@ -0,0 +1,42 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/modules/database/database.hpp>
+
+using namespace gb;
+
+namespace {
+
+    /**
+     * @brief Builds result of one STRING column with one row.
+     */
+    Database_result string_result(std::string_view value) {
+        Database_result result;
+        result.add_column("value", Database_result::Column_type::STRING);
+        result.push_string(0, value);
+        result.finish_row();
+        return result;
+    }
+
+} // namespace
+
+TEST(Database_result, ParsesWholeNumbers) {
+    EXPECT_EQ(string_result("-12").get_int64(0, 0), -12);
+    EXPECT_EQ(string_result("18446744073709551615").get_uint64(0, 0), 18446744073709551615ull);
+    EXPECT_DOUBLE_EQ(string_result("1.5").get_double(0, 0), 1.5);
+}
+
+TEST(Database_result, RejectsTrailingCharacters) {
+    EXPECT_THROW(string_result("12abc").get_int64(0, 0), std::runtime_error);
+    EXPECT_THROW(string_result("1.5").get_int64(0, 0), std::runtime_error);
+    EXPECT_THROW(string_result("1.5").get_uint64(0, 0), std::runtime_error);
+    EXPECT_THROW(string_result("1.5x").get_double(0, 0), std::runtime_error);
+}
+
+TEST(Database_result, RejectsEmptyAndNonNumbers) {
+    EXPECT_THROW(string_result("").get_int64(0, 0), std::runtime_error);
+    EXPECT_THROW(string_result("abc").get_uint64(0, 0), std::runtime_error);
+}
@@ -0,0 +1,97 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/modules/discord/discord_games/game_snapshot.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using gb::Game_snapshot_reader;
+using gb::Game_snapshot_writer;
+
+TEST(Game_snapshot, VarintRoundTrip) {
+    std::vector<uint64_t> values = {0, 1, 127, 128, 300, 16383, 16384, uint64_t(1) << 35,
+                                    std::numeric_limits<uint64_t>::max()};
+    Game_snapshot_writer writer;
+    for (uint64_t v: values) {
+        writer.write_varint(v);
+    }
+    std::string data = writer.release();
+    Game_snapshot_reader reader(data);
+    for (uint64_t v: values) {
+        EXPECT_EQ(reader.read_varint(), v);
+    }
+    EXPECT_TRUE(reader.is_finished());
+}
+
+TEST(Game_snapshot, SmallValuesTakeOneByte) {
+    Game_snapshot_writer writer;
+    writer.write_varint(127);
+    writer.write_signed(-64);
+    writer.write_signed(63);
+    EXPECT_EQ(writer.data().size(), 3u);
+}
+
+TEST(Game_snapshot, SignedRoundTrip) {
+    std::vector<int64_t> values = {0, -1, 1, -64, 64, -1000000, std::numeric_limits<int64_t>::min(),
+                                   std::numeric_limits<int64_t>::max()};
+    Game_snapshot_writer writer;
+    for (int64_t v: values) {
+        writer.write_signed(v);
+    }
+    std::string data = writer.release();
+    Game_snapshot_reader reader(data);
+    for (int64_t v: values) {
+        EXPECT_EQ(reader.read_signed(), v);
+    }
+    EXPECT_TRUE(reader.is_finished());
+}
+
+TEST(Game_snapshot, MixedFieldsRoundTrip) {
+    std::string binary("a\0b\xff", 4);
+    Game_snapshot_writer writer;
+    writer.write_raw("GB");
+    writer.write_varint(1);
+    writer.write_string(binary);
+    writer.write_string("");
+    writer.write_signed(-5);
+    std::string data = writer.release();
+
+    Game_snapshot_reader reader(data);
+    EXPECT_EQ(reader.read_raw(2), "GB");
+    EXPECT_EQ(reader.read_varint(), 1u);
+    EXPECT_EQ(reader.read_string(), binary);
+    EXPECT_EQ(reader.read_string(), "");
+    EXPECT_EQ(reader.read_signed(), -5);
+    EXPECT_TRUE(reader.is_finished());
+}
+
+TEST(Game_snapshot, TruncatedDataThrows) {
+    Game_snapshot_writer writer;
+    writer.write_string("hello");
+    writer.write_varint(uint64_t(1) << 40);
+    std::string data = writer.release();
+    for (size_t size = 0; size < data.size(); size++) {
+        std::string part = data.substr(0, size);
+        Game_snapshot_reader reader(part);
+        EXPECT_THROW(
+            {
+                reader.read_string();
+                reader.read_varint();
+            },
+            std::runtime_error)
+            << "size " << size;
+    }
+}
+
+TEST(Game_snapshot, OverlongVarintThrows) {
+    std::string data(11, '\x80');
+    Game_snapshot_reader reader(data);
+    EXPECT_THROW(reader.read_varint(), std::runtime_error);
+}
@@ -0,0 +1,76 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/games/chess_engine/chess_engine.hpp>
+
+using chess_engine::Chess_engine;
+
+namespace {
+
+    /**
+     * @brief Searches position with a deadline far enough for the search to end by itself.
+     */
+    chess_engine::Search_result search(const std::string &fen) {
+        static Chess_engine engine(16);
+        std::atomic_bool cancel = false;
+        return engine.search(chess::Board(fen), std::chrono::steady_clock::now() + std::chrono::seconds(30), cancel);
+    }
+
+} // namespace
+
+TEST(Chess_engine, FindsMateInOne) {
+    auto result = search("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    ASSERT_TRUE(result.move);
+    EXPECT_EQ(result.move->uci(), "a1a8");
+    EXPECT_EQ(result.score, Chess_engine::mate_score - 1);
+}
+
+TEST(Chess_engine, FindsMateInTwo) {
+    // 1. Kb6 Kb8 2. Rh8#
+    auto result = search("k7/8/2K5/8/8/8/8/7R w - - 0 1");
+    ASSERT_TRUE(result.move);
+    EXPECT_EQ(result.score, Chess_engine::mate_score - 3);
+}
+
+TEST(Chess_engine, MatedSideHasNoMove) {
+    auto result = search("R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1");
+    EXPECT_FALSE(result.move);
+    EXPECT_FALSE(result.is_cancelled);
+}
+
+TEST(Chess_engine, CancelledSearchReportsIt) {
+    Chess_engine engine(10);
+    std::atomic_bool cancel = true;
+    auto result = engine.search(chess::Board(), std::chrono::steady_clock::now() + std::chrono::seconds(30), cancel);
+    // cancel flag is checked every 1024 nodes, the shallow depths may still finish
+    EXPECT_TRUE(result.is_cancelled);
+    EXPECT_TRUE(result.move);
+}
+
+TEST(Chess_engine, KeyDependsOnCastlingRights) {
+    EXPECT_NE(Chess_engine::get_key(chess::Board("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1")),
+              Chess_engine::get_key(chess::Board("r3k2r/8/8/8/8/8/8/R3K2R w - - 0 1")));
+    EXPECT_NE(Chess_engine::get_key(chess::Board("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1")),
+              Chess_engine::get_key(chess::Board("r3k2r/8/8/8/8/8/8/R3K2R w Qkq - 0 1")));
+}
+
+TEST(Chess_engine, KeyDependsOnEnPassantSquare) {
+    EXPECT_NE(Chess_engine::get_key(chess::Board("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3")),
+              Chess_engine::get_key(chess::Board("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq - 0 3")));
+}
+
+TEST(Chess_engine, KeyDependsOnSideToMove) {
+    EXPECT_NE(Chess_engine::get_key(chess::Board("4k3/8/8/8/8/8/8/4K3 w - - 0 1")),
+              Chess_engine::get_key(chess::Board("4k3/8/8/8/8/8/8/4K3 b - - 0 1")));
+}
+
+TEST(Chess_engine, TranspositionsShareKey) {
+    chess::Board board;
+    for (const char *uci: {"g1f3", "g8f6", "f3g1", "f6g8"}) {
+        board.push(chess::Move::from_uci(uci));
+    }
+    EXPECT_EQ(Chess_engine::get_key(board), Chess_engine::get_key(chess::Board()));
+}
@@ -0,0 +1,102 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/games/connect_four/connect_four.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <string_view>
+
+using connect_four::Connect_four;
+using connect_four::Connect_four_solver;
+
+namespace {
+
+    /**
+     * @brief Plays columns given as digits.
+     */
+    Connect_four play(std::string_view moves) {
+        Connect_four board;
+        for (char c: moves) {
+            board.play(c - '0');
+        }
+        return board;
+    }
+
+    constexpr std::chrono::milliseconds budget{200};
+
+} // namespace
+
+TEST(Connect_four, DetectsFourInEveryDirection) {
+    EXPECT_TRUE(play("0101010").is_won()); // vertical
+    EXPECT_TRUE(play("0011223").is_won()); // horizontal
+    EXPECT_FALSE(play("0112322353").is_won());
+    EXPECT_TRUE(play("01123223533").is_won()); // diagonal up to the right
+    EXPECT_TRUE(play("65543443133").is_won()); // diagonal up to the left
+    EXPECT_FALSE(play("001122").is_won());
+}
+
+TEST(Connect_four, FindsWinningMoves) {
+    Connect_four board = play("001122");
+    EXPECT_TRUE(board.is_winning_move(3));
+    EXPECT_FALSE(board.is_winning_move(4));
+    EXPECT_FALSE(board.is_winning_move(0));
+}
+
+TEST(Connect_four, RejectsFullAndInvalidColumns) {
+    Connect_four board = play("000000");
+    EXPECT_FALSE(board.can_play(0));
+    EXPECT_THROW(board.play(0), std::invalid_argument);
+    EXPECT_THROW(board.play(7), std::invalid_argument);
+    EXPECT_THROW(board.play(-1), std::invalid_argument);
+}
+
+TEST(Connect_four, CellsAreShownFromTheTop) {
+    Connect_four board = play("334");
+    EXPECT_EQ(board.get_cell(5, 3), 1);
+    EXPECT_EQ(board.get_cell(4, 3), 2);
+    EXPECT_EQ(board.get_cell(5, 4), 1);
+    EXPECT_EQ(board.get_cell(3, 3), 0);
+    EXPECT_EQ(board.get_cell(5, 0), 0);
+}
+
+TEST(Connect_four, FullBoardWithoutFour) {
+    Connect_four board = play("646230021662464536151305212023541143543500");
+    EXPECT_TRUE(board.is_full());
+    EXPECT_FALSE(board.is_won());
+}
+
+TEST(Connect_four_solver, TakesImmediateWin) {
+    Connect_four_solver solver;
+    EXPECT_EQ(solver.best_move(play("001122"), budget), 3);
+}
+
+TEST(Connect_four_solver, BlocksImmediateLoss) {
+    // second player to move, first threatens 0 1 2 _ on the bottom row
+    Connect_four_solver solver;
+    EXPECT_EQ(solver.best_move(play("05162"), budget), 3);
+}
+
+TEST(Connect_four_solver, MakesDoubleThreat) {
+    // first player has bottom 2 and 3 with both sides open, extending to three wins by force
+    Connect_four_solver solver;
+    int move = solver.best_move(play("2233"), budget);
+    EXPECT_TRUE(move == 1 || move == 4) << move;
+}
+
+TEST(Connect_four_solver, AvoidsMoveLettingOpponentWinAbove) {
+    // first player threatens row 1 of column 4, second player must not fill the bottom cell under it
+    Connect_four board = play("62352133510");
+    Connect_four_solver solver;
+    int move = solver.best_move(board, budget);
+    Connect_four after = board;
+    after.play(move);
+    for (int col = 0; col < connect_four::width; col++) {
+        if (after.can_play(col)) {
+            EXPECT_FALSE(after.is_winning_move(col)) << "move " << move << " lets " << col << " win";
+        }
+    }
+}
@@ -0,0 +1,143 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/games/sudoku/sudoku_solver.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string_view>
+
+using sudoku::Sudoku_solver;
+
+namespace {
+
+    constexpr std::array<int, 9> ascending = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    /**
+     * @brief Builds solver from 81 characters, '.' for empty cells.
+     */
+    Sudoku_solver parse(std::string_view grid) {
+        Sudoku_solver s;
+        for (int cell = 0; cell < 81; cell++) {
+            if (grid[cell] != '.') {
+                s.set(cell, grid[cell] - '0');
+            }
+        }
+        return s;
+    }
+
+    std::string to_string(const Sudoku_solver &s) {
+        std::string r;
+        for (int cell = 0; cell < 81; cell++) {
+            r += s.get(cell) ? char('0' + s.get(cell)) : '.';
+        }
+        return r;
+    }
+
+    /**
+     * @brief Checks that every row, column and box holds every digit once.
+     */
+    bool is_valid_solution(const Sudoku_solver &s) {
+        for (int i = 0; i < 9; i++) {
+            uint16_t row = 0, col = 0, box = 0;
+            for (int j = 0; j < 9; j++) {
+                row |= uint16_t(1) << s.get(i * 9 + j);
+                col |= uint16_t(1) << s.get(j * 9 + i);
+                box |= uint16_t(1) << s.get((i / 3 * 3 + j / 3) * 9 + i % 3 * 3 + j % 3);
+            }
+            if (row != 0x3FE || col != 0x3FE || box != 0x3FE) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // puzzle from Wikipedia's sudoku article, solvable by singles alone
+    constexpr std::string_view easy = "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+    constexpr std::string_view easy_solution =
+        "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+
+    // Arto Inkala's puzzle, needs guessing
+    constexpr std::string_view hard = "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..";
+    constexpr std::string_view hard_solution =
+        "812753649943682175675491283154237896369845721287169534521974368438526917796318452";
+
+} // namespace
+
+TEST(Sudoku_solver, SolvesKnownPuzzles) {
+    for (auto [puzzle, solution]: {std::pair{easy, easy_solution}, std::pair{hard, hard_solution}}) {
+        Sudoku_solver s = parse(puzzle);
+        ASSERT_TRUE(s.solve(ascending));
+        EXPECT_EQ(to_string(s), solution);
+    }
+}
+
+TEST(Sudoku_solver, CountsSolutions) {
+    EXPECT_EQ(parse(easy).count_solutions(2), 1);
+    EXPECT_EQ(parse(hard).count_solutions(2), 1);
+    EXPECT_EQ(Sudoku_solver().count_solutions(2), 2);
+    EXPECT_EQ(Sudoku_solver().count_solutions(5), 5);
+}
+
+TEST(Sudoku_solver, UnsolvableGridIsLeftUnchanged) {
+    // every digit but 9 in the first row, 9 already in the last column
+    std::string grid(81, '.');
+    grid.replace(0, 8, "12345678");
+    grid[9 * 5 + 8] = '9';
+    Sudoku_solver s = parse(grid);
+    EXPECT_EQ(s.count_solutions(2), 0);
+    EXPECT_FALSE(s.solve(ascending));
+    EXPECT_EQ(to_string(s), grid);
+}
+
+TEST(Sudoku_solver, CandidatesExcludeRowColumnAndBox) {
+    Sudoku_solver s = parse(easy);
+    // cell (0, 2): row has 5 3 7, column has 8, box has 5 3 6 9 8
+    EXPECT_EQ(s.candidates(2), (1 << 0) | (1 << 1) | (1 << 3));
+    s.clear(0);
+    EXPECT_EQ(s.get(0), 0);
+    EXPECT_TRUE(s.candidates(2) & (1 << 4));
+}
+
+TEST(Sudoku_solver, RandomOrdersGiveValidGrids) {
+    std::mt19937 rng(42);
+    std::array<int, 9> order = ascending;
+    for (int i = 0; i < 20; i++) {
+        std::shuffle(order.begin(), order.end(), rng);
+        Sudoku_solver s;
+        ASSERT_TRUE(s.solve(order));
+        EXPECT_TRUE(is_valid_solution(s));
+    }
+}
+
+TEST(Sudoku_solver, OtherSolutionMatchesCount) {
+    Sudoku_solver solved = parse(easy_solution);
+    Sudoku_solver puzzle = parse(easy);
+    for (int cell = 0; cell < 81; cell++) {
+        if (puzzle.get(cell)) {
+            continue;
+        }
+        // puzzle has one solution, so removing a solution digit keeps it unique
+        EXPECT_FALSE(puzzle.has_other_solution(cell, solved.get(cell))) << "cell " << cell;
+    }
+    // a nearly empty grid has many solutions whatever the cell holds
+    Sudoku_solver sparse = parse(easy);
+    for (int cell = 9; cell < 81; cell++) {
+        sparse.clear(cell);
+    }
+    EXPECT_TRUE(sparse.has_other_solution(9, 6));
+}
+
+TEST(Sudoku_solver, GradesGuessingOnly) {
+    std::array<uint8_t, 81> easy_cells{}, hard_cells{};
+    for (int cell = 0; cell < 81; cell++) {
+        easy_cells[cell] = easy_solution[cell] - '0';
+        hard_cells[cell] = hard_solution[cell] - '0';
+    }
+    EXPECT_EQ(parse(easy).grade(easy_cells), 0);
+    EXPECT_GT(parse(hard).grade(hard_cells), 0);
+}
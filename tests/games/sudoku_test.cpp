@@ -0,0 +1,69 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/games/sudoku/sudoku.hpp>
+
+using sudoku::Sudoku;
+
+namespace {
+
+    Sudoku generate() {
+        Sudoku engine;
+        engine.create_seed();
+        engine.gen_puzzle();
+        return engine;
+    }
+
+} // namespace
+
+TEST(Sudoku, RestoreKeepsGridAndSolution) {
+    Sudoku engine = generate();
+    Sudoku restored;
+    ASSERT_TRUE(restored.restore(engine.get_field(), engine.get_solution_field()));
+    EXPECT_EQ(restored.get_field(), engine.get_field());
+    EXPECT_EQ(restored.get_solution_field(), engine.get_solution_field());
+    restored.end_game();
+    EXPECT_TRUE(restored.check_win());
+    EXPECT_EQ(restored.get_field(), engine.get_solution_field());
+}
+
+TEST(Sudoku, RestoredGameChecksPlacedNumbers) {
+    Sudoku engine = generate();
+    auto field = engine.get_field();
+    auto solution = engine.get_solution_field();
+    Sudoku restored;
+    ASSERT_TRUE(restored.restore(field, solution));
+    for (int x = 0; x < 9; x++) {
+        for (int y = 0; y < 9; y++) {
+            if (!field[x][y]) {
+                EXPECT_FALSE(restored.place({x, y}, solution[x][y] % 9 + 1));
+                EXPECT_TRUE(restored.place({x, y}, solution[x][y]));
+                return;
+            }
+        }
+    }
+    FAIL() << "generated puzzle has no empty cell";
+}
+
+TEST(Sudoku, RestoreRejectsInconsistentGrids) {
+    Sudoku engine = generate();
+    auto field = engine.get_field();
+    auto solution = engine.get_solution_field();
+    Sudoku restored;
+    ASSERT_TRUE(restored.restore(field, solution));
+
+    auto wrong_field = field;
+    wrong_field[4][4] = solution[4][4] % 9 + 1;
+    EXPECT_FALSE(restored.restore(wrong_field, solution));
+    auto empty_solution = solution;
+    empty_solution[0][0] = 0;
+    EXPECT_FALSE(restored.restore(field, empty_solution));
+    auto out_of_range = field;
+    out_of_range[8][8] = 10;
+    EXPECT_FALSE(restored.restore(out_of_range, solution));
+    // rejected grids leave the game as it was
+    EXPECT_EQ(restored.get_field(), field);
+}
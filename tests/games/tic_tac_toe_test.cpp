@@ -0,0 +1,84 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/games/tic_tac_toe/tic_tac_toe.hpp>
+
+#include <string_view>
+
+using namespace tic_tac_toe;
+
+namespace {
+
+    /**
+     * @brief Builds position index from 9 characters in row-major order, '.' for empty cells.
+     */
+    int position_of(std::string_view cells) {
+        int position = 0;
+        for (int i = 0; i < 9; i++) {
+            position += (cells[i] == 'X' ? X : cells[i] == 'O' ? O : EMPTY) * cell_weights[i];
+        }
+        return position;
+    }
+
+    /**
+     * @brief Plays the game out with both sides following the table.
+     *
+     * @return Winner, EMPTY for a draw.
+     */
+    CELL play_out(int position) {
+        int stone = X;
+        for (int i = 0; i < 9; i++) {
+            stone = get_cell(position, i) == EMPTY ? stone : stone == X ? O : X;
+        }
+        while (get_winner(position) == EMPTY && get_best_move(position) >= 0) {
+            int x = 0, o = 0;
+            for (int i = 0; i < 9; i++) {
+                x += get_cell(position, i) == X;
+                o += get_cell(position, i) == O;
+            }
+            position += (x == o ? X : O) * cell_weights[get_best_move(position)];
+        }
+        return get_winner(position);
+    }
+
+} // namespace
+
+TEST(Tic_tac_toe, DetectsWinner) {
+    EXPECT_EQ(get_winner(position_of("XXXOO....")), X);
+    EXPECT_EQ(get_winner(position_of("XO.XO.X..")), X);
+    EXPECT_EQ(get_winner(position_of("OX.XO.X.O")), O);
+    EXPECT_EQ(get_winner(position_of("X.O.OXO..")), O);
+    EXPECT_EQ(get_winner(position_of("XOXXOOOXX")), EMPTY);
+}
+
+TEST(Tic_tac_toe, PerfectPlayIsADraw) {
+    EXPECT_EQ(table.scores[0], 0);
+    EXPECT_EQ(play_out(0), EMPTY);
+}
+
+TEST(Tic_tac_toe, TakesWin) {
+    // X to move with two in the top row
+    EXPECT_EQ(get_best_move(position_of("XX.OO....")), 2);
+    // O to move, completing the middle column wins at once and beats blocking the top row
+    EXPECT_EQ(get_best_move(position_of("X.X.O.XO.")), 1);
+}
+
+TEST(Tic_tac_toe, BlocksLoss) {
+    // O to move, X threatens the top row
+    EXPECT_EQ(get_best_move(position_of("XX..O....")), 2);
+}
+
+TEST(Tic_tac_toe, AnswersCornerOpeningInTheCenter) {
+    // every other answer to a corner opening loses, scores are for the player to move
+    EXPECT_EQ(get_best_move(position_of("X........")), 4);
+    EXPECT_GT(table.scores[position_of("X.......O")], 0);
+    EXPECT_EQ(table.scores[position_of("X...O....")], 0);
+}
+
+TEST(Tic_tac_toe, FinishedPositionsHaveNoMove) {
+    EXPECT_EQ(get_best_move(position_of("XXXOO....")), -1);
+    EXPECT_EQ(get_best_move(position_of("XOXXOOOXX")), -1);
+}
@@ -0,0 +1,159 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/modules/image_processing/image_blit.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace gb;
+
+namespace {
+
+    using Blend_row_t = void (*)(const uint8_t *, uint8_t *, size_t);
+
+    /**
+     * @brief Random row of premultiplied source and straight alpha destination pixels.
+     */
+    struct Row {
+        std::vector<uint8_t> src;
+        std::vector<uint8_t> dst;
+    };
+
+    /**
+     * @brief Picks alpha, often one of the special values 0 and 255.
+     */
+    uint8_t random_alpha(std::mt19937 &rng, int opaque_percent) {
+        int kind = static_cast<int>(rng() % 100);
+        if (kind < opaque_percent) {
+            return 255;
+        }
+        if (kind < opaque_percent + 15) {
+            return 0;
+        }
+        return static_cast<uint8_t>(rng());
+    }
+
+    /**
+     * @brief Generates row, destination pixels are opaque with given probability, otherwise translucent or clear.
+     */
+    Row random_row(std::mt19937 &rng, size_t pixels, int dst_opaque_percent) {
+        Row row{std::vector<uint8_t>(pixels * 4), std::vector<uint8_t>(pixels * 4)};
+        for (size_t i = 0; i < pixels; i++) {
+            for (int c = 0; c < 3; c++) {
+                row.src[i * 4 + c] = static_cast<uint8_t>(rng());
+                row.dst[i * 4 + c] = static_cast<uint8_t>(rng());
+            }
+            row.src[i * 4 + 3] = random_alpha(rng, 30);
+            row.dst[i * 4 + 3] = random_alpha(rng, dst_opaque_percent);
+        }
+        premultiply_row(row.src.data(), row.src.data(), pixels);
+        return row;
+    }
+
+    /**
+     * @brief Checks blended row against "source over" computed in floating point.
+     *
+     * Colors are compared premultiplied, unpremultiplying a nearly clear pixel magnifies rounding beyond meaning.
+     */
+    void expect_matches_reference(const Row &row, const std::vector<uint8_t> &result) {
+        for (size_t i = 0; i < row.src.size() / 4; i++) {
+            const uint8_t *s = &row.src[i * 4];
+            const uint8_t *d = &row.dst[i * 4];
+            const uint8_t *r = &result[i * 4];
+            double sa = s[3] / 255.0;
+            double da = d[3] / 255.0;
+            double alpha = sa + da * (1 - sa);
+            EXPECT_NEAR(r[3], alpha * 255, 1.0) << "pixel " << i;
+            for (int c = 0; c < 3; c++) {
+                double premultiplied = s[c] + d[c] * da * (1 - sa);
+                EXPECT_NEAR(r[c] * r[3] / 255.0, premultiplied, 2.0) << "pixel " << i << " channel " << c;
+            }
+        }
+    }
+
+    /**
+     * @brief Blends random rows with the path and compares them with the reference and the scalar path.
+     */
+    void check_path(Blend_row_t blend_row, int dst_opaque_percent) {
+        std::mt19937 rng(1234);
+        for (size_t pixels = 0; pixels <= 37; pixels++) {
+            for (int repeat = 0; repeat < 20; repeat++) {
+                Row row = random_row(rng, pixels, dst_opaque_percent);
+                std::vector<uint8_t> result = row.dst;
+                blend_row(row.src.data(), result.data(), pixels);
+                expect_matches_reference(row, result);
+                std::vector<uint8_t> scalar = row.dst;
+                detail::blend_row_scalar(row.src.data(), scalar.data(), pixels);
+                EXPECT_EQ(result, scalar) << "row of " << pixels << " pixels";
+            }
+        }
+    }
+
+} // namespace
+
+TEST(Image_blit, ScalarOverOpaqueDestination) { check_path(detail::blend_row_scalar, 100); }
+
+TEST(Image_blit, ScalarOverTranslucentDestination) { check_path(detail::blend_row_scalar, 40); }
+
+#if defined(__x86_64__) || defined(__i386__)
+TEST(Image_blit, Sse2OverOpaqueDestination) {
+    if (!__builtin_cpu_supports("sse2")) {
+        GTEST_SKIP() << "CPU has no SSE2";
+    }
+    check_path(detail::blend_row_sse2, 100);
+}
+
+TEST(Image_blit, Sse2OverTranslucentDestination) {
+    if (!__builtin_cpu_supports("sse2")) {
+        GTEST_SKIP() << "CPU has no SSE2";
+    }
+    check_path(detail::blend_row_sse2, 40);
+}
+
+TEST(Image_blit, Avx2OverOpaqueDestination) {
+    if (!__builtin_cpu_supports("avx2")) {
+        GTEST_SKIP() << "CPU has no AVX2";
+    }
+    check_path(detail::blend_row_avx2, 100);
+}
+
+TEST(Image_blit, Avx2OverTranslucentDestination) {
+    if (!__builtin_cpu_supports("avx2")) {
+        GTEST_SKIP() << "CPU has no AVX2";
+    }
+    check_path(detail::blend_row_avx2, 40);
+}
+#endif
+
+TEST(Image_blit, DispatchedPathMatchesScalar) { check_path(blend_premultiplied_row, 70); }
+
+TEST(Image_blit, PremultiplyKeepsAlpha) {
+    uint8_t pixels[] = {200, 100, 50, 0, 200, 100, 50, 255, 200, 100, 50, 128};
+    premultiply_row(pixels, pixels, 3);
+    EXPECT_EQ(std::vector<uint8_t>(pixels, pixels + 12),
+              std::vector<uint8_t>({0, 0, 0, 0, 200, 100, 50, 255, 100, 50, 25, 128}));
+}
+
+TEST(Image_blit, BgrMatchesReference) {
+    std::mt19937 rng(99);
+    for (size_t pixels = 0; pixels <= 19; pixels++) {
+        Row row = random_row(rng, pixels, 100);
+        std::vector<uint8_t> bgr(pixels * 3);
+        for (size_t i = 0; i < pixels; i++) {
+            std::copy_n(&row.dst[i * 4], 3, &bgr[i * 3]);
+        }
+        std::vector<uint8_t> result = bgr;
+        blend_premultiplied_row_bgr(row.src.data(), result.data(), pixels);
+        for (size_t i = 0; i < pixels; i++) {
+            double sa = row.src[i * 4 + 3] / 255.0;
+            for (int c = 0; c < 3; c++) {
+                EXPECT_NEAR(result[i * 3 + c], row.src[i * 4 + c] + bgr[i * 3 + c] * (1 - sa), 1.0);
+            }
+        }
+    }
+}
@@ -0,0 +1,147 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/utils/coro/coro.hpp>
+
+#include <future>
+
+using namespace gb;
+
+namespace {
+
+    /**
+     * @brief Executor with one thread which is not registered as its own, like D++ event threads.
+     */
+    class Foreign_executor : public Executor {
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::deque<std::function<void()>> _jobs;
+        bool _is_running = true;
+        std::thread _thread;
+
+    public:
+        Foreign_executor() : _thread([this] {
+            std::unique_lock lk(_mutex);
+            while (true) {
+                _cv.wait(lk, [this] { return !_jobs.empty() || !_is_running; });
+                if (_jobs.empty()) {
+                    return;
+                }
+                auto job = std::move(_jobs.front());
+                _jobs.pop_front();
+                lk.unlock();
+                job();
+                lk.lock();
+            }
+        }) {}
+
+        ~Foreign_executor() override {
+            {
+                std::unique_lock lk(_mutex);
+                _is_running = false;
+            }
+            _cv.notify_all();
+            _thread.join();
+        }
+
+        void post(std::function<void()> job) override {
+            {
+                std::unique_lock lk(_mutex);
+                _jobs.push_back(std::move(job));
+            }
+            _cv.notify_one();
+        }
+    };
+
+    /**
+     * @brief Awaitable doing its work on a separate thread, resumes awaiter like database jobs do.
+     */
+    struct Worker_job {
+        bool await_ready() { return false; }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            std::thread([h, executor = Executor::current()] {
+                if (executor) {
+                    executor->post([h] { h.resume(); });
+                } else {
+                    h.resume();
+                }
+            }).detach();
+        }
+
+        void await_resume() {}
+    };
+
+    Task<int> worker_task() {
+        co_await Worker_job{};
+        co_return 42;
+    }
+
+    Task<Executor *> current_executor_task() { co_return Executor::current(); }
+
+    Task<int> twice_task() {
+        co_await Worker_job{};
+        co_await Worker_job{};
+        co_return 2;
+    }
+
+    /**
+     * @brief Gets foreign executor shared by tests, it outlives detached worker threads still posting to it.
+     */
+    Foreign_executor &get_foreign_executor() {
+        static Foreign_executor executor;
+        return executor;
+    }
+
+    /**
+     * @brief Sets default executor for the test and unsets it afterwards.
+     */
+    struct Default_executor_guard {
+        explicit Default_executor_guard(Executor *executor) { Executor::set_default(executor); }
+        ~Default_executor_guard() { Executor::set_default(nullptr); }
+    };
+
+} // namespace
+
+TEST(Executor, ForeignThreadPostsToDefaultExecutor) {
+    Thread_pool pool(1);
+    Default_executor_guard guard(&pool);
+    Executor *executor = Executor::current();
+    ASSERT_NE(executor, nullptr);
+    std::promise<Thread_pool *> ran_on;
+    executor->post([&] { ran_on.set_value(Thread_pool::current()); });
+    EXPECT_EQ(ran_on.get_future().get(), &pool);
+}
+
+TEST(Executor, ForeignThreadWithoutDefaultHasNoExecutor) { EXPECT_EQ(Executor::current(), nullptr); }
+
+TEST(Executor, PoolThreadKeepsItsExecutor) {
+    Thread_pool pool(1);
+    std::promise<Executor *> executor;
+    pool.post([&] { executor.set_value(sync_wait(current_executor_task())); });
+    EXPECT_EQ(executor.get_future().get(), &pool);
+}
+
+TEST(Executor, SyncWaitOnForeignThreadDoesNotDeadlock) {
+    Foreign_executor &foreign = get_foreign_executor();
+    Default_executor_guard guard(&foreign);
+    std::promise<int> result;
+    auto future = result.get_future();
+    // the only foreign thread blocks, its continuation must not be queued behind it
+    foreign.post([&] { result.set_value(sync_wait(worker_task())); });
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(Executor, SyncWaitServesJobsOfSaturatedPool) {
+    Foreign_executor &foreign = get_foreign_executor();
+    Default_executor_guard guard(&foreign);
+    std::promise<int> result;
+    auto future = result.get_future();
+    foreign.post([&] { result.set_value(sync_wait(twice_task()) + sync_wait(worker_task())); });
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(future.get(), 44);
+}
@@ -0,0 +1,65 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/utils/puzzle_pool/puzzle_pool.hpp>
+
+#include <chrono>
+#include <thread>
+
+using gb::Puzzle_pool;
+
+namespace {
+
+    /**
+     * @brief Waits until the pool holds the amount of ready puzzles.
+     */
+    template<typename Pool>
+    bool wait_ready(Pool &pool, size_t amount) {
+        for (int i = 0; i < 2000; i++) {
+            if (pool.get_stats().ready >= amount) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+} // namespace
+
+TEST(Puzzle_pool, ServesWantedLevel) {
+    // generator ignores the wanted level and always makes level 1 puzzles
+    Puzzle_pool<int> pool(3, 2, 1, [](size_t) { return std::pair<size_t, int>{1, 100}; });
+    ASSERT_TRUE(wait_ready(pool, 2));
+    EXPECT_EQ(pool.take(1), 100);
+    auto stats = pool.get_stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 0u);
+}
+
+TEST(Puzzle_pool, ServesNearestLevelWithoutGenerating) {
+    std::atomic_size_t calls = 0;
+    Puzzle_pool<int> pool(4, 1, 1, [&calls](size_t) {
+        calls++;
+        return std::pair<size_t, int>{2, 2};
+    });
+    ASSERT_TRUE(wait_ready(pool, 1));
+    size_t calls_before = calls;
+    // level 0 is empty, level 2 is the nearest ready one
+    EXPECT_EQ(pool.take(0), 2);
+    auto stats = pool.get_stats();
+    EXPECT_EQ(stats.nearest, 1u);
+    EXPECT_EQ(stats.misses, 0u);
+    EXPECT_LE(calls - calls_before, 1u); // only the worker refilling, take did not generate
+}
+
+TEST(Puzzle_pool, GeneratesOnceWhenEmpty) {
+    // without workers nothing is ever ready
+    Puzzle_pool<int> pool(2, 4, 0, [](size_t level) { return std::pair<size_t, int>{1 - level, 7}; });
+    EXPECT_EQ(pool.take(0), 7);
+    auto stats = pool.get_stats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.ready, 0u);
+}
@@ -0,0 +1,120 @@
+//
+// Created by ilesik on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <src/utils/timer_wheel/timer_wheel.hpp>
+
+#include <random>
+#include <vector>
+
+using gb::Timer_wheel;
+
+namespace {
+
+    /**
+     * @brief Ticks wheel, recording tick number of every fired timer id.
+     */
+    struct Recorder {
+        Timer_wheel wheel;
+        uint64_t now = 0;
+        std::vector<std::pair<uint64_t, int>> fired; ///< Tick and id of fired timers in firing order.
+
+        Timer_wheel::Handle add(time_t timeout, int id) {
+            return wheel.add(timeout, [this, id] { fired.emplace_back(now, id); });
+        }
+
+        void tick(uint64_t amount) {
+            for (uint64_t i = 0; i < amount; i++) {
+                now++;
+                wheel.tick();
+            }
+        }
+    };
+
+} // namespace
+
+TEST(Timer_wheel, FiresExactlyAtTimeout) {
+    Recorder r;
+    r.add(3, 1);
+    r.tick(2);
+    EXPECT_TRUE(r.fired.empty());
+    r.tick(1);
+    ASSERT_EQ(r.fired.size(), 1u);
+    EXPECT_EQ(r.fired[0], std::make_pair(uint64_t(3), 1));
+    EXPECT_EQ(r.wheel.size(), 0u);
+}
+
+TEST(Timer_wheel, NonPositiveTimeoutFiresOnFirstTick) {
+    Recorder r;
+    r.add(0, 1);
+    r.add(-5, 2);
+    r.tick(1);
+    EXPECT_EQ(r.fired.size(), 2u);
+}
+
+TEST(Timer_wheel, FiresInExpiryOrderAcrossLevels) {
+    Recorder r;
+    // timeouts spanning all levels, including ones right at level boundaries
+    std::vector<time_t> timeouts = {1, 63, 64, 65, 127, 128, 4095, 4096, 4097, 70000, 262143, 262144, 300000};
+    for (size_t i = 0; i < timeouts.size(); i++) {
+        r.add(timeouts[i], static_cast<int>(i));
+    }
+    r.tick(300000);
+    ASSERT_EQ(r.fired.size(), timeouts.size());
+    for (size_t i = 0; i < timeouts.size(); i++) {
+        EXPECT_EQ(r.fired[i].first, static_cast<uint64_t>(timeouts[i])) << "timeout " << timeouts[i];
+        EXPECT_EQ(r.fired[i].second, static_cast<int>(i));
+    }
+}
+
+TEST(Timer_wheel, RandomTimersFireOnTimeWhenAddedAtAnyTick) {
+    Recorder r;
+    std::mt19937 rng(7);
+    std::vector<uint64_t> expected(2000);
+    for (int i = 0; i < 2000; i++) {
+        // spread additions over time, so timers are placed relative to a moving now
+        r.tick(rng() % 50);
+        time_t timeout = 1 + rng() % 20000;
+        expected[i] = r.now + timeout;
+        r.add(timeout, i);
+    }
+    r.tick(20000);
+    ASSERT_EQ(r.fired.size(), expected.size());
+    for (size_t i = 1; i < r.fired.size(); i++) {
+        EXPECT_LE(r.fired[i - 1].first, r.fired[i].first);
+    }
+    for (auto &[tick, id]: r.fired) {
+        EXPECT_EQ(tick, expected[id]);
+    }
+}
+
+TEST(Timer_wheel, CancelledTimerDoesNotFire) {
+    Recorder r;
+    auto handle = r.add(100, 1);
+    r.add(100, 2);
+    EXPECT_EQ(r.wheel.size(), 2u);
+    EXPECT_TRUE(r.wheel.cancel(handle));
+    EXPECT_FALSE(r.wheel.cancel(handle));
+    EXPECT_EQ(r.wheel.size(), 1u);
+    r.tick(100);
+    ASSERT_EQ(r.fired.size(), 1u);
+    EXPECT_EQ(r.fired[0].second, 2);
+}
+
+TEST(Timer_wheel, CancelAfterFiringFails) {
+    Recorder r;
+    auto handle = r.add(1, 1);
+    r.tick(1);
+    EXPECT_FALSE(r.wheel.cancel(handle));
+    EXPECT_FALSE(r.wheel.cancel(Timer_wheel::Handle{}));
+}
+
+TEST(Timer_wheel, CallbackCanAddTimers) {
+    Recorder r;
+    r.wheel.add(2, [&r] { r.add(5, 2); });
+    r.tick(7);
+    ASSERT_EQ(r.fired.size(), 1u);
+    EXPECT_EQ(r.fired[0], std::make_pair(uint64_t(7), 2));
+}